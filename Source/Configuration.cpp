@@ -75,6 +75,17 @@ void readStringMandatory(std::string& storage, tinyxml2::XMLElement* node) {
   }
 }
 
+void readStringOptional(
+  std::string& storage, tinyxml2::XMLElement* node, const char* tag, const std::string& defaultValue = ""
+) {
+  const char* myText = node->Attribute(tag);
+  if (myText == NULL) {
+    storage = defaultValue;
+  } else {
+    storage = myText;
+  }
+}
+
 void readWall(tinyxml2::XMLElement* wall, RealType* vector, RealType& scalar) {
   tinyxml2::XMLElement* quantity = wall->FirstChildElement("vector");
   if (quantity != NULL) {
@@ -191,6 +202,17 @@ void Configuration::loadParameters(Parameters& parameters, const MPI_Comm& commu
       } else {
         parameters.geometry.stretchZ = false;
       }
+    } else if (meshsizeType == "file") {
+      parameters.geometry.meshsizeType = CoordinateFile;
+      readStringOptional(parameters.geometry.meshFile, node, "meshFile");
+      if (parameters.geometry.meshFile.empty()) {
+        throw std::runtime_error("Missing 'meshFile' for mesh 'file'!");
+      }
+      // Relative paths are given w.r.t. the configuration file
+      const std::filesystem::path meshFile(parameters.geometry.meshFile);
+      if (meshFile.is_relative()) {
+        parameters.geometry.meshFile = (std::filesystem::path(filename_).parent_path() / meshFile).string();
+      }
     } else {
       throw std::runtime_error("Unknown 'mesh'!");
     }
@@ -211,6 +233,33 @@ void Configuration::loadParameters(Parameters& parameters, const MPI_Comm& commu
     readFloatOptional(parameters.timestep.dt, node, "dt", 1);
     readFloatOptional(parameters.timestep.tau, node, "tau", 0.5);
 
+    std::string timeScheme = "";
+    readStringOptional(timeScheme, node, "scheme", "euler");
+    if (timeScheme == "euler") {
+      parameters.timestep.scheme = ForwardEuler;
+    } else if (timeScheme == "ab2") {
+      parameters.timestep.scheme = AdamsBashforth2;
+    } else if (timeScheme == "rk3") {
+      parameters.timestep.scheme = RungeKutta3;
+    } else {
+      throw std::runtime_error("Unknown time integration 'scheme'! Currently supported: euler, ab2, rk3");
+    }
+
+    bool imex = false;
+    readBoolOptional(imex, node, "imex");
+    parameters.timestep.imex = static_cast<int>(imex);
+    readFloatOptional(parameters.timestep.imexTolerance, node, "imexTolerance", 1e-6);
+    readIntOptional(parameters.timestep.imexIterations, node, "imexIterations", 500);
+
+    bool singleProjection = false;
+    readBoolOptional(singleProjection, node, "singleProjection");
+    parameters.timestep.singleProjection = static_cast<int>(singleProjection);
+    // The pressure of the final stage of RK3/Crank-Nicolson has a weight of 1/3, so the error of the previous pressure,
+    // which the first two stages would take, doubles every step
+    if (singleProjection && (parameters.timestep.scheme != RungeKutta3 || imex)) {
+      throw std::runtime_error("Timestep 'singleProjection' requires the time integration scheme 'rk3' without 'imex'!");
+    }
+
     //--------------------------------------------------
     // Flow parameters
     //--------------------------------------------------
@@ -233,6 +282,174 @@ void Configuration::loadParameters(Parameters& parameters, const MPI_Comm& commu
 
     readFloatMandatory(parameters.solver.gamma, node, "gamma");
     readIntOptional(parameters.solver.maxIterations, node, "maxIterations");
+    readFloatOptional(parameters.solver.tolerance, node, "tolerance", 1e-4);
+    if (parameters.solver.tolerance <= 0) {
+      throw std::runtime_error("Solver 'tolerance' must be positive!");
+    }
+    // Replaces the fixed tolerance by one scaled every step, see Simulation::solveStage
+    readFloatOptional(parameters.solver.divergence, node, "divergence", 0);
+    if (parameters.solver.divergence < 0) {
+      throw std::runtime_error("Solver 'divergence' must not be negative!");
+    }
+
+    std::string extrapolation = "";
+    readStringOptional(extrapolation, node, "extrapolation", "linear");
+    if (extrapolation == "none") {
+      parameters.solver.extrapolation = 0;
+    } else if (extrapolation == "linear") {
+      parameters.solver.extrapolation = 1;
+    } else if (extrapolation == "quadratic") {
+      parameters.solver.extrapolation = 2;
+    } else {
+      throw std::runtime_error("Unknown solver 'extrapolation'! Currently supported: none, linear, quadratic");
+    }
+
+    // The low-storage Runge-Kutta scheme folds the pressure correction u - F of a stage into its register, which
+    // requires a predictor without the pressure gradient
+    bool incremental = false;
+    readBoolOptional(incremental, node, "incremental");
+    parameters.solver.incremental = static_cast<int>(incremental);
+    if (incremental && parameters.timestep.scheme == RungeKutta3) {
+      throw std::runtime_error("Solver 'incremental' cannot be combined with the time integration scheme 'rk3'!");
+    }
+
+    // The automatic choice is made once the domain decomposition is known, see createPressureSolver
+    std::string solverType = "";
+    readStringOptional(solverType, node, "type", "auto");
+    if (solverType == "auto") {
+      parameters.solver.type = AutomaticPressureSolver;
+    } else if (solverType == "sor") {
+      parameters.solver.type = SORPressureSolver;
+    } else if (solverType == "multigrid") {
+      parameters.solver.type = MultigridPressureSolver;
+    } else if (solverType == "spectral") {
+      parameters.solver.type = SpectralPressureSolver;
+    } else if (solverType == "cg") {
+      parameters.solver.type = CGPressureSolver;
+    } else if (solverType == "line") {
+      parameters.solver.type = LinePressureSolver;
+    } else if (solverType == "petsc") {
+#ifndef ENABLE_PETSC
+      throw std::runtime_error("Solver type 'petsc' requires a build with PETSc!");
+#endif
+      parameters.solver.type = PetscPressureSolver;
+    } else {
+      throw std::runtime_error("Unknown solver 'type'! Currently supported: auto, sor, multigrid, line, spectral, cg, petsc");
+    }
+
+    if (parameters.solver.type == MultigridPressureSolver) {
+      std::string cycle = "";
+      readStringOptional(cycle, node, "cycle", "V");
+      if (cycle == "V") {
+        parameters.solver.cycle = VCycle;
+      } else if (cycle == "W") {
+        parameters.solver.cycle = WCycle;
+      } else if (cycle == "F") {
+        parameters.solver.cycle = FCycle;
+      } else {
+        throw std::runtime_error("Unknown multigrid 'cycle'! Currently supported: V, W, F");
+      }
+
+      std::string smoother = "";
+      // Point smoothers are inefficient on the anisotropic cells of non-uniform meshes
+      readStringOptional(smoother, node, "smoother", parameters.geometry.meshsizeType == Uniform ? "redblack" : "line");
+      if (smoother == "redblack") {
+        parameters.solver.smoother = RedBlackGaussSeidel;
+      } else if (smoother == "jacobi") {
+        parameters.solver.smoother = WeightedJacobi;
+      } else if (smoother == "line") {
+        parameters.solver.smoother = LineGaussSeidel;
+      } else {
+        throw std::runtime_error("Unknown multigrid 'smoother'! Currently supported: redblack, jacobi, line");
+      }
+
+      readIntOptional(parameters.solver.preSmoothing, node, "preSmoothing", 2);
+      readIntOptional(parameters.solver.postSmoothing, node, "postSmoothing", 2);
+      if (parameters.solver.preSmoothing < 0 || parameters.solver.postSmoothing < 0 || parameters.solver.preSmoothing + parameters.solver.postSmoothing == 0) {
+        throw std::runtime_error("Multigrid needs at least one smoothing step!");
+      }
+    }
+
+    // The automatic choice falls back to CG in builds without PETSc
+    if (parameters.solver.type == CGPressureSolver || parameters.solver.type == AutomaticPressureSolver) {
+      std::string preconditioner = "";
+      readStringOptional(preconditioner, node, "preconditioner", "ic");
+      if (preconditioner == "jacobi") {
+        parameters.solver.preconditioner = JacobiPreconditioner;
+      } else if (preconditioner == "ssor") {
+        parameters.solver.preconditioner = SSORPreconditioner;
+      } else if (preconditioner == "ic") {
+        parameters.solver.preconditioner = IncompleteCholesky;
+      } else {
+        throw std::runtime_error("Unknown CG 'preconditioner'! Currently supported: jacobi, ssor, ic");
+      }
+    }
+
+    // CG and the multigrid solver, also with the line smoother only, iterate in single precision. PetscScalar is fixed
+    // when PETSc is configured, so the PETSc solver keeps its Krylov iteration in double precision and takes a
+    // single-precision multigrid cycle as preconditioner.
+    bool mixedPrecision = false;
+    readBoolOptional(mixedPrecision, node, "mixedPrecision");
+    parameters.solver.mixedPrecision = static_cast<int>(mixedPrecision);
+    if (mixedPrecision && parameters.solver.type != CGPressureSolver && parameters.solver.type != MultigridPressureSolver
+        && parameters.solver.type != LinePressureSolver && parameters.solver.type != PetscPressureSolver
+        && parameters.solver.type != AutomaticPressureSolver) {
+      throw std::runtime_error("Solver 'mixedPrecision' is only supported by the solver types auto, petsc, cg, multigrid and line!");
+    }
+
+    if (parameters.solver.type == SORPressureSolver) {
+      readFloatOptional(parameters.solver.omega, node, "omega", 0);
+      if (parameters.solver.omega < 0 || parameters.solver.omega >= 2) {
+        throw std::runtime_error("SOR 'omega' must be within (0, 2), or 0 to estimate it!");
+      }
+
+      bool chebyshev = false;
+      readBoolOptional(chebyshev, node, "chebyshev");
+      parameters.solver.chebyshev = static_cast<int>(chebyshev);
+      if (chebyshev && parameters.solver.omega > 0) {
+        throw std::runtime_error("SOR 'chebyshev' acceleration requires an estimated 'omega'!");
+      }
+
+      readIntOptional(parameters.solver.residualInterval, node, "residualInterval", 1);
+      if (parameters.solver.residualInterval < 1) {
+        throw std::runtime_error("SOR 'residualInterval' must be at least 1!");
+      }
+    }
+
+    if (parameters.solver.type == LinePressureSolver) {
+      readFloatOptional(parameters.solver.omega, node, "omega", 1);
+      if (parameters.solver.omega <= 0 || parameters.solver.omega >= 2) {
+        throw std::runtime_error("Line relaxation 'omega' must be within (0, 2)!");
+      }
+    }
+
+    if (parameters.solver.type == PetscPressureSolver || parameters.solver.type == AutomaticPressureSolver) {
+      bool matrixFree = false;
+      readBoolOptional(matrixFree, node, "matrixFree");
+      parameters.solver.matrixFree = static_cast<int>(matrixFree);
+
+      bool pipelined = false;
+      readBoolOptional(pipelined, node, "pipelined");
+      parameters.solver.pipelined = static_cast<int>(pipelined);
+
+      // The coarse operators are Galerkin products, which need the entries of the matrix
+      bool multigrid = false;
+      readBoolOptional(multigrid, node, "multigrid");
+      parameters.solver.multigrid = static_cast<int>(multigrid);
+      if (multigrid && matrixFree) {
+        throw std::runtime_error("Solver 'multigrid' requires an assembled matrix and cannot be combined with 'matrixFree'!");
+      }
+
+      bool autotune = false;
+      readBoolOptional(autotune, node, "autotune");
+      parameters.solver.autotune = static_cast<int>(autotune);
+      readStringOptional(parameters.solver.autotuneCache, node, "autotuneCache", "PressureSolver.cache");
+
+      // Mixed precision sets the preconditioner itself
+      if (mixedPrecision && (multigrid || autotune)) {
+        throw std::runtime_error("Solver 'mixedPrecision' cannot be combined with 'multigrid' or 'autotune'!");
+      }
+    }
 
     //--------------------------------------------------
     // Environmental parameters
@@ -415,11 +632,34 @@ void Configuration::loadParameters(Parameters& parameters, const MPI_Comm& commu
 
   MPI_Bcast(&(parameters.timestep.dt), 1, MY_MPI_FLOAT, 0, communicator);
   MPI_Bcast(&(parameters.timestep.tau), 1, MY_MPI_FLOAT, 0, communicator);
+  MPI_Bcast(&(parameters.timestep.scheme), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.timestep.imex), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.timestep.singleProjection), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.timestep.imexTolerance), 1, MY_MPI_FLOAT, 0, communicator);
+  MPI_Bcast(&(parameters.timestep.imexIterations), 1, MPI_INT, 0, communicator);
 
   MPI_Bcast(&(parameters.flow.Re), 1, MY_MPI_FLOAT, 0, communicator);
 
   MPI_Bcast(&(parameters.solver.gamma), 1, MY_MPI_FLOAT, 0, communicator);
-  MPI_Bcast(&(parameters.solver.maxIterations), 1, MY_MPI_FLOAT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.maxIterations), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.type), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.tolerance), 1, MY_MPI_FLOAT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.divergence), 1, MY_MPI_FLOAT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.extrapolation), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.incremental), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.cycle), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.smoother), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.preSmoothing), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.postSmoothing), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.preconditioner), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.mixedPrecision), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.omega), 1, MY_MPI_FLOAT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.chebyshev), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.residualInterval), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.matrixFree), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.pipelined), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.multigrid), 1, MPI_INT, 0, communicator);
+  MPI_Bcast(&(parameters.solver.autotune), 1, MPI_INT, 0, communicator);
 
   MPI_Bcast(&(parameters.environment.gx), 1, MY_MPI_FLOAT, 0, communicator);
   MPI_Bcast(&(parameters.environment.gy), 1, MY_MPI_FLOAT, 0, communicator);
@@ -430,9 +670,11 @@ void Configuration::loadParameters(Parameters& parameters, const MPI_Comm& commu
   MPI_Bcast(&(parameters.vtk.interval), 1, MY_MPI_FLOAT, 0, communicator);
   MPI_Bcast(&(parameters.stdOut.interval), 1, MPI_INT, 0, communicator);
 
+  broadcastString(parameters.geometry.meshFile, communicator);
   broadcastString(parameters.vtk.prefix, communicator);
   broadcastString(parameters.simulation.type, communicator);
   broadcastString(parameters.simulation.scenario, communicator);
+  broadcastString(parameters.solver.autotuneCache, communicator);
 
   MPI_Bcast(&(parameters.bfStep.xRatio), 1, MY_MPI_FLOAT, 0, communicator);
   MPI_Bcast(&(parameters.bfStep.yRatio), 1, MY_MPI_FLOAT, 0, communicator);
@@ -16,7 +16,8 @@ FlowField::FlowField(int Nx, int Ny):
   velocity_(VectorField(Nx + 3, Ny + 3)),
   flags_(IntScalarField(Nx + 3, Ny + 3)),
   FGH_(VectorField(Nx + 3, Ny + 3)),
-  RHS_(ScalarField(Nx + 3, Ny + 3)) {
+  RHS_(ScalarField(Nx + 3, Ny + 3)),
+  history_(VectorField(Nx + 3, Ny + 3)) {
 
   ASSERTION(Nx > 0);
   ASSERTION(Ny > 0);
@@ -33,7 +34,8 @@ FlowField::FlowField(int Nx, int Ny, int Nz):
   velocity_(VectorField(Nx + 3, Ny + 3, Nz + 3)),
   flags_(IntScalarField(Nx + 3, Ny + 3, Nz + 3)),
   FGH_(VectorField(Nx + 3, Ny + 3, Nz + 3)),
-  RHS_(ScalarField(Nx + 3, Ny + 3, Nz + 3)) {
+  RHS_(ScalarField(Nx + 3, Ny + 3, Nz + 3)),
+  history_(VectorField(Nx + 3, Ny + 3, Nz + 3)) {
 
   ASSERTION(Nx > 0);
   ASSERTION(Ny > 0);
@@ -63,6 +65,12 @@ FlowField::FlowField(const Parameters& parameters):
   ),
   RHS_(
     parameters.geometry.dim == 2 ? ScalarField(sizeX_ + 3, sizeY_ + 3) : ScalarField(sizeX_ + 3, sizeY_ + 3, sizeZ_ + 3)
+  ),
+  // Forward Euler does not carry any state between timesteps
+  history_(
+    parameters.timestep.scheme == ForwardEuler ? VectorField(1, 1)
+    : parameters.geometry.dim == 2             ? VectorField(sizeX_ + 3, sizeY_ + 3)
+                                               : VectorField(sizeX_ + 3, sizeY_ + 3, sizeZ_ + 3)
   ) {}
 
 int FlowField::getNx() const { return sizeX_; }
@@ -87,6 +95,8 @@ VectorField& FlowField::getFGH() { return FGH_; }
 
 ScalarField& FlowField::getRHS() { return RHS_; }
 
+VectorField& FlowField::getHistory() { return history_; }
+
 void FlowField::getPressureAndVelocity(RealType& pressure, RealType* const velocity, int i, int j) {
   RealType* vHere = getVelocity().getVector(i, j);
   RealType* vLeft = getVelocity().getVector(i - 1, j);
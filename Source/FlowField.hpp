@@ -25,6 +25,8 @@ private:
   VectorField FGH_;
   ScalarField RHS_; //! Right hand side for the Poisson equation
 
+  VectorField history_; //! Tendency register of the multi-step/multi-stage time integrators
+
 public:
   /** Constructor for the 2D flow field
    *
@@ -89,6 +91,13 @@ public:
 
   ScalarField& getRHS();
 
+  /** Tendency register used by the Adams-Bashforth and low-storage Runge-Kutta schemes
+   *
+   * Holds the previous momentum tendency (AB2) or the accumulated stage increment (RK3), per
+   * velocity component. Only allocated at full size if one of these schemes is selected.
+   */
+  VectorField& getHistory();
+
   void getPressureAndVelocity(RealType& pressure, RealType* const velocity, int i, int j);
   void getPressureAndVelocity(RealType& pressure, RealType* const velocity, int i, int j, int k);
 };
@@ -124,8 +124,38 @@ int main(int argc, char* argv[]) {
     timeSteps++;
     time += parameters.timestep.dt;
 
-    if ((rank == 0) && (timeStdOut <= time)) {
-      spdlog::info("Current time: {}\tTimestep: {}", time, parameters.timestep.dt);
+    if (timeStdOut <= time) {
+      const int           pressureSolves     = simulation->getPressureSolves();
+      const int           pressureIterations = simulation->getPressureIterations();
+      const std::uint64_t pressureTime       = simulation->getPressureTime();
+      const auto          pressureReductions = simulation->getPressureReductions();
+      const int           singleIterations   = simulation->getSinglePrecisionIterations();
+      const std::uint64_t singleTime         = simulation->getSinglePrecisionTime();
+      if (rank == 0) {
+        // With mixed precision, the share of the single-precision iterations shows the effect on every step
+        const std::string single = parameters.solver.mixedPrecision
+                                     ? fmt::format(" (single precision: {} iterations in {}us)", singleIterations, singleTime / 1000)
+                                     : "";
+        // Per solve, to compare the solvers independently of the stdOut interval
+        const double      solves     = std::max(pressureSolves, 1);
+        const std::string reductions = ParallelManagers::ReductionCounter::isEnabled()
+                                         ? fmt::format(
+                                           "\tGlobal reductions per solve: {:.1f} blocking ({:.1f}us), {:.1f} non-blocking",
+                                           pressureReductions.blocking / solves,
+                                           pressureReductions.blockingTime * 1e6 / solves,
+                                           pressureReductions.nonBlocking / solves
+                                         )
+                                         : "";
+        spdlog::info(
+          "Current time: {}\tTimestep: {}\tPressure iterations: {}\tPressure time: {}us{}{}",
+          time,
+          parameters.timestep.dt,
+          pressureIterations,
+          pressureTime / 1000,
+          single,
+          reductions
+        );
+      }
       timeStdOut += parameters.stdOut.interval;
     }
 
@@ -4,58 +4,213 @@
 
 #include "Parameters.hpp"
 
+void Meshsize::allocateAxis(int axis, int localSize) {
+  // Local indices -2, ..., localSize + 3
+  spacings_[axis].assign(localSize + 4 + ghostOffset_, 0.0);
+  coordinates_[axis].assign(localSize + 4 + ghostOffset_, 0.0);
+}
+
+void Meshsize::setUniformAxis(int axis, int localSize, int firstCorner, RealType meshsize) {
+  allocateAxis(axis, localSize);
+  for (int n = 0; n < static_cast<int>(spacings_[axis].size()); n++) {
+    const int i           = n - ghostOffset_;
+    spacings_[axis][n]    = meshsize;
+    coordinates_[axis][n] = meshsize * (firstCorner - 2 + i);
+  }
+  minSpacing_[axis] = meshsize;
+}
+
 UniformMeshsize::UniformMeshsize(const Parameters& parameters):
-  Meshsize(),
-  dx_(parameters.geometry.lengthX / parameters.geometry.sizeX),
-  dy_(parameters.geometry.lengthY / parameters.geometry.sizeY),
-  dz_(parameters.geometry.dim == 3 ? parameters.geometry.lengthZ / parameters.geometry.sizeZ : 0.0),
-  firstCornerX_(parameters.parallel.firstCorner[0]),
-  firstCornerY_(parameters.parallel.firstCorner[1]),
-  firstCornerZ_(parameters.geometry.dim == 3 ? parameters.parallel.firstCorner[2] : 0) {
-
-  if (dx_ <= 0.0) {
+  Meshsize() {
+
+  const RealType dx = parameters.geometry.lengthX / parameters.geometry.sizeX;
+  const RealType dy = parameters.geometry.lengthY / parameters.geometry.sizeY;
+  const RealType dz = parameters.geometry.dim == 3 ? parameters.geometry.lengthZ / parameters.geometry.sizeZ : 0.0;
+
+  if (dx <= 0.0) {
     throw std::runtime_error("dx <= 0.0!");
   }
-  if (dy_ <= 0.0) {
+  if (dy <= 0.0) {
     throw std::runtime_error("dy <= 0.0!");
   }
   if (parameters.geometry.dim == 3) {
-    if (dz_ <= 0.0) {
+    if (dz <= 0.0) {
       throw std::runtime_error("dz <= 0.0!");
     }
   }
+
+  setUniformAxis(0, parameters.parallel.localSize[0], parameters.parallel.firstCorner[0], dx);
+  setUniformAxis(1, parameters.parallel.localSize[1], parameters.parallel.firstCorner[1], dy);
+  if (parameters.geometry.dim == 3) {
+    setUniformAxis(2, parameters.parallel.localSize[2], parameters.parallel.firstCorner[2], dz);
+  } else {
+    setUniformAxis(2, 1, 0, dz);
+  }
 }
 
 TanhMeshStretching::TanhMeshStretching(const Parameters& parameters, bool stretchX, bool stretchY, bool stretchZ):
   Meshsize(),
-  uniformMeshsize_(parameters),
-  lengthX_(parameters.geometry.lengthX),
-  lengthY_(parameters.geometry.lengthY),
-  lengthZ_(parameters.geometry.dim == 3 ? parameters.geometry.lengthZ : 0.0),
-  sizeX_(parameters.geometry.sizeX),
-  sizeY_(parameters.geometry.sizeY),
-  sizeZ_(parameters.geometry.dim == 3 ? parameters.geometry.sizeZ : 1),
-  firstCornerX_(parameters.parallel.firstCorner[0]),
-  firstCornerY_(parameters.parallel.firstCorner[1]),
-  firstCornerZ_(parameters.geometry.dim == 3 ? parameters.parallel.firstCorner[2] : 0),
-  stretchX_(stretchX),
-  stretchY_(stretchY),
-  stretchZ_(stretchZ),
   deltaS_(2.7),
   tanhDeltaS_(tanh(2.7)) // This parameters is chosen as 2.7 as used also in the dissertation by Tobias Neckel
-  ,
-  dxMin_(
-    stretchX
-      ? 0.5 * parameters.geometry.lengthX * (1.0 + tanh(deltaS_ * (2.0 / sizeX_ - 1.0)) / tanhDeltaS_)
-      : uniformMeshsize_.getDx(0, 0)
-  ),
-  dyMin_(
-    stretchY
-      ? 0.5 * parameters.geometry.lengthY * (1.0 + tanh(deltaS_ * (2.0 / sizeY_ - 1.0)) / tanhDeltaS_)
-      : uniformMeshsize_.getDy(0, 0)
-  ),
-  dzMin_(
-    stretchZ
-      ? 0.5 * parameters.geometry.lengthZ * (1.0 + tanh(deltaS_ * (2.0 / sizeZ_ - 1.0)) / tanhDeltaS_)
-      : uniformMeshsize_.getDz(0, 0, 0)
-  ) {}
+{
+  const int      dim             = parameters.geometry.dim;
+  const int      sizes[3]        = {parameters.geometry.sizeX, parameters.geometry.sizeY, dim == 3 ? parameters.geometry.sizeZ : 1};
+  const int      localSizes[3]   = {parameters.parallel.localSize[0], parameters.parallel.localSize[1], dim == 3 ? parameters.parallel.localSize[2] : 1};
+  const RealType lengths[3]      = {parameters.geometry.lengthX, parameters.geometry.lengthY, dim == 3 ? parameters.geometry.lengthZ : 0.0};
+  const int      firstCorners[3] = {parameters.parallel.firstCorner[0], parameters.parallel.firstCorner[1], dim == 3 ? parameters.parallel.firstCorner[2] : 0};
+  const bool     stretch[3]      = {stretchX, stretchY, stretchZ};
+
+  for (int axis = 0; axis < 3; axis++) {
+    // Uniform meshsize of this axis, zero for z in 2D
+    const RealType uniform = (axis < dim) ? lengths[axis] / sizes[axis] : 0.0;
+    if (stretch[axis]) {
+      const RealType dxMin = 0.5 * lengths[axis] * (1.0 + tanh(deltaS_ * (2.0 / sizes[axis] - 1.0)) / tanhDeltaS_);
+      setStretchedAxis(axis, sizes[axis], localSizes[axis], firstCorners[axis], lengths[axis], dxMin);
+    } else {
+      setUniformAxis(axis, localSizes[axis], firstCorners[axis], uniform);
+    }
+  }
+}
+
+RealType TanhMeshStretching::computeCoordinate(int index, int size, RealType length, RealType dxMin) const {
+  if (index < 0) {
+    // Equidistant mesh on lower/left part
+    return dxMin * index;
+  } else if (index > size - 1) {
+    // Equidistant mesh on upper/right part
+    return length + dxMin * (index - size);
+  } else {
+    // Stretched mesh on lower half of channel -> we check if we are in lower 50% and then use stretching for 2.0 * p
+    RealType p = (static_cast<RealType>(index)) / size;
+    if (p < 0.5) {
+      return 0.5 * length * (1.0 + tanh(deltaS_ * (2.0 * p - 1.0)) / tanhDeltaS_);
+    } else {
+      // Stretched mesh on upper half of channel -> we mirror the stretching
+      p = (static_cast<RealType>(size) - index) / size;
+      return length - 0.5 * length * (1.0 + tanh(deltaS_ * (2.0 * p - 1.0)) / tanhDeltaS_);
+    }
+  }
+}
+
+void TanhMeshStretching::setStretchedAxis(
+  int axis, int size, int localSize, int firstCorner, RealType length, RealType dxMin
+) {
+  allocateAxis(axis, localSize);
+  for (int n = 0; n < static_cast<int>(spacings_[axis].size()); n++) {
+    // Global index of the local cell i = n - ghostOffset_
+    const int      index = n - ghostOffset_ - 2 + firstCorner;
+    const RealType pos0  = computeCoordinate(index, size, length, dxMin);
+    const RealType pos1  = computeCoordinate(index + 1, size, length, dxMin);
+    // The meshsize is based on the vertex coordinates that span the respective 1D-cell
+    if (pos1 - pos0 < 1.0e-12) {
+      throw std::runtime_error("Error TanhMeshStretching: dx < 1.0e-12!");
+    }
+    spacings_[axis][n]    = pos1 - pos0;
+    coordinates_[axis][n] = pos0;
+  }
+  minSpacing_[axis] = dxMin;
+}
+
+// Reads the node coordinates of the axes that are listed in a mesh file. The other axes remain empty.
+static void readMeshFile(const std::string& filename, std::vector<RealType> nodes[3]) {
+  std::ifstream file(filename);
+  if (!file) {
+    throw std::runtime_error("Error FileMeshsize: cannot open mesh file '" + filename + "'!");
+  }
+
+  int         axis = -1;
+  std::string line;
+  while (std::getline(file, line)) {
+    const std::size_t comment = line.find('#');
+    if (comment != std::string::npos) {
+      line.erase(comment);
+    }
+
+    std::istringstream stream(line);
+    std::string        token;
+    while (stream >> token) {
+      if (token == "x" || token == "y" || token == "z") {
+        axis = token[0] - 'x';
+        if (!nodes[axis].empty()) {
+          throw std::runtime_error("Error FileMeshsize: axis " + token + " is defined twice!");
+        }
+        continue;
+      }
+      if (axis < 0) {
+        throw std::runtime_error("Error FileMeshsize: coordinates without axis name!");
+      }
+
+      std::size_t    length = 0;
+      const RealType value  = static_cast<RealType>(std::stod(token, &length));
+      if (length != token.size()) {
+        throw std::runtime_error("Error FileMeshsize: invalid coordinate '" + token + "'!");
+      }
+      nodes[axis].push_back(value);
+    }
+  }
+}
+
+FileMeshsize::FileMeshsize(const Parameters& parameters):
+  Meshsize() {
+
+  const int      dim             = parameters.geometry.dim;
+  const int      sizes[3]        = {parameters.geometry.sizeX, parameters.geometry.sizeY, dim == 3 ? parameters.geometry.sizeZ : 1};
+  const int      localSizes[3]   = {parameters.parallel.localSize[0], parameters.parallel.localSize[1], dim == 3 ? parameters.parallel.localSize[2] : 1};
+  const RealType lengths[3]      = {parameters.geometry.lengthX, parameters.geometry.lengthY, dim == 3 ? parameters.geometry.lengthZ : 0.0};
+  const int      firstCorners[3] = {parameters.parallel.firstCorner[0], parameters.parallel.firstCorner[1], dim == 3 ? parameters.parallel.firstCorner[2] : 0};
+
+  // The file is small compared to the flow field, every process reads it and keeps its slice
+  std::vector<RealType> nodes[3];
+  readMeshFile(parameters.geometry.meshFile, nodes);
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (nodes[axis].empty()) {
+      setUniformAxis(axis, localSizes[axis], firstCorners[axis], (axis < dim) ? lengths[axis] / sizes[axis] : 0.0);
+      continue;
+    }
+
+    if (axis >= dim) {
+      throw std::runtime_error("Error FileMeshsize: z-coordinates given for a 2D simulation!");
+    }
+    if (static_cast<int>(nodes[axis].size()) != sizes[axis] + 1) {
+      throw std::runtime_error("Error FileMeshsize: wrong number of node coordinates, expected size + 1!");
+    }
+    if (nodes[axis].front() != 0.0 || fabs(nodes[axis].back() - lengths[axis]) > 1.0e-10 * lengths[axis]) {
+      throw std::runtime_error("Error FileMeshsize: node coordinates must span the interval [0, length]!");
+    }
+    setTabulatedAxis(axis, localSizes[axis], firstCorners[axis], nodes[axis]);
+  }
+}
+
+void FileMeshsize::setTabulatedAxis(int axis, int localSize, int firstCorner, const std::vector<RealType>& nodes) {
+  const int size = static_cast<int>(nodes.size()) - 1;
+
+  // The min. meshsize is the one of the whole domain, as for the other mesh types
+  minSpacing_[axis] = nodes[1] - nodes[0];
+  for (int index = 0; index < size; index++) {
+    if (nodes[index + 1] - nodes[index] < 1.0e-12) {
+      throw std::runtime_error("Error FileMeshsize: node coordinates must increase by at least 1.0e-12!");
+    }
+    minSpacing_[axis] = std::min(minSpacing_[axis], nodes[index + 1] - nodes[index]);
+  }
+
+  // Coordinate of the node with global index "index", continued with the outermost meshsizes outside the domain
+  auto coordinate = [&nodes, size](int index) {
+    if (index < 0) {
+      return nodes[0] + index * (nodes[1] - nodes[0]);
+    } else if (index > size) {
+      return nodes[size] + (index - size) * (nodes[size] - nodes[size - 1]);
+    }
+    return nodes[index];
+  };
+
+  allocateAxis(axis, localSize);
+  for (int n = 0; n < static_cast<int>(spacings_[axis].size()); n++) {
+    // Global index of the local cell i = n - ghostOffset_
+    const int      index = n - ghostOffset_ - 2 + firstCorner;
+    const RealType pos0  = coordinate(index);
+    const RealType pos1  = coordinate(index + 1);
+    spacings_[axis][n]    = pos1 - pos0;
+    coordinates_[axis][n] = pos0;
+  }
+}
@@ -1,87 +1,89 @@
 #pragma once
 
+#include "Assertion.hpp"
 #include "Definitions.hpp"
 
 // Forward declaration of Parameters
 class Parameters;
 
-enum MeshsizeType { Uniform = 0, TanhStretching = 1 };
+enum MeshsizeType { Uniform = 0, TanhStretching = 1, CoordinateFile = 2 };
 
+/**
+ * Mesh geometry of the local subdomain. The coordinates and meshsizes only depend on the 1D index along each axis, so
+ * they are tabulated once by the derived classes at startup. Every query is a single table lookup, independent of the
+ * mesh type. The tables cover the local indices -2 to (local number of cells + 3), i.e., the subdomain of this
+ * process with its ghost layers and two more cells on each side.
+ */
 class Meshsize {
+protected:
+  // Local index i is stored at position i + ghostOffset_
+  static constexpr int ghostOffset_ = 2;
+
+  std::vector<RealType> spacings_[3];    //! Meshsize of each 1D-cell
+  std::vector<RealType> coordinates_[3]; //! Coordinate of the lower/left/front corner of each 1D-cell
+  RealType              minSpacing_[3] = {0.0, 0.0, 0.0};
+
+  // Allocates the tables of an axis with "localSize" cells in this process
+  void allocateAxis(int axis, int localSize);
+
+  // Fills an axis with an equidistant mesh. "firstCorner" is the global index of the first non-ghost cell of this
+  // process.
+  void setUniformAxis(int axis, int localSize, int firstCorner, RealType meshsize);
+
+  inline int tableIndex([[maybe_unused]] int axis, int i) const {
+    ASSERTION(i + ghostOffset_ >= 0 && i + ghostOffset_ < static_cast<int>(spacings_[axis].size()));
+    return i + ghostOffset_;
+  }
+
 public:
   Meshsize()          = default;
   virtual ~Meshsize() = default;
 
   // Returns the meshsize of cell i, j or i, j, k, respectively.
-  virtual RealType getDx(int i, int j) const = 0;
-  virtual RealType getDy(int i, int j) const = 0;
+  inline RealType getDx(int i, [[maybe_unused]] int j) const { return spacings_[0][tableIndex(0, i)]; }
+  inline RealType getDy([[maybe_unused]] int i, int j) const { return spacings_[1][tableIndex(1, j)]; }
 
-  virtual RealType getDx(int i, int j, int k) const = 0;
-  virtual RealType getDy(int i, int j, int k) const = 0;
-  virtual RealType getDz(int i, int j, int k) const = 0;
+  inline RealType getDx(int i, [[maybe_unused]] int j, [[maybe_unused]] int k) const {
+    return spacings_[0][tableIndex(0, i)];
+  }
+  inline RealType getDy([[maybe_unused]] int i, int j, [[maybe_unused]] int k) const {
+    return spacings_[1][tableIndex(1, j)];
+  }
+  inline RealType getDz([[maybe_unused]] int i, [[maybe_unused]] int j, int k) const {
+    return spacings_[2][tableIndex(2, k)];
+  }
 
   // Returns the global geometric position in x-, y-, z-direction
   // of the lower/left/front corner of the local cell at (i, j, k).
-  virtual RealType getPosX(int i, int j, int k) const = 0;
-  virtual RealType getPosY(int i, int j, int k) const = 0;
-  virtual RealType getPosZ(int i, int j, int k) const = 0;
+  inline RealType getPosX(int i, [[maybe_unused]] int j, [[maybe_unused]] int k) const {
+    return coordinates_[0][tableIndex(0, i)];
+  }
+  inline RealType getPosY([[maybe_unused]] int i, int j, [[maybe_unused]] int k) const {
+    return coordinates_[1][tableIndex(1, j)];
+  }
+  inline RealType getPosZ([[maybe_unused]] int i, [[maybe_unused]] int j, int k) const {
+    return coordinates_[2][tableIndex(2, k)];
+  }
+
+  inline RealType getPosX(int i, [[maybe_unused]] int j) const { return coordinates_[0][tableIndex(0, i)]; }
+  inline RealType getPosY([[maybe_unused]] int i, int j) const { return coordinates_[1][tableIndex(1, j)]; }
 
-  virtual RealType getPosX(int i, int j) const = 0;
-  virtual RealType getPosY(int i, int j) const = 0;
+  // Raw access to the tables of an axis (0, 1, 2 for x, y, z), indexed by the local cell index.
+  inline const RealType* getSpacings(int axis) const { return spacings_[axis].data() + ghostOffset_; }
+  inline const RealType* getCoordinates(int axis) const { return coordinates_[axis].data() + ghostOffset_; }
 
   // Returns the min. meshsize used in this simulation
   // -> required for adaptive time stepping.
-  virtual RealType getDxMin() const = 0;
-  virtual RealType getDyMin() const = 0;
-  virtual RealType getDzMin() const = 0;
+  inline RealType getDxMin() const { return minSpacing_[0]; }
+  inline RealType getDyMin() const { return minSpacing_[1]; }
+  inline RealType getDzMin() const { return minSpacing_[2]; }
 };
 
 /** Implements a uniform, equidistant grid spacing */
 class UniformMeshsize: public Meshsize {
-private:
-  const RealType dx_;
-  const RealType dy_;
-  const RealType dz_;
-  const int      firstCornerX_;
-  const int      firstCornerY_;
-  const int      firstCornerZ_;
-
 public:
   UniformMeshsize(const Parameters& parameters);
-  virtual ~UniformMeshsize() override = default;
-
-  inline virtual RealType getDx([[maybe_unused]] int i, [[maybe_unused]] int j) const override { return dx_; }
-  inline virtual RealType getDy([[maybe_unused]] int i, [[maybe_unused]] int j) const override { return dy_; }
-
-  inline virtual RealType getDx([[maybe_unused]] int i, [[maybe_unused]] int j, [[maybe_unused]] int k) const override {
-    return dx_;
-  }
-  inline virtual RealType getDy([[maybe_unused]] int i, [[maybe_unused]] int j, [[maybe_unused]] int k) const override {
-    return dy_;
-  }
-  inline virtual RealType getDz([[maybe_unused]] int i, [[maybe_unused]] int j, [[maybe_unused]] int k) const override {
-    return dz_;
-  }
-
-  inline virtual RealType getPosX([[maybe_unused]] int i, [[maybe_unused]] int j, [[maybe_unused]] int k)
-    const override {
-    return dx_ * (firstCornerX_ - 2 + i);
-  }
-  inline virtual RealType getPosY([[maybe_unused]] int i, [[maybe_unused]] int j, [[maybe_unused]] int k)
-    const override {
-    return dy_ * (firstCornerY_ - 2 + j);
-  }
-  inline virtual RealType getPosZ([[maybe_unused]] int i, [[maybe_unused]] int j, [[maybe_unused]] int k)
-    const override {
-    return dz_ * (firstCornerZ_ - 2 + k);
-  }
-
-  inline virtual RealType getPosX(int i, int j) const override { return getPosX(i, j, 0); }
-  inline virtual RealType getPosY(int i, int j) const override { return getPosY(i, j, 0); }
-
-  inline virtual RealType getDxMin() const override { return dx_; }
-  inline virtual RealType getDyMin() const override { return dy_; }
-  inline virtual RealType getDzMin() const override { return dz_; }
+  ~UniformMeshsize() override = default;
 };
 
 /**
@@ -89,126 +91,39 @@ public:
  * towards the outer boundaries, i.e. if stretchX is true (in constructor), then the mesh will be finer close to the
  * left and right boundary. The stretching is based on a formular involving tanh-functions, as e.g. used in the
  * dissertation by Tobias Neckel, Chair of Scientific Computing in Computer Science (TUM SCCS). For non-stretched
- * meshes, the UniformMeshsize implementation is used to create a uniform mesh.
+ * axes, a uniform mesh is used.
  */
 class TanhMeshStretching: public Meshsize {
 private:
-  const UniformMeshsize uniformMeshsize_;
-  const RealType        lengthX_;
-  const RealType        lengthY_;
-  const RealType        lengthZ_;
-  const int             sizeX_;
-  const int             sizeY_;
-  const int             sizeZ_;
-  const int             firstCornerX_;
-  const int             firstCornerY_;
-  const int             firstCornerZ_;
-  const bool            stretchX_;
-  const bool            stretchY_;
-  const bool            stretchZ_;
-  const RealType        deltaS_;
-  const RealType        tanhDeltaS_;
-  const RealType        dxMin_;
-  const RealType        dyMin_;
-  const RealType        dzMin_;
-
-  // Computes the coordinate of the lower/left/front corner of the 1D-cell at index i w.r.t. having "size" cells along
-  // an interval of length "length". We refer to local indexing, so "firstCorner" denotes the first non-ghost cell index
-  // of this process. We use a stretched mesh for all nodes inside the comput. bounding box, and a regular mesh outside
-  // this box, using the meshsize of the next inner cell.
-  inline RealType computeCoordinate(int i, int firstCorner, int size, RealType length, RealType dxMin) const {
-    const int index = i - 2 + firstCorner;
-    if (index < 0) {
-      // Equidistant mesh on lower/left part
-      return dxMin * index;
-    } else if (index > size - 1) {
-      // Equidistant mesh on upper/right part
-      return length + dxMin * (index - size);
-    } else {
-      // Stretched mesh on lower half of channel -> we check if we are in lower 50% and then use stretching for 2.0 * p
-      RealType p = (static_cast<RealType>(index)) / size;
-      if (p < 0.5) {
-        return 0.5 * length * (1.0 + tanh(deltaS_ * (2.0 * p - 1.0)) / tanhDeltaS_);
-      } else {
-        // Stretched mesh on upper half of channel -> we mirror the stretching
-        p = (static_cast<RealType>(size) - index) / size;
-        return length - 0.5 * length * (1.0 + tanh(deltaS_ * (2.0 * p - 1.0)) / tanhDeltaS_);
-      }
-    }
-  }
+  const RealType deltaS_;
+  const RealType tanhDeltaS_;
 
-  // Returns the meshsize based on vertex coordinates that span the respective 1D-cell
-  inline RealType getMeshsize(int i, int firstCorner, int size, RealType length, RealType dxMin) const {
-    const RealType pos0 = computeCoordinate(i, firstCorner, size, length, dxMin);
-    const RealType pos1 = computeCoordinate(i + 1, firstCorner, size, length, dxMin);
-#ifndef NDEBUG
-    if (pos1 - pos0 < 1.0e-12) {
-      throw std::runtime_error("Error TanhMeshStretching::getMeshsize(): dx < 1.0e-12!");
-    }
-#endif
-    return pos1 - pos0;
-  }
+  // Computes the coordinate of the lower/left/front corner of the 1D-cell with global index "index" w.r.t. having
+  // "size" cells along an interval of length "length". We use a stretched mesh for all nodes inside the comput.
+  // bounding box, and a regular mesh outside this box, using the meshsize of the next inner cell.
+  RealType computeCoordinate(int index, int size, RealType length, RealType dxMin) const;
+
+  // Fills the local part of an axis with the stretched mesh of "size" global cells
+  void setStretchedAxis(int axis, int size, int localSize, int firstCorner, RealType length, RealType dxMin);
 
 public:
   TanhMeshStretching(const Parameters& parameters, bool stretchX, bool stretchY, bool stretchZ);
-  virtual ~TanhMeshStretching() = default;
-
-  inline virtual RealType getDx(int i, int j) const override {
-    if (stretchX_) {
-      return getMeshsize(i, firstCornerX_, sizeX_, lengthX_, dxMin_);
-    } else {
-      return uniformMeshsize_.getDx(i, j);
-    }
-  }
-
-  inline virtual RealType getDy(int i, int j) const override {
-    if (stretchY_) {
-      return getMeshsize(j, firstCornerY_, sizeY_, lengthY_, dyMin_);
-    } else {
-      return uniformMeshsize_.getDy(i, j);
-    }
-  }
-
-  inline virtual RealType getDx(int i, int j, [[maybe_unused]] int k) const override { return getDx(i, j); }
-
-  inline virtual RealType getDy(int i, int j, [[maybe_unused]] int k) const override { return getDy(i, j); }
-
-  inline virtual RealType getDz(int i, int j, int k) const override {
-    if (stretchZ_) {
-      return getMeshsize(k, firstCornerZ_, sizeZ_, lengthZ_, dzMin_);
-    } else {
-      return uniformMeshsize_.getDz(i, j, k);
-    }
-  }
-
-  inline virtual RealType getPosX(int i, int j, int k) const override {
-    if (stretchX_) {
-      return computeCoordinate(i, firstCornerX_, sizeX_, lengthX_, dxMin_);
-    } else {
-      return uniformMeshsize_.getPosX(i, j, k);
-    }
-  }
-
-  inline virtual RealType getPosY(int i, int j, int k) const override {
-    if (stretchY_) {
-      return computeCoordinate(j, firstCornerY_, sizeY_, lengthY_, dyMin_);
-    } else {
-      return uniformMeshsize_.getPosY(i, j, k);
-    }
-  }
-
-  inline virtual RealType getPosZ(int i, int j, int k) const override {
-    if (stretchZ_) {
-      return computeCoordinate(k, firstCornerZ_, sizeZ_, lengthZ_, dzMin_);
-    } else {
-      return uniformMeshsize_.getPosZ(i, j, k);
-    }
-  }
+  ~TanhMeshStretching() override = default;
+};
 
-  inline virtual RealType getPosX(int i, int j) const override { return getPosX(i, j, 0); }
-  inline virtual RealType getPosY(int i, int j) const override { return getPosY(i, j, 0); }
+/**
+ * Implements a mesh with user-supplied node coordinates. The file contains, for each axis that is not uniform, the
+ * axis name (x, y or z) followed by the size + 1 node coordinates from 0 to the length of the domain along this
+ * axis. Lines starting with '#' are comments. Axes that are not listed in the file use a uniform mesh. Every process
+ * reads the file and only keeps the nodes of its subdomain. Outside the domain, the meshsize of the next inner cell is
+ * continued.
+ */
+class FileMeshsize: public Meshsize {
+private:
+  // Fills the local part of an axis from the global node coordinates
+  void setTabulatedAxis(int axis, int localSize, int firstCorner, const std::vector<RealType>& nodes);
 
-  inline virtual RealType getDxMin() const override { return dxMin_; }
-  inline virtual RealType getDyMin() const override { return dyMin_; }
-  inline virtual RealType getDzMin() const override { return dzMin_; }
+public:
+  FileMeshsize(const Parameters& parameters);
+  ~FileMeshsize() override = default;
 };
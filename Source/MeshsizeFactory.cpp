@@ -23,6 +23,10 @@ void MeshsizeFactory::initMeshsize(Parameters& parameters) {
       static_cast<bool>(parameters.geometry.stretchZ)
     );
     break;
+  // Node coordinates from file
+  case CoordinateFile:
+    parameters.meshsize = new FileMeshsize(parameters);
+    break;
   default:
     throw std::runtime_error("Unknown meshsize type!");
     break;
@@ -55,10 +55,6 @@ void ParallelManagers::PetscParallelConfiguration::locateNeighbors() {
     parameters_.parallel.frontNb  = computeRankFromIndices(i, j, k - 1);
     parameters_.parallel.backNb   = computeRankFromIndices(i, j, k + 1);
   }
-
-  // If periodic boundaries declared, let the process itself deal with it, without communication.
-  int rank;
-  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
 }
 
 void ParallelManagers::PetscParallelConfiguration::createIndices() {
@@ -71,6 +67,22 @@ void ParallelManagers::PetscParallelConfiguration::createIndices() {
 }
 
 int ParallelManagers::PetscParallelConfiguration::computeRankFromIndices(int i, int j, int k) const {
+  // The periodic scenarios wrap around split axes, the halo exchange then fills the periodic ghost layers. An axis
+  // with a single process keeps MPI_PROC_NULL and is left to the periodic boundary stencils.
+  const std::string& scenario = parameters_.simulation.scenario;
+  if (scenario == "periodic-box" || scenario == "taylor-green") {
+    const int* numProcessors = parameters_.parallel.numProcessors;
+    if (numProcessors[0] > 1) {
+      i = (i + numProcessors[0]) % numProcessors[0];
+    }
+    if (numProcessors[1] > 1) {
+      j = (j + numProcessors[1]) % numProcessors[1];
+    }
+    if (parameters_.geometry.dim == 3 && numProcessors[2] > 1) {
+      k = (k + numProcessors[2]) % numProcessors[2];
+    }
+  }
+
   if (i < 0 || i >= parameters_.parallel.numProcessors[0] ||
         j < 0 || j >= parameters_.parallel.numProcessors[1] ||
         k < 0 || k >= parameters_.parallel.numProcessors[2]) {
@@ -24,7 +24,7 @@ namespace ParallelManagers {
      * @param j Intex in the Y directon
      * @param k Intex in the Z directon
      * @return Rank of the process with that index, assuming that they are ordered
-     * lexicographically, or MPI_PROC_NULL if outside the domain.
+     * lexicographically, or MPI_PROC_NULL if outside the domain. Split axes of the periodic scenarios wrap around.
      */
     int computeRankFromIndices(int i, int j, int k) const;
 
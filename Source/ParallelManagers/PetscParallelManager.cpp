@@ -0,0 +1,75 @@
+#include "StdAfx.hpp"
+
+#include "PetscParallelManager.hpp"
+
+ParallelManagers::PetscParallelManager::PetscParallelManager(const Parameters& parameters, FlowField& flowField):
+  parameters_(parameters),
+  flowField_(flowField),
+  fillStencil_(parameters),
+  readStencil_(parameters),
+  fillIterator_(flowField, parameters, fillStencil_),
+  readIterator_(flowField, parameters, readStencil_) {}
+
+void ParallelManagers::PetscParallelManager::communicatePressure() { communicate(Stencils::HaloPressure); }
+
+void ParallelManagers::PetscParallelManager::communicateVelocity() { communicate(Stencils::HaloVelocity); }
+
+void ParallelManagers::PetscParallelManager::communicateFGH() { communicate(Stencils::HaloFGH); }
+
+void ParallelManagers::PetscParallelManager::communicateVector(VectorField& vector) {
+  communicate(Stencils::HaloVector, &vector);
+}
+
+void ParallelManagers::PetscParallelManager::communicate(Stencils::HaloQuantity quantity, VectorField* vector) {
+  const int dim           = parameters_.geometry.dim;
+  const int neighbours[6] = {
+    parameters_.parallel.leftNb,
+    parameters_.parallel.rightNb,
+    parameters_.parallel.bottomNb,
+    parameters_.parallel.topNb,
+    parameters_.parallel.frontNb,
+    parameters_.parallel.backNb};
+  const int cells[3]      = {flowField_.getCellsX(), flowField_.getCellsY(), flowField_.getCellsZ()};
+  const int components    = quantity == Stencils::HaloPressure ? 1 : dim;
+
+  for (int axis = 0; axis < dim; axis++) {
+    const int lower = 2 * axis;
+    const int upper = 2 * axis + 1;
+    if (neighbours[lower] < 0 && neighbours[upper] < 0) {
+      continue;
+    }
+
+    // Values in one layer of the face, the ghost cells of the other axes included
+    int layer = components;
+    for (int d = 0; d < dim; d++) {
+      if (d != axis) {
+        layer *= cells[d];
+      }
+    }
+
+    fillStencil_.setUp(quantity, axis, vector);
+    readStencil_.setUp(quantity, axis, vector);
+    fillIterator_.iterate();
+
+    // The tag is the direction of the message, so that both neighbours may be the same process
+    MPI_Request requests[4];
+    int         count = 0;
+    if (neighbours[lower] >= 0) {
+      std::vector<RealType>&       receive = readStencil_.getBuffer(lower);
+      const std::vector<RealType>& send    = fillStencil_.getBuffer(lower);
+      receive.resize(2 * layer);
+      MPI_Irecv(receive.data(), 2 * layer, MY_MPI_FLOAT, neighbours[lower], upper, PETSC_COMM_WORLD, &requests[count++]);
+      MPI_Isend(send.data(), static_cast<int>(send.size()), MY_MPI_FLOAT, neighbours[lower], lower, PETSC_COMM_WORLD, &requests[count++]);
+    }
+    if (neighbours[upper] >= 0) {
+      std::vector<RealType>&       receive = readStencil_.getBuffer(upper);
+      const std::vector<RealType>& send    = fillStencil_.getBuffer(upper);
+      receive.resize(layer);
+      MPI_Irecv(receive.data(), layer, MY_MPI_FLOAT, neighbours[upper], lower, PETSC_COMM_WORLD, &requests[count++]);
+      MPI_Isend(send.data(), static_cast<int>(send.size()), MY_MPI_FLOAT, neighbours[upper], upper, PETSC_COMM_WORLD, &requests[count++]);
+    }
+    MPI_Waitall(count, requests, MPI_STATUSES_IGNORE);
+
+    readIterator_.iterate();
+  }
+}
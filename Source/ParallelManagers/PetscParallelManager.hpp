@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "FlowField.hpp"
+#include "Iterators.hpp"
+#include "Parameters.hpp"
+
+#include "Stencils/BufferStencils.hpp"
+
+namespace ParallelManagers {
+
+  /** Exchanges the ghost layers of the flow field with the neighbouring subdomains
+   *
+   * The faces are packed by the buffer stencils and sent with non-blocking point-to-point messages to the neighbours
+   * located by PetscParallelConfiguration. The axes are exchanged one after the other, and each face carries the ghost
+   * cells of the axes before it, so that the edges and corners are filled as well. Periodic axes that are split
+   * between processes are exchanged like the others. Faces without a neighbour, i.e., global boundaries and periodic
+   * axes with a single process, are left to the boundary iterators.
+   */
+  class PetscParallelManager {
+  private:
+    const Parameters& parameters_;
+    FlowField&        flowField_;
+
+    Stencils::BufferFillStencil         fillStencil_;
+    Stencils::BufferReadStencil         readStencil_;
+    ParallelBoundaryIterator<FlowField> fillIterator_;
+    ParallelBoundaryIterator<FlowField> readIterator_;
+
+    void communicate(Stencils::HaloQuantity quantity, VectorField* vector = nullptr);
+
+  public:
+    PetscParallelManager(const Parameters& parameters, FlowField& flowField);
+    ~PetscParallelManager() = default;
+
+    /** Fills the pressure in the ghost layers, to be called after the pressure solve */
+    void communicatePressure();
+
+    /** Fills the velocity in the ghost layers, to be called after the velocity update */
+    void communicateVelocity();
+
+    /** Fills F, G and H in the ghost layers, to be called before the right hand side is computed */
+    void communicateFGH();
+
+    /** Fills the ghost layers of a vector field with the cells of the flow field, e.g. an auxiliary field of a solver */
+    void communicateVector(VectorField& vector);
+  };
+
+} // namespace ParallelManagers
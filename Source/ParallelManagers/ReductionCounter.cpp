@@ -0,0 +1,47 @@
+#include "StdAfx.hpp"
+
+#include "ReductionCounter.hpp"
+
+#ifdef ENABLE_REDUCTION_COUNTER
+static std::atomic<std::uint64_t> blocking{0};
+static std::atomic<std::uint64_t> nonBlocking{0};
+static std::atomic<double>        blockingTime{0.0};
+
+int MPI_Allreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
+  const double start = PMPI_Wtime();
+  const int    error = PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+  blockingTime.fetch_add(PMPI_Wtime() - start, std::memory_order_relaxed);
+  blocking.fetch_add(1, std::memory_order_relaxed);
+  return error;
+}
+
+int MPI_Iallreduce(const void* sendbuf, void* recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm, MPI_Request* request) {
+  nonBlocking.fetch_add(1, std::memory_order_relaxed);
+  return PMPI_Iallreduce(sendbuf, recvbuf, count, datatype, op, comm, request);
+}
+#endif
+
+ParallelManagers::ReductionCounter::Counts ParallelManagers::ReductionCounter::Counts::operator-(const Counts& other) const {
+  Counts difference;
+  difference.blocking     = blocking - other.blocking;
+  difference.nonBlocking  = nonBlocking - other.nonBlocking;
+  difference.blockingTime = blockingTime - other.blockingTime;
+  return difference;
+}
+
+ParallelManagers::ReductionCounter::Counts& ParallelManagers::ReductionCounter::Counts::operator+=(const Counts& other) {
+  blocking += other.blocking;
+  nonBlocking += other.nonBlocking;
+  blockingTime += other.blockingTime;
+  return *this;
+}
+
+ParallelManagers::ReductionCounter::Counts ParallelManagers::ReductionCounter::getCounts() {
+  Counts counts;
+#ifdef ENABLE_REDUCTION_COUNTER
+  counts.blocking     = blocking.load(std::memory_order_relaxed);
+  counts.nonBlocking  = nonBlocking.load(std::memory_order_relaxed);
+  counts.blockingTime = blockingTime.load(std::memory_order_relaxed);
+#endif
+  return counts;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace ParallelManagers {
+
+  /** Counts the global reductions of this process through the profiling interface of MPI
+   *
+   * Only with ENABLE_REDUCTION_COUNTER, as it replaces MPI_Allreduce and MPI_Iallreduce for the whole program: they are
+   * defined in ReductionCounter.cpp and forward to PMPI_Allreduce and PMPI_Iallreduce. Calls from libraries such as
+   * PETSc are included as long as they are resolved against these definitions, which is the case for shared libraries
+   * on ELF platforms. The time of the blocking reductions is the latency that the pipelined Krylov methods hide; the
+   * non-blocking reductions complete in the background. The counts are atomic, so that reductions from several threads
+   * are all counted. Without the option, all counts stay zero.
+   */
+  class ReductionCounter {
+  public:
+    struct Counts {
+      std::uint64_t blocking     = 0;
+      std::uint64_t nonBlocking  = 0;
+      double        blockingTime = 0.0; //! Seconds spent in blocking reductions
+
+      Counts operator-(const Counts& other) const;
+      Counts& operator+=(const Counts& other);
+    };
+
+    /** If the reductions are counted, see ENABLE_REDUCTION_COUNTER */
+    static constexpr bool isEnabled() {
+#ifdef ENABLE_REDUCTION_COUNTER
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    /** Returns the reductions since the start of the program */
+    static Counts getCounts();
+  };
+
+} // namespace ParallelManagers
@@ -4,12 +4,39 @@
 #include "Definitions.hpp"
 #include "Meshsize.hpp"
 
+//! Explicit time integration schemes for the momentum predictor
+enum TimeIntegrationScheme { ForwardEuler = 0, AdamsBashforth2 = 1, RungeKutta3 = 2 };
+
+//! Linear solvers for the pressure equation
+enum PressureSolverType {
+  AutomaticPressureSolver = -1,
+  SORPressureSolver       = 0,
+  MultigridPressureSolver = 1,
+  PetscPressureSolver     = 2,
+  SpectralPressureSolver  = 3,
+  CGPressureSolver        = 4,
+  LinePressureSolver      = 5
+};
+
+//! Cycle types and smoothers of the multigrid solver
+enum MultigridCycle { VCycle = 0, WCycle = 1, FCycle = 2 };
+enum MultigridSmoother { RedBlackGaussSeidel = 0, WeightedJacobi = 1, LineGaussSeidel = 2 };
+
+//! Preconditioners of the conjugate gradient solver
+enum CGPreconditioner { JacobiPreconditioner = 0, SSORPreconditioner = 1, IncompleteCholesky = 2 };
+
 //! Classes for the parts of the parameters
 //@{
 class TimestepParameters {
 public:
-  RealType dt  = 0; //! Timestep
-  RealType tau = 0; //! Security factor
+  RealType dt               = 0;            //! Timestep
+  RealType tau              = 0;            //! Security factor
+  int      scheme           = ForwardEuler; //! Time integration scheme, see TimeIntegrationScheme
+  int      imex             = 0;            //! Crank-Nicolson for the viscous terms, explicit convection
+  int      singleProjection = 0;            //! RK3 solves for the pressure in its final stage only
+
+  RealType imexTolerance  = 1e-6; //! Relative residual of the implicit viscous solve
+  int      imexIterations = 500;  //! Maximum number of iterations of the implicit viscous solve
 };
 
 class SimulationParameters {
@@ -34,8 +61,35 @@ public:
 
 class SolverParameters {
 public:
-  RealType gamma         = 0;  //! Donor cell balance coefficient
-  int      maxIterations = -1; //! Maximum number of iterations in the linear solver
+  RealType gamma         = 0;    //! Donor cell balance coefficient
+  int      maxIterations = -1;   //! Maximum number of iterations in the linear solver
+  int      type          = -1;   //! Pressure solver, see PressureSolverType
+  RealType tolerance     = 1e-4; //! Tolerance of the root mean square residual of the pressure equation
+  RealType divergence    = 0;    //! Target root mean square divergence after the projection, adapts the tolerance if positive
+  int      extrapolation = 0;    //! Order of the extrapolation of the initial guess from previous solutions, up to 2
+  int      incremental   = 0;    //! Solve for the change of the pressure in every step, see Simulation::solveStage
+
+  // SOR settings
+  RealType omega            = 0; //! Over-relaxation factor, estimated from the convergence rate if 0, also of the line solver
+  int      chebyshev        = 0; //! Chebyshev acceleration of the over-relaxation factor
+  int      residualInterval = 1; //! Number of iterations between two convergence checks
+
+  // Multigrid settings
+  int cycle         = VCycle;              //! See MultigridCycle
+  int smoother      = RedBlackGaussSeidel; //! See MultigridSmoother
+  int preSmoothing  = 2;                   //! Smoothing steps before the coarse grid correction
+  int postSmoothing = 2;                   //! Smoothing steps after the coarse grid correction
+
+  // Conjugate gradient settings
+  int preconditioner = IncompleteCholesky; //! See CGPreconditioner
+  int mixedPrecision = 0;                  //! Inner iterations in single precision within an iterative refinement
+
+  // PETSc settings
+  int         matrixFree = 0; //! Apply the pressure operator as a stencil instead of assembling a matrix
+  int         pipelined  = 0; //! Pipelined Krylov methods that overlap the global reductions with the operator
+  int         multigrid  = 0; //! Geometric multigrid on a cell-centred hierarchy as preconditioner instead of ILU or ASM
+  int         autotune   = 0; //! Time several Krylov methods and preconditioners in the first solve, keep the fastest
+  std::string autotuneCache;  //! File with the fastest choice per configuration, not cached if empty
 };
 
 class GeometricParameters {
@@ -60,6 +114,9 @@ public:
   int stretchX = -1;
   int stretchY = -1;
   int stretchZ = -1;
+
+  // Node coordinates for the mesh read from file
+  std::string meshFile;
 };
 
 class WallParameters {
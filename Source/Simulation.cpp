@@ -2,8 +2,71 @@
 
 #include "Simulation.hpp"
 
+#include "Clock.hpp"
+
+#include "Solvers/CGSolver.hpp"
+#include "Solvers/MultigridSolver.hpp"
 #include "Solvers/PetscSolver.hpp"
 #include "Solvers/SORSolver.hpp"
+#include "Solvers/SpectralSolver.hpp"
+
+static std::unique_ptr<Solvers::LinearSolver> createPressureSolver(FlowField& flowField, Parameters& parameters) {
+  // The ghost layers are exchanged between the processes, so the subdomains are coupled. Only the PETSc solver and the
+  // spectral solver on slabs solve the pressure equation globally, the others would solve the subdomains separately
+  // with Neumann interfaces.
+  const int processes = parameters.parallel.numProcessors[0] * parameters.parallel.numProcessors[1]
+                        * (parameters.geometry.dim == 3 ? parameters.parallel.numProcessors[2] : 1);
+  if (processes > 1) {
+    if (parameters.solver.type == SpectralPressureSolver
+        || (parameters.solver.type == AutomaticPressureSolver && Solvers::SpectralSolver::isApplicable(parameters))) {
+      spdlog::info("Using the spectral pressure solver{}", parameters.solver.type == AutomaticPressureSolver ? ", chosen automatically" : "");
+      return std::make_unique<Solvers::SpectralSolver>(flowField, parameters);
+    }
+#ifdef ENABLE_PETSC
+    if (parameters.solver.type == PetscPressureSolver || parameters.solver.type == AutomaticPressureSolver) {
+      spdlog::info("Using the PETSc pressure solver{}", parameters.solver.type == AutomaticPressureSolver ? ", chosen automatically" : "");
+      return std::make_unique<Solvers::PetscSolver>(flowField, parameters);
+    }
+#endif
+    throw std::runtime_error("Parallel runs require the PETSc pressure solver, or the spectral one on a domain split along the outermost axis");
+  }
+
+  switch (parameters.solver.type) {
+  case SORPressureSolver:
+    spdlog::info("Using the SOR pressure solver");
+    return std::make_unique<Solvers::SORSolver>(flowField, parameters);
+  case MultigridPressureSolver:
+  case LinePressureSolver:
+    spdlog::info("Using the {} pressure solver", parameters.solver.type == LinePressureSolver ? "line" : "multigrid");
+    return std::make_unique<Solvers::MultigridSolver>(flowField, parameters);
+  case SpectralPressureSolver:
+    spdlog::info("Using the spectral pressure solver");
+    return std::make_unique<Solvers::SpectralSolver>(flowField, parameters);
+  case CGPressureSolver:
+    spdlog::info("Using the CG pressure solver");
+    return std::make_unique<Solvers::CGSolver>(flowField, parameters);
+  case AutomaticPressureSolver:
+    if (Solvers::SpectralSolver::isApplicable(parameters)) {
+      spdlog::info("Using the spectral pressure solver, chosen automatically");
+      return std::make_unique<Solvers::SpectralSolver>(flowField, parameters);
+    }
+#ifdef ENABLE_PETSC
+    spdlog::info("Using the PETSc pressure solver{}, chosen automatically", parameters.solver.mixedPrecision ? " with mixed precision" : "");
+    return std::make_unique<Solvers::PetscSolver>(flowField, parameters);
+#else
+    // Without PETSc, the default is no longer the SOR solver
+    spdlog::info("Using the CG pressure solver, chosen automatically as PETSc is not available");
+    return std::make_unique<Solvers::CGSolver>(flowField, parameters);
+#endif
+  default:
+#ifdef ENABLE_PETSC
+    spdlog::info("Using the PETSc pressure solver");
+    return std::make_unique<Solvers::PetscSolver>(flowField, parameters);
+#else
+    throw std::runtime_error("Solver type 'petsc' requires a build with PETSc!");
+#endif
+  }
+}
 
 Simulation::Simulation(Parameters& parameters, FlowField& flowField):
   parameters_(parameters),
@@ -21,15 +84,22 @@ Simulation::Simulation(Parameters& parameters, FlowField& flowField):
   velocityStencil_(parameters),
   obstacleStencil_(parameters),
   velocityIterator_(flowField_, parameters, velocityStencil_),
-  obstacleIterator_(flowField_, parameters, obstacleStencil_)
-#ifdef ENABLE_PETSC
-  ,
-  solver_(std::make_unique<Solvers::PetscSolver>(flowField_, parameters))
-#else
-  ,
-  solver_(std::make_unique<Solvers::SORSolver>(flowField_, parameters))
-#endif
-{
+  obstacleIterator_(flowField_, parameters, obstacleStencil_),
+  parallelManager_(parameters, flowField_),
+  divergenceStencil_(parameters),
+  divergenceIterator_(flowField_, parameters, divergenceStencil_, 1, 0),
+  toleranceScaling_(1.0),
+  minToleranceScaling_(1e-2),
+  previousScaling_(1.0),
+  previousDivergence_(0.0),
+  solver_(createPressureSolver(flowField_, parameters)),
+  viscousSolver_(parameters.timestep.imex ? std::make_unique<Solvers::ViscousSolver>(flowField_, parameters, parallelManager_) : nullptr),
+  previousDt_(0.0),
+  pressureSolves_(0),
+  pressureIterations_(0),
+  pressureTime_(0),
+  singleIterations_(0),
+  singleTime_(0) {
 }
 
 void Simulation::initializeFlowField() {
@@ -38,6 +108,9 @@ void Simulation::initializeFlowField() {
     Stencils::InitTaylorGreenFlowFieldStencil stencil(parameters_);
     FieldIterator<FlowField>                  iterator(flowField_, parameters_, stencil);
     iterator.iterate();
+    // The periodic ghost layers, which the first predictor reads. Otherwise the faces on opposite boundaries, which
+    // are stored twice, start from different predictors and never agree again.
+    wallVelocityIterator_.iterate();
   } else if (parameters_.simulation.scenario == "channel") {
     Stencils::BFStepInitStencil stencil(parameters_);
     FieldIterator<FlowField>    iterator(flowField_, parameters_, stencil, 0, 1);
@@ -63,33 +136,246 @@ void Simulation::initializeFlowField() {
       }
     }
 
+    // The pressure has to satisfy the boundary condition from the start: the increments of the incremental projection
+    // vanish on the left wall, and with IMEX, the first predictor on the wall is shifted by the gradient of the current
+    // pressure in both projections. The inner cells are zero, the ghost layer mirrors them about the value.
+    if (parameters_.parallel.leftNb == MPI_PROC_NULL) {
+      ScalarField& pressure = flowField_.getPressure();
+      for (int k = 0; k < pressure.getNz(); k++) {
+        for (int j = 0; j < pressure.getNy(); j++) {
+          pressure.getScalar(1, j, k) = 2.0 * value;
+        }
+      }
+    }
+
     // Do same procedure for domain flagging as for regular channel
     Stencils::BFStepInitStencil stencil(parameters_);
     FieldIterator<FlowField>    iterator(flowField_, parameters_, stencil, 0, 1);
     iterator.iterate();
   }
 
+  // The initialisation stencils only cover the cells of this process
+  parallelManager_.communicateVelocity();
   solver_->reInitMatrix();
 }
 
 void Simulation::solveTimestep() {
   // Determine and set max. timestep which is allowed in this simulation
   setTimeStep();
+  const RealType dt = parameters_.timestep.dt;
+
+  if (parameters_.timestep.scheme == RungeKutta3 && parameters_.timestep.imex) {
+    // The RK3/Crank-Nicolson scheme of Spalart, Moser and Rogers: u_k+1 = u_k + dt (gamma_k N_k + zeta_k N_k-1)
+    // + dt_k L (u_k + u_k+1) / 2 with the stage timestep dt_k = (gamma_k + zeta_k) dt, which matches the theta = 1/2
+    // of the ViscousSolver. Q keeps the convective tendency of the previous stage, every stage is projected with dt_k.
+    static constexpr RealType gamma[3] = {8.0 / 15.0, 5.0 / 12.0, 3.0 / 4.0};
+    static constexpr RealType zeta[3]  = {0.0, -17.0 / 60.0, -5.0 / 12.0};
+
+    for (int stage = 0; stage < 3; stage++) {
+      const RealType stageDt = (gamma[stage] + zeta[stage]) * dt;
+      fghStencil_.setStageCoefficients({gamma[stage] * dt, zeta[stage] * dt, 0.0, 1.0, 0.0, stageDt});
+      parameters_.timestep.dt = stageDt;
+      solveStage(stageDt);
+    }
+    parameters_.timestep.dt = dt;
+  } else if (parameters_.timestep.scheme == RungeKutta3) {
+    // Williamson's low-storage RK3: Q = a Q + dt R, u = u + b Q. Every stage is projected, using b dt as
+    // timestep for the pressure equation and velocity update. The pressure correction u - F of a stage is
+    // folded into Q by the next FGH sweep, so that every stage solves for a pressure of the same magnitude.
+    // With a single projection (Le and Moin, 1991), the first two stages are not projected and take the gradient of
+    // the previous pressure, which the fold turns into a tendency like any other. The final stage solves for the
+    // pressure that makes the velocity divergence-free, so a step costs one pressure solve instead of three. As the
+    // final stage carries a weight of 8/15 of the pressure, an error of the previous pressure is damped by 7/8 per step.
+    static constexpr RealType a[3] = {0.0, -5.0 / 9.0, -153.0 / 128.0};
+    static constexpr RealType b[3] = {1.0 / 3.0, 15.0 / 16.0, 8.0 / 15.0};
+    // The stages end at t + dt / 3, t + 3 dt / 4 and t + dt
+    static constexpr RealType increments[3] = {1.0 / 3.0, 5.0 / 12.0, 1.0 / 4.0};
+
+    for (int stage = 0; stage < 3; stage++) {
+      const RealType projectionWeight = stage == 0 ? 0.0 : 1.0 / b[stage - 1];
+      fghStencil_.setStageCoefficients({b[stage] * dt, b[stage] * a[stage], a[stage], dt, projectionWeight});
+      parameters_.timestep.dt = b[stage] * dt;
+      if (parameters_.timestep.singleProjection) {
+        solveStage(dt, stage == 2);
+      } else {
+        solveStage(increments[stage] * dt);
+      }
+    }
+    // The time loop advances by the full step
+    parameters_.timestep.dt = dt;
+  } else {
+    if (parameters_.timestep.scheme == AdamsBashforth2) {
+      // Q keeps the tendency of the previous step. The weights account for a varying timestep, the very
+      // first step falls back to forward Euler. In IMEX mode, this is AB2/Crank-Nicolson.
+      if (previousDt_ > 0.0) {
+        const RealType ratio = dt / (2.0 * previousDt_);
+        fghStencil_.setStageCoefficients({dt * (1.0 + ratio), -dt * ratio, 0.0, 1.0, 0.0, dt});
+      } else {
+        fghStencil_.setStageCoefficients({dt, 0.0, 0.0, 1.0, 0.0, dt});
+      }
+      previousDt_ = dt;
+    }
+    solveStage(dt);
+  }
+}
+
+int Simulation::getPressureSolves() {
+  const int solves = pressureSolves_;
+  pressureSolves_  = 0;
+  return solves;
+}
+
+int Simulation::getPressureIterations() {
+  const int iterations = pressureIterations_;
+  pressureIterations_  = 0;
+  return iterations;
+}
+
+std::uint64_t Simulation::getPressureTime() {
+  const std::uint64_t time = pressureTime_;
+  pressureTime_            = 0;
+  return time;
+}
+
+int Simulation::getSinglePrecisionIterations() {
+  const int iterations = singleIterations_;
+  singleIterations_    = 0;
+  return iterations;
+}
+
+std::uint64_t Simulation::getSinglePrecisionTime() {
+  const std::uint64_t time = singleTime_;
+  singleTime_              = 0;
+  return time;
+}
+
+ParallelManagers::ReductionCounter::Counts Simulation::getPressureReductions() {
+  const ParallelManagers::ReductionCounter::Counts reductions = pressureReductions_;
+  pressureReductions_                                         = ParallelManagers::ReductionCounter::Counts();
+  return reductions;
+}
+
+void Simulation::solveStage(RealType increment, bool project) {
   // Compute FGH
   fghIterator_.iterate();
+  // Treat the viscous terms implicitly
+  if (viscousSolver_) {
+    viscousSolver_->solve();
+  }
+  parallelManager_.communicateFGH();
   // Set global boundary values
   wallFGHIterator_.iterate();
+  if (!project) {
+    // Velocity update with the current pressure, whose ghost layers are still valid
+    velocityIterator_.iterate();
+    obstacleIterator_.iterate();
+    parallelManager_.communicateVelocity();
+    wallVelocityIterator_.iterate();
+    return;
+  }
   // Compute the right hand side (RHS)
   rhsIterator_.iterate();
-  // Solve for pressure
+  // Solve for pressure, starting from an extrapolation of the previous solutions. In incremental mode, the predictor
+  // includes the gradient of the current pressure and the solver works on the change of the pressure, whose right
+  // hand side is much smaller. The initial guess is the change between the current pressure and the extrapolation.
+  const bool incremental = parameters_.solver.incremental != 0;
+  if (incremental) {
+    storePreviousPressure();
+  }
+  // The projection leaves a divergence of dt times the residual of the pressure equation, so target / dt meets the
+  // target divergence. The scaling corrects this from the divergence achieved in the previous stages.
+  const RealType target    = parameters_.solver.divergence;
+  RealType       tolerance = parameters_.solver.tolerance;
+  if (target > 0.0) {
+    tolerance = toleranceScaling_ * target / parameters_.timestep.dt;
+    solver_->setTolerance(tolerance);
+  }
+  solver_->extrapolatePressure(increment);
+  if (incremental) {
+    addPreviousPressure(-1.0);
+  }
+  const Clock                                      clock;
+  const ParallelManagers::ReductionCounter::Counts reductions = ParallelManagers::ReductionCounter::getCounts();
   solver_->solve();
-  // TODO WS2: communicate pressure values
+  pressureTime_ += clock.getTime();
+  pressureSolves_++;
+  pressureReductions_ += ParallelManagers::ReductionCounter::getCounts() - reductions;
+  pressureIterations_ += solver_->getIterations();
+  singleIterations_ += solver_->getSingleIterations();
+  singleTime_ += solver_->getSingleTime();
+  // In incremental mode, the change of the pressure is exchanged, the ghost layers get the previous pressure below
+  parallelManager_.communicatePressure();
   // Compute velocity
   velocityIterator_.iterate();
   obstacleIterator_.iterate();
-  // TODO WS2: communicate velocity values
+  if (incremental) {
+    addPreviousPressure(1.0);
+  }
+  solver_->storePressure();
+  parallelManager_.communicateVelocity();
   // Iterate for velocities on the boundary
   wallVelocityIterator_.iterate();
+
+  if (target > 0.0) {
+    const RealType divergence = computeDivergence();
+    spdlog::info("Pressure tolerance {:.3e}, divergence {:.3e}", tolerance, divergence);
+    updateToleranceScaling(divergence);
+  }
+}
+
+void Simulation::updateToleranceScaling(RealType divergence) {
+  // Where the pressure operator and the divergence of the velocity update differ, e.g., at obstacles or on stretched
+  // meshes, a part of the divergence does not depend on the solve. Once a tightening fails to reduce the divergence by
+  // at least half of its factor (on a logarithmic scale), the divergence has reached this floor. The tightening is
+  // undone and becomes the lower bound, so that an unreachable target does not make every following solve more
+  // expensive. The fixed bound and the factors per stage keep the scaling from running away or oscillating.
+  if (toleranceScaling_ < previousScaling_ && divergence > previousDivergence_ * std::sqrt(toleranceScaling_ / previousScaling_)) {
+    spdlog::info("Divergence {:.3e} does not follow the pressure tolerance, keeping its scaling at {:.3e}", divergence, previousScaling_);
+    minToleranceScaling_ = previousScaling_;
+    toleranceScaling_    = previousScaling_;
+  }
+  previousScaling_    = toleranceScaling_;
+  previousDivergence_ = divergence;
+
+  const RealType factor = std::clamp<RealType>(parameters_.solver.divergence / std::max(divergence, MY_FLOAT_MIN), 0.5, 2.0);
+  toleranceScaling_     = std::clamp<RealType>(toleranceScaling_ * factor, minToleranceScaling_, 1.0);
+}
+
+RealType Simulation::computeDivergence() {
+  divergenceStencil_.reset();
+  divergenceIterator_.iterate();
+
+  RealType local[2] = {divergenceStencil_.getSum(), divergenceStencil_.getCells()};
+  RealType global[2];
+  MPI_Allreduce(local, global, 2, MY_MPI_FLOAT, MPI_SUM, PETSC_COMM_WORLD);
+  return global[1] > 0.0 ? std::sqrt(global[0] / global[1]) : 0.0;
+}
+
+void Simulation::storePreviousPressure() {
+  ScalarField& pressure = flowField_.getPressure();
+  previousPressure_.resize(pressure.getNx() * pressure.getNy() * pressure.getNz());
+
+  int index = 0;
+  for (int k = 0; k < pressure.getNz(); k++) {
+    for (int j = 0; j < pressure.getNy(); j++) {
+      for (int i = 0; i < pressure.getNx(); i++) {
+        previousPressure_[index++] = pressure.getScalar(i, j, k);
+      }
+    }
+  }
+}
+
+void Simulation::addPreviousPressure(RealType weight) {
+  ScalarField& pressure = flowField_.getPressure();
+
+  int index = 0;
+  for (int k = 0; k < pressure.getNz(); k++) {
+    for (int j = 0; j < pressure.getNy(); j++) {
+      for (int i = 0; i < pressure.getNx(); i++) {
+        pressure.getScalar(i, j, k) += weight * previousPressure_[index++];
+      }
+    }
+  }
 }
 
 void Simulation::plotVTK(int timeStep, RealType simulationTime) {
@@ -141,12 +427,52 @@ void Simulation::setTimeStep() {
 
   // localMin = std::min(parameters_.timestep.dt, std::min(std::min(parameters_.flow.Re/(2 * factor), 1.0 /
   // maxUStencil_.getMaxValues()[0]), 1.0 / maxUStencil_.getMaxValues()[1]));
-  localMin = std::min(
-    parameters_.flow.Re / (2 * factor),
-    std::min(
-      parameters_.timestep.dt, std::min(1 / (maxU0), 1 / (maxU1))
-    )
-  );
+  localMin = std::min(parameters_.timestep.dt, std::min(1 / (maxU0), 1 / (maxU1)));
+
+  // The convective limit is scaled such that each scheme keeps the stability margin of forward Euler, whose
+  // limit along the eigenvalues of the blended donor-cell differences is a Courant number of gamma. RK3 reaches
+  // sqrt(3) on the imaginary axis and at least 1.25 times the Euler limit for any gamma. AB2 falls to half the
+  // Euler limit for pure donor-cell differences and exceeds it for gamma below 0.7. Both bounds have been checked
+  // against the stability regions for gamma in [0, 1].
+  RealType convectiveScaling = 1.0;
+  if (parameters_.timestep.scheme == AdamsBashforth2) {
+    convectiveScaling = std::min<RealType>(1.0, 1.5 - parameters_.solver.gamma);
+  } else if (parameters_.timestep.scheme == RungeKutta3) {
+    convectiveScaling = std::min<RealType>(sqrt(3.0), 1.25 / std::max(parameters_.solver.gamma, MY_FLOAT_MIN));
+  }
+  localMin *= convectiveScaling;
+
+  // The diffusive limit is scaled by the extent of the stability region on the negative real axis relative to
+  // forward Euler (2): 1 for AB2 and about 2.5 for RK3. In IMEX mode, the viscous terms are implicit and only
+  // the convective limit applies.
+  if (!parameters_.timestep.imex) {
+    RealType diffusiveScaling = 1.0;
+    if (parameters_.timestep.scheme == AdamsBashforth2) {
+      diffusiveScaling = 0.5;
+    } else if (parameters_.timestep.scheme == RungeKutta3) {
+      diffusiveScaling = 1.25;
+    }
+    localMin = std::min(diffusiveScaling * parameters_.flow.Re / (2 * factor), localMin);
+  } else {
+    // Without the diffusive limit, a fluid at rest would get an arbitrarily large first step. Prescribed wall
+    // and inflow velocities are therefore part of the convective limit.
+    const RealType* const walls[6] = {
+      parameters_.walls.vectorLeft,
+      parameters_.walls.vectorRight,
+      parameters_.walls.vectorBottom,
+      parameters_.walls.vectorTop,
+      parameters_.walls.vectorFront,
+      parameters_.walls.vectorBack};
+    const RealType minMeshsize[3] = {
+      parameters_.meshsize->getDxMin(), parameters_.meshsize->getDyMin(), parameters_.meshsize->getDzMin()};
+    for (int d = 0; d < parameters_.geometry.dim; d++) {
+      for (int wall = 0; wall < 6; wall++) {
+        if (fabs(walls[wall][d]) > MY_FLOAT_MIN) {
+          localMin = std::min(convectiveScaling * minMeshsize[d] / fabs(walls[wall][d]), localMin);
+        }
+      }
+    }
+  }
 
   // Here, we select the type of operation before compiling. This allows to use the correct
   // data type for MPI. Not a concern for small simulations, but useful if using heterogeneous
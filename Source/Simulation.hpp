@@ -5,9 +5,14 @@
 #include "GlobalBoundaryFactory.hpp"
 #include "Iterators.hpp"
 
+#include "ParallelManagers/PetscParallelManager.hpp"
+#include "ParallelManagers/ReductionCounter.hpp"
+
 #include "Solvers/LinearSolver.hpp"
+#include "Solvers/ViscousSolver.hpp"
 #include "Stencils/BFInputStencils.hpp"
 #include "Stencils/BFStepInitStencil.hpp"
+#include "Stencils/DivergenceStencil.hpp"
 #include "Stencils/FGHStencil.hpp"
 #include "Stencils/RHSStencil.hpp"
 #include "Stencils/InitTaylorGreenFlowFieldStencil.hpp"
@@ -46,11 +51,58 @@ protected:
   FieldIterator<FlowField>  velocityIterator_;
   FieldIterator<FlowField>  obstacleIterator_;
 
+  //! Exchange of the ghost layers with the neighbouring subdomains
+  ParallelManagers::PetscParallelManager parallelManager_;
+
+  // Divergence left by the projection, for the adaptive tolerance of the pressure solver
+  Stencils::DivergenceStencil divergenceStencil_;
+  FieldIterator<FlowField>    divergenceIterator_;
+
+  RealType toleranceScaling_;    //! Ratio of the pressure tolerance to target divergence / dt, see solveStage
+  RealType minToleranceScaling_; //! Lower bound of toleranceScaling_, raised at the floor of the divergence
+  RealType previousScaling_;     //! toleranceScaling_ of the previous stage
+  RealType previousDivergence_;  //! Divergence after the previous stage
 
   std::unique_ptr<Solvers::LinearSolver> solver_;
 
+  //! Implicit viscous correction of the predictor, only created in IMEX mode
+  std::unique_ptr<Solvers::ViscousSolver> viscousSolver_;
+
+  RealType previousDt_; //! Timestep of the last step, for the variable-step Adams-Bashforth weights
+
+  //! Pressure before the solve in incremental mode, the solver works on the change of the pressure
+  std::vector<RealType> previousPressure_;
+
+  int           pressureSolves_;     //! Pressure solves since the last call of getPressureSolves()
+  int           pressureIterations_; //! Iterations of the pressure solver since the last call of getPressureIterations()
+  std::uint64_t pressureTime_;       //! Time in ns spent in the pressure solver since the last call of getPressureTime()
+  int           singleIterations_;   //! Part of pressureIterations_ in single precision, see getSinglePrecisionIterations()
+  std::uint64_t singleTime_;         //! Part of pressureTime_ spent in these iterations
+
+  //! Global reductions of the pressure solver since the last call of getPressureReductions()
+  ParallelManagers::ReductionCounter::Counts pressureReductions_;
+
   virtual void setTimeStep();
 
+  /** Predictor, pressure projection and boundary update with the current parameters_.timestep.dt
+   *
+   * @param increment Time since the previous pressure solve, for the initial guess of the pressure
+   * @param project Whether to solve for the pressure, otherwise the velocity takes the gradient of the current one
+   */
+  void solveStage(RealType increment, bool project = true);
+
+  /** Returns the root mean square divergence of the velocity over the fluid cells of all processes */
+  RealType computeDivergence();
+
+  /** Adapts toleranceScaling_ to the divergence after the last stage, see solveStage */
+  void updateToleranceScaling(RealType divergence);
+
+  /** Copies the pressure field into previousPressure_ */
+  void storePreviousPressure();
+
+  /** Adds weight times previousPressure_ to the pressure field */
+  void addPreviousPressure(RealType weight);
+
 public:
   Simulation(Parameters& parameters, FlowField& flowField);
   virtual ~Simulation() = default;
@@ -60,6 +112,25 @@ public:
 
   virtual void solveTimestep();
 
+  /** Returns the number of pressure solves since the last call and resets it */
+  int getPressureSolves();
+
+  /** Returns the iterations of the pressure solver since the last call and resets the count */
+  int getPressureIterations();
+
+  /** Returns the time in ns spent in the pressure solver since the last call and resets it */
+  std::uint64_t getPressureTime();
+
+  /** Returns the single-precision iterations of the pressure solver and their time in ns since the last call and resets
+   * them, see parameters.solver.mixedPrecision
+   */
+  int getSinglePrecisionIterations();
+
+  std::uint64_t getSinglePrecisionTime();
+
+  /** Returns the global reductions of the pressure solver since the last call and resets them */
+  ParallelManagers::ReductionCounter::Counts getPressureReductions();
+
   /** Plots the flow field */
   virtual void plotVTK(int timeStep, RealType simulationTime);
 };
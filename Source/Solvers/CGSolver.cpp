@@ -0,0 +1,723 @@
+#include "StdAfx.hpp"
+
+#include "CGSolver.hpp"
+
+#include "Clock.hpp"
+
+Solvers::CGSolver::CGSolver(FlowField& flowField, const Parameters& parameters):
+  LinearSolver(flowField, parameters),
+  fluidCells_(0),
+  maxIterations_(parameters.solver.maxIterations > 0 ? parameters.solver.maxIterations : 10000),
+  preconditioner_(parameters.solver.preconditioner),
+  mixedPrecision_(parameters.solver.mixedPrecision != 0) {
+
+  for (int axis = 0; axis < 3; axis++) {
+    sizes_[axis] = axis < parameters.geometry.dim ? parameters.parallel.localSize[axis] : 1;
+  }
+  strides_[0] = 1;
+  strides_[1] = sizes_[0] + 3;
+  strides_[2] = (sizes_[0] + 3) * (sizes_[1] + 3);
+
+  const int cells = strides_[2] * (parameters.geometry.dim == 3 ? sizes_[2] + 3 : 1);
+  rhs_.assign(cells, 0.0);
+  for (std::vector<RealType>* values :
+       {&workspace_.scaling,
+        &workspace_.centre,
+        &workspace_.inverseDiagonal,
+        &workspace_.inverseFactors,
+        &workspace_.solution,
+        &workspace_.residual,
+        &workspace_.preconditioned,
+        &workspace_.direction,
+        &workspace_.product}) {
+    values->assign(cells, 0.0);
+  }
+  if (mixedPrecision_) {
+    for (std::vector<float>* values :
+         {&singleWorkspace_.solution, &singleWorkspace_.residual, &singleWorkspace_.preconditioned, &singleWorkspace_.direction, &singleWorkspace_.product}) {
+      values->assign(cells, 0.0f);
+    }
+  }
+
+  updateCoefficients();
+}
+
+void Solvers::CGSolver::updateCoefficients() {
+  const int dim = parameters_.geometry.dim;
+
+  std::vector<RealType>& scaling         = workspace_.scaling;
+  std::vector<RealType>& centre          = workspace_.centre;
+  std::vector<RealType>& inverseDiagonal = workspace_.inverseDiagonal;
+
+  // The solver iterates on the negated operator, with the rows scaled by w(n + 1) = w(n) upper(n) / lower(n + 1) per
+  // axis, which recovers the symmetric flux form on non-uniform meshes. Per-axis coefficients and symmetrising weights,
+  // relative to the first inner cell.
+  std::vector<RealType> weights[3];
+  for (int axis = 0; axis < 3; axis++) {
+    weights[axis].assign(sizes_[axis] + 3, 1.0);
+    if (axis < dim) {
+      const RealType* const lower = pressureOperator_.getLower(axis);
+      const RealType* const upper = pressureOperator_.getUpper(axis);
+      workspace_.lower[axis].assign(lower, lower + sizes_[axis] + 3);
+      workspace_.upper[axis].assign(upper, upper + sizes_[axis] + 3);
+      for (int n = 2; n < sizes_[axis] + 1; n++) {
+        weights[axis][n + 1] = weights[axis][n] * upper[n] / lower[n + 1];
+      }
+    } else {
+      workspace_.lower[axis].assign(sizes_[axis] + 3, 0.0);
+      workspace_.upper[axis].assign(sizes_[axis] + 3, 0.0);
+    }
+  }
+
+  const int kBegin = dim == 3 ? 2 : 0;
+  const int kEnd   = dim == 3 ? sizes_[2] + 2 : 1;
+
+  std::fill(scaling.begin(), scaling.end(), 0.0);
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < sizes_[1] + 2; j++) {
+      for (int i = 2; i < sizes_[0] + 2; i++) {
+        const int index = i + j * strides_[1] + k * strides_[2];
+        scaling[index]  = -weights[0][i] * weights[1][j] * weights[2][k];
+        centre[index]   = dim == 3 ? pressureOperator_.getCentre(i, j, k) : pressureOperator_.getCentre(i, j);
+      }
+    }
+  }
+
+  const std::vector<PressureOperator::ObstacleRow>& obstacleRows = pressureOperator_.getObstacleRows();
+  for (const auto& row : obstacleRows) {
+    scaling[row.index] = 0.0;
+  }
+  fluidCells_ = sizes_[0] * sizes_[1] * sizes_[2] - static_cast<int>(obstacleRows.size());
+
+  // Neumann faces towards obstacles: the coefficient of the fluid neighbour towards the obstacle joins its centre
+  for (const auto& row : obstacleRows) {
+    const int coordinates[3] = {row.i, row.j, row.k};
+    for (int axis = 0; axis < dim; axis++) {
+      const int n = coordinates[axis];
+      if (scaling[row.index - strides_[axis]] != 0.0) {
+        centre[row.index - strides_[axis]] += pressureOperator_.getUpper(axis)[n - 1];
+      }
+      if (scaling[row.index + strides_[axis]] != 0.0) {
+        centre[row.index + strides_[axis]] += pressureOperator_.getLower(axis)[n + 1];
+      }
+    }
+  }
+
+  // The ghost cells of Neumann and Dirichlet faces are eliminated into the diagonal
+  std::fill(inverseDiagonal.begin(), inverseDiagonal.end(), 0.0);
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < sizes_[1] + 2; j++) {
+      for (int i = 2; i < sizes_[0] + 2; i++) {
+        const int index = i + j * strides_[1] + k * strides_[2];
+        if (scaling[index] == 0.0) {
+          continue;
+        }
+
+        RealType  diagonal       = centre[index];
+        const int coordinates[3] = {i, j, k};
+        for (int axis = 0; axis < dim; axis++) {
+          const int n = coordinates[axis];
+          if (n == 2 && lowerFaces_[axis] != PeriodicFace) {
+            diagonal += (lowerFaces_[axis] == DirichletFace ? -1.0 : 1.0) * pressureOperator_.getLower(axis)[n];
+          }
+          if (n == sizes_[axis] + 1 && upperFaces_[axis] != PeriodicFace) {
+            diagonal += (upperFaces_[axis] == DirichletFace ? -1.0 : 1.0) * pressureOperator_.getUpper(axis)[n];
+          }
+        }
+        inverseDiagonal[index] = 1.0 / (scaling[index] * diagonal);
+      }
+    }
+  }
+
+  if (preconditioner_ == IncompleteCholesky) {
+    factorise();
+  }
+
+  // The single-precision operator and preconditioner are rounded from the double-precision ones
+  if (mixedPrecision_) {
+    for (int axis = 0; axis < 3; axis++) {
+      singleWorkspace_.lower[axis].assign(workspace_.lower[axis].begin(), workspace_.lower[axis].end());
+      singleWorkspace_.upper[axis].assign(workspace_.upper[axis].begin(), workspace_.upper[axis].end());
+    }
+    singleWorkspace_.scaling.assign(scaling.begin(), scaling.end());
+    singleWorkspace_.centre.assign(centre.begin(), centre.end());
+    singleWorkspace_.inverseDiagonal.assign(inverseDiagonal.begin(), inverseDiagonal.end());
+    singleWorkspace_.inverseFactors.assign(workspace_.inverseFactors.begin(), workspace_.inverseFactors.end());
+  }
+}
+
+void Solvers::CGSolver::factorise() {
+  const int dim = parameters_.geometry.dim;
+  const int sy = strides_[1], sz = strides_[2];
+
+  const RealType* const a_W     = workspace_.lower[0].data();
+  const RealType* const a_S     = workspace_.lower[1].data();
+  const RealType* const a_B     = workspace_.lower[2].data();
+  const RealType* const scaling = workspace_.scaling.data();
+  const RealType* const diag    = workspace_.inverseDiagonal.data();
+  RealType* const       factors = workspace_.inverseFactors.data();
+
+  // Pivot d(m) = diagonal(m) - sum of l(m, n)^2 / d(n) over the lower neighbours n. The factors of cells that are not
+  // fluid are zero, which removes their couplings.
+  std::fill(workspace_.inverseFactors.begin(), workspace_.inverseFactors.end(), 0.0);
+  for (int k = dim == 3 ? 2 : 0; k < (dim == 3 ? sizes_[2] + 2 : 1); k++) {
+    for (int j = 2; j < sizes_[1] + 2; j++) {
+      for (int i = 2; i < sizes_[0] + 2; i++) {
+        const int      index = i + j * sy + k * sz;
+        const RealType s     = scaling[index];
+        if (s == 0.0) {
+          continue;
+        }
+
+        RealType pivot = 1.0 / diag[index];
+        pivot -= s * a_W[i] * s * a_W[i] * factors[index - 1];
+        pivot -= s * a_S[j] * s * a_S[j] * factors[index - sy];
+        if (dim == 3) {
+          pivot -= s * a_B[k] * s * a_B[k] * factors[index - sz];
+        }
+        factors[index] = 1.0 / pivot;
+      }
+    }
+  }
+}
+
+void Solvers::CGSolver::reInitMatrix() {
+  LinearSolver::reInitMatrix();
+  updateCoefficients();
+}
+
+template <int Dim, typename Scalar>
+void Solvers::CGSolver::updateGhosts(std::vector<Scalar>& values, bool homogeneous) {
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  const int firstK = Dim == 3 ? 2 : 0;
+  const int lastK  = Dim == 3 ? nz + 1 : 0;
+
+  Scalar lower[3], upper[3];
+  for (int axis = 0; axis < 3; axis++) {
+    lower[axis] = homogeneous ? Scalar(0) : static_cast<Scalar>(lowerValues_[axis]);
+    upper[axis] = homogeneous ? Scalar(0) : static_cast<Scalar>(upperValues_[axis]);
+  }
+
+  Scalar* const p = values.data();
+
+  // Left and right
+  for (int k = firstK; k <= lastK; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      Scalar* const line = p + j * sy + k * sz;
+      line[1]            = getGhostValue(lowerFaces_[0], line[2], line[nx + 1], lower[0]);
+      line[nx + 2]       = getGhostValue(upperFaces_[0], line[nx + 1], line[2], upper[0]);
+    }
+  }
+
+  // Bottom and top, including the ghost cells in x
+  for (int k = firstK; k <= lastK; k++) {
+    for (int i = 1; i < nx + 3; i++) {
+      Scalar* const line  = p + i + k * sz;
+      line[sy]            = getGhostValue(lowerFaces_[1], line[2 * sy], line[(ny + 1) * sy], lower[1]);
+      line[(ny + 2) * sy] = getGhostValue(upperFaces_[1], line[(ny + 1) * sy], line[2 * sy], upper[1]);
+    }
+  }
+
+  // Front and back, including the ghost cells in x and y
+  if constexpr (Dim == 3) {
+    for (int j = 1; j < ny + 3; j++) {
+      for (int i = 1; i < nx + 3; i++) {
+        Scalar* const line  = p + i + j * sy;
+        line[sz]            = getGhostValue(lowerFaces_[2], line[2 * sz], line[(nz + 1) * sz], lower[2]);
+        line[(nz + 2) * sz] = getGhostValue(upperFaces_[2], line[(nz + 1) * sz], line[2 * sz], upper[2]);
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::CGSolver::applyOperator(Workspace<Scalar>& workspace, std::vector<Scalar>& input, std::vector<Scalar>& output, bool homogeneous) {
+  updateGhosts<Dim>(input, homogeneous);
+
+  const Scalar* const a_W = workspace.lower[0].data();
+  const Scalar* const a_E = workspace.upper[0].data();
+  const Scalar* const a_S = workspace.lower[1].data();
+  const Scalar* const a_N = workspace.upper[1].data();
+  const Scalar* const a_B = workspace.lower[2].data();
+  const Scalar* const a_T = workspace.upper[2].data();
+
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  const Scalar* const x     = input.data();
+  Scalar* const       y     = output.data();
+  const Scalar* const scale = workspace.scaling.data();
+  const Scalar* const a_C   = workspace.centre.data();
+
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+  for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int line = j * sy + k * sz;
+#ifdef ENABLE_OPENMP
+#pragma omp simd
+#endif
+      for (int i = line + 2; i < line + nx + 2; i++) {
+        const int n     = i - line;
+        Scalar    value = a_W[n] * x[i - 1] + a_E[n] * x[i + 1] + a_S[j] * x[i - sy] + a_N[j] * x[i + sy] + a_C[i] * x[i];
+        if constexpr (Dim == 3) {
+          value += a_B[k] * x[i - sz] + a_T[k] * x[i + sz];
+        }
+        y[i] = scale[i] * value;
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::CGSolver::relax(Workspace<Scalar>& workspace, int colour, bool first) {
+  const Scalar* const a_W = workspace.lower[0].data();
+  const Scalar* const a_E = workspace.upper[0].data();
+  const Scalar* const a_S = workspace.lower[1].data();
+  const Scalar* const a_N = workspace.upper[1].data();
+  const Scalar* const a_B = workspace.lower[2].data();
+  const Scalar* const a_T = workspace.upper[2].data();
+
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  const Scalar* const r     = workspace.residual.data();
+  Scalar* const       z     = workspace.preconditioned.data();
+  const Scalar* const scale = workspace.scaling.data();
+  const Scalar* const diag  = workspace.inverseDiagonal.data();
+
+  // The ghost cells of z are never written and the values of obstacle cells are zero, so they do not contribute
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+  for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int line = j * sy + k * sz;
+      for (int n = 2 + ((colour + j + k) & 1); n < nx + 2; n += 2) {
+        const int i = line + n;
+        if (first) {
+          z[i] = r[i] * diag[i];
+          continue;
+        }
+        Scalar value = a_W[n] * z[i - 1] + a_E[n] * z[i + 1] + a_S[j] * z[i - sy] + a_N[j] * z[i + sy];
+        if constexpr (Dim == 3) {
+          value += a_B[k] * z[i - sz] + a_T[k] * z[i + sz];
+        }
+        z[i] = (r[i] - scale[i] * value) * diag[i];
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::CGSolver::solveTriangular(Workspace<Scalar>& workspace) {
+  const Scalar* const a_W = workspace.lower[0].data();
+  const Scalar* const a_E = workspace.upper[0].data();
+  const Scalar* const a_S = workspace.lower[1].data();
+  const Scalar* const a_N = workspace.upper[1].data();
+  const Scalar* const a_B = workspace.lower[2].data();
+  const Scalar* const a_T = workspace.upper[2].data();
+
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  const int firstK = Dim == 3 ? 2 : 0;
+  const int lastK  = Dim == 3 ? nz + 1 : 0;
+
+  const Scalar* const r       = workspace.residual.data();
+  Scalar* const       z       = workspace.preconditioned.data();
+  const Scalar* const scale   = workspace.scaling.data();
+  const Scalar* const factors = workspace.inverseFactors.data();
+
+  // Line (j, k) depends on the lines (j - 1, k) and (j, k - 1) in the forward substitution, and on (j + 1, k) and
+  // (j, k + 1) in the backward substitution. The lines on a diagonal j + k = const are independent.
+  for (int diagonal = 2 + firstK; diagonal <= ny + 1 + lastK; diagonal++) {
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int k = std::max(firstK, diagonal - ny - 1); k <= std::min(lastK, diagonal - 2); k++) {
+      const int j    = diagonal - k;
+      const int line = j * sy + k * sz;
+      for (int i = line + 2; i < line + nx + 2; i++) {
+        Scalar value = a_W[i - line] * z[i - 1] + a_S[j] * z[i - sy];
+        if constexpr (Dim == 3) {
+          value += a_B[k] * z[i - sz];
+        }
+        z[i] = (r[i] - scale[i] * value) * factors[i];
+      }
+    }
+  }
+
+  for (int diagonal = ny + 1 + lastK; diagonal >= 2 + firstK; diagonal--) {
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (int k = std::max(firstK, diagonal - ny - 1); k <= std::min(lastK, diagonal - 2); k++) {
+      const int j    = diagonal - k;
+      const int line = j * sy + k * sz;
+      for (int i = line + nx + 1; i >= line + 2; i--) {
+        Scalar value = a_E[i - line] * z[i + 1] + a_N[j] * z[i + sy];
+        if constexpr (Dim == 3) {
+          value += a_T[k] * z[i + sz];
+        }
+        z[i] -= scale[i] * value * factors[i];
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::CGSolver::precondition(Workspace<Scalar>& workspace) {
+  if (preconditioner_ == IncompleteCholesky) {
+    solveTriangular<Dim>(workspace);
+  } else if (preconditioner_ == SSORPreconditioner) {
+    relax<Dim>(workspace, 0, true);
+    relax<Dim>(workspace, 1, false);
+    relax<Dim>(workspace, 0, false);
+  } else {
+    const int           cells = static_cast<int>(workspace.residual.size());
+    const Scalar* const r     = workspace.residual.data();
+    const Scalar* const diag  = workspace.inverseDiagonal.data();
+    Scalar* const       z     = workspace.preconditioned.data();
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for simd schedule(static)
+#endif
+    for (int i = 0; i < cells; i++) {
+      z[i] = r[i] * diag[i];
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+RealType Solvers::CGSolver::dot(const std::vector<Scalar>& a, const std::vector<Scalar>& b) const {
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  RealType sum = 0.0;
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static) reduction(+ : sum)
+#endif
+  for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int line = j * sy + k * sz;
+      for (int i = line + 2; i < line + nx + 2; i++) {
+        sum += static_cast<RealType>(a[i]) * b[i];
+      }
+    }
+  }
+  return sum;
+}
+
+template <int Dim, typename Scalar>
+void Solvers::CGSolver::removeMean(const Workspace<Scalar>& workspace, std::vector<Scalar>& values) {
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  // Obstacle cells are zero
+  RealType sum = 0.0;
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static) reduction(+ : sum)
+#endif
+  for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int line = j * sy + k * sz;
+      for (int i = line + 2; i < line + nx + 2; i++) {
+        sum += values[i];
+      }
+    }
+  }
+
+  const Scalar mean = static_cast<Scalar>(sum / fluidCells_);
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+  for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int line = j * sy + k * sz;
+      for (int i = line + 2; i < line + nx + 2; i++) {
+        if (workspace.scaling[i] != Scalar(0)) {
+          values[i] -= mean;
+        }
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+RealType Solvers::CGSolver::residualNorm(const Workspace<Scalar>& workspace) const {
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  const Scalar* const r     = workspace.residual.data();
+  const Scalar* const scale = workspace.scaling.data();
+
+  RealType resnorm = 0.0;
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static) reduction(+ : resnorm)
+#endif
+  for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int line = j * sy + k * sz;
+      for (int i = line + 2; i < line + nx + 2; i++) {
+        if (scale[i] != Scalar(0)) {
+          const RealType residual = static_cast<RealType>(r[i]) / scale[i];
+          resnorm += residual * residual;
+        }
+      }
+    }
+  }
+  return sqrt(resnorm / (nx * ny * nz));
+}
+
+template <int Dim>
+RealType Solvers::CGSolver::computeResidual() {
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  RealType* const       r     = workspace_.residual.data();
+  const RealType* const q     = workspace_.product.data();
+  const RealType* const b     = rhs_.data();
+  const RealType* const scale = workspace_.scaling.data();
+
+  // The fluid cells do not see the obstacle cells, see updateCoefficients()
+  for (const auto& row : pressureOperator_.getObstacleRows()) {
+    workspace_.solution[row.index] = 0.0;
+  }
+
+  applyOperator<Dim>(workspace_, workspace_.solution, workspace_.product, false);
+  RealType residualSum = 0.0, scalingSum = 0.0;
+  for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int line = j * sy + k * sz;
+      for (int i = line + 2; i < line + nx + 2; i++) {
+        r[i] = scale[i] * b[i] - q[i];
+        residualSum += r[i];
+        scalingSum += scale[i];
+      }
+    }
+  }
+
+  // Without a Dirichlet boundary, the weighted residual has to be orthogonal to the constants. This removes the
+  // weighted mean of the right hand side, as in the multigrid solver.
+  if (singular_) {
+    const RealType shift = residualSum / scalingSum;
+    for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+      for (int j = 2; j < ny + 2; j++) {
+        const int line = j * sy + k * sz;
+        for (int i = line + 2; i < line + nx + 2; i++) {
+          r[i] -= scale[i] * shift;
+        }
+      }
+    }
+  }
+
+  return residualNorm<Dim>(workspace_);
+}
+
+template <int Dim, typename Scalar>
+int Solvers::CGSolver::iterate(Workspace<Scalar>& workspace, RealType& norm, RealType& projection, RealType target, int maxIterations) {
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  Scalar* const       x = workspace.solution.data();
+  Scalar* const       r = workspace.residual.data();
+  Scalar* const       p = workspace.direction.data();
+  const Scalar* const z = workspace.preconditioned.data();
+  const Scalar* const q = workspace.product.data();
+
+  int iterations = 0;
+  while (norm > target && iterations < maxIterations) {
+    precondition<Dim>(workspace);
+    if (singular_) {
+      removeMean<Dim>(workspace, workspace.preconditioned);
+    }
+
+    const RealType previous = projection;
+    projection              = dot<Dim>(workspace.residual, workspace.preconditioned);
+    if (projection <= 0.0) {
+      break;
+    }
+
+    const Scalar beta = previous == 0.0 ? Scalar(0) : static_cast<Scalar>(projection / previous);
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+    for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+      for (int j = 2; j < ny + 2; j++) {
+        const int line = j * sy + k * sz;
+        for (int i = line + 2; i < line + nx + 2; i++) {
+          p[i] = z[i] + beta * p[i];
+        }
+      }
+    }
+
+    applyOperator<Dim>(workspace, workspace.direction, workspace.product, true);
+    const RealType curvature = dot<Dim>(workspace.direction, workspace.product);
+    if (curvature <= 0.0) {
+      break;
+    }
+
+    const Scalar alpha = static_cast<Scalar>(projection / curvature);
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+    for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+      for (int j = 2; j < ny + 2; j++) {
+        const int line = j * sy + k * sz;
+        for (int i = line + 2; i < line + nx + 2; i++) {
+          x[i] += alpha * p[i];
+          r[i] -= alpha * q[i];
+        }
+      }
+    }
+
+    norm = residualNorm<Dim>(workspace);
+    spdlog::debug("Residual norm : {}", norm);
+    iterations++;
+  }
+
+  return iterations;
+}
+
+template <int Dim>
+int Solvers::CGSolver::run() {
+  const int nx = sizes_[0], ny = sizes_[1], nz = sizes_[2];
+  const int sy = strides_[1], sz = strides_[2];
+
+  RealType norm       = computeResidual<Dim>();
+  RealType projection = 0.0;
+  int      iterations = 0;
+
+  if (!mixedPrecision_) {
+    iterations = iterate<Dim>(workspace_, norm, projection, tolerance_, maxIterations_);
+  }
+
+  // Iterative refinement: single-precision correction of the double-precision residual, restarted at each step. Keeping
+  // the search direction across the replacements of the residual loses the conjugacy on stretched meshes.
+  for (int step = 0; mixedPrecision_ && step < refinementSteps_ && norm > tolerance_ && iterations < maxIterations_; step++) {
+    singleWorkspace_.residual.assign(workspace_.residual.begin(), workspace_.residual.end());
+    std::fill(singleWorkspace_.solution.begin(), singleWorkspace_.solution.end(), 0.0f);
+
+    RealType    innerNorm = norm;
+    projection            = 0.0;
+    const Clock clock;
+    const int   inner = iterate<Dim>(singleWorkspace_, innerNorm, projection, std::max(tolerance_, innerReduction_ * norm), maxIterations_ - iterations);
+    singleTime_ += clock.getTime();
+    singleIterations_ += inner;
+    iterations += inner;
+
+    RealType* const    x = workspace_.solution.data();
+    const float* const e = singleWorkspace_.solution.data();
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static)
+#endif
+    for (int k = Dim == 3 ? 2 : 0; k < (Dim == 3 ? nz + 2 : 1); k++) {
+      for (int j = 2; j < ny + 2; j++) {
+        const int line = j * sy + k * sz;
+        for (int i = line + 2; i < line + nx + 2; i++) {
+          x[i] += e[i];
+        }
+      }
+    }
+
+    // The refinement stagnates once the single-precision operator cannot resolve the residual any more
+    const RealType previous = norm;
+    norm                    = computeResidual<Dim>();
+    spdlog::debug("Refinement step {}, residual norm : {}", step, norm);
+    if (norm >= previous) {
+      break;
+    }
+  }
+
+  // The true residual may stagnate above the tolerance due to the rounding errors of its evaluation, the conjugate
+  // gradient iteration in double precision continues on its recursive residual like a full double-precision solve
+  if (mixedPrecision_ && norm > tolerance_) {
+    projection = 0.0;
+    iterations += iterate<Dim>(workspace_, norm, projection, tolerance_, maxIterations_ - iterations);
+  }
+
+  if (norm > tolerance_) {
+    spdlog::warn("CGSolver did not converge within {} iterations, residual norm {}", iterations, norm);
+  }
+
+  updateObstacles<Dim>();
+  return iterations;
+}
+
+template <int Dim>
+void Solvers::CGSolver::updateObstacles() {
+  std::vector<RealType>& pressure = workspace_.solution;
+
+  // Ghost cells of periodic faces hold the opposite fluid cells
+  updateGhosts<Dim>(pressure, false);
+
+  for (const auto& row : pressureOperator_.getObstacleRows()) {
+    const int coordinates[3] = {row.i, row.j, row.k};
+
+    RealType centre = row.values[PressureOperator::Centre];
+    RealType value  = rhs_[row.index];
+    for (int axis = 0; axis < Dim; axis++) {
+      for (int side = 0; side < 2; side++) {
+        const RealType coefficient = row.values[2 * axis + side];
+        if (coefficient == 0.0) {
+          continue;
+        }
+
+        const FaceType face  = side == 0 ? lowerFaces_[axis] : upperFaces_[axis];
+        const bool     ghost = coordinates[axis] == (side == 0 ? 2 : sizes_[axis] + 1) && face != PeriodicFace;
+
+        // The ghost cell of a wall depends on the obstacle cell itself, see getGhostValue()
+        if (ghost && face == DirichletFace) {
+          value -= 2.0 * coefficient * (side == 0 ? lowerValues_[axis] : upperValues_[axis]);
+          centre -= coefficient;
+        } else if (ghost) {
+          centre += coefficient;
+        } else {
+          value -= coefficient * pressure[row.index + (side == 0 ? -strides_[axis] : strides_[axis])];
+        }
+      }
+    }
+    pressure[row.index] = centre != 0.0 ? value / centre : 0.0;
+  }
+
+  updateGhosts<Dim>(pressure, false);
+}
+
+void Solvers::CGSolver::solve() {
+  ScalarField& P   = flowField_.getPressure();
+  ScalarField& RHS = flowField_.getRHS();
+
+  const int dim   = parameters_.geometry.dim;
+  const int lastK = dim == 3 ? sizes_[2] + 2 : 0;
+
+  std::vector<RealType>& pressure = workspace_.solution;
+  for (int k = 0; k <= lastK; k++) {
+    for (int j = 0; j < sizes_[1] + 3; j++) {
+      for (int i = 0; i < sizes_[0] + 3; i++) {
+        const int index = i + j * strides_[1] + k * strides_[2];
+        pressure[index] = P.getScalar(i, j, k);
+        rhs_[index]     = RHS.getScalar(i, j, k);
+      }
+    }
+  }
+  for (const auto& row : pressureOperator_.getObstacleRows()) {
+    rhs_[row.index] = 0.0;
+  }
+
+  singleIterations_ = 0;
+  singleTime_       = 0;
+  iterations_       = dim == 3 ? run<3>() : run<2>();
+
+  for (int k = 0; k <= lastK; k++) {
+    for (int j = 0; j < sizes_[1] + 3; j++) {
+      for (int i = 0; i < sizes_[0] + 3; i++) {
+        P.getScalar(i, j, k) = pressure[i + j * strides_[1] + k * strides_[2]];
+      }
+    }
+  }
+
+  spdlog::debug("CGSolver needed {} iterations", iterations_);
+}
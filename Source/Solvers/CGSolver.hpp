@@ -0,0 +1,111 @@
+#pragma once
+
+#include "LinearSolver.hpp"
+
+namespace Solvers {
+
+  /** Preconditioned conjugate gradient solver for the pressure equation, optionally in single precision inside a
+   * double-precision iterative refinement
+   */
+  class CGSolver: public LinearSolver {
+  private:
+    int sizes_[3];   //! Number of inner cells per axis
+    int strides_[3]; //! Strides of the linear index, see PressureOperator::getLinearIndex()
+    int fluidCells_;
+
+    const int      maxIterations_;
+    const int      preconditioner_; //! See CGPreconditioner
+    const bool     mixedPrecision_;
+
+    static constexpr RealType innerReduction_  = 1e-5;
+    static constexpr int      refinementSteps_ = 30;
+
+    // Weighted operator, preconditioner and vectors of the iteration in the precision Scalar
+    template <typename Scalar>
+    struct Workspace {
+      // Per-axis coefficients, see PressureOperator
+      std::vector<Scalar> lower[3];
+      std::vector<Scalar> upper[3];
+
+      // Rows of the weighted, negated operator: scaling is minus the weight of fluid cells and zero for obstacle and
+      // ghost cells, centre the centre coefficient including the couplings to neighbouring obstacles
+      std::vector<Scalar> scaling;
+      std::vector<Scalar> centre;
+      std::vector<Scalar> inverseDiagonal; //! Inverse diagonal of the weighted operator, zero if not fluid
+      std::vector<Scalar> inverseFactors;  //! Inverse pivots of the incomplete Cholesky factorisation
+
+      std::vector<Scalar> solution;
+      std::vector<Scalar> residual;
+      std::vector<Scalar> preconditioned;
+      std::vector<Scalar> direction;
+      std::vector<Scalar> product; //! Operator applied to the search direction
+    };
+
+    Workspace<RealType> workspace_;       //! The solution is the pressure
+    Workspace<float>    singleWorkspace_; //! The solution is the correction of a refinement step, if mixed precision
+
+    std::vector<RealType> rhs_;
+
+    // Computes the rows of the weighted operator and the preconditioner from the pressure operator
+    void updateCoefficients();
+
+    void factorise();
+
+    template <int Dim, typename Scalar>
+    void updateGhosts(std::vector<Scalar>& values, bool homogeneous);
+
+    // output = weighted operator applied to input, updates the ghost cells of input
+    template <int Dim, typename Scalar>
+    void applyOperator(Workspace<Scalar>& workspace, std::vector<Scalar>& input, std::vector<Scalar>& output, bool homogeneous);
+
+    // Computes the preconditioned residual
+    template <int Dim, typename Scalar>
+    void precondition(Workspace<Scalar>& workspace);
+
+    // Red-black Gauss-Seidel half-sweep of the preconditioner over one colour, ignoring the other colour if first
+    template <int Dim, typename Scalar>
+    void relax(Workspace<Scalar>& workspace, int colour, bool first);
+
+    template <int Dim, typename Scalar>
+    void solveTriangular(Workspace<Scalar>& workspace);
+
+    // Inner products are accumulated in double precision
+    template <int Dim, typename Scalar>
+    RealType dot(const std::vector<Scalar>& a, const std::vector<Scalar>& b) const;
+
+    // Removes the mean over the fluid cells
+    template <int Dim, typename Scalar>
+    void removeMean(const Workspace<Scalar>& workspace, std::vector<Scalar>& values);
+
+    // Root mean square of the unweighted residual
+    template <int Dim, typename Scalar>
+    RealType residualNorm(const Workspace<Scalar>& workspace) const;
+
+    // Computes the weighted residual of the pressure in workspace_, returns its norm
+    template <int Dim>
+    RealType computeResidual();
+
+    // Conjugate gradient iteration on the residual of the workspace until its norm drops below target, returns the
+    // number of iterations and updates norm. The iteration continues along the direction of the workspace unless the
+    // projection of the preconditioned residual is zero.
+    template <int Dim, typename Scalar>
+    int iterate(Workspace<Scalar>& workspace, RealType& norm, RealType& projection, RealType target, int maxIterations);
+
+    // Runs a complete solve and returns the number of iterations
+    template <int Dim>
+    int run();
+
+    // Sets the obstacle cells from their explicit rows
+    template <int Dim>
+    void updateObstacles();
+
+  public:
+    CGSolver(FlowField& flowField, const Parameters& parameters);
+    ~CGSolver() override = default;
+
+    void solve() override;
+
+    void reInitMatrix() override;
+  };
+
+} // namespace Solvers
@@ -0,0 +1,121 @@
+#include "StdAfx.hpp"
+
+#include "FourierTransform.hpp"
+
+// exp(i angle)
+static inline Solvers::FourierTransform::Complex unitRoot(double angle) {
+  return Solvers::FourierTransform::Complex(static_cast<RealType>(cos(angle)), static_cast<RealType>(sin(angle)));
+}
+
+Solvers::FourierTransform::FourierTransform(int size):
+  size_(size),
+  paddedSize_(1) {
+
+  if (size < 1) {
+    throw std::runtime_error("Fourier transform needs a positive length");
+  }
+
+  const bool powerOfTwo = (size & (size - 1)) == 0;
+  while (paddedSize_ < (powerOfTwo ? size : 2 * size - 1)) {
+    paddedSize_ *= 2;
+  }
+
+  twiddles_.resize(paddedSize_ / 2);
+  for (int j = 0; j < paddedSize_ / 2; j++) {
+    twiddles_[j] = unitRoot(-2.0 * M_PI * j / paddedSize_);
+  }
+
+  reversed_.resize(paddedSize_);
+  int bits = 0;
+  while ((1 << bits) < paddedSize_) {
+    bits++;
+  }
+  for (int n = 0; n < paddedSize_; n++) {
+    int reversed = 0;
+    for (int b = 0; b < bits; b++) {
+      reversed |= ((n >> b) & 1) << (bits - 1 - b);
+    }
+    reversed_[n] = reversed;
+  }
+
+  if (powerOfTwo) {
+    return;
+  }
+
+  // X_k = chirp_k sum_n (x_n chirp_n) conj(chirp_{k - n}), a convolution that is evaluated with the padded transform.
+  // n^2 is reduced modulo 2 size to keep the argument of the exponential small.
+  chirp_.resize(size_);
+  for (int n = 0; n < size_; n++) {
+    const long long square = (static_cast<long long>(n) * n) % (2 * size_);
+    chirp_[n]              = unitRoot(-M_PI * static_cast<double>(square) / size_);
+  }
+
+  chirpSpectrum_.assign(paddedSize_, Complex(0.0, 0.0));
+  chirpSpectrum_[0] = std::conj(chirp_[0]);
+  for (int n = 1; n < size_; n++) {
+    chirpSpectrum_[n]               = std::conj(chirp_[n]);
+    chirpSpectrum_[paddedSize_ - n] = std::conj(chirp_[n]);
+  }
+  transformRadix2(chirpSpectrum_.data(), false);
+
+  work_.resize(paddedSize_);
+}
+
+void Solvers::FourierTransform::transformRadix2(Complex* data, bool inverse) const {
+  for (int n = 0; n < paddedSize_; n++) {
+    if (n < reversed_[n]) {
+      std::swap(data[n], data[reversed_[n]]);
+    }
+  }
+
+  for (int length = 2; length <= paddedSize_; length *= 2) {
+    const int half   = length / 2;
+    const int stride = paddedSize_ / length;
+    for (int start = 0; start < paddedSize_; start += length) {
+      for (int j = 0; j < half; j++) {
+        const Complex twiddle = inverse ? std::conj(twiddles_[j * stride]) : twiddles_[j * stride];
+        const Complex odd     = twiddle * data[start + j + half];
+        data[start + j + half] = data[start + j] - odd;
+        data[start + j] += odd;
+      }
+    }
+  }
+}
+
+void Solvers::FourierTransform::forward(Complex* data) {
+  if (chirp_.empty()) {
+    transformRadix2(data, false);
+    return;
+  }
+
+  for (int n = 0; n < size_; n++) {
+    work_[n] = data[n] * chirp_[n];
+  }
+  std::fill(work_.begin() + size_, work_.end(), Complex(0.0, 0.0));
+
+  transformRadix2(work_.data(), false);
+  for (int n = 0; n < paddedSize_; n++) {
+    work_[n] *= chirpSpectrum_[n];
+  }
+  transformRadix2(work_.data(), true);
+
+  for (int k = 0; k < size_; k++) {
+    data[k] = work_[k] * chirp_[k] / static_cast<RealType>(paddedSize_);
+  }
+}
+
+void Solvers::FourierTransform::backward(Complex* data) {
+  if (chirp_.empty()) {
+    transformRadix2(data, true);
+    return;
+  }
+
+  // The inverse is the conjugate of the forward transform of the conjugate
+  for (int n = 0; n < size_; n++) {
+    data[n] = std::conj(data[n]);
+  }
+  forward(data);
+  for (int n = 0; n < size_; n++) {
+    data[n] = std::conj(data[n]);
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Definitions.hpp"
+
+namespace Solvers {
+
+  /** Complex discrete Fourier transform of a fixed length
+   *
+   * Lengths that are a power of two use an iterative radix-2 FFT. Other lengths are mapped onto a convolution of a
+   * power-of-two length with Bluestein's algorithm, so that every length costs O(N log N).
+   */
+  class FourierTransform {
+  public:
+    using Complex = std::complex<RealType>;
+
+  private:
+    int size_;
+    int paddedSize_; //! Length of the radix-2 transform, equal to the size for powers of two
+
+    std::vector<Complex> twiddles_; //! exp(-2 pi i j / paddedSize) for j < paddedSize / 2
+    std::vector<int>     reversed_; //! Bit reversal permutation of the radix-2 transform
+
+    // Bluestein's algorithm
+    std::vector<Complex> chirp_;         //! exp(-i pi n^2 / size)
+    std::vector<Complex> chirpSpectrum_; //! Transform of the conjugate chirp, wrapped around
+    std::vector<Complex> work_;
+
+    // In-place radix-2 transform of length paddedSize, with the sign of the exponent reversed if inverse is set
+    void transformRadix2(Complex* data, bool inverse) const;
+
+  public:
+    FourierTransform(int size);
+    ~FourierTransform() = default;
+
+    /** Computes X_k = sum_n x_n exp(-2 pi i k n / N) in place */
+    void forward(Complex* data);
+
+    /** Computes x_n = sum_k X_k exp(2 pi i k n / N) in place, i.e., the inverse without the factor 1 / N */
+    void backward(Complex* data);
+
+    inline int getSize() const { return size_; }
+  };
+
+} // namespace Solvers
@@ -4,4 +4,132 @@
 
 Solvers::LinearSolver::LinearSolver(FlowField& flowField, const Parameters& parameters):
   flowField_(flowField),
-  parameters_(parameters) {}
+  parameters_(parameters),
+  pressureOperator_(parameters),
+  singular_(true),
+  tolerance_(parameters.solver.tolerance),
+  iterations_(0),
+  singleIterations_(0),
+  singleTime_(0),
+  nextTime_(0.0) {
+
+  const WallParameters&     walls    = parameters.walls;
+  const ParallelParameters& parallel = parameters.parallel;
+  setFaces(0, walls.typeLeft, walls.typeRight, parallel.leftNb, parallel.rightNb, walls.scalarLeft, walls.scalarRight);
+  setFaces(1, walls.typeBottom, walls.typeTop, parallel.bottomNb, parallel.topNb, walls.scalarBottom, walls.scalarTop);
+  if (parameters.geometry.dim == 3) {
+    setFaces(2, walls.typeFront, walls.typeBack, parallel.frontNb, parallel.backNb, walls.scalarFront, walls.scalarBack);
+  } else {
+    lowerFaces_[2]  = NeumannFace;
+    upperFaces_[2]  = NeumannFace;
+    lowerValues_[2] = 0.0;
+    upperValues_[2] = 0.0;
+  }
+
+  pressureOperator_.update(flowField.getFlags());
+}
+
+void Solvers::LinearSolver::setFaces(
+  int axis, BoundaryType lower, BoundaryType upper, int lowerNb, int upperNb, RealType lowerValue, RealType upperValue
+) {
+  lowerValues_[axis] = getDirichletValue(lowerValue);
+  upperValues_[axis] = getDirichletValue(upperValue);
+
+  if (lower == PERIODIC && parameters_.parallel.numProcessors[axis] == 1) {
+    lowerFaces_[axis] = PeriodicFace;
+    upperFaces_[axis] = PeriodicFace;
+    return;
+  }
+
+  lowerFaces_[axis] = lowerNb == MPI_PROC_NULL && getDomainFace(lower) == DirichletFace ? DirichletFace : NeumannFace;
+  upperFaces_[axis] = upperNb == MPI_PROC_NULL && getDomainFace(upper) == DirichletFace ? DirichletFace : NeumannFace;
+  if (lowerFaces_[axis] == DirichletFace || upperFaces_[axis] == DirichletFace) {
+    singular_ = false;
+  }
+}
+
+void Solvers::LinearSolver::reInitMatrix() { pressureOperator_.update(flowField_.getFlags()); }
+
+void Solvers::LinearSolver::setTolerance(RealType tolerance) { tolerance_ = tolerance; }
+
+int Solvers::LinearSolver::getExtrapolationWeights(RealType increment, RealType weights[3]) {
+  nextTime_ = historyTimes_.empty() ? 0.0 : historyTimes_.front() + increment;
+
+  const int points = std::min(static_cast<int>(historyTimes_.size()), parameters_.solver.extrapolation + 1);
+  if (points < 2) {
+    return points;
+  }
+
+  // Lagrange weights of the solutions at the next time, which accounts for varying timesteps
+  for (int m = 0; m < points; m++) {
+    weights[m] = 1.0;
+    for (int l = 0; l < points; l++) {
+      if (l != m) {
+        weights[m] *= (nextTime_ - historyTimes_[l]) / (historyTimes_[m] - historyTimes_[l]);
+      }
+    }
+  }
+  return points;
+}
+
+void Solvers::LinearSolver::storeSolutionTime() {
+  if (static_cast<int>(historyTimes_.size()) > parameters_.solver.extrapolation) {
+    historyTimes_.pop_back();
+  }
+  historyTimes_.push_front(nextTime_);
+}
+
+void Solvers::LinearSolver::extrapolatePressure(RealType increment) {
+  if (parameters_.solver.extrapolation == 0) {
+    return;
+  }
+  // The field holds the latest solution already
+  RealType  weights[3];
+  const int points = getExtrapolationWeights(increment, weights);
+  if (points < 2) {
+    return;
+  }
+
+  ScalarField& pressure = flowField_.getPressure();
+  int          index    = 0;
+  for (int k = 0; k < pressure.getNz(); k++) {
+    for (int j = 0; j < pressure.getNy(); j++) {
+      for (int i = 0; i < pressure.getNx(); i++) {
+        RealType value = 0.0;
+        for (int m = 0; m < points; m++) {
+          value += weights[m] * history_[m][index];
+        }
+        pressure.getScalar(i, j, k) = value;
+        index++;
+      }
+    }
+  }
+}
+
+void Solvers::LinearSolver::storePressure() {
+  const int order = parameters_.solver.extrapolation;
+  if (order == 0) {
+    return;
+  }
+
+  // Reuse the storage of the oldest solution
+  std::vector<RealType> values;
+  if (static_cast<int>(history_.size()) > order) {
+    values = std::move(history_.back());
+    history_.pop_back();
+  }
+
+  ScalarField& pressure = flowField_.getPressure();
+  values.resize(pressure.getNx() * pressure.getNy() * pressure.getNz());
+  int index = 0;
+  for (int k = 0; k < pressure.getNz(); k++) {
+    for (int j = 0; j < pressure.getNy(); j++) {
+      for (int i = 0; i < pressure.getNx(); i++) {
+        values[index++] = pressure.getScalar(i, j, k);
+      }
+    }
+  }
+
+  history_.push_front(std::move(values));
+  storeSolutionTime();
+}
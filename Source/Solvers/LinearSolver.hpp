@@ -3,21 +3,102 @@
 #include "Definitions.hpp"
 #include "FlowField.hpp"
 #include "Parameters.hpp"
+#include "PressureOperator.hpp"
 
 namespace Solvers {
 
   // Abstract class for linear solvers for the pressure
   class LinearSolver {
   protected:
+    enum FaceType { NeumannFace = 0, DirichletFace = 1, PeriodicFace = 2 };
+
     FlowField&        flowField_;
     const Parameters& parameters_;
 
+    PressureOperator pressureOperator_; //! Coefficients of the pressure equation
+
+    // Pressure conditions on the faces of the subdomain, see getDomainFace(). Faces between processes are Neumann
+    // faces, periodic axes are only periodic if they are not split. In 2D, the faces along z are Neumann faces.
+    FaceType lowerFaces_[3];
+    FaceType upperFaces_[3];
+    RealType lowerValues_[3]; //! Pressure on the Dirichlet faces, see getDirichletValue()
+    RealType upperValues_[3];
+    bool     singular_;       //! If no face of the subdomain is Dirichlet, i.e., the pressure is only defined up to a constant
+
+    RealType tolerance_;  //! Root mean square residual at which the iterative solvers stop
+    int      iterations_; //! Iterations of the last solve, 0 for direct solvers
+
+    int           singleIterations_; //! Iterations of the last solve in single precision, see parameters.solver.mixedPrecision
+    std::uint64_t singleTime_;       //! Time in ns of these iterations
+
+    // Pressure on a Dirichlet face. The incremental projection solves for the change of the pressure, which vanishes
+    // there as the initial pressure already takes the value, see Simulation::initializeFlowField.
+    RealType getDirichletValue(RealType value) const { return parameters_.solver.incremental ? 0.0 : value; }
+
+    // Pressure condition on a face of the domain, as in the PETSc assembly: walls with Dirichlet velocity conditions
+    // have a homogeneous Neumann condition for the pressure, walls with Neumann velocity conditions (outflow or a
+    // prescribed pressure) a Dirichlet condition
+    static FaceType getDomainFace(BoundaryType type) {
+      return type == PERIODIC ? PeriodicFace : (type == NEUMANN ? DirichletFace : NeumannFace);
+    }
+
+    // Value of a ghost cell from the inner cell next to it, the inner cell at the opposite face and the pressure on
+    // the face
+    template <typename Scalar>
+    static inline Scalar getGhostValue(FaceType type, Scalar inner, std::type_identity_t<Scalar> opposite, std::type_identity_t<Scalar> value) {
+      if (type == DirichletFace) {
+        return 2 * value - inner;
+      }
+      return type == PeriodicFace ? opposite : inner;
+    }
+
+    /** Lagrange weights of the stored solutions, the latest first, at the time of the next solve
+     *
+     * @param increment Time between the last solve and the next one
+     * @return Number of solutions to combine, below 2 the latest solution is kept
+     */
+    int getExtrapolationWeights(RealType increment, RealType weights[3]);
+
+    /** Adds the time of the last solve to the history, see storePressure() */
+    void storeSolutionTime();
+
+  private:
+    void setFaces(int axis, BoundaryType lower, BoundaryType upper, int lowerNb, int upperNb, RealType lowerValue, RealType upperValue);
+
+    // Solutions of the previous solves, the latest first, with their times relative to the first solve
+    std::deque<std::vector<RealType>> history_;
+    std::deque<RealType>              historyTimes_;
+    RealType                          nextTime_;
+
   public:
     LinearSolver(FlowField& flowField, const Parameters& parameters);
     virtual ~LinearSolver() = default;
 
-    virtual void        solve() = 0;
-    virtual inline void reInitMatrix() {}
+    virtual void solve() = 0;
+
+    // Updates the operator after the flag field has changed
+    virtual void reInitMatrix();
+
+    /** Replaces the pressure by a polynomial extrapolation of the previous solutions in time
+     *
+     * The order is set by parameters.solver.extrapolation. Together with storePressure(), this gives the iterative
+     * solvers an initial guess that is accurate to O(dt^(order + 1)) for smooth flows.
+     *
+     * @param increment Time between the last solve and the next one
+     */
+    virtual void extrapolatePressure(RealType increment);
+
+    /** Adds the current pressure to the history of solutions, call after solve() */
+    virtual void storePressure();
+
+    /** Sets the tolerance of the next solves, see parameters.solver.divergence */
+    virtual void setTolerance(RealType tolerance);
+
+    int getIterations() const { return iterations_; }
+
+    int getSingleIterations() const { return singleIterations_; }
+
+    std::uint64_t getSingleTime() const { return singleTime_; }
   };
 
 } // namespace Solvers
@@ -0,0 +1,951 @@
+#include "StdAfx.hpp"
+
+#include "MultigridSolver.hpp"
+
+#include "Clock.hpp"
+
+Solvers::MultigridSolver::MultigridSolver(FlowField& flowField, const Parameters& parameters):
+  LinearSolver(flowField, parameters),
+  lineRelaxation_(parameters.solver.type == LinePressureSolver),
+  lineOmega_(lineRelaxation_ ? parameters.solver.omega : 1.0),
+  maxCycles_(parameters.solver.maxIterations > 0 ? parameters.solver.maxIterations : (lineRelaxation_ ? 10000 : 100)),
+  coarsestSweeps_(50),
+  mixedPrecision_(parameters.solver.mixedPrecision != 0) {
+
+  createLevels();
+  spdlog::debug("MultigridSolver uses {} levels", levels_.size());
+}
+
+void Solvers::MultigridSolver::createLevels() {
+  const int dim = parameters_.geometry.dim;
+
+  auto finest = std::make_unique<Level>();
+  for (int axis = 0; axis < 3; axis++) {
+    finest->sizes[axis]     = axis < dim ? parameters_.parallel.localSize[axis] : 1;
+    finest->coarsened[axis] = false;
+    if (axis < dim) {
+      const RealType* const spacings = parameters_.meshsize->getSpacings(axis);
+      finest->spacings[axis].assign(spacings - 1, spacings + finest->sizes[axis] + 4);
+    }
+  }
+  finest->flags            = &flowField_.getFlags();
+  finest->pressureOperator = &pressureOperator_;
+  levels_.push_back(std::move(finest));
+
+  // Coarsen until no axis has more than two cells
+  while (true) {
+    const Level& fine = *levels_.back();
+    if (lineRelaxation_ || (fine.sizes[0] <= 2 && fine.sizes[1] <= 2 && (dim == 2 || fine.sizes[2] <= 2))) {
+      break;
+    }
+    createCoarseLevel(*levels_.back());
+  }
+
+  for (auto& level : levels_) {
+    level->strides[0] = 1;
+    level->strides[1] = level->sizes[0] + 3;
+    level->strides[2] = (level->sizes[0] + 3) * (level->sizes[1] + 3);
+
+    const int cells = level->strides[2] * (dim == 3 ? level->sizes[2] + 3 : 1);
+    for (std::vector<RealType>* values :
+         {&level->values.pressure, &level->values.rhs, &level->values.residual, &level->values.inverseDiagonal}) {
+      values->assign(cells, 0.0);
+    }
+    if (mixedPrecision_) {
+      for (std::vector<float>* values :
+           {&level->singleValues.pressure, &level->singleValues.rhs, &level->singleValues.residual, &level->singleValues.inverseDiagonal}) {
+        values->assign(cells, 0.0f);
+      }
+    }
+    level->obstacleRows.assign(cells, -1);
+
+    for (int axis = 0; axis < dim; axis++) {
+      const RealType* const h = level->spacings[axis].data() + 1;
+      level->duals[axis].assign(level->sizes[axis] + 3, 0.0);
+      for (int n = 1; n < level->sizes[axis] + 3; n++) {
+        level->duals[axis][n] = 0.25 * (h[n - 1] + 2.0 * h[n] + h[n + 1]);
+      }
+    }
+    updateCoefficients(*level);
+  }
+}
+
+void Solvers::MultigridSolver::createCoarseLevel(Level& fine) {
+  const int dim = parameters_.geometry.dim;
+
+  // Mean meshsize per axis. Only axes that are not much coarser than the finest one are coarsened.
+  RealType meanSpacings[3] = {0.0, 0.0, 0.0};
+  RealType minSpacing      = std::numeric_limits<RealType>::max();
+  for (int axis = 0; axis < dim; axis++) {
+    for (int n = 2; n < fine.sizes[axis] + 2; n++) {
+      meanSpacings[axis] += fine.spacings[axis][n + 1];
+    }
+    meanSpacings[axis] /= fine.sizes[axis];
+    if (fine.sizes[axis] > 2) {
+      minSpacing = std::min(minSpacing, meanSpacings[axis]);
+    }
+  }
+
+  auto coarse = std::make_unique<Level>();
+  for (int axis = 0; axis < 3; axis++) {
+    coarse->coarsened[axis] = axis < dim && fine.sizes[axis] > 2 && meanSpacings[axis] < 1.5 * minSpacing;
+    coarse->sizes[axis]     = coarse->coarsened[axis] ? (fine.sizes[axis] + 1) / 2 : fine.sizes[axis];
+  }
+
+  const RealType* spacings[3] = {nullptr, nullptr, nullptr};
+  for (int axis = 0; axis < dim; axis++) {
+    const int             size         = coarse->sizes[axis];
+    const RealType* const fineSpacings = fine.spacings[axis].data() + 1;
+
+    // Each coarse cell spans its children, the ghost layers continue the outermost meshsize
+    coarse->spacings[axis].resize(size + 5);
+    RealType* const coarseSpacings = coarse->spacings[axis].data() + 1;
+    for (int c = 2; c < size + 2; c++) {
+      int first, last;
+      getChildren(fine, *coarse, axis, c, first, last);
+      coarseSpacings[c] = 0.0;
+      for (int f = first; f <= last; f++) {
+        coarseSpacings[c] += fineSpacings[f];
+      }
+    }
+    coarseSpacings[-1]       = coarseSpacings[2];
+    coarseSpacings[0]        = coarseSpacings[2];
+    coarseSpacings[1]        = coarseSpacings[2];
+    coarseSpacings[size + 2] = coarseSpacings[size + 1];
+    coarseSpacings[size + 3] = coarseSpacings[size + 1];
+
+    spacings[axis] = coarseSpacings;
+  }
+
+  // Cell centres of both levels, measured from the same lower face
+  for (Level* level : {&fine, coarse.get()}) {
+    for (int axis = 0; axis < dim; axis++) {
+      const RealType* const  h       = level->spacings[axis].data() + 1;
+      std::vector<RealType>& centres = level->centres[axis];
+      if (!centres.empty()) {
+        continue;
+      }
+      centres.resize(level->sizes[axis] + 3);
+      centres[2] = 0.5 * h[2];
+      for (int n = 3; n < level->sizes[axis] + 3; n++) {
+        centres[n] = centres[n - 1] + 0.5 * (h[n - 1] + h[n]);
+      }
+      centres[1] = centres[2] - 0.5 * (h[1] + h[2]);
+      centres[0] = centres[1] - 0.5 * (h[0] + h[1]);
+    }
+  }
+
+  // Linear interpolation from the two closest coarse cell centres
+  for (int axis = 0; axis < dim; axis++) {
+    const int size = fine.sizes[axis];
+    fine.parent[axis].assign(size + 3, 0);
+    fine.other[axis].assign(size + 3, 0);
+    fine.weight[axis].assign(size + 3, 0.0);
+
+    for (int f = 2; f < size + 2; f++) {
+      if (!coarse->coarsened[axis]) {
+        fine.parent[axis][f] = f;
+        fine.other[axis][f]  = f;
+        continue;
+      }
+      const RealType x      = fine.centres[axis][f];
+      const int      parent = 2 + (f - 2) / 2;
+      const int      other  = x < coarse->centres[axis][parent] ? parent - 1 : parent + 1;
+      fine.parent[axis][f]  = parent;
+      fine.other[axis][f]   = other;
+      fine.weight[axis][f]  = (x - coarse->centres[axis][parent])
+                             / (coarse->centres[axis][other] - coarse->centres[axis][parent]);
+    }
+  }
+
+  coarse->ownFlags = dim == 2
+                       ? std::make_unique<IntScalarField>(coarse->sizes[0] + 3, coarse->sizes[1] + 3)
+                       : std::make_unique<IntScalarField>(coarse->sizes[0] + 3, coarse->sizes[1] + 3, coarse->sizes[2] + 3);
+  coarse->flags = coarse->ownFlags.get();
+  updateCoarseFlags(fine, *coarse);
+
+  coarse->ownOperator      = std::make_unique<PressureOperator>(dim, coarse->sizes, spacings);
+  coarse->pressureOperator = coarse->ownOperator.get();
+  coarse->pressureOperator->update(*coarse->flags);
+
+  levels_.push_back(std::move(coarse));
+}
+
+void Solvers::MultigridSolver::getChildren(
+  const Level& fine, const Level& coarse, int axis, int index, int& first, int& last
+) const {
+  if (!coarse.coarsened[axis] || index <= 1) {
+    first = index;
+    last  = index;
+  } else if (index >= coarse.sizes[axis] + 2) {
+    // Upper ghost layer
+    first = fine.sizes[axis] + 2;
+    last  = first;
+  } else {
+    first = 2 + 2 * (index - 2);
+    last  = std::min(first + 1, fine.sizes[axis] + 1);
+  }
+}
+
+void Solvers::MultigridSolver::updateCoarseFlags(const Level& fine, Level& coarse) {
+  const int       dim   = parameters_.geometry.dim;
+  IntScalarField& flags = *coarse.flags;
+
+  const int firstK = dim == 3 ? 1 : 0;
+  const int lastK  = dim == 3 ? coarse.sizes[2] + 2 : 0;
+
+  // A coarse cell, ghost layers included, is an obstacle if all its children are
+  for (int k = firstK; k <= lastK; k++) {
+    int firstChildK, lastChildK;
+    getChildren(fine, coarse, 2, k, firstChildK, lastChildK);
+    for (int j = 1; j < coarse.sizes[1] + 3; j++) {
+      int firstChildJ, lastChildJ;
+      getChildren(fine, coarse, 1, j, firstChildJ, lastChildJ);
+      for (int i = 1; i < coarse.sizes[0] + 3; i++) {
+        int firstChildI, lastChildI;
+        getChildren(fine, coarse, 0, i, firstChildI, lastChildI);
+
+        bool obstacle = true;
+        for (int kk = firstChildK; kk <= lastChildK; kk++) {
+          for (int jj = firstChildJ; jj <= lastChildJ; jj++) {
+            for (int ii = firstChildI; ii <= lastChildI; ii++) {
+              obstacle = obstacle && (fine.flags->getValue(ii, jj, kk) & OBSTACLE_SELF);
+            }
+          }
+        }
+        flags.getValue(i, j, k) = obstacle ? OBSTACLE_SELF : 0;
+      }
+    }
+  }
+
+  const auto isObstacle = [&flags](int i, int j, int k) { return (flags.getValue(i, j, k) & OBSTACLE_SELF) != 0; };
+
+  for (int k = dim == 3 ? 2 : 0; k <= (dim == 3 ? coarse.sizes[2] + 1 : 0); k++) {
+    for (int j = 2; j < coarse.sizes[1] + 2; j++) {
+      for (int i = 2; i < coarse.sizes[0] + 2; i++) {
+        int& value = flags.getValue(i, j, k);
+        value += isObstacle(i - 1, j, k) ? OBSTACLE_LEFT : 0;
+        value += isObstacle(i + 1, j, k) ? OBSTACLE_RIGHT : 0;
+        value += isObstacle(i, j - 1, k) ? OBSTACLE_BOTTOM : 0;
+        value += isObstacle(i, j + 1, k) ? OBSTACLE_TOP : 0;
+        if (dim == 3) {
+          value += isObstacle(i, j, k - 1) ? OBSTACLE_FRONT : 0;
+          value += isObstacle(i, j, k + 1) ? OBSTACLE_BACK : 0;
+        }
+      }
+    }
+  }
+}
+
+void Solvers::MultigridSolver::updateCoefficients(Level& level) {
+  const PressureOperator& pressureOperator = *level.pressureOperator;
+  const RealType* const   centreX          = pressureOperator.getCentre(0);
+  const RealType* const   centreY          = pressureOperator.getCentre(1);
+  const bool              is3D             = parameters_.geometry.dim == 3;
+
+  for (int axis = 0; axis < parameters_.geometry.dim; axis++) {
+    const RealType* const lower = pressureOperator.getLower(axis);
+    const RealType* const upper = pressureOperator.getUpper(axis);
+    level.values.lower[axis].assign(lower, lower + level.sizes[axis] + 3);
+    level.values.upper[axis].assign(upper, upper + level.sizes[axis] + 3);
+  }
+
+  std::vector<RealType>& inverseDiagonal = level.values.inverseDiagonal;
+  for (int k = is3D ? 2 : 0; k <= (is3D ? level.sizes[2] + 1 : 0); k++) {
+    const RealType centreZ = is3D ? pressureOperator.getCentre(2)[k] : 0.0;
+    for (int j = 2; j < level.sizes[1] + 2; j++) {
+      for (int i = 2; i < level.sizes[0] + 2; i++) {
+        inverseDiagonal[i + level.strides[1] * j + level.strides[2] * k] = 1.0 / (centreX[i] + centreY[j] + centreZ);
+      }
+    }
+  }
+
+  const std::vector<PressureOperator::ObstacleRow>& obstacleRows = pressureOperator.getObstacleRows();
+  std::fill(level.obstacleRows.begin(), level.obstacleRows.end(), -1);
+  for (size_t n = 0; n < obstacleRows.size(); n++) {
+    inverseDiagonal[obstacleRows[n].index]    = 1.0 / obstacleRows[n].values[PressureOperator::Centre];
+    level.obstacleRows[obstacleRows[n].index] = static_cast<int>(n);
+  }
+
+  if (mixedPrecision_) {
+    for (int axis = 0; axis < parameters_.geometry.dim; axis++) {
+      level.singleValues.lower[axis].assign(level.values.lower[axis].begin(), level.values.lower[axis].end());
+      level.singleValues.upper[axis].assign(level.values.upper[axis].begin(), level.values.upper[axis].end());
+    }
+    level.singleValues.inverseDiagonal.assign(inverseDiagonal.begin(), inverseDiagonal.end());
+  }
+}
+
+void Solvers::MultigridSolver::reInitMatrix() {
+  LinearSolver::reInitMatrix();
+
+  for (size_t l = 1; l < levels_.size(); l++) {
+    updateCoarseFlags(*levels_[l - 1], *levels_[l]);
+    levels_[l]->pressureOperator->update(*levels_[l]->flags);
+  }
+  for (auto& level : levels_) {
+    updateCoefficients(*level);
+  }
+}
+
+// Explicit row of an obstacle cell without its centre entry, applied to the pressure around the linear index
+template <int Dim, typename Scalar>
+static inline RealType obstacleNeighbours(
+  const Solvers::PressureOperator::ObstacleRow& row, const Scalar* p, int strideY, int strideZ
+) {
+  const int index = row.index;
+  RealType  value = row.values[Solvers::PressureOperator::West] * p[index - 1]
+                   + row.values[Solvers::PressureOperator::East] * p[index + 1]
+                   + row.values[Solvers::PressureOperator::South] * p[index - strideY]
+                   + row.values[Solvers::PressureOperator::North] * p[index + strideY];
+  if constexpr (Dim == 3) {
+    value += row.values[Solvers::PressureOperator::Bottom] * p[index - strideZ]
+             + row.values[Solvers::PressureOperator::Top] * p[index + strideZ];
+  }
+  return value;
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::updateGhosts(Level& level, bool homogeneous) {
+  const int nx = level.sizes[0], ny = level.sizes[1], nz = level.sizes[2];
+  const int sy = level.strides[1], sz = level.strides[2];
+
+  const int firstK = Dim == 3 ? 2 : 0;
+  const int lastK  = Dim == 3 ? nz + 1 : 0;
+
+  Scalar lower[3], upper[3];
+  for (int axis = 0; axis < 3; axis++) {
+    lower[axis] = homogeneous ? Scalar(0) : static_cast<Scalar>(lowerValues_[axis]);
+    upper[axis] = homogeneous ? Scalar(0) : static_cast<Scalar>(upperValues_[axis]);
+  }
+
+  Scalar* const p = level.get<Scalar>().pressure.data();
+
+  // Left and right
+  for (int k = firstK; k <= lastK; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      Scalar* const line = p + j * sy + k * sz;
+      line[1]            = getGhostValue(lowerFaces_[0], line[2], line[nx + 1], lower[0]);
+      line[nx + 2]       = getGhostValue(upperFaces_[0], line[nx + 1], line[2], upper[0]);
+    }
+  }
+
+  // Bottom and top, including the ghost cells in x
+  for (int k = firstK; k <= lastK; k++) {
+    for (int i = 1; i < nx + 3; i++) {
+      Scalar* const line  = p + i + k * sz;
+      line[sy]            = getGhostValue(lowerFaces_[1], line[2 * sy], line[(ny + 1) * sy], lower[1]);
+      line[(ny + 2) * sy] = getGhostValue(upperFaces_[1], line[(ny + 1) * sy], line[2 * sy], upper[1]);
+    }
+  }
+
+  // Front and back, including the ghost cells in x and y
+  if constexpr (Dim == 3) {
+    for (int j = 1; j < ny + 3; j++) {
+      for (int i = 1; i < nx + 3; i++) {
+        Scalar* const line  = p + i + j * sy;
+        line[sz]            = getGhostValue(lowerFaces_[2], line[2 * sz], line[(nz + 1) * sz], lower[2]);
+        line[(nz + 2) * sz] = getGhostValue(upperFaces_[2], line[(nz + 1) * sz], line[2 * sz], upper[2]);
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::computeResidual(Level& level) {
+  const PressureOperator& pressureOperator = *level.pressureOperator;
+  Values<Scalar>&         values           = level.get<Scalar>();
+
+  const Scalar* const a_W = values.lower[0].data();
+  const Scalar* const a_E = values.upper[0].data();
+  const Scalar* const a_S = values.lower[1].data();
+  const Scalar* const a_N = values.upper[1].data();
+  const Scalar* const a_B = Dim == 3 ? values.lower[2].data() : nullptr;
+  const Scalar* const a_T = Dim == 3 ? values.upper[2].data() : nullptr;
+
+  const int nx = level.sizes[0], ny = level.sizes[1], nz = level.sizes[2];
+  const int sy = level.strides[1], sz = level.strides[2];
+
+  const Scalar* const p    = values.pressure.data();
+  const Scalar* const rhs  = values.rhs.data();
+  const Scalar* const diag = values.inverseDiagonal.data();
+  Scalar* const       r    = values.residual.data();
+
+  for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? nz + 1 : 0); k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      for (int i = 2; i < nx + 2; i++) {
+        const int index = i + j * sy + k * sz;
+        Scalar    value = rhs[index] - a_W[i] * p[index - 1] - a_E[i] * p[index + 1] - a_S[j] * p[index - sy]
+                         - a_N[j] * p[index + sy] - p[index] / diag[index];
+        if constexpr (Dim == 3) {
+          value -= a_B[k] * p[index - sz] + a_T[k] * p[index + sz];
+        }
+        r[index] = value;
+      }
+    }
+  }
+
+  for (const auto& row : pressureOperator.getObstacleRows()) {
+    r[row.index] = static_cast<Scalar>(rhs[row.index] - obstacleNeighbours<Dim>(row, p, sy, sz) - p[row.index] / diag[row.index]);
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::smooth(Level& level, int sweeps, bool homogeneous) {
+  if (parameters_.solver.smoother == WeightedJacobi) {
+    smoothJacobi<Dim, Scalar>(level, sweeps, homogeneous);
+  } else if (parameters_.solver.smoother == LineGaussSeidel) {
+    smoothLines<Dim, Scalar>(level, sweeps, homogeneous);
+  } else {
+    smoothRedBlack<Dim, Scalar>(level, sweeps, homogeneous);
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::smoothRedBlack(Level& level, int sweeps, bool homogeneous) {
+  const PressureOperator& pressureOperator = *level.pressureOperator;
+  Values<Scalar>&         values           = level.get<Scalar>();
+
+  const Scalar* const a_W = values.lower[0].data();
+  const Scalar* const a_E = values.upper[0].data();
+  const Scalar* const a_S = values.lower[1].data();
+  const Scalar* const a_N = values.upper[1].data();
+  const Scalar* const a_B = Dim == 3 ? values.lower[2].data() : nullptr;
+  const Scalar* const a_T = Dim == 3 ? values.upper[2].data() : nullptr;
+
+  const int nx = level.sizes[0], ny = level.sizes[1], nz = level.sizes[2];
+  const int sy = level.strides[1], sz = level.strides[2];
+
+  Scalar* const       p    = values.pressure.data();
+  const Scalar* const rhs  = values.rhs.data();
+  const Scalar* const diag = values.inverseDiagonal.data();
+
+  const std::vector<PressureOperator::ObstacleRow>& obstacleRows = pressureOperator.getObstacleRows();
+
+  for (int sweep = 0; sweep < sweeps; sweep++) {
+    for (int colour = 0; colour < 2; colour++) {
+      for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? nz + 1 : 0); k++) {
+        for (int j = 2; j < ny + 2; j++) {
+          for (int i = 2 + ((colour + j + k) & 1); i < nx + 2; i += 2) {
+            const int index = i + j * sy + k * sz;
+            Scalar    value = rhs[index] - a_W[i] * p[index - 1] - a_E[i] * p[index + 1] - a_S[j] * p[index - sy]
+                             - a_N[j] * p[index + sy];
+            if constexpr (Dim == 3) {
+              value -= a_B[k] * p[index - sz] + a_T[k] * p[index + sz];
+            }
+            p[index] = value * diag[index];
+          }
+        }
+      }
+
+      // Obstacle rows only couple to the other colour, so the fluid update above can simply be overwritten
+      for (const auto& row : obstacleRows) {
+        if (((row.i + row.j + row.k) & 1) == colour) {
+          p[row.index] = static_cast<Scalar>((rhs[row.index] - obstacleNeighbours<Dim>(row, p, sy, sz)) * diag[row.index]);
+        }
+      }
+
+      updateGhosts<Dim, Scalar>(level, homogeneous);
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::smoothJacobi(Level& level, int sweeps, bool homogeneous) {
+  // Damping factor that minimises the amplification of the high frequencies for the uniform Laplacian
+  const Scalar omega = Dim == 3 ? Scalar(6.0 / 7.0) : Scalar(4.0 / 5.0);
+
+  const int nx = level.sizes[0], ny = level.sizes[1], nz = level.sizes[2];
+  const int sy = level.strides[1], sz = level.strides[2];
+
+  Values<Scalar>&     values = level.get<Scalar>();
+  Scalar* const       p      = values.pressure.data();
+  const Scalar* const r      = values.residual.data();
+  const Scalar* const diag   = values.inverseDiagonal.data();
+
+  for (int sweep = 0; sweep < sweeps; sweep++) {
+    computeResidual<Dim, Scalar>(level);
+    for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? nz + 1 : 0); k++) {
+      for (int j = 2; j < ny + 2; j++) {
+        for (int i = 2; i < nx + 2; i++) {
+          const int index = i + j * sy + k * sz;
+          p[index] += omega * r[index] * diag[index];
+        }
+      }
+    }
+    updateGhosts<Dim, Scalar>(level, homogeneous);
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::smoothLines(Level& level, int sweeps, bool homogeneous) {
+  for (int sweep = 0; sweep < sweeps; sweep++) {
+    // Alternate the direction of the lines, the lines of one direction are coloured like a chessboard in the
+    // remaining axes
+    for (int axis = 0; axis < Dim; axis++) {
+      const int first  = (axis + 1) % Dim;
+      const int second = (axis + 2) % Dim;
+
+      for (int colour = 0; colour < 2; colour++) {
+        lineBases_.clear();
+        lineCoordinates_.clear();
+        for (int c = Dim == 3 ? 2 : 0; c <= (Dim == 3 ? level.sizes[second] + 1 : 0); c++) {
+          for (int b = 2; b < level.sizes[first] + 2; b++) {
+            if (((b + c + colour) & 1) != 0) {
+              continue;
+            }
+            int coordinates[3] = {0, 0, 0};
+            coordinates[first] = b;
+            int base           = b * level.strides[first];
+            if constexpr (Dim == 3) {
+              coordinates[second] = c;
+              base += c * level.strides[second];
+            }
+            lineBases_.push_back(base);
+            lineCoordinates_.insert(lineCoordinates_.end(), coordinates, coordinates + 3);
+          }
+        }
+
+        // The lines of one colour do not couple to each other
+        const int lines = static_cast<int>(lineBases_.size());
+        for (int line = 0; line < lines; line += lineBatch_) {
+          solveLines<Dim, Scalar>(level, axis, line, std::min(lineBatch_, lines - line), homogeneous);
+        }
+        updateGhosts<Dim, Scalar>(level, homogeneous);
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::solveLines(Level& level, int axis, int first, int lanes, bool homogeneous) {
+  const PressureOperator&                           pressureOperator = *level.pressureOperator;
+  const std::vector<PressureOperator::ObstacleRow>& obstacleRows     = pressureOperator.getObstacleRows();
+
+  constexpr int width = lineBatch_;
+
+  const int size   = level.sizes[axis];
+  const int stride = level.strides[axis];
+
+  Values<Scalar>&     levelValues = level.get<Scalar>();
+  Scalar* const       p           = levelValues.pressure.data();
+  const Scalar* const rhs         = levelValues.rhs.data();
+  const Scalar* const diag        = levelValues.inverseDiagonal.data();
+
+  const int* const bases       = lineBases_.data() + first;
+  const int* const coordinates = lineCoordinates_.data() + 3 * first;
+
+  // The unknowns of the lanes are interleaved, entry m * width + l belongs to cell m of lane l
+  if (static_cast<int>(lineFactors_.size()) < (size + 3) * width) {
+    lineFactors_.resize((size + 3) * width);
+    lineValues_.resize((size + 3) * width);
+  }
+  RealType* const factors = lineFactors_.data();
+  RealType* const values  = lineValues_.data();
+  for (int l = 0; l < width; l++) {
+    factors[width + l] = 0.0;
+    values[width + l]  = 0.0;
+  }
+
+  const Scalar* const lower = levelValues.lower[axis].data();
+  const Scalar* const upper = levelValues.upper[axis].data();
+
+  // Forward elimination of the tridiagonal systems. The rows are gathered per lane, the unused lanes of the last batch
+  // get the identity, so that the elimination runs over the full width.
+  RealType a[width], b[width], c[width], value[width];
+  for (int m = 2; m < size + 2; m++) {
+    for (int l = 0; l < width; l++) {
+      if (l >= lanes) {
+        a[l]     = 0.0;
+        b[l]     = 1.0;
+        c[l]     = 0.0;
+        value[l] = 0.0;
+        continue;
+      }
+
+      const int base  = bases[l];
+      const int index = base + m * stride;
+      const int row   = level.obstacleRows[index];
+
+      value[l] = rhs[index];
+      if (row < 0) {
+        a[l] = lower[m];
+        c[l] = upper[m];
+        b[l] = 1.0 / diag[index];
+        for (int other = 0; other < Dim; other++) {
+          if (other != axis) {
+            const int n = coordinates[3 * l + other], s = level.strides[other];
+            value[l] -= levelValues.lower[other][n] * p[index - s] + levelValues.upper[other][n] * p[index + s];
+          }
+        }
+      } else {
+        const RealType* const coefficients = obstacleRows[row].values;
+        a[l]                               = coefficients[2 * axis];
+        c[l]                               = coefficients[2 * axis + 1];
+        b[l]                               = coefficients[PressureOperator::Centre];
+        for (int other = 0; other < Dim; other++) {
+          if (other != axis) {
+            const int s = level.strides[other];
+            value[l] -= coefficients[2 * other] * p[index - s] + coefficients[2 * other + 1] * p[index + s];
+          }
+        }
+      }
+
+      // Ghost cells at the ends of the line, see getGhostValue()
+      if (m == 2) {
+        const FaceType type = lowerFaces_[axis];
+        if (type == NeumannFace) {
+          b[l] += a[l];
+        } else if (type == DirichletFace) {
+          b[l] -= a[l];
+          value[l] -= 2.0 * a[l] * (homogeneous ? 0.0 : lowerValues_[axis]);
+        } else {
+          value[l] -= a[l] * p[base + (size + 1) * stride];
+        }
+        a[l] = 0.0;
+      }
+      if (m == size + 1) {
+        const FaceType type = upperFaces_[axis];
+        if (type == NeumannFace) {
+          b[l] += c[l];
+        } else if (type == DirichletFace) {
+          b[l] -= c[l];
+          value[l] -= 2.0 * c[l] * (homogeneous ? 0.0 : upperValues_[axis]);
+        } else {
+          value[l] -= c[l] * p[base + 2 * stride];
+        }
+        c[l] = 0.0;
+      }
+    }
+
+    RealType* const       factor         = factors + m * width;
+    RealType* const       current        = values + m * width;
+    const RealType* const previousFactor = factors + (m - 1) * width;
+    const RealType* const previous       = values + (m - 1) * width;
+#ifdef ENABLE_OPENMP
+#pragma omp simd
+#endif
+    for (int l = 0; l < width; l++) {
+      const RealType denominator = b[l] - a[l] * previousFactor[l];
+      factor[l]                  = c[l] / denominator;
+      current[l]                 = (value[l] - a[l] * previous[l]) / denominator;
+    }
+  }
+
+  // Back substitution
+  for (int m = size; m >= 2; m--) {
+    RealType* const       current = values + m * width;
+    const RealType* const next    = values + (m + 1) * width;
+    const RealType* const factor  = factors + m * width;
+#ifdef ENABLE_OPENMP
+#pragma omp simd
+#endif
+    for (int l = 0; l < width; l++) {
+      current[l] -= factor[l] * next[l];
+    }
+  }
+
+  for (int l = 0; l < lanes; l++) {
+    for (int m = 2; m < size + 2; m++) {
+      Scalar& pressure = p[bases[l] + m * stride];
+      pressure += lineOmega_ * (values[m * width + l] - pressure);
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::restrictResidual(Level& fine, Level& coarse) {
+  computeResidual<Dim, Scalar>(fine);
+
+  std::vector<Scalar>& residual = fine.get<Scalar>().residual;
+  std::vector<Scalar>& rhs      = coarse.get<Scalar>().rhs;
+
+  // The rows of obstacle cells are not part of the coarse problem
+  for (const auto& row : fine.pressureOperator->getObstacleRows()) {
+    residual[row.index] = Scalar(0);
+  }
+
+  const RealType* const fineX   = fine.duals[0].data();
+  const RealType* const fineY   = fine.duals[1].data();
+  const RealType* const fineZ   = Dim == 3 ? fine.duals[2].data() : nullptr;
+  const RealType* const coarseX = coarse.duals[0].data();
+  const RealType* const coarseY = coarse.duals[1].data();
+  const RealType* const coarseZ = Dim == 3 ? coarse.duals[2].data() : nullptr;
+
+  for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? coarse.sizes[2] + 1 : 0); k++) {
+    int firstK = 0, lastK = 0;
+    if constexpr (Dim == 3) {
+      getChildren(fine, coarse, 2, k, firstK, lastK);
+    }
+    for (int j = 2; j < coarse.sizes[1] + 2; j++) {
+      int firstJ, lastJ;
+      getChildren(fine, coarse, 1, j, firstJ, lastJ);
+      for (int i = 2; i < coarse.sizes[0] + 2; i++) {
+        int firstI, lastI;
+        getChildren(fine, coarse, 0, i, firstI, lastI);
+
+        // Sum of the fluxes through the dual cells of the children
+        RealType sum = 0.0;
+        for (int kk = firstK; kk <= lastK; kk++) {
+          for (int jj = firstJ; jj <= lastJ; jj++) {
+            for (int ii = firstI; ii <= lastI; ii++) {
+              sum += fineX[ii] * fineY[jj] * (Dim == 3 ? fineZ[kk] : 1.0)
+                     * residual[ii + jj * fine.strides[1] + kk * fine.strides[2]];
+            }
+          }
+        }
+        rhs[i + j * coarse.strides[1] + k * coarse.strides[2]] = static_cast<Scalar>(sum / (coarseX[i] * coarseY[j] * (Dim == 3 ? coarseZ[k] : 1.0)));
+      }
+    }
+  }
+
+  for (const auto& row : coarse.pressureOperator->getObstacleRows()) {
+    rhs[row.index] = Scalar(0);
+  }
+  std::fill(coarse.get<Scalar>().pressure.begin(), coarse.get<Scalar>().pressure.end(), Scalar(0));
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::prolongate(const Level& coarse, Level& fine) {
+  const int nx = fine.sizes[0], ny = fine.sizes[1], nz = fine.sizes[2];
+  const int sy = fine.strides[1], sz = fine.strides[2];
+
+  const Scalar* const e = coarse.get<Scalar>().pressure.data();
+  Scalar* const       p = fine.get<Scalar>().pressure.data();
+
+  for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? nz + 1 : 0); k++) {
+    int      parentK = 0, otherK = 0;
+    RealType wz      = 0.0;
+    if constexpr (Dim == 3) {
+      parentK = fine.parent[2][k] * coarse.strides[2];
+      otherK  = fine.other[2][k] * coarse.strides[2];
+      wz      = fine.weight[2][k];
+    }
+    for (int j = 2; j < ny + 2; j++) {
+      const int      parentJ = fine.parent[1][j] * coarse.strides[1];
+      const int      otherJ  = fine.other[1][j] * coarse.strides[1];
+      const RealType wy      = fine.weight[1][j];
+      for (int i = 2; i < nx + 2; i++) {
+        const int      parentI = fine.parent[0][i];
+        const int      otherI  = fine.other[0][i];
+        const RealType wx      = fine.weight[0][i];
+
+        const auto bilinear = [&](int offsetK) {
+          return (1.0 - wy) * ((1.0 - wx) * e[parentI + parentJ + offsetK] + wx * e[otherI + parentJ + offsetK])
+                 + wy * ((1.0 - wx) * e[parentI + otherJ + offsetK] + wx * e[otherI + otherJ + offsetK]);
+        };
+
+        RealType correction = bilinear(parentK);
+        if constexpr (Dim == 3) {
+          correction = (1.0 - wz) * correction + wz * bilinear(otherK);
+        }
+        p[i + j * sy + k * sz] += static_cast<Scalar>(correction);
+      }
+    }
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::removeIncompatibleRhs(Level& level) {
+  // The dual cells of the operator are orthogonal to its range, see Level::duals
+  const auto weight = [&level](int i, int j, int k) {
+    return level.duals[0][i] * level.duals[1][j] * (Dim == 3 ? level.duals[2][k] : 1.0);
+  };
+  std::vector<Scalar>& rhs = level.get<Scalar>().rhs;
+
+  RealType sum = 0.0, total = 0.0;
+  for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? level.sizes[2] + 1 : 0); k++) {
+    for (int j = 2; j < level.sizes[1] + 2; j++) {
+      for (int i = 2; i < level.sizes[0] + 2; i++) {
+        sum += weight(i, j, k) * rhs[i + j * level.strides[1] + k * level.strides[2]];
+        total += weight(i, j, k);
+      }
+    }
+  }
+  // The right hand side of obstacle rows is zero
+  for (const auto& row : level.pressureOperator->getObstacleRows()) {
+    total -= weight(row.i, row.j, row.k);
+  }
+  if (total <= 0.0) {
+    return;
+  }
+
+  const Scalar mean = static_cast<Scalar>(sum / total);
+  for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? level.sizes[2] + 1 : 0); k++) {
+    for (int j = 2; j < level.sizes[1] + 2; j++) {
+      for (int i = 2; i < level.sizes[0] + 2; i++) {
+        rhs[i + j * level.strides[1] + k * level.strides[2]] -= mean;
+      }
+    }
+  }
+  for (const auto& row : level.pressureOperator->getObstacleRows()) {
+    rhs[row.index] = Scalar(0);
+  }
+}
+
+template <int Dim, typename Scalar>
+void Solvers::MultigridSolver::cycle(int l, int type) {
+  Level& level = *levels_[l];
+  // In single precision, the finest level solves for the correction of a refinement step, see refine()
+  const bool homogeneous = l > 0 || std::is_same_v<Scalar, float>;
+
+  if (l + 1 == static_cast<int>(levels_.size())) {
+    if (singular_) {
+      removeIncompatibleRhs<Dim, Scalar>(level);
+    }
+    if (lineRelaxation_) {
+      smoothLines<Dim, Scalar>(level, 1, homogeneous);
+    } else {
+      smoothRedBlack<Dim, Scalar>(level, coarsestSweeps_, homogeneous);
+    }
+    return;
+  }
+
+  Level& coarse = *levels_[l + 1];
+
+  smooth<Dim, Scalar>(level, parameters_.solver.preSmoothing, homogeneous);
+  restrictResidual<Dim, Scalar>(level, coarse);
+
+  if (type == FCycle) {
+    cycle<Dim, Scalar>(l + 1, FCycle);
+    cycle<Dim, Scalar>(l + 1, VCycle);
+  } else if (type == WCycle) {
+    cycle<Dim, Scalar>(l + 1, WCycle);
+    cycle<Dim, Scalar>(l + 1, WCycle);
+  } else {
+    cycle<Dim, Scalar>(l + 1, VCycle);
+  }
+
+  prolongate<Dim, Scalar>(coarse, level);
+  updateGhosts<Dim, Scalar>(level, homogeneous);
+  smooth<Dim, Scalar>(level, parameters_.solver.postSmoothing, homogeneous);
+}
+
+template <int Dim>
+RealType Solvers::MultigridSolver::residualNorm() {
+  Level& level = *levels_[0];
+  computeResidual<Dim, RealType>(level);
+
+  RealType resnorm = 0.0;
+  for (int k = Dim == 3 ? 2 : 0; k <= (Dim == 3 ? level.sizes[2] + 1 : 0); k++) {
+    for (int j = 2; j < level.sizes[1] + 2; j++) {
+      for (int i = 2; i < level.sizes[0] + 2; i++) {
+        const RealType residual = level.values.residual[i + j * level.strides[1] + k * level.strides[2]];
+        resnorm += residual * residual;
+      }
+    }
+  }
+  return sqrt(resnorm / (level.sizes[0] * level.sizes[1] * (Dim == 3 ? level.sizes[2] : 1)));
+}
+
+template <int Dim>
+void Solvers::MultigridSolver::cycleCorrection(const RealType* residual) {
+  Values<float>& single = levels_[0]->singleValues;
+
+  std::copy(residual, residual + single.rhs.size(), single.rhs.begin());
+  std::fill(single.pressure.begin(), single.pressure.end(), 0.0f);
+  cycle<Dim, float>(0, parameters_.solver.cycle);
+}
+
+template <int Dim>
+void Solvers::MultigridSolver::refine() {
+  Level&         level  = *levels_[0];
+  Values<float>& single = level.singleValues;
+
+  cycleCorrection<Dim>(level.values.residual.data());
+
+  std::vector<RealType>& pressure = level.values.pressure;
+  for (size_t n = 0; n < pressure.size(); n++) {
+    pressure[n] += single.pressure[n];
+  }
+  updateGhosts<Dim, RealType>(level, false);
+}
+
+template <int Dim>
+int Solvers::MultigridSolver::iterate() {
+  // Without a Dirichlet boundary, only the part of the right hand side in the range of the operator can be matched.
+  // This removes the inconsistency that the discretisation leaves on non-uniform meshes.
+  if (singular_) {
+    removeIncompatibleRhs<Dim, RealType>(*levels_[0]);
+  }
+  updateGhosts<Dim, RealType>(*levels_[0], false);
+
+  RealType resnorm = residualNorm<Dim>();
+  int      cycles  = 0;
+  bool     single  = mixedPrecision_;
+  while (resnorm > tolerance_ && cycles < maxCycles_) {
+    const RealType previous = resnorm;
+    if (single) {
+      const Clock clock;
+      refine<Dim>();
+      singleTime_ += clock.getTime();
+      singleIterations_++;
+    } else {
+      cycle<Dim, RealType>(0, parameters_.solver.cycle);
+    }
+    resnorm = residualNorm<Dim>();
+    spdlog::debug("Residual norm : {}", resnorm);
+    cycles++;
+
+    // The refinement stagnates once the single-precision cycle cannot resolve the residual any more
+    single = single && resnorm < previous;
+  }
+
+  if (resnorm > tolerance_) {
+    spdlog::warn("MultigridSolver did not converge within {} cycles, residual norm {}", cycles, resnorm);
+  }
+  return cycles;
+}
+
+void Solvers::MultigridSolver::solve() {
+  Level&       level = *levels_[0];
+  ScalarField& P     = flowField_.getPressure();
+  ScalarField& RHS   = flowField_.getRHS();
+
+  const int dim   = parameters_.geometry.dim;
+  const int lastK = dim == 3 ? level.sizes[2] + 2 : 0;
+
+  std::vector<RealType>& pressure = level.values.pressure;
+  std::vector<RealType>& rhs      = level.values.rhs;
+  for (int k = 0; k <= lastK; k++) {
+    for (int j = 0; j < level.sizes[1] + 3; j++) {
+      for (int i = 0; i < level.sizes[0] + 3; i++) {
+        const int index = i + j * level.strides[1] + k * level.strides[2];
+        pressure[index] = P.getScalar(i, j, k);
+        rhs[index]      = RHS.getScalar(i, j, k);
+      }
+    }
+  }
+  for (const auto& row : pressureOperator_.getObstacleRows()) {
+    rhs[row.index] = 0.0;
+  }
+
+  singleIterations_ = 0;
+  singleTime_       = 0;
+  const int cycles  = dim == 3 ? iterate<3>() : iterate<2>();
+
+  for (int k = 0; k <= lastK; k++) {
+    for (int j = 0; j < level.sizes[1] + 3; j++) {
+      for (int i = 0; i < level.sizes[0] + 3; i++) {
+        P.getScalar(i, j, k) = pressure[i + j * level.strides[1] + k * level.strides[2]];
+      }
+    }
+  }
+
+  spdlog::debug("MultigridSolver needed {} cycles", cycles);
+  iterations_ = cycles;
+}
+
+void Solvers::MultigridSolver::applyCycle(const RealType* residual, RealType* correction) {
+  Level&         level  = *levels_[0];
+  Values<float>& single = level.singleValues;
+
+  if (parameters_.geometry.dim == 3) {
+    cycleCorrection<3>(residual);
+    updateGhosts<3, float>(level, true);
+  } else {
+    cycleCorrection<2>(residual);
+    updateGhosts<2, float>(level, true);
+  }
+  std::copy(single.pressure.begin(), single.pressure.end(), correction);
+}
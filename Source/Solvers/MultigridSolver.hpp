@@ -0,0 +1,198 @@
+#pragma once
+
+#include "LinearSolver.hpp"
+
+namespace Solvers {
+
+  /** Geometric multigrid solver for the pressure equation
+   *
+   * The grid hierarchy halves the number of cells along the axes with the finest mean meshsize, until no axis can be
+   * coarsened any more. Coarsening only these axes (semi-coarsening) makes the cells of the coarse levels more
+   * isotropic on meshes with different meshsizes per axis. A coarse cell merges two neighbouring fine cells; its
+   * meshsize is the sum of the ones of its children, so that stretched meshes stay stretched on the coarse levels. The
+   * operator of each level is the discretisation of the Laplacian on this level, see PressureOperator. A coarse cell
+   * is an obstacle if all its children are.
+   *
+   * The residual is restricted by summing the fluxes over the fluid children, which keeps the coarse problems
+   * compatible on non-uniform meshes. The correction is interpolated linearly between the coarse cell centres.
+   * Red-black Gauss-Seidel, weighted Jacobi or alternating red-black line Gauss-Seidel are used as smoothers. Point
+   * smoothers degrade on cells with a large aspect ratio, as they appear on stretched meshes; the line smoother solves
+   * for all cells along a line at once and stays efficient there. The coarsest level is solved with a fixed number of
+   * red-black sweeps.
+   *
+   * With the solver type line, the hierarchy only has the finest level and each cycle is one sweep of the line
+   * smoother, i.e., the solver is an alternating-direction zebra line Gauss-Seidel iteration, over-relaxed with the
+   * solver option omega. Without coarse grid correction it needs far more sweeps than the cycles, but unlike point SOR
+   * it still converges on the anisotropic cells near the walls of stretched meshes.
+   *
+   * The pressure boundaries follow the PETSc assembly: walls with Dirichlet velocity conditions use a homogeneous
+   * Neumann condition for the pressure, walls with Neumann velocity conditions a Dirichlet condition. Periodic axes
+   * are supported if they are not split among several processes. As the SOR solver, the solver works on the local
+   * subdomain only and treats the faces to neighbouring processes as Neumann boundaries.
+   *
+   * With mixed precision, every cycle is a step of an iterative refinement: the residual of the pressure is computed in
+   * double precision and the correction is approximated by one cycle in single precision, with homogeneous boundary
+   * values, which halves the memory traffic of the smoothers and the grid transfers. The reduction of the residual by a
+   * cycle stays far above the rounding errors of single precision, so the refinement needs as many cycles as a
+   * double-precision solve. If it stagnates, the remaining cycles run in double precision. The per-axis
+   * coefficients and the inverse diagonal are stored in both precisions; the obstacle rows, the grid transfer weights
+   * and the Thomas algorithm of the line smoother stay in double precision.
+   */
+  class MultigridSolver: public LinearSolver {
+  private:
+
+    // Vectors and operator coefficients of a level in the precision Scalar
+    template <typename Scalar>
+    struct Values {
+      std::vector<Scalar> lower[3]; //! Per-axis coefficients, see PressureOperator
+      std::vector<Scalar> upper[3];
+
+      std::vector<Scalar> pressure;
+      std::vector<Scalar> rhs;
+      std::vector<Scalar> residual;
+      std::vector<Scalar> inverseDiagonal;
+    };
+
+    struct Level {
+      int  sizes[3];     //! Number of inner cells per axis
+      int  strides[3];   //! Strides of the linear index, see PressureOperator::getLinearIndex()
+      bool coarsened[3]; //! If the axis was coarsened with respect to the next finer level
+
+      std::vector<RealType> spacings[3]; //! Meshsizes of the cells -1 to size + 3, stored at index + 1
+      std::vector<RealType> centres[3];  //! Cell centres of the cells 0 to size + 2, relative to the lower face
+
+      // Distance between the midpoints to the lower and upper neighbour. Row n of the operator along an axis is the
+      // difference of the fluxes to both neighbours divided by this length, with symmetric fluxes.
+      std::vector<RealType> duals[3];
+
+      // Interpolation from the next coarser level, per axis and local index: the value of cell i is
+      // (1 - weight[i]) * coarse(parent[i]) + weight[i] * coarse(other[i])
+      std::vector<int>      parent[3];
+      std::vector<int>      other[3];
+      std::vector<RealType> weight[3];
+
+      // The finest level uses the flags and operator of the flow field
+      std::unique_ptr<IntScalarField>   ownFlags;
+      std::unique_ptr<PressureOperator> ownOperator;
+      IntScalarField*                   flags;
+      PressureOperator*                 pressureOperator;
+
+      Values<RealType> values;
+      Values<float>    singleValues; //! Only allocated with mixed precision
+      std::vector<int> obstacleRows; //! Position of the cell in the obstacle rows of the operator, -1 for fluid
+
+      template <typename Scalar>
+      Values<Scalar>& get() {
+        if constexpr (std::is_same_v<Scalar, float>) {
+          return singleValues;
+        } else {
+          return values;
+        }
+      }
+
+      template <typename Scalar>
+      const Values<Scalar>& get() const {
+        return const_cast<Level*>(this)->get<Scalar>();
+      }
+    };
+
+    std::vector<std::unique_ptr<Level>> levels_;
+
+    const bool     lineRelaxation_; //! Line relaxation on the finest level only, see the solver type line
+    const RealType lineOmega_;      //! Over-relaxation of the line solves, one for the smoother
+    const int      maxCycles_;
+    const int      coarsestSweeps_;
+    const bool     mixedPrecision_;
+
+    // Scratch space of the line smoother. The lines of one direction and colour are solved in batches of lineBatch_
+    // lines, whose Thomas algorithms run in lockstep and vectorise across the lines.
+    static constexpr int  lineBatch_ = 8;
+    std::vector<int>      lineBases_;       //! Linear index of cell 0 of each line
+    std::vector<int>      lineCoordinates_; //! Three coordinates per line, the one along the line is zero
+    std::vector<RealType> lineFactors_;
+    std::vector<RealType> lineValues_;
+
+    void createLevels();
+    void createCoarseLevel(Level& fine);
+    void updateCoarseFlags(const Level& fine, Level& coarse);
+
+    // Copies the per-axis coefficients of the pressure operator and computes the inverse diagonal, in both precisions
+    // with mixed precision
+    void updateCoefficients(Level& level);
+
+    // Range of the fine cells that are merged into a coarse cell
+    void getChildren(const Level& fine, const Level& coarse, int axis, int index, int& first, int& last) const;
+
+    template <int Dim, typename Scalar>
+    void updateGhosts(Level& level, bool homogeneous);
+
+    template <int Dim, typename Scalar>
+    void computeResidual(Level& level);
+
+    template <int Dim, typename Scalar>
+    void smooth(Level& level, int sweeps, bool homogeneous);
+
+    template <int Dim, typename Scalar>
+    void smoothRedBlack(Level& level, int sweeps, bool homogeneous);
+
+    template <int Dim, typename Scalar>
+    void smoothJacobi(Level& level, int sweeps, bool homogeneous);
+
+    template <int Dim, typename Scalar>
+    void smoothLines(Level& level, int sweeps, bool homogeneous);
+
+    // Solves for the cells base + m * stride, m = 2 to size + 1, of the lines first to first + lanes - 1 in lineBases_
+    // with the Thomas algorithm
+    template <int Dim, typename Scalar>
+    void solveLines(Level& level, int axis, int first, int lanes, bool homogeneous);
+
+    template <int Dim, typename Scalar>
+    void restrictResidual(Level& fine, Level& coarse);
+
+    template <int Dim, typename Scalar>
+    void prolongate(const Level& coarse, Level& fine);
+
+    // Removes the weighted mean of the right hand side of a singular problem
+    template <int Dim, typename Scalar>
+    void removeIncompatibleRhs(Level& level);
+
+    template <int Dim, typename Scalar>
+    void cycle(int level, int type);
+
+    // Computes the residual of the pressure of the finest level in double precision, returns its norm
+    template <int Dim>
+    RealType residualNorm();
+
+    // Single-precision cycle from a zero initial guess with homogeneous boundary values, on the residual in the layout
+    // of the finest level. The correction is left in the single-precision pressure of the finest level.
+    template <int Dim>
+    void cycleCorrection(const RealType* residual);
+
+    // Refinement step with a single-precision cycle on the residual of the finest level, see mixedPrecision_
+    template <int Dim>
+    void refine();
+
+    // Runs cycles until the residual of the finest level has converged, returns the number of cycles
+    template <int Dim>
+    int iterate();
+
+  public:
+    MultigridSolver(FlowField& flowField, const Parameters& parameters);
+    ~MultigridSolver() override = default;
+
+    void solve() override;
+
+    void reInitMatrix() override;
+
+    /** Approximates the correction of a refinement step by one single-precision cycle, without touching the flow field
+     *
+     * Both arrays have the layout of the pressure field, the ghost cells of the correction follow the homogeneous
+     * boundary conditions. Requires mixed precision. The PETSc solver uses it as preconditioner, see PetscSolver.
+     *
+     * @param residual Residual of the pressure equation, only the inner cells are read
+     * @param correction Approximate solution of the pressure equation for the residual
+     */
+    void applyCycle(const RealType* residual, RealType* correction);
+  };
+
+} // namespace Solvers
@@ -4,6 +4,8 @@
 
 #include "PetscSolver.hpp"
 
+#include "Clock.hpp"
+
 static constexpr unsigned char LEFT_WALL_BIT   = 1 << 0;
 static constexpr unsigned char RIGHT_WALL_BIT  = 1 << 1;
 static constexpr unsigned char BOTTOM_WALL_BIT = 1 << 2;
@@ -11,6 +13,335 @@ static constexpr unsigned char TOP_WALL_BIT    = 1 << 3;
 static constexpr unsigned char FRONT_WALL_BIT  = 1 << 4;
 static constexpr unsigned char BACK_WALL_BIT   = 1 << 5;
 
+// Candidates of the autotuner, every Krylov method with every preconditioner. The levels are the fill of ILU, also on
+// the subdomains of ASM.
+struct PreconditionerCandidate {
+  PCType type;
+  int    levels;
+};
+
+static const KSPType                 autotuneMethods[]         = {KSPCG, KSPFGMRES, KSPBCGS};
+static const KSPType                 pipelinedMethods[]        = {KSPPIPECG, KSPPIPEFGMRES, KSPPIPEBCGS};
+static const PreconditionerCandidate autotunePreconditioners[] = {
+  {PCILU, 0}, {PCILU, 1}, {PCILU, 2}, {PCASM, 1}, {PCGAMG, 0}, {PCHYPRE, 0}, {PCMG, 0}, {PCJACOBI, 0}, {PCNONE, 0}};
+
+static constexpr int numAutotunePreconditioners = sizeof(autotunePreconditioners) / sizeof(PreconditionerCandidate);
+static constexpr int numAutotuneCandidates      = 3 * numAutotunePreconditioners;
+
+// The pipelined variants overlap their global reductions with the operator and the preconditioner
+static inline KSPType getCandidateMethod(int candidate, bool pipelined) {
+  return (pipelined ? pipelinedMethods : autotuneMethods)[candidate / numAutotunePreconditioners];
+}
+
+static inline const PreconditionerCandidate& getCandidatePreconditioner(int candidate) {
+  return autotunePreconditioners[candidate % numAutotunePreconditioners];
+}
+
+static inline bool isPeriodic(const Parameters& parameters, int axis) {
+  const BoundaryType types[3] = {parameters.walls.typeLeft, parameters.walls.typeBottom, parameters.walls.typeFront};
+  return types[axis] == PERIODIC;
+}
+
+/** Cell-centred hierarchy of the geometric multigrid preconditioner
+ *
+ * As in the multigrid solver, a coarse cell merges two neighbouring fine cells, so an axis is halved as long as the
+ * inner cells of every process are even, and axes that cannot be halved any more stay as they are (semi-coarsening).
+ * Each process keeps at least two inner cells per axis. Every level has a node before the first and after the last
+ * inner cell of an axis, for the boundary rows, as the DMDA of the finest level. Unlike the vertex-centred coarsening
+ * of the DMDA, this needs no particular number of intervals between the nodes.
+ */
+struct MultigridHierarchy {
+  int levels = 1;
+
+  // Inner cells of every process per axis and level, the finest level first. The first and the last process of an
+  // axis also own a boundary node. Axes beyond the dimension have a single cell.
+  std::vector<std::vector<PetscInt>> cells[3];
+};
+
+static MultigridHierarchy getMultigridHierarchy(const Parameters& parameters) {
+  MultigridHierarchy hierarchy;
+  for (int axis = 0; axis < 3; axis++) {
+    std::vector<PetscInt> cells(axis < parameters.geometry.dim ? parameters.parallel.numProcessors[axis] : 1, 1);
+    if (axis < parameters.geometry.dim) {
+      for (size_t p = 0; p < cells.size(); p++) {
+        cells[p] = parameters.parallel.sizes[axis][p] - (p == 0) - (p + 1 == cells.size());
+      }
+    }
+    hierarchy.cells[axis].push_back(cells);
+  }
+
+  while (true) {
+    bool                  coarsened = false;
+    std::vector<PetscInt> coarse[3];
+    for (int axis = 0; axis < 3; axis++) {
+      coarse[axis]      = hierarchy.cells[axis].back();
+      const bool halved = axis < parameters.geometry.dim
+                          && std::all_of(coarse[axis].begin(), coarse[axis].end(), [](PetscInt n) { return n % 2 == 0 && n >= 4; });
+      if (halved) {
+        for (PetscInt& n : coarse[axis]) {
+          n /= 2;
+        }
+        coarsened = true;
+      }
+    }
+    if (!coarsened) {
+      return hierarchy;
+    }
+    for (int axis = 0; axis < 3; axis++) {
+      hierarchy.cells[axis].push_back(coarse[axis]);
+    }
+    hierarchy.levels++;
+  }
+}
+
+// Levels of geometric multigrid, 1 if the grid cannot be coarsened at all
+static int getMultigridLevels(const Parameters& parameters) { return getMultigridHierarchy(parameters).levels; }
+
+// Nodes of one level of the hierarchy along an axis: the nodes owned by every process and the first of them
+struct MultigridNodes {
+  std::vector<PetscInt> owned;
+  std::vector<PetscInt> first;
+  PetscInt              total = 0;
+
+  MultigridNodes(const std::vector<PetscInt>& cells, bool boundary) {
+    for (size_t p = 0; p < cells.size(); p++) {
+      first.push_back(total);
+      owned.push_back(cells[p] + (boundary && p == 0) + (boundary && p + 1 == cells.size()));
+      total += owned.back();
+    }
+  }
+
+  int getOwner(PetscInt node) const {
+    return static_cast<int>(std::upper_bound(first.begin(), first.end(), node) - first.begin()) - 1;
+  }
+};
+
+/** Interpolation from level + 1 to level of the hierarchy, in the global ordering of the DMDA: the nodes of the
+ * processes follow each other in the order of the ranks, and each process numbers its nodes lexicographically
+ *
+ * Along a halved axis, the inner node of a fine cell takes 3/4 of the coarse cell that contains it and 1/4 of the
+ * neighbouring coarse node on the side of the fine cell, which is a boundary node next to the walls or the inner node
+ * at the opposite end on periodic axes. The boundary nodes take the coarse boundary nodes. The interpolation in several
+ * dimensions is the tensor product.
+ */
+static Mat createInterpolation(const Parameters& parameters, const MultigridHierarchy& hierarchy, int level) {
+  std::vector<MultigridNodes>           fine, coarse;
+  std::vector<std::vector<PetscInt>>    columns[3];
+  std::vector<std::vector<PetscScalar>> weights[3];
+  PetscInt                              localRows = 1, localColumns = 1;
+  for (int axis = 0; axis < 3; axis++) {
+    const bool boundary = axis < parameters.geometry.dim;
+    fine.emplace_back(hierarchy.cells[axis][level], boundary);
+    coarse.emplace_back(hierarchy.cells[axis][level + 1], boundary);
+    const int index = boundary ? parameters.parallel.indices[axis] : 0;
+    localRows *= fine[axis].owned[index];
+    localColumns *= coarse[axis].owned[index];
+
+    const bool     halved   = fine[axis].total != coarse[axis].total;
+    const bool     periodic = boundary && isPeriodic(parameters, axis);
+    const PetscInt last     = coarse[axis].total - 1;
+    for (PetscInt node = fine[axis].first[index]; node < fine[axis].first[index] + fine[axis].owned[index]; node++) {
+      if (!halved || node == 0 || node == fine[axis].total - 1) {
+        columns[axis].push_back({halved && node > 0 ? last : node});
+        weights[axis].push_back({1.0});
+        continue;
+      }
+      const PetscInt parent = (node + 1) / 2;
+      PetscInt       other  = node % 2 == 1 ? parent - 1 : parent + 1;
+      if (periodic && other == 0) {
+        other = last - 1;
+      } else if (periodic && other == last) {
+        other = 1;
+      }
+      columns[axis].push_back({parent, other});
+      weights[axis].push_back({0.75, 0.25});
+    }
+  }
+
+  // First global index of the nodes of every process on the coarse level
+  const int             processes[3] = {static_cast<int>(coarse[0].owned.size()), static_cast<int>(coarse[1].owned.size()), static_cast<int>(coarse[2].owned.size())};
+  std::vector<PetscInt> offsets(1, 0);
+  for (int pz = 0; pz < processes[2]; pz++) {
+    for (int py = 0; py < processes[1]; py++) {
+      for (int px = 0; px < processes[0]; px++) {
+        offsets.push_back(offsets.back() + coarse[0].owned[px] * coarse[1].owned[py] * coarse[2].owned[pz]);
+      }
+    }
+  }
+  const auto getColumn = [&](PetscInt i, PetscInt j, PetscInt k) {
+    const int px = coarse[0].getOwner(i), py = coarse[1].getOwner(j), pz = coarse[2].getOwner(k);
+    return offsets[px + processes[0] * (py + processes[1] * pz)] + i - coarse[0].first[px]
+           + coarse[0].owned[px] * (j - coarse[1].first[py] + coarse[1].owned[py] * (k - coarse[2].first[pz]));
+  };
+
+  const PetscInt maxEntries = 1 << parameters.geometry.dim;
+  Mat            interpolation;
+  MatCreateAIJ(PETSC_COMM_WORLD, localRows, localColumns, PETSC_DETERMINE, PETSC_DETERMINE, maxEntries, PETSC_NULLPTR, maxEntries, PETSC_NULLPTR, &interpolation);
+  PetscInt row;
+  MatGetOwnershipRange(interpolation, &row, PETSC_NULLPTR);
+
+  std::vector<PetscInt>    rowColumns;
+  std::vector<PetscScalar> rowWeights;
+  for (size_t k = 0; k < columns[2].size(); k++) {
+    for (size_t j = 0; j < columns[1].size(); j++) {
+      for (size_t i = 0; i < columns[0].size(); i++, row++) {
+        rowColumns.clear();
+        rowWeights.clear();
+        for (size_t c = 0; c < columns[2][k].size(); c++) {
+          for (size_t b = 0; b < columns[1][j].size(); b++) {
+            for (size_t a = 0; a < columns[0][i].size(); a++) {
+              rowColumns.push_back(getColumn(columns[0][i][a], columns[1][j][b], columns[2][k][c]));
+              rowWeights.push_back(weights[0][i][a] * weights[1][j][b] * weights[2][k][c]);
+            }
+          }
+        }
+        MatSetValues(interpolation, 1, &row, static_cast<PetscInt>(rowColumns.size()), rowColumns.data(), rowWeights.data(), INSERT_VALUES);
+      }
+    }
+  }
+  MatAssemblyBegin(interpolation, MAT_FINAL_ASSEMBLY);
+  MatAssemblyEnd(interpolation, MAT_FINAL_ASSEMBLY);
+  return interpolation;
+}
+
+// The pressure has a Dirichlet condition only on walls with a Neumann condition on the velocity, i.e., outflow or a
+// prescribed pressure. Without such a wall, the pressure is only defined up to a constant.
+static bool isSingular(const Parameters& parameters) {
+  const BoundaryType types[6] = {
+    parameters.walls.typeLeft,
+    parameters.walls.typeRight,
+    parameters.walls.typeBottom,
+    parameters.walls.typeTop,
+    parameters.walls.typeFront,
+    parameters.walls.typeBack};
+  for (int n = 0; n < 2 * parameters.geometry.dim; n++) {
+    if (types[n] == NEUMANN) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Attaches the constants as null space of a singular operator, so that the Krylov methods remove them from the
+// iterates. A non-singular operator must not get one: algebraic multigrid projects the null space out of its coarse
+// spaces and does not converge if the constants are in fact determined by the boundary.
+static void setConstantNullSpace(Mat A, const Solvers::PetscUserCtx& context) {
+  if (!context.singular) {
+    return;
+  }
+  MatNullSpace nullspace;
+  MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, 0, &nullspace);
+  MatSetNullSpace(A, nullspace);
+  MatNullSpaceDestroy(&nullspace);
+}
+
+// Calls function(node, inner) for every owned node of the DMDA on two or more global boundaries, i.e., the corners in
+// 2D and the edges and corners in 3D. The first and last nodes of periodic axes count as boundary, as they are ghost
+// nodes that copy the opposite end. These nodes are not part of the discretisation, but an empty row breaks the
+// Jacobi and Chebyshev smoothers of algebraic multigrid and adds spurious vectors to the null space. Their rows copy
+// the node inner, one node inwards along the first boundary axis, which is a wall node or an edge node on one
+// boundary less.
+template <class Function>
+static void forEachEdgeNode(Solvers::PetscUserCtx& context, Function function) {
+  const Parameters& parameters = context.getParameters();
+  const int         dim        = parameters.geometry.dim;
+
+  const PetscInt sizes[3] = {parameters.geometry.sizeX + 2, parameters.geometry.sizeY + 2, dim == 3 ? parameters.geometry.sizeZ + 2 : 1};
+
+  PetscInt first[3], length[3];
+  DMDAGetCorners(context.getGrid(), &first[0], &first[1], &first[2], &length[0], &length[1], &length[2]);
+
+  const auto onBoundary = [&](int axis, PetscInt index) { return axis < dim && (index == 0 || index == sizes[axis] - 1); };
+
+  const auto visit = [&](PetscInt i, PetscInt j, PetscInt k) {
+    MatStencil node, inner;
+    node.i = inner.i = i;
+    node.j = inner.j = j;
+    node.k = inner.k = k;
+    node.c = inner.c = 0;
+    if (onBoundary(0, i)) {
+      inner.i += i == 0 ? 1 : -1;
+    } else if (onBoundary(1, j)) {
+      inner.j += j == 0 ? 1 : -1;
+    } else {
+      inner.k += k == 0 ? 1 : -1;
+    }
+    function(node, inner);
+  };
+
+  for (PetscInt k = first[2]; k < first[2] + length[2]; k++) {
+    for (PetscInt j = first[1]; j < first[1] + length[1]; j++) {
+      const int boundaries = onBoundary(1, j) + onBoundary(2, k);
+      if (boundaries >= 2) {
+        for (PetscInt i = first[0]; i < first[0] + length[0]; i++) {
+          visit(i, j, k);
+        }
+      } else if (boundaries == 1) {
+        // Only the ends of the line are on a boundary along x
+        if (first[0] == 0) {
+          visit(0, j, k);
+        }
+        if (first[0] + length[0] == sizes[0]) {
+          visit(sizes[0] - 1, j, k);
+        }
+      }
+    }
+  }
+}
+
+// Removes the weighted mean of the right hand side of the fluid cells, so that a singular system is consistent. The
+// weights are the dual cells of the operator, which are orthogonal to its range, as in the multigrid solver.
+// value(i, j, k) accesses the right hand side at a node of the DMDA.
+template <class Access>
+static void removeIncompatibleRhs(Solvers::PetscUserCtx& context, Access value) {
+  const Parameters& parameters = context.getParameters();
+  const int         dim        = parameters.geometry.dim;
+
+  int *limitsX, *limitsY, *limitsZ;
+  context.getLimits(&limitsX, &limitsY, &limitsZ);
+  const int lowerZ = dim == 3 ? limitsZ[0] : 0;
+  const int upperZ = dim == 3 ? limitsZ[1] : 1;
+
+  const RealType* const spacings[3] = {
+    parameters.meshsize->getSpacings(0), parameters.meshsize->getSpacings(1), dim == 3 ? parameters.meshsize->getSpacings(2) : nullptr};
+  const auto dual = [&spacings](int axis, int n) {
+    return 0.25 * (spacings[axis][n - 1] + 2.0 * spacings[axis][n] + spacings[axis][n + 1]);
+  };
+  const auto weight = [&](int i, int j, int k) {
+    return dual(0, i - limitsX[0] + 2) * dual(1, j - limitsY[0] + 2) * (dim == 3 ? dual(2, k - limitsZ[0] + 2) : 1.0);
+  };
+
+  // The right hand side of obstacle rows is zero
+  RealType sums[2] = {0.0, 0.0};
+  for (int k = lowerZ; k < upperZ; k++) {
+    for (int j = limitsY[0]; j < limitsY[1]; j++) {
+      for (int i = limitsX[0]; i < limitsX[1]; i++) {
+        sums[0] += weight(i, j, k) * value(i, j, k);
+        sums[1] += weight(i, j, k);
+      }
+    }
+  }
+  for (const Solvers::PressureOperator::ObstacleRow& row : context.getPressureOperator().getObstacleRows()) {
+    sums[1] -= weight(row.i - 2 + limitsX[0], row.j - 2 + limitsY[0], dim == 3 ? row.k - 2 + limitsZ[0] : 0);
+  }
+  MPI_Allreduce(MPI_IN_PLACE, sums, 2, MY_MPI_FLOAT, MPI_SUM, PETSC_COMM_WORLD);
+  if (sums[1] <= 0.0) {
+    return;
+  }
+
+  const RealType mean = sums[0] / sums[1];
+  for (int k = lowerZ; k < upperZ; k++) {
+    for (int j = limitsY[0]; j < limitsY[1]; j++) {
+      for (int i = limitsX[0]; i < limitsX[1]; i++) {
+        value(i, j, k) -= mean;
+      }
+    }
+  }
+  for (const Solvers::PressureOperator::ObstacleRow& row : context.getPressureOperator().getObstacleRows()) {
+    value(row.i - 2 + limitsX[0], row.j - 2 + limitsY[0], dim == 3 ? row.k - 2 + limitsZ[0] : 0) = 0.0;
+  }
+}
+
 // This function returns the ranges to work on the pressure with the non-boundary stencil.
 // Since the domain PETSc deals with has an additional layer of cells, the size is clipped to
 // ignore them.
@@ -68,7 +399,8 @@ void createLimits(Parameters& parameters, DM& da, int* limitsX, int* limitsY, in
 
 Solvers::PetscUserCtx::PetscUserCtx(Parameters& parameters, FlowField& flowField):
   parameters_(parameters),
-  flowField_(flowField) {}
+  flowField_(flowField),
+  pressureOperator_(nullptr) {}
 
 Parameters& Solvers::PetscUserCtx::getParameters() { return parameters_; }
 
@@ -80,9 +412,20 @@ PetscErrorCode computeMatrix3D(KSP ksp, Mat A, Mat pc, void* ctx);
 PetscErrorCode computeRHS2D(KSP ksp, Vec b, void* ctx);
 PetscErrorCode computeRHS3D(KSP ksp, Vec b, void* ctx);
 
+PetscErrorCode applyOperator2D(Mat A, Vec x, Vec y);
+PetscErrorCode applyOperator3D(Mat A, Vec x, Vec y);
+
+PetscErrorCode getOperatorDiagonal2D(Mat A, Vec diagonal);
+PetscErrorCode getOperatorDiagonal3D(Mat A, Vec diagonal);
+
 Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
   LinearSolver(flowField, parameters),
-  ctx_(parameters, flowField) {
+  operator_(PETSC_NULLPTR),
+  b_(PETSC_NULLPTR),
+  ctx_(parameters, flowField),
+  tunePending_(false),
+  solved_(false),
+  comparePending_(parameters.solver.mixedPrecision != 0) {
 
   // Set the type of boundary nodes of the system
   DMBoundaryType bx = DM_BOUNDARY_NONE, by = DM_BOUNDARY_NONE, bz = DM_BOUNDARY_NONE;
@@ -101,9 +444,11 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
   PCCreate(PETSC_COMM_WORLD, &pc_);
 
   PetscErrorCode (*computeMatrix)(KSP, Mat, Mat, void*) = NULL;
+  PetscErrorCode (*computeRHS)(KSP, Vec, void*)         = NULL;
 
   if (parameters_.geometry.dim == 2) {
     computeMatrix = computeMatrix2D;
+    computeRHS    = computeRHS2D;
     DMDACreate2d(
       PETSC_COMM_WORLD,
       bx,
@@ -121,6 +466,7 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
     );
   } else if (parameters_.geometry.dim == 3) {
     computeMatrix = computeMatrix3D;
+    computeRHS    = computeRHS3D;
     DMDACreate3d(
       PETSC_COMM_WORLD,
       bx,
@@ -178,6 +524,7 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
 
   // Set a pointer to the limits in the context, so that they can be used by the function.
   ctx_.setLimits(limitsX_, limitsY_, limitsZ_);
+  ctx_.setPressureOperator(&pressureOperator_);
 
   // Determine whether a process writes a boundary on the system.
   // Right now, it only depends on the position of the array. The identity of the neighbors will
@@ -203,6 +550,8 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
     ctx_.setAsBoundary += BACK_WALL_BIT;
   }
 
+  ctx_.singular = isSingular(parameters);
+
   // Set displacements to deal with periodic boundaries if necessary.
   // If the boundary is periodic, it will take information from positions beyond the ghost cells,
   // since they are used only for parallel communication. Otherwise, PETSc deals with
@@ -236,15 +585,59 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
   }
 
   DMCreateGlobalVector(da_, &x_);
-  KSPSetDM(ksp_, da_);
-  KSPSetComputeOperators(ksp_, computeMatrix, &ctx_);
+  ctx_.setGrid(da_);
+
+  if (parameters_.solver.matrixFree) {
+    // The shell applies the stencil of the PressureOperator on the local vector of the DMDA, so that no matrix is
+    // stored. The KSP has no DM in this mode, it uses the shell as operator and the right hand side is passed in solve().
+    PetscInt localSize;
+    VecGetLocalSize(x_, &localSize);
+    MatCreateShell(PETSC_COMM_WORLD, localSize, localSize, PETSC_DETERMINE, PETSC_DETERMINE, &ctx_, &operator_);
+    if (parameters_.geometry.dim == 2) {
+      MatShellSetOperation(operator_, MATOP_MULT, (void (*)(void))applyOperator2D);
+      MatShellSetOperation(operator_, MATOP_GET_DIAGONAL, (void (*)(void))getOperatorDiagonal2D);
+    } else {
+      MatShellSetOperation(operator_, MATOP_MULT, (void (*)(void))applyOperator3D);
+      MatShellSetOperation(operator_, MATOP_GET_DIAGONAL, (void (*)(void))getOperatorDiagonal3D);
+    }
+
+    setConstantNullSpace(operator_, ctx_);
+
+    VecDuplicate(x_, &b_);
+  } else {
+    KSPSetDM(ksp_, da_);
+    // The operator only depends on the mesh and the flags. PETSc assembles it and sets up the preconditioner in the
+    // first solve after KSPSetComputeOperators() and reuses both afterwards, see reInitMatrix(). The right hand side is
+    // computed in every solve.
+    KSPSetComputeOperators(ksp_, computeMatrix, &ctx_);
+    KSPSetComputeRHS(ksp_, computeRHS, &ctx_);
+  }
 
-  KSPSetType(ksp_, KSPFGMRES);
+  // The pipelined FGMRES overlaps the reduction of the orthogonalisation with the next operator and preconditioner. It
+  // is replaced by the pipelined CG below if the assembled operator turns out to be symmetric.
+  KSPSetType(ksp_, parameters_.solver.pipelined ? KSPPIPEFGMRES : KSPFGMRES);
 
   int commSize;
   MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
 
-  if (commSize == 1) {
+  if (parameters_.solver.multigrid && !parameters_.solver.matrixFree && getMultigridLevels(parameters_) < 2) {
+    spdlog::warn(
+      "The pressure grid cannot be coarsened for geometric multigrid, the cells of every process need to be even "
+      "and at least four along some axis. Using {} instead",
+      commSize == 1 ? "ILU" : "ASM"
+    );
+  }
+
+  if (parameters_.solver.matrixFree) {
+    // Only the diagonal of the shell is available. Other preconditioners that work without the matrix entries, such
+    // as -pc_type none with -ksp_type chebyshev, can be chosen on the command line.
+    PCSetType(pc_, PCJACOBI);
+    KSPSetPC(ksp_, pc_);
+    KSPSetOperators(ksp_, operator_, operator_);
+  } else if (parameters_.solver.multigrid && getMultigridLevels(parameters_) > 1) {
+    setUpMultigrid();
+    KSPSetPC(ksp_, pc_);
+  } else if (commSize == 1) {
     // If serial
     PCSetType(pc_, PCILU);
     PCFactorSetLevels(pc_, 1);
@@ -255,6 +648,14 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
     KSPSetPC(ksp_, pc_);
   }
 
+  if (parameters_.solver.mixedPrecision) {
+    const ScalarField& pressure = flowField_.getPressure();
+    singleSolver_               = std::make_unique<MultigridSolver>(flowField_, parameters_);
+    residual_.assign(pressure.getNx() * pressure.getNy() * pressure.getNz(), 0.0);
+    correction_.assign(residual_.size(), 0.0);
+    setUpSinglePrecision();
+  }
+
   KSPSetFromOptions(ksp_);
   KSPSetInitialGuessNonzero(ksp_, PETSC_TRUE);
   KSPSetUp(ksp_);
@@ -263,7 +664,9 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
   // that has to be done after setup. The other solvers above
   // can be changed before setup with KSPSetFromOptions.
 
-  if (commSize > 1) {
+  PetscBool asm_;
+  PetscObjectTypeCompare(reinterpret_cast<PetscObject>(pc_), PCASM, &asm_);
+  if (asm_) {
     KSP* subksp;
     PC   subpc;
 
@@ -281,51 +684,557 @@ Solvers::PetscSolver::PetscSolver(FlowField& flowField, Parameters& parameters):
 
     KSPSetUp(ksp_);
   }
+
+  if (parameters_.solver.pipelined) {
+    selectPipelinedMethod();
+  }
+
+  if (parameters_.solver.autotune) {
+    const int candidate = readCache();
+    if (candidate >= 0) {
+      spdlog::info(
+        "Using the cached pressure solver {} with {}", getCandidateMethod(candidate, parameters_.solver.pipelined), getCandidatePreconditioner(candidate).type
+      );
+      applyCandidate(candidate);
+    } else {
+      // The candidates are compared on the right hand side of the first solve
+      tunePending_ = true;
+    }
+  }
 }
 
-void Solvers::PetscSolver::solve() {
-  ScalarField& pressure = flowField_.getPressure();
+Solvers::PetscSolver::~PetscSolver() {
+  // The KSP holds references to the preconditioner, the grid and the operators, so it goes first. Each object is only
+  // freed once the last reference is gone.
+  if (ksp_ != PETSC_NULLPTR) {
+    KSPDestroy(&ksp_);
+  }
+  if (pc_ != PETSC_NULLPTR) {
+    PCDestroy(&pc_);
+  }
+  if (operator_ != PETSC_NULLPTR) {
+    MatDestroy(&operator_);
+  }
+  if (b_ != PETSC_NULLPTR) {
+    VecDestroy(&b_);
+  }
+  if (x_ != PETSC_NULLPTR) {
+    VecDestroy(&x_);
+  }
+  for (Vec& solution : previousSolutions_) {
+    VecDestroy(&solution);
+  }
+  if (da_ != PETSC_NULLPTR) {
+    DMDestroy(&da_);
+  }
+}
 
-  if (parameters_.geometry.dim == 2) {
-    KSPSetComputeRHS(ksp_, computeRHS2D, &ctx_);
-    KSPSetComputeOperators(ksp_, computeMatrix2D, &ctx_);
-    KSPSolve(ksp_, PETSC_NULLPTR, x_);
+PetscErrorCode Solvers::PetscSolver::solveSystem() {
+  if (parameters_.solver.matrixFree) {
+    if (parameters_.geometry.dim == 2) {
+      computeRHS2D(ksp_, b_, &ctx_);
+    } else {
+      computeRHS3D(ksp_, b_, &ctx_);
+    }
+    return KSPSolve(ksp_, b_, x_);
+  }
+  return KSPSolve(ksp_, PETSC_NULLPTR, x_);
+}
 
-    // Then extract the information
-    PetscScalar** array;
-    DMDAVecGetArray(da_, x_, &array);
+void Solvers::PetscSolver::selectPipelinedMethod() {
+  PetscBool hasType;
+  PetscOptionsHasName(NULL, NULL, "-ksp_type", &hasType);
+  // The shell only provides the product and the diagonal, so its symmetry is unknown. The Dirichlet and copy rows of
+  // the assembled operator at the boundary are not symmetric, so this usually keeps the pipelined FGMRES. The
+  // single-precision preconditioner of mixed precision needs the flexible method in any case.
+  if (!hasType && !parameters_.solver.matrixFree && !parameters_.solver.mixedPrecision) {
+    Mat       A;
+    PetscReal norm;
+    PetscBool symmetric;
+    KSPGetOperators(ksp_, &A, NULL);
+    MatNorm(A, NORM_INFINITY, &norm);
+    MatIsSymmetric(A, 1e-12 * norm, &symmetric);
+    if (symmetric) {
+      KSPSetType(ksp_, KSPPIPECG);
+      KSPSetUp(ksp_);
+    }
+  }
+  KSPType type;
+  KSPGetType(ksp_, &type);
+  spdlog::info("Pipelined pressure solver: {}", type);
+}
 
-    for (int j = firstY_; j < firstY_ + lengthY_; j++) {
-      for (int i = firstX_; i < firstX_ + lengthX_; i++) {
-        pressure.getScalar(i - firstX_ + offsetX_, j - firstY_ + offsetY_) = array[j][i];
+PetscErrorCode Solvers::PetscSolver::applyCandidate(int candidate) {
+  const PreconditionerCandidate& preconditioner = getCandidatePreconditioner(candidate);
+
+  KSPSetType(ksp_, getCandidateMethod(candidate, parameters_.solver.pipelined));
+  // PCHYPRE, i.e., BoomerAMG, is only available if PETSc was configured with hypre
+  PetscErrorCode error = PCSetType(pc_, preconditioner.type);
+  if (error != 0) {
+    return error;
+  }
+  if (std::strcmp(preconditioner.type, PCILU) == 0) {
+    PCFactorSetLevels(pc_, preconditioner.levels);
+  } else if (std::strcmp(preconditioner.type, PCMG) == 0) {
+    setUpMultigrid();
+  }
+
+  error = KSPSetUp(ksp_);
+  if (error == 0 && std::strcmp(preconditioner.type, PCASM) == 0) {
+    KSP* subksp;
+    PC   subpc;
+    PCASMGetSubKSP(pc_, NULL, NULL, &subksp);
+    KSPGetPC(subksp[0], &subpc);
+    PCSetType(subpc, PCILU);
+    PCFactorSetLevels(subpc, preconditioner.levels);
+    error = KSPSetUp(ksp_);
+  }
+  return error;
+}
+
+void Solvers::PetscSolver::setUpSinglePrecision() {
+  // The cycle is not exactly the same linear operator in every application, which the flexible FGMRES allows for
+  PCSetType(pc_, PCSHELL);
+  PCShellSetContext(pc_, this);
+  PCShellSetName(pc_, "single-precision multigrid cycle");
+  PCShellSetSetUp(pc_, updateBoundaryRows);
+  PCShellSetApply(pc_, applySinglePrecision);
+}
+
+PetscErrorCode Solvers::PetscSolver::updateBoundaryRows(PC pc) {
+  PetscSolver* solver;
+  PCShellGetContext(pc, &solver);
+
+  Mat A;
+  Vec diagonal;
+  PCGetOperators(pc, &A, PETSC_NULLPTR);
+  VecDuplicate(solver->x_, &diagonal);
+  MatGetDiagonal(A, diagonal);
+  std::vector<RealType> values(solver->residual_.size(), 0.0);
+  solver->exchange(diagonal, values.data(), false);
+  VecDestroy(&diagonal);
+
+  // The cells outside the inner cells of the subdomain that hold a row are the boundary nodes of the DMDA, the cells
+  // next to the neighbouring processes stay zero
+  const int  dim = solver->parameters_.geometry.dim;
+  const int* n   = solver->parameters_.parallel.localSize;
+  solver->boundaryRows_.clear();
+  solver->boundaryInverse_.clear();
+  int index = 0;
+  for (int k = 0; k < (dim == 3 ? n[2] + 3 : 1); k++) {
+    for (int j = 0; j < n[1] + 3; j++) {
+      for (int i = 0; i < n[0] + 3; i++, index++) {
+        const bool inner = i >= 2 && i < n[0] + 2 && j >= 2 && j < n[1] + 2 && (dim == 2 || (k >= 2 && k < n[2] + 2));
+        if (!inner && values[index] != 0.0) {
+          solver->boundaryRows_.push_back(index);
+          solver->boundaryInverse_.push_back(1.0 / values[index]);
+        }
       }
     }
-    DMDAVecRestoreArray(da_, x_, &array);
-  } else if (parameters_.geometry.dim == 3) {
-    KSPSetComputeRHS(ksp_, computeRHS3D, &ctx_);
-    KSPSetComputeOperators(ksp_, computeMatrix3D, &ctx_);
-    KSPSolve(ksp_, PETSC_NULLPTR, x_);
+  }
+  return 0;
+}
 
-    // Then extract the information
-    PetscScalar*** array;
-    DMDAVecGetArray(da_, x_, &array);
+PetscErrorCode Solvers::PetscSolver::applySinglePrecision(PC pc, Vec residual, Vec correction) {
+  PetscSolver* solver;
+  PCShellGetContext(pc, &solver);
+
+  solver->exchange(residual, solver->residual_.data(), false);
+  const Clock clock;
+  solver->singleSolver_->applyCycle(solver->residual_.data(), solver->correction_.data());
+  solver->singleTime_ += clock.getTime();
+  solver->singleIterations_++;
+
+  // The cycle sets the ghost cells such that the boundary rows have no residual. Each boundary row couples its node to
+  // one other node, so the residual of the row is matched by the node itself.
+  for (size_t n = 0; n < solver->boundaryRows_.size(); n++) {
+    const int row = solver->boundaryRows_[n];
+    solver->correction_[row] += solver->residual_[row] * solver->boundaryInverse_[n];
+  }
+  solver->exchange(correction, solver->correction_.data(), true);
+  return 0;
+}
+
+void Solvers::PetscSolver::compareMixedPrecision() {
+  int commSize;
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+
+  // The reference is the preconditioner that the solver uses without mixed precision
+  const PreconditionerCandidate reference = parameters_.solver.matrixFree
+                                              ? PreconditionerCandidate{PCJACOBI, 0}
+                                              : PreconditionerCandidate{commSize == 1 ? PCILU : PCASM, 1};
+  int candidate = -1;
+  for (int n = 0; n < numAutotunePreconditioners; n++) {
+    if (std::strcmp(autotunePreconditioners[n].type, reference.type) == 0 && autotunePreconditioners[n].levels == reference.levels) {
+      candidate = numAutotunePreconditioners + n; // FGMRES, or its pipelined variant
+    }
+  }
+
+  Vec initial;
+  VecDuplicate(x_, &initial);
+  VecCopy(x_, initial);
+
+  PetscInt doubleIterations, iterations;
+  applyCandidate(candidate);
+  double start = MPI_Wtime();
+  solveSystem();
+  double doubleTime = MPI_Wtime() - start;
+  KSPGetIterationNumber(ksp_, &doubleIterations);
+
+  VecCopy(initial, x_);
+  VecDestroy(&initial);
+  setUpSinglePrecision();
+  KSPSetUp(ksp_);
+
+  start = MPI_Wtime();
+  solveSystem();
+  double singleTime = MPI_Wtime() - start;
+  KSPGetIterationNumber(ksp_, &iterations);
+
+  MPI_Allreduce(MPI_IN_PLACE, &doubleTime, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &singleTime, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD);
+  spdlog::info(
+    "Mixed precision: the first pressure solve took {} s and {} iterations, {} s and {} iterations with {}({}) in double "
+    "precision, time ratio {:.2f}",
+    singleTime,
+    iterations,
+    doubleTime,
+    doubleIterations,
+    reference.type,
+    reference.levels,
+    singleTime / doubleTime
+  );
+}
+
+void Solvers::PetscSolver::setUpMultigrid() {
+  const MultigridHierarchy hierarchy = getMultigridHierarchy(parameters_);
+  PCSetType(pc_, PCMG);
+  PCMGSetLevels(pc_, hierarchy.levels, PETSC_NULLPTR);
+  PCMGSetGalerkin(pc_, PC_MG_GALERKIN_BOTH);
+
+  // PCMG levels count from the coarsest. With all interpolations given, PCMG does not coarsen the DMDA itself, and the
+  // Galerkin products build the coarse operators from them.
+  for (int level = 0; level + 1 < hierarchy.levels; level++) {
+    Mat interpolation = createInterpolation(parameters_, hierarchy, level);
+    PCMGSetInterpolation(pc_, hierarchy.levels - 1 - level, interpolation);
+    MatDestroy(&interpolation);
+  }
+
+  int commSize;
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+
+  // The coarse operator of a singular system is singular as well, so its LU factorisation needs a shift of the zero
+  // pivot. The null space is removed by the outer Krylov method.
+  KSP coarse;
+  PC  coarsePC, factorPC;
+  PCMGGetCoarseSolve(pc_, &coarse);
+  KSPGetPC(coarse, &coarsePC);
+  if (commSize == 1) {
+    factorPC = coarsePC;
+  } else {
+    KSP redundant;
+    PCSetType(coarsePC, PCREDUNDANT);
+    PCRedundantGetKSP(coarsePC, &redundant);
+    KSPGetPC(redundant, &factorPC);
+  }
+  PCSetType(factorPC, PCLU);
+  if (ctx_.singular) {
+    PCFactorSetShiftType(factorPC, MAT_SHIFT_NONZERO);
+  }
+  if (commSize == 1) {
+    return;
+  }
 
+  // Nodes of the coarsest level. Below minCoarseNodes per process, the reductions of the coarse solve dominate its
+  // arithmetic, so the coarse problem is gathered onto fewer processes.
+  constexpr PetscInt minCoarseNodes = 4096;
+  PetscInt           coarseNodes    = 1;
+  for (int axis = 0; axis < parameters_.geometry.dim; axis++) {
+    const std::vector<PetscInt>& cells = hierarchy.cells[axis].back();
+    coarseNodes *= std::accumulate(cells.begin(), cells.end(), PetscInt(2));
+  }
+  const int processes = static_cast<int>(std::max<PetscInt>(1, coarseNodes / minCoarseNodes));
+  if (processes < commSize) {
+    // The telescope creates its own coarse solver, which takes -mg_coarse_telescope_pc_factor_shift_type nonzero
+    PCSetType(coarsePC, PCTELESCOPE);
+    PCTelescopeSetReductionFactor(coarsePC, (commSize + processes - 1) / processes);
+  }
+}
+
+int Solvers::PetscSolver::tune() {
+  int commSize;
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+
+  // All candidates start from the same initial guess
+  Vec initial;
+  VecDuplicate(x_, &initial);
+  VecCopy(x_, initial);
+
+  // Candidates that fail, e.g., a preconditioner that does not support the matrix, are skipped without aborting
+  PetscPushErrorHandler(PetscReturnErrorHandler, PETSC_NULLPTR);
+
+  int    best     = -1;
+  double bestTime = std::numeric_limits<double>::max();
+  for (int candidate = 0; candidate < numAutotuneCandidates; candidate++) {
+    const KSPType                  method         = getCandidateMethod(candidate, parameters_.solver.pipelined);
+    const PreconditionerCandidate& preconditioner = getCandidatePreconditioner(candidate);
+
+    const bool ilu  = std::strcmp(preconditioner.type, PCILU) == 0;
+    const bool mg   = std::strcmp(preconditioner.type, PCMG) == 0;
+    const bool none = std::strcmp(preconditioner.type, PCNONE) == 0;
+    if ((ilu && commSize > 1) || (mg && getMultigridLevels(parameters_) < 2)
+        || (parameters_.solver.matrixFree && std::strcmp(preconditioner.type, PCJACOBI) != 0 && !none)) {
+      continue;
+    }
+
+    VecCopy(initial, x_);
+
+    // The operator and the preconditioner are reused over many timesteps, so only the solve is timed
+    PetscErrorCode error = applyCandidate(candidate);
+    const double   start = MPI_Wtime();
+    if (error == 0) {
+      error = solveSystem();
+    }
+    double time = MPI_Wtime() - start;
+
+    KSPConvergedReason reason     = KSP_CONVERGED_ITERATING;
+    PetscInt           iterations = 0;
+    KSPGetConvergedReason(ksp_, &reason);
+    KSPGetIterationNumber(ksp_, &iterations);
+
+    int failed = error != 0 || reason <= 0;
+    MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_MAX, PETSC_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD);
+
+    if (failed) {
+      spdlog::info("Autotuner: {} with {}({}) failed", method, preconditioner.type, preconditioner.levels);
+      continue;
+    }
+    spdlog::info("Autotuner: {} with {}({}) took {} s and {} iterations", method, preconditioner.type, preconditioner.levels, time, iterations);
+    if (time < bestTime) {
+      best     = candidate;
+      bestTime = time;
+    }
+  }
+
+  PetscPopErrorHandler();
+
+  VecCopy(initial, x_);
+  VecDestroy(&initial);
+
+  if (best < 0) {
+    throw std::runtime_error("None of the pressure solvers of the autotuner converged");
+  }
+  return best;
+}
+
+std::string Solvers::PetscSolver::getCacheKey() const {
+  int commSize;
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+
+  std::ostringstream key;
+  key << parameters_.simulation.scenario << " " << parameters_.geometry.sizeX << "x" << parameters_.geometry.sizeY;
+  if (parameters_.geometry.dim == 3) {
+    key << "x" << parameters_.geometry.sizeZ;
+  }
+  key << " " << commSize;
+  if (parameters_.solver.matrixFree) {
+    key << " matrix-free";
+  }
+  if (parameters_.solver.pipelined) {
+    key << " pipelined";
+  }
+  return key.str();
+}
+
+int Solvers::PetscSolver::readCache() const {
+  int rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+
+  // Each line of the cache holds a key, the Krylov method, the preconditioner and its levels
+  int candidate = -1;
+  if (rank == 0 && !parameters_.solver.autotuneCache.empty()) {
+    const std::string key = getCacheKey() + " ";
+    std::ifstream     file(parameters_.solver.autotuneCache);
+    std::string       line;
+    while (candidate < 0 && std::getline(file, line)) {
+      if (line.compare(0, key.size(), key) != 0) {
+        continue;
+      }
+      std::istringstream choice(line.substr(key.size()));
+      std::string        method, preconditioner;
+      int                levels = -1;
+      choice >> method >> preconditioner >> levels;
+      for (int n = 0; n < numAutotuneCandidates; n++) {
+        const PreconditionerCandidate& candidatePreconditioner = getCandidatePreconditioner(n);
+        if (method == getCandidateMethod(n, parameters_.solver.pipelined) && preconditioner == candidatePreconditioner.type && levels == candidatePreconditioner.levels) {
+          candidate = n;
+          break;
+        }
+      }
+    }
+  }
+  MPI_Bcast(&candidate, 1, MPI_INT, 0, PETSC_COMM_WORLD);
+  return candidate;
+}
+
+void Solvers::PetscSolver::writeCache(int candidate) const {
+  int rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+  if (rank != 0 || parameters_.solver.autotuneCache.empty()) {
+    return;
+  }
+
+  std::ofstream file(parameters_.solver.autotuneCache, std::ios::app);
+  if (!file) {
+    spdlog::warn("Cannot write the autotuner cache {}", parameters_.solver.autotuneCache);
+    return;
+  }
+  const PreconditionerCandidate& preconditioner = getCandidatePreconditioner(candidate);
+  file << getCacheKey() << " " << getCandidateMethod(candidate, parameters_.solver.pipelined) << " " << preconditioner.type << " " << preconditioner.levels << std::endl;
+}
+
+void Solvers::PetscSolver::exchange(Vec vector, RealType* field, bool toVector) {
+  const ScalarField& pressure = flowField_.getPressure();
+  const int          strideY  = pressure.getNx();
+  const int          strideZ  = pressure.getNx() * pressure.getNy();
+
+  // The owned rows along x are contiguous in both storages
+  auto exchangeRow = [&](PetscScalar* row, int j, int k) {
+    RealType* values = field + offsetX_ + j * strideY + k * strideZ;
+    if (toVector) {
+      std::copy(values, values + lengthX_, row + firstX_);
+    } else {
+      std::copy(row + firstX_, row + firstX_ + lengthX_, values);
+    }
+  };
+
+  // Vectors that are only read, such as the input of a preconditioner, may be locked for writing
+  const auto getArray     = toVector ? DMDAVecGetArray : DMDAVecGetArrayRead;
+  const auto restoreArray = toVector ? DMDAVecRestoreArray : DMDAVecRestoreArrayRead;
+  if (parameters_.geometry.dim == 2) {
+    PetscScalar** array;
+    getArray(da_, vector, &array);
+    for (int j = firstY_; j < firstY_ + lengthY_; j++) {
+      exchangeRow(array[j], j - firstY_ + offsetY_, 0);
+    }
+    restoreArray(da_, vector, &array);
+  } else {
+    PetscScalar*** array;
+    getArray(da_, vector, &array);
     for (int k = firstZ_; k < firstZ_ + lengthZ_; k++) {
       for (int j = firstY_; j < firstY_ + lengthY_; j++) {
-        for (int i = firstX_; i < firstX_ + lengthX_; i++) {
-          pressure.getScalar(i - firstX_ + offsetX_, j - firstY_ + offsetY_, k - firstZ_ + offsetZ_) = array[k][j][i];
-        }
+        exchangeRow(array[k][j], j - firstY_ + offsetY_, k - firstZ_ + offsetZ_);
       }
     }
-    DMDAVecRestoreArray(da_, x_, &array);
+    restoreArray(da_, vector, &array);
+  }
+}
+
+void Solvers::PetscSolver::exchangePressure(bool toVector) {
+  exchange(x_, &flowField_.getPressure().getScalar(0, 0, 0), toVector);
+}
+
+void Solvers::PetscSolver::extrapolatePressure(RealType increment) {
+  // The incremental projection solves for the change of the pressure, which Simulation computes on the field
+  if (parameters_.solver.incremental) {
+    LinearSolver::extrapolatePressure(increment);
+    return;
+  }
+  if (parameters_.solver.extrapolation == 0) {
+    return;
+  }
+  RealType  weights[3];
+  const int points = getExtrapolationWeights(increment, weights);
+  if (points == 0) {
+    return;
+  }
+
+  // The guess goes into the storage of the oldest solution, x_ becomes the latest previous solution
+  Vec guess;
+  if (static_cast<int>(previousSolutions_.size()) == parameters_.solver.extrapolation) {
+    guess = previousSolutions_.back();
+    previousSolutions_.pop_back();
+  } else {
+    VecDuplicate(x_, &guess);
+  }
+  if (points < 2) {
+    VecCopy(x_, guess);
+  } else {
+    VecAXPBYPCZ(guess, weights[0], weights[1], 0.0, x_, previousSolutions_[0]);
+    if (points > 2) {
+      VecAXPY(guess, weights[2], previousSolutions_[1]);
+    }
+  }
+  previousSolutions_.push_front(x_);
+  x_ = guess;
+}
+
+void Solvers::PetscSolver::storePressure() {
+  if (parameters_.solver.incremental) {
+    LinearSolver::storePressure();
+  } else if (parameters_.solver.extrapolation > 0) {
+    // The solution stays in x_
+    storeSolutionTime();
+  }
+}
+
+void Solvers::PetscSolver::solve() {
+  // x_ holds the last solution or its extrapolation. The first solve and the incremental projection, where the
+  // extrapolation is done on the pressure field, start from the field.
+  if (!solved_ || (parameters_.solver.incremental && parameters_.solver.extrapolation > 0)) {
+    exchangePressure(true);
+  }
+  solved_ = true;
+
+  if (tunePending_) {
+    tunePending_        = false;
+    const int candidate = tune();
+    spdlog::info("Autotuner chose {} with {}", getCandidateMethod(candidate, parameters_.solver.pipelined), getCandidatePreconditioner(candidate).type);
+    writeCache(candidate);
+    applyCandidate(candidate);
+  }
+
+  singleIterations_ = 0;
+  singleTime_       = 0;
+  if (comparePending_) {
+    comparePending_ = false;
+    compareMixedPrecision();
+  } else {
+    solveSystem();
+  }
+
+  PetscInt iterations;
+  KSPGetIterationNumber(ksp_, &iterations);
+  iterations_ = iterations;
+
+  exchangePressure(false);
+}
+
+void Solvers::PetscSolver::setTolerance(RealType tolerance) {
+  LinearSolver::setTolerance(tolerance);
+
+  // PETSc tests the 2-norm of the residual instead of the root mean square. The relative tolerance of the options
+  // still applies, the solve stops at the looser of both.
+  PetscReal rows = (parameters_.geometry.sizeX + 2) * (parameters_.geometry.sizeY + 2);
+  if (parameters_.geometry.dim == 3) {
+    rows *= parameters_.geometry.sizeZ + 2;
   }
+  PetscReal rtol, dtol;
+  PetscInt  maxits;
+  KSPGetTolerances(ksp_, &rtol, PETSC_NULLPTR, &dtol, &maxits);
+  KSPSetTolerances(ksp_, rtol, tolerance * std::sqrt(rows), dtol, maxits);
 }
 
 PetscErrorCode computeMatrix2D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]] Mat pc, void* ctx) {
   Solvers::PetscUserCtx* context    = static_cast<Solvers::PetscUserCtx*>(ctx);
   Parameters&            parameters = context->getParameters();
 
-  IntScalarField& flags = context->getFlowField().getFlags();
+  const Solvers::PressureOperator& pressureOperator = context->getPressureOperator();
+  const RealType* const            lowerX           = pressureOperator.getLower(0);
+  const RealType* const            upperX           = pressureOperator.getUpper(0);
+  const RealType* const            lowerY           = pressureOperator.getLower(1);
+  const RealType* const            upperY           = pressureOperator.getUpper(1);
 
   int *limitsX, *limitsY, *limitsZ;
   context->getLimits(&limitsX, &limitsY, &limitsZ);
@@ -349,130 +1258,35 @@ PetscErrorCode computeMatrix2D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
       const int cellIndexX = i - limitsX[0] + 2;
       const int cellIndexY = j - limitsY[0] + 2;
 
-      const int obstacle = flags.getValue(cellIndexX, cellIndexY);
-
-      if ((obstacle & OBSTACLE_SELF) == 0) { // If we have a fluid cell
-        const RealType dx_0  = parameters.meshsize->getDx(cellIndexX, cellIndexY);
-        const RealType dx_M1 = parameters.meshsize->getDx(cellIndexX - 1, cellIndexY);
-        const RealType dx_P1 = parameters.meshsize->getDx(cellIndexX + 1, cellIndexY);
-        const RealType dy_0  = parameters.meshsize->getDy(cellIndexX, cellIndexY);
-        const RealType dy_M1 = parameters.meshsize->getDy(cellIndexX, cellIndexY - 1);
-        const RealType dy_P1 = parameters.meshsize->getDy(cellIndexX, cellIndexY + 1);
-
-        const RealType dx_L  = 0.5 * (dx_0 + dx_M1);
-        const RealType dx_R  = 0.5 * (dx_0 + dx_P1);
-        const RealType dx_Bo = 0.5 * (dy_0 + dy_M1);
-        const RealType dx_T  = 0.5 * (dy_0 + dy_P1);
-
-        // Definition of values: set general formulation for laplace operator here, based on arbitrary meshsizes.
-        stencilValues[1] = 2.0 / (dx_L * (dx_L + dx_R));                // Left
-        stencilValues[0] = 2.0 / (dx_R * (dx_L + dx_R));                // Right
-        stencilValues[3] = 2.0 / (dx_T * (dx_T + dx_Bo));               // Top
-        stencilValues[4] = 2.0 / (dx_Bo * (dx_T + dx_Bo));              // Bottom
-        stencilValues[2] = -2.0 / (dx_R * dx_L) - 2.0 / (dx_T * dx_Bo); // Center
-
-        // Definition of positions. Order must correspond to values.
-        column[0].i = i + 1;
-        column[0].j = j;
-        column[1].i = i - 1;
-        column[1].j = j;
-        column[2].i = i;
-        column[2].j = j;
-        column[3].i = i;
-        column[3].j = j + 1;
-        column[4].i = i;
-        column[4].j = j - 1;
-
-        MatSetValuesStencil(A, 1, &row, 5, column, stencilValues, INSERT_VALUES);
-      } else if (obstacle != OBSTACLE_SELF + OBSTACLE_LEFT + OBSTACLE_RIGHT + OBSTACLE_TOP + OBSTACLE_BOTTOM) { // Not
-                                                                                                                // fluid,
-                                                                                                                // but
-                                                                                                                // fluid
-                                                                                                                // somewhere
-                                                                                                                // around.
-        int counter      = 0; // This will contain how many neighbours are fluid
-        int counterFluid = 0;
-        // TODO: variable meshwidth might have to be considered
-        if ((obstacle & OBSTACLE_LEFT) == 0) { // If there is fluid to the left
-          stencilValues[counter] = 1.0;
-          column[counter].i      = i - 1;
-          column[counter].j      = j;
-          counter++; // We have just identified a fuid cell and prepared to average
-          counterFluid++;
-        } else {
-          stencilValues[counter] = 0.0;
-          column[counter].i      = i - 1;
-          column[counter].j      = j;
-          counter++;
-        }
-        if ((obstacle & OBSTACLE_RIGHT) == 0) {
-          stencilValues[counter] = 1.0;
-          column[counter].i      = i + 1;
-          column[counter].j      = j;
-          counter++;
-          counterFluid++;
-        } else {
-          stencilValues[counter] = 0.0;
-          column[counter].i      = i + 1;
-          column[counter].j      = j;
-          counter++;
-        }
-        if ((obstacle & OBSTACLE_BOTTOM) == 0) {
-          stencilValues[counter] = 1.0;
-          column[counter].i      = i;
-          column[counter].j      = j - 1;
-          counter++;
-          counterFluid++;
-        } else {
-          stencilValues[counter] = 0.0;
-          column[counter].i      = i;
-          column[counter].j      = j - 1;
-          counter++;
-        }
-        if ((obstacle & OBSTACLE_TOP) == 0) {
-          stencilValues[counter] = 1.0;
-          column[counter].i      = i;
-          column[counter].j      = j + 1;
-          counter++;
-          counterFluid++;
-        } else {
-          stencilValues[counter] = 0.0;
-          column[counter].i      = i;
-          column[counter].j      = j + 1;
-          counter++;
-        }
-
-        // A column for the cell itself
-        stencilValues[counter] = -static_cast<PetscScalar>(counterFluid);
-        column[counter].i      = i;
-        column[counter].j      = j;
-
-        // Once we identified how many fluid cells are around and set columns for each, we
-        // enter the row into the matrix.
-
-        MatSetValuesStencil(A, 1, &row, 5, column, stencilValues, INSERT_VALUES);
-      } else { // The remaining possibility is that the cell is obstacle surrounded
-               // by more obstacle cells.
-        // Here, we just add an equation to set the value according to the right hand side.
-        stencilValues[1] = 0.0; // Left
-        stencilValues[0] = 0.0; // Right
-        stencilValues[3] = 0.0; // Top
-        stencilValues[4] = 0.0; // Bottom
-        stencilValues[2] = 1.0; // Center
-
-        // Definition of positions. Order must correspond to values.
-        column[0].i = i + 1;
-        column[0].j = j;
-        column[1].i = i - 1;
-        column[1].j = j;
-        column[2].i = i;
-        column[2].j = j;
-        column[3].i = i;
-        column[3].j = j + 1;
-        column[4].i = i;
-        column[4].j = j - 1;
-        MatSetValuesStencil(A, 1, &row, 5, column, stencilValues, INSERT_VALUES);
+      // Definition of positions. Order must correspond to values.
+      column[0].i = i - 1; // Left
+      column[0].j = j;
+      column[1].i = i + 1; // Right
+      column[1].j = j;
+      column[2].i = i; // Bottom
+      column[2].j = j - 1;
+      column[3].i = i; // Top
+      column[3].j = j + 1;
+      column[4].i = i; // Center
+      column[4].j = j;
+
+      const Solvers::PressureOperator::ObstacleRow* obstacle = pressureOperator.findObstacleRow(cellIndexX, cellIndexY);
+
+      if (obstacle == nullptr) { // If we have a fluid cell
+        stencilValues[0] = lowerX[cellIndexX];
+        stencilValues[1] = upperX[cellIndexX];
+        stencilValues[2] = lowerY[cellIndexY];
+        stencilValues[3] = upperY[cellIndexY];
+        stencilValues[4] = pressureOperator.getCentre(cellIndexX, cellIndexY);
+      } else { // Obstacle cells take the explicit row of the operator
+        stencilValues[0] = obstacle->values[Solvers::PressureOperator::West];
+        stencilValues[1] = obstacle->values[Solvers::PressureOperator::East];
+        stencilValues[2] = obstacle->values[Solvers::PressureOperator::South];
+        stencilValues[3] = obstacle->values[Solvers::PressureOperator::North];
+        stencilValues[4] = obstacle->values[Solvers::PressureOperator::Centre];
       }
+
+      MatSetValuesStencil(A, 1, &row, 5, column, stencilValues, INSERT_VALUES);
     }
   }
 
@@ -485,8 +1299,9 @@ PetscErrorCode computeMatrix2D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
       column[1].j = j;
       row.i       = 0;
       row.j       = j;
-      if (parameters.walls.typeLeft == DIRICHLET) { // If Dirichlet velocity boundary conditions
-        // Therefore, Neumann in the pressure
+      // Dirichlet velocity boundary conditions, therefore Neumann in the pressure. The ghost nodes of periodic
+      // boundaries copy the inner node at the opposite end, see the displacements in the constructor.
+      if (parameters.walls.typeLeft == DIRICHLET || parameters.walls.typeLeft == PERIODIC) {
         stencilValues[0] = 1;
         stencilValues[1] = -1;
       } else if (parameters.walls.typeLeft == NEUMANN) { // Neumann velocity boundary conditions
@@ -506,7 +1321,7 @@ PetscErrorCode computeMatrix2D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
       column[1].j = j;
       row.i       = Nx - 1;
       row.j       = j;
-      if (parameters.walls.typeRight == DIRICHLET) {
+      if (parameters.walls.typeRight == DIRICHLET || parameters.walls.typeRight == PERIODIC) {
         stencilValues[0] = 1;
         stencilValues[1] = -1;
       } else if (parameters.walls.typeRight == NEUMANN) {
@@ -526,7 +1341,7 @@ PetscErrorCode computeMatrix2D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
       column[1].j = context->displacement[2];
       row.i       = i;
       row.j       = 0;
-      if (parameters.walls.typeBottom == DIRICHLET) {
+      if (parameters.walls.typeBottom == DIRICHLET || parameters.walls.typeBottom == PERIODIC) {
         stencilValues[0] = 1;
         stencilValues[1] = -1;
       } else if (parameters.walls.typeBottom == NEUMANN) {
@@ -546,7 +1361,7 @@ PetscErrorCode computeMatrix2D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
       column[1].j = context->displacement[3];
       row.i       = i;
       row.j       = Ny - 1;
-      if (parameters.walls.typeTop == DIRICHLET) {
+      if (parameters.walls.typeTop == DIRICHLET || parameters.walls.typeTop == PERIODIC) {
         stencilValues[0] = 1;
         stencilValues[1] = -1;
       } else if (parameters.walls.typeTop == NEUMANN) {
@@ -557,13 +1372,17 @@ PetscErrorCode computeMatrix2D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
     }
   }
 
+  // Corners and edges
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil& inner) {
+    const MatStencil  columns[2] = {node, inner};
+    const PetscScalar values[2]  = {1.0, -1.0};
+    MatSetValuesStencil(A, 1, &node, 2, columns, values, INSERT_VALUES);
+  });
+
   MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
   MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
 
-  MatNullSpace nullspace;
-  MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, 0, &nullspace);
-  MatSetNullSpace(A, nullspace);
-  MatNullSpaceDestroy(&nullspace);
+  setConstantNullSpace(A, *context);
 
   return 0;
 }
@@ -572,7 +1391,13 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
   Solvers::PetscUserCtx* context    = static_cast<Solvers::PetscUserCtx*>(ctx);
   Parameters&            parameters = context->getParameters();
 
-  IntScalarField& flags = context->getFlowField().getFlags();
+  const Solvers::PressureOperator& pressureOperator = context->getPressureOperator();
+  const RealType* const            lowerX           = pressureOperator.getLower(0);
+  const RealType* const            upperX           = pressureOperator.getUpper(0);
+  const RealType* const            lowerY           = pressureOperator.getLower(1);
+  const RealType* const            upperY           = pressureOperator.getUpper(1);
+  const RealType* const            lowerZ           = pressureOperator.getLower(2);
+  const RealType* const            upperZ           = pressureOperator.getUpper(2);
 
   int *limitsX, *limitsY, *limitsZ;
   context->getLimits(&limitsX, &limitsY, &limitsZ);
@@ -599,176 +1424,47 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
         const int cellIndexX = i - limitsX[0] + 2;
         const int cellIndexY = j - limitsY[0] + 2;
         const int cellIndexZ = k - limitsZ[0] + 2;
-        const int obstacle   = flags.getValue(cellIndexX, cellIndexY, cellIndexZ);
-
-        if ((obstacle & OBSTACLE_SELF) == 0) { // If the cell is fluid
-          const RealType dx_0  = parameters.meshsize->getDx(cellIndexX, cellIndexY, cellIndexZ);
-          const RealType dx_M1 = parameters.meshsize->getDx(cellIndexX - 1, cellIndexY, cellIndexZ);
-          const RealType dx_P1 = parameters.meshsize->getDx(cellIndexX + 1, cellIndexY, cellIndexZ);
-          const RealType dy_0  = parameters.meshsize->getDy(cellIndexX, cellIndexY, cellIndexZ);
-          const RealType dy_M1 = parameters.meshsize->getDy(cellIndexX, cellIndexY - 1, cellIndexZ);
-          const RealType dy_P1 = parameters.meshsize->getDy(cellIndexX, cellIndexY + 1, cellIndexZ);
-          const RealType dz_0  = parameters.meshsize->getDz(cellIndexX, cellIndexY, cellIndexZ);
-          const RealType dz_M1 = parameters.meshsize->getDz(cellIndexX, cellIndexY, cellIndexZ - 1);
-          const RealType dz_P1 = parameters.meshsize->getDz(cellIndexX, cellIndexY, cellIndexZ + 1);
-
-          const RealType dx_L  = 0.5 * (dx_0 + dx_M1);
-          const RealType dx_R  = 0.5 * (dx_0 + dx_P1);
-          const RealType dx_Bo = 0.5 * (dy_0 + dy_M1);
-          const RealType dx_T  = 0.5 * (dy_0 + dy_P1);
-          const RealType dx_F  = 0.5 * (dz_0 + dz_M1);
-          const RealType dx_B  = 0.5 * (dz_0 + dz_P1);
-
-          // Definition of values
-          stencilValues[1] = 2.0 / (dx_L * (dx_L + dx_R));                                      // Left
-          stencilValues[0] = 2.0 / (dx_R * (dx_L + dx_R));                                      // Right
-          stencilValues[2] = 2.0 / (dx_T * (dx_T + dx_Bo));                                     // Top
-          stencilValues[3] = 2.0 / (dx_Bo * (dx_T + dx_Bo));                                    // Bottom
-          stencilValues[4] = 2.0 / (dx_B * (dx_B + dx_F));                                      // Back
-          stencilValues[5] = 2.0 / (dx_F * (dx_B + dx_F));                                      // Front
-          stencilValues[6] = -2.0 / (dx_R * dx_L) - 2.0 / (dx_T * dx_Bo) - 2.0 / (dx_F * dx_B); // Center
-
-          // Definition of positions. Order must correspond to values.
-          column[0].i = i + 1;
-          column[0].j = j;
-          column[0].k = k;
-          column[1].i = i - 1;
-          column[1].j = j;
-          column[1].k = k;
-          column[2].i = i;
-          column[2].j = j + 1;
-          column[2].k = k;
-          column[3].i = i;
-          column[3].j = j - 1;
-          column[3].k = k;
-          column[4].i = i;
-          column[4].j = j;
-          column[4].k = k + 1;
-          column[5].i = i;
-          column[5].j = j;
-          column[5].k = k - 1;
-          column[6].i = i;
-          column[6].j = j;
-          column[6].k = k;
-
-          MatSetValuesStencil(A, 1, &row, 7, column, stencilValues, INSERT_VALUES);
-        } else if (obstacle != 127) { // If non-fluid and still not completely surounded
-          int counter      = 0;
-          int counterFluid = 0;
-          if ((obstacle & OBSTACLE_LEFT) == 0) { // If there's fluid to the left
-            stencilValues[counter] = 1;
-            column[counter].i      = i - 1;
-            column[counter].j = j, column[counter].k = k;
-            counter++;
-            counterFluid++;
-          } else {
-            stencilValues[counter] = 0.0;
-            column[counter].i      = i - 1;
-            column[counter].j = j, column[counter].k = k;
-            counter++;
-          }
-          if ((obstacle & OBSTACLE_RIGHT) == 0) {
-            stencilValues[counter] = 1;
-            column[counter].i      = i + 1;
-            column[counter].j = j, column[counter].k = k;
-            counter++;
-            counterFluid++;
-          } else {
-            stencilValues[counter] = 0.0;
-            column[counter].i      = i + 1;
-            column[counter].j = j, column[counter].k = k;
-            counter++;
-          }
-          if ((obstacle & OBSTACLE_BOTTOM) == 0) {
-            stencilValues[counter] = 1;
-            column[counter].i      = i;
-            column[counter].j = j - 1, column[counter].k = k;
-            counter++;
-            counterFluid++;
-          } else {
-            stencilValues[counter] = 0.0;
-            column[counter].i      = i;
-            column[counter].j = j - 1, column[counter].k = k;
-            counter++;
-          }
-          if ((obstacle & OBSTACLE_TOP) == 0) {
-            stencilValues[counter] = 1;
-            column[counter].i      = i;
-            column[counter].j = j + 1, column[counter].k = k;
-            counter++;
-            counterFluid++;
-          } else {
-            stencilValues[counter] = 0.0;
-            column[counter].i      = i;
-            column[counter].j = j + 1, column[counter].k = k;
-            counter++;
-          }
-          if ((obstacle & OBSTACLE_FRONT) == 0) {
-            stencilValues[counter] = 1;
-            column[counter].i      = i;
-            column[counter].j = j, column[counter].k = k - 1;
-            counter++;
-            counterFluid++;
-          } else {
-            stencilValues[counter] = 0.0;
-            column[counter].i      = i;
-            column[counter].j = j, column[counter].k = k - 1;
-            counter++;
-          }
-          if ((obstacle & OBSTACLE_BACK) == 0) {
-            stencilValues[counter] = 1;
-            column[counter].i      = i;
-            column[counter].j = j, column[counter].k = k + 1;
-            counter++;
-            counterFluid++;
-          } else {
-            stencilValues[counter] = 0.0;
-            column[counter].i      = i;
-            column[counter].j = j, column[counter].k = k + 1;
-            counter++;
-          }
 
-          // Now set a line for the element itself
-          stencilValues[counter] = static_cast<PetscScalar>(-counterFluid);
-          column[counter].i      = i;
-          column[counter].j = j, column[counter].k = k;
-
-          MatSetValuesStencil(A, 1, &row, counter + 1, column, stencilValues, INSERT_VALUES);
-        } else { // The remaining possibility is that the cell is obstacle surrounded
-                 // by more obstacle cells.
-          // Here, we just add an equation to set the value according to the right hand side.
-          stencilValues[1] = 0.0; // Left
-          stencilValues[0] = 0.0; // Right
-          stencilValues[3] = 0.0; // Top
-          stencilValues[4] = 0.0; // Bottom
-          stencilValues[5] = 0.0; // Front
-          stencilValues[5] = 0.0; // Back
-          stencilValues[2] = 1.0; // Center
-
-          // Definition of positions. Order must correspond to values
-          column[0].i = i + 1;
-          column[0].j = j;
-          column[0].k = k;
-          column[1].i = i - 1;
-          column[1].j = j;
-          column[1].k = k;
-          column[2].i = i;
-          column[2].j = j;
-          column[2].k = k;
-          column[3].i = i;
-          column[3].j = j + 1;
-          column[3].k = k;
-          column[4].i = i;
-          column[4].j = j - 1;
-          column[4].k = k;
-          column[5].i = i;
-          column[5].j = j;
-          column[5].k = k + 1;
-          column[6].i = i;
-          column[6].j = j;
-          column[6].k = k - 1;
-          MatSetValuesStencil(A, 1, &row, 7, column, stencilValues, INSERT_VALUES);
+        // Definition of positions. Order must correspond to values.
+        column[0].i = i - 1; // Left
+        column[0].j = j;
+        column[0].k = k;
+        column[1].i = i + 1; // Right
+        column[1].j = j;
+        column[1].k = k;
+        column[2].i = i; // Bottom
+        column[2].j = j - 1;
+        column[2].k = k;
+        column[3].i = i; // Top
+        column[3].j = j + 1;
+        column[3].k = k;
+        column[4].i = i; // Front
+        column[4].j = j;
+        column[4].k = k - 1;
+        column[5].i = i; // Back
+        column[5].j = j;
+        column[5].k = k + 1;
+        column[6].i = i; // Center
+        column[6].j = j;
+        column[6].k = k;
+
+        const Solvers::PressureOperator::ObstacleRow* obstacle = pressureOperator.findObstacleRow(cellIndexX, cellIndexY, cellIndexZ);
+
+        if (obstacle == nullptr) { // If the cell is fluid
+          stencilValues[0] = lowerX[cellIndexX];
+          stencilValues[1] = upperX[cellIndexX];
+          stencilValues[2] = lowerY[cellIndexY];
+          stencilValues[3] = upperY[cellIndexY];
+          stencilValues[4] = lowerZ[cellIndexZ];
+          stencilValues[5] = upperZ[cellIndexZ];
+          stencilValues[6] = pressureOperator.getCentre(cellIndexX, cellIndexY, cellIndexZ);
+        } else { // Obstacle cells take the explicit row of the operator
+          for (int n = 0; n < 7; n++) {
+            stencilValues[n] = obstacle->values[n];
+          }
         }
+
+        MatSetValuesStencil(A, 1, &row, 7, column, stencilValues, INSERT_VALUES);
       }
     }
   }
@@ -786,7 +1482,8 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
         row.i       = 0;
         row.j       = j;
         row.k       = k;
-        if (parameters.walls.typeLeft == DIRICHLET) {
+        // Neumann in the pressure for Dirichlet velocities, periodic ghost nodes copy the opposite inner node
+        if (parameters.walls.typeLeft == DIRICHLET || parameters.walls.typeLeft == PERIODIC) {
           stencilValues[0] = 1;
           stencilValues[1] = -1;
         } else if (parameters.walls.typeLeft == NEUMANN) {
@@ -811,7 +1508,7 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
         row.i       = Nx - 1;
         row.j       = j;
         row.k       = k;
-        if (parameters.walls.typeRight == DIRICHLET) {
+        if (parameters.walls.typeRight == DIRICHLET || parameters.walls.typeRight == PERIODIC) {
           stencilValues[0] = 1;
           stencilValues[1] = -1;
         } else if (parameters.walls.typeRight == NEUMANN) {
@@ -836,7 +1533,7 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
         row.i       = i;
         row.j       = 0;
         row.k       = k;
-        if (parameters.walls.typeBottom == DIRICHLET) {
+        if (parameters.walls.typeBottom == DIRICHLET || parameters.walls.typeBottom == PERIODIC) {
           stencilValues[0] = 1;
           stencilValues[1] = -1;
         } else if (parameters.walls.typeBottom == NEUMANN) {
@@ -861,7 +1558,7 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
         row.i       = i;
         row.j       = Ny - 1;
         row.k       = k;
-        if (parameters.walls.typeTop == DIRICHLET) {
+        if (parameters.walls.typeTop == DIRICHLET || parameters.walls.typeTop == PERIODIC) {
           stencilValues[0] = 1;
           stencilValues[1] = -1;
         } else if (parameters.walls.typeTop == NEUMANN) {
@@ -886,7 +1583,7 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
         row.i       = i;
         row.j       = j;
         row.k       = 0;
-        if (parameters.walls.typeFront == DIRICHLET) {
+        if (parameters.walls.typeFront == DIRICHLET || parameters.walls.typeFront == PERIODIC) {
           stencilValues[0] = 1;
           stencilValues[1] = -1;
         } else if (parameters.walls.typeFront == NEUMANN) {
@@ -911,7 +1608,7 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
         row.i       = i;
         row.j       = j;
         row.k       = Nz - 1;
-        if (parameters.walls.typeBack == DIRICHLET) {
+        if (parameters.walls.typeBack == DIRICHLET || parameters.walls.typeBack == PERIODIC) {
           stencilValues[0] = 1;
           stencilValues[1] = -1;
         } else if (parameters.walls.typeBack == NEUMANN) {
@@ -923,18 +1620,22 @@ PetscErrorCode computeMatrix3D([[maybe_unused]] KSP ksp, Mat A, [[maybe_unused]]
     }
   }
 
+  // Corners and edges
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil& inner) {
+    const MatStencil  columns[2] = {node, inner};
+    const PetscScalar values[2]  = {1.0, -1.0};
+    MatSetValuesStencil(A, 1, &node, 2, columns, values, INSERT_VALUES);
+  });
+
   MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
   MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY);
 
-  MatNullSpace nullspace;
-  MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_TRUE, 0, 0, &nullspace);
-  MatSetNullSpace(A, nullspace);
-  MatNullSpaceDestroy(&nullspace);
+  setConstantNullSpace(A, *context);
 
   return 0;
 }
 
-PetscErrorCode computeRHS2D(KSP ksp, Vec b, void* ctx) {
+PetscErrorCode computeRHS2D([[maybe_unused]] KSP ksp, Vec b, void* ctx) {
   FlowField&             flowField  = static_cast<Solvers::PetscUserCtx*>(ctx)->getFlowField();
   Parameters&            parameters = static_cast<Solvers::PetscUserCtx*>(ctx)->getParameters();
   Solvers::PetscUserCtx* context    = static_cast<Solvers::PetscUserCtx*>(ctx);
@@ -942,23 +1643,21 @@ PetscErrorCode computeRHS2D(KSP ksp, Vec b, void* ctx) {
   int *limitsX, *limitsY, *limitsZ;
   static_cast<Solvers::PetscUserCtx*>(ctx)->getLimits(&limitsX, &limitsY, &limitsZ);
 
-  IntScalarField& flags = context->getFlowField().getFlags();
-
   ScalarField& RHS = flowField.getRHS();
 
   PetscInt      i, j;
   PetscInt      Nx = parameters.geometry.sizeX + 2, Ny = parameters.geometry.sizeY + 2;
   PetscScalar** array;
 
-  DM da;
-  KSPGetDM(ksp, &da);
+  DM da = context->getGrid();
 
   DMDAVecGetArray(da, b, &array);
 
   // Iteration domains are going to be set and the values on the global boundary set when necessary
   // Check left wall
   if (context->setAsBoundary & LEFT_WALL_BIT) {
-    if (parameters.simulation.scenario == "pressure-channel") {
+    // The increments of the incremental projection vanish on the Dirichlet wall
+    if (parameters.simulation.scenario == "pressure-channel" && !parameters.solver.incremental) {
       for (j = limitsY[0]; j < limitsY[1]; j++) {
         array[j][0] = RHS.getScalar(0, j);
       }
@@ -990,33 +1689,33 @@ PetscErrorCode computeRHS2D(KSP ksp, Vec b, void* ctx) {
     }
   }
 
-  // Fill the internal nodes. We already have the values.
+  // Fill the internal nodes. We already have the values, the rows along x are contiguous in both storages.
+  const int rowLength = limitsX[1] - limitsX[0];
   for (j = limitsY[0]; j < limitsY[1]; j++) {
-    for (i = limitsX[0]; i < limitsX[1]; i++) {
-      const int obstacle = flags.getValue(i - limitsX[0] + 2, j - limitsY[0] + 2);
-      if ((obstacle & OBSTACLE_SELF) == 0) { // If this is a fluid cell
-        array[j][i] = RHS.getScalar(i - limitsX[0] + 2, j - limitsY[0] + 2);
-      } else {
-        array[j][i] = 0.0;
-      }
-    }
+    const RealType* row = &RHS.getScalar(2, j - limitsY[0] + 2);
+    std::copy(row, row + rowLength, &array[j][limitsX[0]]);
+  }
+  for (const Solvers::PressureOperator::ObstacleRow& row : context->getPressureOperator().getObstacleRows()) {
+    array[row.j - 2 + limitsY[0]][row.i - 2 + limitsX[0]] = 0.0;
+  }
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil&) { array[node.j][node.i] = 0.0; });
+
+  if (context->singular) {
+    removeIncompatibleRhs(*context, [&](PetscInt i, PetscInt j, PetscInt) -> PetscScalar& { return array[j][i]; });
   }
 
+  // Only local entries were written, the vector needs no assembly
   DMDAVecRestoreArray(da, b, &array);
-  VecAssemblyBegin(b);
-  VecAssemblyEnd(b);
 
   return 0;
 }
 
-PetscErrorCode computeRHS3D(KSP ksp, Vec b, void* ctx) {
+PetscErrorCode computeRHS3D([[maybe_unused]] KSP ksp, Vec b, void* ctx) {
   FlowField&             flowField  = static_cast<Solvers::PetscUserCtx*>(ctx)->getFlowField();
   Parameters&            parameters = static_cast<Solvers::PetscUserCtx*>(ctx)->getParameters();
   ScalarField&           RHS        = flowField.getRHS();
   Solvers::PetscUserCtx* context    = static_cast<Solvers::PetscUserCtx*>(ctx);
 
-  IntScalarField& flags = flowField.getFlags();
-
   int *limitsX, *limitsY, *limitsZ;
   static_cast<Solvers::PetscUserCtx*>(ctx)->getLimits(&limitsX, &limitsY, &limitsZ);
 
@@ -1024,8 +1723,7 @@ PetscErrorCode computeRHS3D(KSP ksp, Vec b, void* ctx) {
   PetscInt Nx = parameters.geometry.sizeX + 2, Ny = parameters.geometry.sizeY + 2, Nz = parameters.geometry.sizeZ + 2;
   PetscScalar*** array;
 
-  DM da;
-  KSPGetDM(ksp, &da);
+  DM da = context->getGrid();
 
   DMDAVecGetArray(da, b, &array);
 
@@ -1034,7 +1732,8 @@ PetscErrorCode computeRHS3D(KSP ksp, Vec b, void* ctx) {
 
   // Left wall
   if (context->setAsBoundary & LEFT_WALL_BIT) {
-    if (parameters.simulation.scenario == "pressure-channel") {
+    // The increments of the incremental projection vanish on the Dirichlet wall
+    if (parameters.simulation.scenario == "pressure-channel" && !parameters.solver.incremental) {
       for (k = limitsZ[0]; k < limitsZ[1]; k++) {
         for (j = limitsY[0]; j < limitsY[1]; j++) {
           array[k][j][0] = RHS.getScalar(0, j, k);
@@ -1094,29 +1793,352 @@ PetscErrorCode computeRHS3D(KSP ksp, Vec b, void* ctx) {
     }
   }
 
-  // Fill the internal nodes. We already have the values.
+  // Fill the internal nodes. We already have the values, the rows along x are contiguous in both storages.
+  const int rowLength = limitsX[1] - limitsX[0];
   for (k = limitsZ[0]; k < limitsZ[1]; k++) {
     for (j = limitsY[0]; j < limitsY[1]; j++) {
-      for (i = limitsX[0]; i < limitsX[1]; i++) {
-        const int obstacle = flags.getValue(i - limitsX[0] + 2, j - limitsY[0] + 2, k - limitsZ[0] + 2);
-        if ((obstacle & OBSTACLE_SELF) == 0) { // If this is a fluid cell
-          array[k][j][i] = RHS.getScalar(i - limitsX[0] + 2, j - limitsY[0] + 2, k - limitsZ[0] + 2);
-        } else {
-          array[k][j][i] = 0.0;
-        }
-      }
+      const RealType* row = &RHS.getScalar(2, j - limitsY[0] + 2, k - limitsZ[0] + 2);
+      std::copy(row, row + rowLength, &array[k][j][limitsX[0]]);
     }
   }
+  for (const Solvers::PressureOperator::ObstacleRow& row : context->getPressureOperator().getObstacleRows()) {
+    array[row.k - 2 + limitsZ[0]][row.j - 2 + limitsY[0]][row.i - 2 + limitsX[0]] = 0.0;
+  }
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil&) { array[node.k][node.j][node.i] = 0.0; });
+
+  if (context->singular) {
+    removeIncompatibleRhs(*context, [&](PetscInt i, PetscInt j, PetscInt k) -> PetscScalar& { return array[k][j][i]; });
+  }
 
+  // Only local entries were written, the vector needs no assembly
   DMDAVecRestoreArray(da, b, &array);
-  VecAssemblyBegin(b);
-  VecAssemblyEnd(b);
+
+  return 0;
+}
+
+// Rows of the global boundary as assembled in computeMatrix2D() and computeMatrix3D(): Neumann in the pressure for
+// Dirichlet velocities, the average of the two cells for Neumann velocities and a copy of the opposite inner node for
+// periodic boundaries
+static inline PetscScalar applyBoundaryRow(BoundaryType type, PetscScalar boundary, PetscScalar other) {
+  if (type == DIRICHLET || type == PERIODIC) {
+    return boundary - other;
+  } else if (type == NEUMANN) {
+    return 0.5 * (boundary + other);
+  }
+  return 0.0;
+}
+
+static inline PetscScalar getBoundaryDiagonal(BoundaryType type) {
+  if (type == DIRICHLET || type == PERIODIC) {
+    return 1.0;
+  } else if (type == NEUMANN) {
+    return 0.5;
+  }
+  return 0.0;
+}
+
+PetscErrorCode applyOperator2D(Mat A, Vec x, Vec y) {
+  Solvers::PetscUserCtx* context;
+  MatShellGetContext(A, &context);
+  Parameters& parameters = context->getParameters();
+
+  const Solvers::PressureOperator& pressureOperator = context->getPressureOperator();
+  const RealType* const            lowerX           = pressureOperator.getLower(0);
+  const RealType* const            upperX           = pressureOperator.getUpper(0);
+  const RealType* const            lowerY           = pressureOperator.getLower(1);
+  const RealType* const            upperY           = pressureOperator.getUpper(1);
+
+  int *limitsX, *limitsY, *limitsZ;
+  context->getLimits(&limitsX, &limitsY, &limitsZ);
+
+  const PetscInt Nx = parameters.geometry.sizeX + 2, Ny = parameters.geometry.sizeY + 2;
+
+  // The stencil needs the neighbours owned by other processes and the periodic images
+  DM  da = context->getGrid();
+  Vec local;
+  DMGetLocalVector(da, &local);
+  DMGlobalToLocalBegin(da, x, INSERT_VALUES, local);
+  DMGlobalToLocalEnd(da, x, INSERT_VALUES, local);
+
+  const PetscScalar** in;
+  PetscScalar**       out;
+  DMDAVecGetArrayRead(da, local, &in);
+  DMDAVecGetArray(da, y, &out);
+
+  for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+    const int cellIndexY = j - limitsY[0] + 2;
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      const int cellIndexX = i - limitsX[0] + 2;
+      out[j][i] = lowerX[cellIndexX] * in[j][i - 1] + upperX[cellIndexX] * in[j][i + 1]
+                  + lowerY[cellIndexY] * in[j - 1][i] + upperY[cellIndexY] * in[j + 1][i]
+                  + pressureOperator.getCentre(cellIndexX, cellIndexY) * in[j][i];
+    }
+  }
+
+  // Obstacle cells take the explicit row of the operator
+  for (const Solvers::PressureOperator::ObstacleRow& row : pressureOperator.getObstacleRows()) {
+    const PetscInt i = row.i - 2 + limitsX[0];
+    const PetscInt j = row.j - 2 + limitsY[0];
+    out[j][i] = row.values[Solvers::PressureOperator::West] * in[j][i - 1]
+                + row.values[Solvers::PressureOperator::East] * in[j][i + 1]
+                + row.values[Solvers::PressureOperator::South] * in[j - 1][i]
+                + row.values[Solvers::PressureOperator::North] * in[j + 1][i]
+                + row.values[Solvers::PressureOperator::Centre] * in[j][i];
+  }
+
+  if (context->setAsBoundary & LEFT_WALL_BIT) {
+    for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+      out[j][0] = applyBoundaryRow(parameters.walls.typeLeft, in[j][0], in[j][context->displacement[0]]);
+    }
+  }
+  if (context->setAsBoundary & RIGHT_WALL_BIT) {
+    for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+      out[j][Nx - 1] = applyBoundaryRow(parameters.walls.typeRight, in[j][Nx - 1], in[j][context->displacement[1]]);
+    }
+  }
+  if (context->setAsBoundary & BOTTOM_WALL_BIT) {
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      out[0][i] = applyBoundaryRow(parameters.walls.typeBottom, in[0][i], in[context->displacement[2]][i]);
+    }
+  }
+  if (context->setAsBoundary & TOP_WALL_BIT) {
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      out[Ny - 1][i] = applyBoundaryRow(parameters.walls.typeTop, in[Ny - 1][i], in[context->displacement[3]][i]);
+    }
+  }
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil& inner) {
+    out[node.j][node.i] = in[node.j][node.i] - in[inner.j][inner.i];
+  });
+
+  DMDAVecRestoreArray(da, y, &out);
+  DMDAVecRestoreArrayRead(da, local, &in);
+  DMRestoreLocalVector(da, &local);
+
+  return 0;
+}
+
+PetscErrorCode applyOperator3D(Mat A, Vec x, Vec y) {
+  Solvers::PetscUserCtx* context;
+  MatShellGetContext(A, &context);
+  Parameters& parameters = context->getParameters();
+
+  const Solvers::PressureOperator& pressureOperator = context->getPressureOperator();
+  const RealType* const            lowerX           = pressureOperator.getLower(0);
+  const RealType* const            upperX           = pressureOperator.getUpper(0);
+  const RealType* const            lowerY           = pressureOperator.getLower(1);
+  const RealType* const            upperY           = pressureOperator.getUpper(1);
+  const RealType* const            lowerZ           = pressureOperator.getLower(2);
+  const RealType* const            upperZ           = pressureOperator.getUpper(2);
+
+  int *limitsX, *limitsY, *limitsZ;
+  context->getLimits(&limitsX, &limitsY, &limitsZ);
+
+  const PetscInt Nx = parameters.geometry.sizeX + 2, Ny = parameters.geometry.sizeY + 2;
+  const PetscInt Nz = parameters.geometry.sizeZ + 2;
+
+  DM  da = context->getGrid();
+  Vec local;
+  DMGetLocalVector(da, &local);
+  DMGlobalToLocalBegin(da, x, INSERT_VALUES, local);
+  DMGlobalToLocalEnd(da, x, INSERT_VALUES, local);
+
+  const PetscScalar*** in;
+  PetscScalar***       out;
+  DMDAVecGetArrayRead(da, local, &in);
+  DMDAVecGetArray(da, y, &out);
+
+  for (PetscInt k = limitsZ[0]; k < limitsZ[1]; k++) {
+    const int cellIndexZ = k - limitsZ[0] + 2;
+    for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+      const int cellIndexY = j - limitsY[0] + 2;
+      for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+        const int cellIndexX = i - limitsX[0] + 2;
+        out[k][j][i] = lowerX[cellIndexX] * in[k][j][i - 1] + upperX[cellIndexX] * in[k][j][i + 1]
+                       + lowerY[cellIndexY] * in[k][j - 1][i] + upperY[cellIndexY] * in[k][j + 1][i]
+                       + lowerZ[cellIndexZ] * in[k - 1][j][i] + upperZ[cellIndexZ] * in[k + 1][j][i]
+                       + pressureOperator.getCentre(cellIndexX, cellIndexY, cellIndexZ) * in[k][j][i];
+      }
+    }
+  }
+
+  for (const Solvers::PressureOperator::ObstacleRow& row : pressureOperator.getObstacleRows()) {
+    const PetscInt i = row.i - 2 + limitsX[0];
+    const PetscInt j = row.j - 2 + limitsY[0];
+    const PetscInt k = row.k - 2 + limitsZ[0];
+    out[k][j][i] = row.values[Solvers::PressureOperator::West] * in[k][j][i - 1]
+                   + row.values[Solvers::PressureOperator::East] * in[k][j][i + 1]
+                   + row.values[Solvers::PressureOperator::South] * in[k][j - 1][i]
+                   + row.values[Solvers::PressureOperator::North] * in[k][j + 1][i]
+                   + row.values[Solvers::PressureOperator::Bottom] * in[k - 1][j][i]
+                   + row.values[Solvers::PressureOperator::Top] * in[k + 1][j][i]
+                   + row.values[Solvers::PressureOperator::Centre] * in[k][j][i];
+  }
+
+  for (PetscInt k = limitsZ[0]; k < limitsZ[1]; k++) {
+    for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+      if (context->setAsBoundary & LEFT_WALL_BIT) {
+        out[k][j][0] = applyBoundaryRow(parameters.walls.typeLeft, in[k][j][0], in[k][j][context->displacement[0]]);
+      }
+      if (context->setAsBoundary & RIGHT_WALL_BIT) {
+        out[k][j][Nx - 1] = applyBoundaryRow(
+          parameters.walls.typeRight, in[k][j][Nx - 1], in[k][j][context->displacement[1]]
+        );
+      }
+    }
+  }
+  for (PetscInt k = limitsZ[0]; k < limitsZ[1]; k++) {
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      if (context->setAsBoundary & BOTTOM_WALL_BIT) {
+        out[k][0][i] = applyBoundaryRow(parameters.walls.typeBottom, in[k][0][i], in[k][context->displacement[2]][i]);
+      }
+      if (context->setAsBoundary & TOP_WALL_BIT) {
+        out[k][Ny - 1][i] = applyBoundaryRow(
+          parameters.walls.typeTop, in[k][Ny - 1][i], in[k][context->displacement[3]][i]
+        );
+      }
+    }
+  }
+  for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      if (context->setAsBoundary & FRONT_WALL_BIT) {
+        out[0][j][i] = applyBoundaryRow(parameters.walls.typeFront, in[0][j][i], in[context->displacement[4]][j][i]);
+      }
+      if (context->setAsBoundary & BACK_WALL_BIT) {
+        out[Nz - 1][j][i] = applyBoundaryRow(
+          parameters.walls.typeBack, in[Nz - 1][j][i], in[context->displacement[5]][j][i]
+        );
+      }
+    }
+  }
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil& inner) {
+    out[node.k][node.j][node.i] = in[node.k][node.j][node.i] - in[inner.k][inner.j][inner.i];
+  });
+
+  DMDAVecRestoreArray(da, y, &out);
+  DMDAVecRestoreArrayRead(da, local, &in);
+  DMRestoreLocalVector(da, &local);
+
+  return 0;
+}
+
+PetscErrorCode getOperatorDiagonal2D(Mat A, Vec diagonal) {
+  Solvers::PetscUserCtx* context;
+  MatShellGetContext(A, &context);
+  Parameters& parameters = context->getParameters();
+
+  const Solvers::PressureOperator& pressureOperator = context->getPressureOperator();
+
+  int *limitsX, *limitsY, *limitsZ;
+  context->getLimits(&limitsX, &limitsY, &limitsZ);
+
+  const PetscInt Nx = parameters.geometry.sizeX + 2, Ny = parameters.geometry.sizeY + 2;
+
+  DM da = context->getGrid();
+  VecSet(diagonal, 0.0);
+  PetscScalar** array;
+  DMDAVecGetArray(da, diagonal, &array);
+
+  for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      array[j][i] = pressureOperator.getCentre(i - limitsX[0] + 2, j - limitsY[0] + 2);
+    }
+  }
+  for (const Solvers::PressureOperator::ObstacleRow& row : pressureOperator.getObstacleRows()) {
+    array[row.j - 2 + limitsY[0]][row.i - 2 + limitsX[0]] = row.values[Solvers::PressureOperator::Centre];
+  }
+
+  for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+    if (context->setAsBoundary & LEFT_WALL_BIT) {
+      array[j][0] = getBoundaryDiagonal(parameters.walls.typeLeft);
+    }
+    if (context->setAsBoundary & RIGHT_WALL_BIT) {
+      array[j][Nx - 1] = getBoundaryDiagonal(parameters.walls.typeRight);
+    }
+  }
+  for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+    if (context->setAsBoundary & BOTTOM_WALL_BIT) {
+      array[0][i] = getBoundaryDiagonal(parameters.walls.typeBottom);
+    }
+    if (context->setAsBoundary & TOP_WALL_BIT) {
+      array[Ny - 1][i] = getBoundaryDiagonal(parameters.walls.typeTop);
+    }
+  }
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil&) { array[node.j][node.i] = 1.0; });
+
+  DMDAVecRestoreArray(da, diagonal, &array);
+
+  return 0;
+}
+
+PetscErrorCode getOperatorDiagonal3D(Mat A, Vec diagonal) {
+  Solvers::PetscUserCtx* context;
+  MatShellGetContext(A, &context);
+  Parameters& parameters = context->getParameters();
+
+  const Solvers::PressureOperator& pressureOperator = context->getPressureOperator();
+
+  int *limitsX, *limitsY, *limitsZ;
+  context->getLimits(&limitsX, &limitsY, &limitsZ);
+
+  const PetscInt Nx = parameters.geometry.sizeX + 2, Ny = parameters.geometry.sizeY + 2;
+  const PetscInt Nz = parameters.geometry.sizeZ + 2;
+
+  DM da = context->getGrid();
+  VecSet(diagonal, 0.0);
+  PetscScalar*** array;
+  DMDAVecGetArray(da, diagonal, &array);
+
+  for (PetscInt k = limitsZ[0]; k < limitsZ[1]; k++) {
+    for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+      for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+        array[k][j][i] = pressureOperator.getCentre(i - limitsX[0] + 2, j - limitsY[0] + 2, k - limitsZ[0] + 2);
+      }
+    }
+  }
+  for (const Solvers::PressureOperator::ObstacleRow& row : pressureOperator.getObstacleRows()) {
+    array[row.k - 2 + limitsZ[0]][row.j - 2 + limitsY[0]][row.i - 2 + limitsX[0]]
+      = row.values[Solvers::PressureOperator::Centre];
+  }
+
+  for (PetscInt k = limitsZ[0]; k < limitsZ[1]; k++) {
+    for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+      if (context->setAsBoundary & LEFT_WALL_BIT) {
+        array[k][j][0] = getBoundaryDiagonal(parameters.walls.typeLeft);
+      }
+      if (context->setAsBoundary & RIGHT_WALL_BIT) {
+        array[k][j][Nx - 1] = getBoundaryDiagonal(parameters.walls.typeRight);
+      }
+    }
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      if (context->setAsBoundary & BOTTOM_WALL_BIT) {
+        array[k][0][i] = getBoundaryDiagonal(parameters.walls.typeBottom);
+      }
+      if (context->setAsBoundary & TOP_WALL_BIT) {
+        array[k][Ny - 1][i] = getBoundaryDiagonal(parameters.walls.typeTop);
+      }
+    }
+  }
+  for (PetscInt j = limitsY[0]; j < limitsY[1]; j++) {
+    for (PetscInt i = limitsX[0]; i < limitsX[1]; i++) {
+      if (context->setAsBoundary & FRONT_WALL_BIT) {
+        array[0][j][i] = getBoundaryDiagonal(parameters.walls.typeFront);
+      }
+      if (context->setAsBoundary & BACK_WALL_BIT) {
+        array[Nz - 1][j][i] = getBoundaryDiagonal(parameters.walls.typeBack);
+      }
+    }
+  }
+  forEachEdgeNode(*context, [&](const MatStencil& node, const MatStencil&) { array[node.k][node.j][node.i] = 1.0; });
+
+  DMDAVecRestoreArray(da, diagonal, &array);
 
   return 0;
 }
 
 const DM& Solvers::PetscSolver::getGrid() const { return da_; }
 
+const KSP& Solvers::PetscSolver::getKrylovSolver() const { return ksp_; }
+
 void Solvers::PetscUserCtx::setLimits(int* limitsX, int* limitsY, int* limitsZ) {
   limitsX_ = limitsX;
   limitsY_ = limitsY;
@@ -1133,8 +2155,28 @@ void Solvers::PetscUserCtx::setRank(int rank) { rank_ = rank; }
 
 int Solvers::PetscUserCtx::getRank() const { return rank_; }
 
+void Solvers::PetscUserCtx::setPressureOperator(const PressureOperator* pressureOperator) {
+  pressureOperator_ = pressureOperator;
+}
+
+const Solvers::PressureOperator& Solvers::PetscUserCtx::getPressureOperator() const { return *pressureOperator_; }
+
+void Solvers::PetscUserCtx::setGrid(DM grid) { grid_ = grid; }
+
+DM Solvers::PetscUserCtx::getGrid() const { return grid_; }
+
 void Solvers::PetscSolver::reInitMatrix() {
   spdlog::info("Reinit the matrix");
+  LinearSolver::reInitMatrix();
+  if (singleSolver_) {
+    singleSolver_->reInitMatrix();
+  }
+  if (parameters_.solver.matrixFree) {
+    // The shell reads the updated PressureOperator. Marking it as changed makes the next solve rebuild the diagonal.
+    PetscObjectStateIncrease(reinterpret_cast<PetscObject>(operator_));
+    return;
+  }
+  // Setting the callback again makes the next solve reassemble the operator and rebuild the preconditioner
   if (parameters_.geometry.dim == 2) {
     KSPSetComputeOperators(ksp_, computeMatrix2D, &ctx_);
   } else {
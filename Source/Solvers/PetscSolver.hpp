@@ -2,6 +2,7 @@
 
 #include "DataStructures.hpp"
 #include "LinearSolver.hpp"
+#include "MultigridSolver.hpp"
 
 #ifdef ENABLE_PETSC
 
@@ -21,6 +22,10 @@ namespace Solvers {
 
     int rank_;
 
+    const PressureOperator* pressureOperator_;
+
+    DM grid_;
+
   public:
     PetscUserCtx(Parameters& parameters, FlowField& flowField);
     ~PetscUserCtx() = default;
@@ -34,8 +39,15 @@ namespace Solvers {
     void setRank(int rank);
     int  getRank() const;
 
+    void                    setPressureOperator(const PressureOperator* pressureOperator);
+    const PressureOperator& getPressureOperator() const;
+
+    void setGrid(DM grid);
+    DM   getGrid() const;
+
     unsigned char setAsBoundary;   // If set as boundary in the linear system. Use bits.
     int           displacement[6]; // Displacements for the boundary treatment
+    bool          singular;        // If the pressure is only defined up to a constant, see PetscSolver.cpp
   };
 
   class PetscSolver: public LinearSolver {
@@ -45,6 +57,10 @@ namespace Solvers {
     KSP ksp_; //! Solver context
     PC  pc_;  //! Preconditioner
 
+    // Matrix-free mode: the operator is a shell that applies the stencil, the right hand side is computed explicitly
+    Mat operator_;
+    Vec b_;
+
     PetscUserCtx ctx_; //! Capsule for Petsc builders
 
     // Indices for filling the matrices and right hand side
@@ -55,16 +71,82 @@ namespace Solvers {
     // Additional variables used to determine where to write back the results
     int offsetX_, offsetY_, offsetZ_;
 
+    bool tunePending_; //! If the autotuner runs in the next solve
+    bool solved_;      //! If x_ holds a solution, see solve()
+
+    // Mixed precision: the preconditioner is one single-precision cycle of the native multigrid solver on the subdomain
+    // of each process, i.e., block Jacobi in parallel runs. It works on copies of the residual and the correction in
+    // the layout of the pressure field.
+    std::unique_ptr<MultigridSolver> singleSolver_;
+    std::vector<RealType>            residual_;
+    std::vector<RealType>            correction_;
+    std::vector<int>                 boundaryRows_;    //! Ghost cells that the process owns in the DMDA, see applySinglePrecision()
+    std::vector<RealType>            boundaryInverse_; //! Inverse diagonal of the system in these rows
+    bool                             comparePending_;  //! If the next solve is compared with the double-precision one
+
+    // Solutions before the one in x_, the latest first. Without the incremental projection, the extrapolation works on
+    // these vectors instead of the pressure field, see extrapolatePressure().
+    std::deque<Vec> previousSolutions_;
+
+    // Copies the owned part of a vector of the DMDA into an array with the layout of the pressure field, or back
+    void exchange(Vec vector, RealType* field, bool toVector);
+
+    // Copies the pressure field into x_ or back. The FlowField includes another ghost layer and, in parallel runs,
+    // overlaps with the neighbours, so the owned part of the DMDA vector cannot share its storage.
+    void exchangePressure(bool toVector);
+
+    // Computes the right hand side if necessary and solves into x_
+    PetscErrorCode solveSystem();
+
+    // Sets the Krylov method and preconditioner of an autotuner candidate, see PetscSolver.cpp
+    PetscErrorCode applyCandidate(int candidate);
+
+    // Switches the pipelined FGMRES to the pipelined CG if the assembled operator is symmetric, see
+    // parameters.solver.pipelined
+    void selectPipelinedMethod();
+
+    // Sets pc_ to the single-precision cycle of singleSolver_, see parameters.solver.mixedPrecision
+    void setUpSinglePrecision();
+
+    // Callbacks of the shell preconditioner: the setup finds the boundary rows, the application runs the cycle
+    static PetscErrorCode updateBoundaryRows(PC pc);
+    static PetscErrorCode applySinglePrecision(PC pc, Vec residual, Vec correction);
+
+    // Solves the current system with the default double-precision preconditioner and then with the single-precision
+    // one, from the same initial guess, and logs the ratio of the times. Keeps the mixed-precision solution.
+    void compareMixedPrecision();
+
+    // Sets pc_ to geometric multigrid with Galerkin coarse operators on the cell-centred hierarchy of the grid of da_
+    void setUpMultigrid();
+
+  protected:
+    // Solves the current system with every candidate and returns the fastest one
+    int tune();
+
+    // Identifies the configuration in the autotuner cache: scenario, grid size and number of processes. readCache()
+    // returns the first valid choice for this key, or -1.
+    std::string getCacheKey() const;
+    int         readCache() const;
+    void        writeCache(int candidate) const;
+
   public:
     PetscSolver(FlowField& flowField, Parameters& parameters);
-    ~PetscSolver() override = default;
+    ~PetscSolver() override;
 
     void solve() override;
 
+    void extrapolatePressure(RealType increment) override;
+    void storePressure() override;
+
+    void setTolerance(RealType tolerance) override;
+
     // Reinit the matrix so that it uses the right flag field
     void reInitMatrix() override;
 
     const DM& getGrid() const;
+
+    // Krylov solver of the pressure system, e.g., to inspect the operator or the convergence of the last solve
+    const KSP& getKrylovSolver() const;
   };
 
 } // namespace Solvers
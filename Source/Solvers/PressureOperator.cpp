@@ -0,0 +1,93 @@
+#include "StdAfx.hpp"
+
+#include "PressureOperator.hpp"
+
+Solvers::PressureOperator::PressureOperator(const Parameters& parameters):
+  dim_(parameters.geometry.dim) {
+
+  // Cells 0 to localSize + 2 are stored, which covers the ghost layers of the flow field
+  sizes_[0] = parameters.parallel.localSize[0] + 3;
+  sizes_[1] = parameters.parallel.localSize[1] + 3;
+  sizes_[2] = dim_ == 3 ? parameters.parallel.localSize[2] + 3 : 1;
+
+  for (int axis = 0; axis < dim_; axis++) {
+    setAxis(axis, parameters.meshsize->getSpacings(axis));
+  }
+}
+
+Solvers::PressureOperator::PressureOperator(int dim, const int localSizes[3], const RealType* const spacings[3]):
+  dim_(dim) {
+
+  sizes_[0] = localSizes[0] + 3;
+  sizes_[1] = localSizes[1] + 3;
+  sizes_[2] = dim_ == 3 ? localSizes[2] + 3 : 1;
+
+  for (int axis = 0; axis < dim_; axis++) {
+    setAxis(axis, spacings[axis]);
+  }
+}
+
+void Solvers::PressureOperator::setAxis(int axis, const RealType* spacings) {
+  lower_[axis].resize(sizes_[axis]);
+  upper_[axis].resize(sizes_[axis]);
+  centre_[axis].resize(sizes_[axis]);
+
+  for (int n = 0; n < sizes_[axis]; n++) {
+    // Distances between the centre of cell n and the ones of its lower and upper neighbour
+    const RealType distanceLower = 0.5 * (spacings[n] + spacings[n - 1]);
+    const RealType distanceUpper = 0.5 * (spacings[n] + spacings[n + 1]);
+
+    lower_[axis][n]  = 2.0 / (distanceLower * (distanceLower + distanceUpper));
+    upper_[axis][n]  = 2.0 / (distanceUpper * (distanceLower + distanceUpper));
+    centre_[axis][n] = -2.0 / (distanceUpper * distanceLower);
+  }
+}
+
+void Solvers::PressureOperator::update(IntScalarField& flags) {
+  const int surrounded = dim_ == 3 ? OBSTACLE_SELF | OBSTACLE_LEFT | OBSTACLE_RIGHT | OBSTACLE_BOTTOM | OBSTACLE_TOP | OBSTACLE_FRONT | OBSTACLE_BACK
+                                   : OBSTACLE_SELF | OBSTACLE_LEFT | OBSTACLE_RIGHT | OBSTACLE_BOTTOM | OBSTACLE_TOP;
+  const int neighbours[6] = {OBSTACLE_LEFT, OBSTACLE_RIGHT, OBSTACLE_BOTTOM, OBSTACLE_TOP, OBSTACLE_FRONT, OBSTACLE_BACK};
+
+  const int firstK = dim_ == 3 ? 2 : 0;
+  const int lastK  = dim_ == 3 ? sizes_[2] - 2 : 1;
+
+  obstacleRows_.clear();
+  for (int k = firstK; k < lastK; k++) {
+    for (int j = 2; j < sizes_[1] - 1; j++) {
+      for (int i = 2; i < sizes_[0] - 1; i++) {
+        const int obstacle = flags.getValue(i, j, k);
+        if ((obstacle & OBSTACLE_SELF) == 0) {
+          continue;
+        }
+
+        ObstacleRow row{getLinearIndex(i, j, k), i, j, k, {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}};
+        if (obstacle == surrounded) {
+          // Not connected to any fluid cell, the pressure is set to the right hand side
+          row.values[Centre] = 1.0;
+        } else {
+          // Average of the surrounding fluid cells
+          for (int neighbour = 0; neighbour < 2 * dim_; neighbour++) {
+            if ((obstacle & neighbours[neighbour]) == 0) {
+              row.values[neighbour] = 1.0;
+              row.values[Centre] -= 1.0;
+            }
+          }
+        }
+        obstacleRows_.push_back(row);
+      }
+    }
+  }
+
+  spdlog::debug("Pressure operator has {} obstacle rows", obstacleRows_.size());
+}
+
+const Solvers::PressureOperator::ObstacleRow* Solvers::PressureOperator::findObstacleRow(int i, int j, int k) const {
+  const int  index = getLinearIndex(i, j, k);
+  const auto row   = std::lower_bound(
+    obstacleRows_.begin(), obstacleRows_.end(), index, [](const ObstacleRow& row, int value) { return row.index < value; }
+  );
+  if (row == obstacleRows_.end() || row->index != index) {
+    return nullptr;
+  }
+  return &(*row);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "DataStructures.hpp"
+#include "Definitions.hpp"
+#include "Parameters.hpp"
+
+namespace Solvers {
+
+  /** Coefficients of the discrete pressure Laplacian, shared by the pressure solvers and the PETSc assembly.
+   *
+   * For a fluid cell (i, j, k), the operator reads
+   *
+   *   lowerX(i) p(i-1) + upperX(i) p(i+1) + lowerY(j) p(j-1) + upperY(j) p(j+1) [+ z] + centre(i, j, k) p(i, j, k),
+   *
+   * with centre(i, j, k) = centreX(i) + centreY(j) [+ centreZ(k)]. These factors only depend on the 1D index and are
+   * tabulated per axis for the local cells 0 to localSize + 2. Cells flagged as obstacle break this pattern. Their rows
+   * are stored explicitly: an obstacle cell with fluid neighbours averages the pressure of these neighbours, a cell
+   * that is surrounded by obstacles is set to zero.
+   */
+  class PressureOperator {
+  public:
+    // Order of the coefficients in an obstacle row
+    enum Neighbour { West = 0, East = 1, South = 2, North = 3, Bottom = 4, Top = 5, Centre = 6 };
+
+    struct ObstacleRow {
+      int      index; //! Linear index of the cell, see getLinearIndex()
+      int      i, j, k;
+      RealType values[7];
+    };
+
+  private:
+    const int dim_;
+    int       sizes_[3]; //! Number of local cells per axis, ghost layers included
+
+    std::vector<RealType> lower_[3];
+    std::vector<RealType> upper_[3];
+    std::vector<RealType> centre_[3];
+
+    std::vector<ObstacleRow> obstacleRows_; //! Sorted by their linear index
+
+    // Tabulates the coefficients of an axis from the meshsizes of the local cells -1 to localSize + 3
+    void setAxis(int axis, const RealType* spacings);
+
+  public:
+    PressureOperator(const Parameters& parameters);
+
+    /** Operator of a grid that is not the one of the flow field, e.g. a coarse multigrid level
+     *
+     * @param localSizes Number of inner cells per axis
+     * @param spacings Meshsizes per axis, indexed by the local cell index, valid from -1 to localSize + 3
+     */
+    PressureOperator(int dim, const int localSizes[3], const RealType* const spacings[3]);
+    ~PressureOperator() = default;
+
+    /** Rebuilds the obstacle rows for the inner cells from the flag field */
+    void update(IntScalarField& flags);
+
+    inline int getLinearIndex(int i, int j, int k = 0) const { return i + sizes_[0] * (j + sizes_[1] * k); }
+
+    // Per-axis tables, indexed by the local cell index
+    inline const RealType* getLower(int axis) const { return lower_[axis].data(); }
+    inline const RealType* getUpper(int axis) const { return upper_[axis].data(); }
+    inline const RealType* getCentre(int axis) const { return centre_[axis].data(); }
+
+    inline RealType getCentre(int i, int j) const { return centre_[0][i] + centre_[1][j]; }
+    inline RealType getCentre(int i, int j, int k) const { return centre_[0][i] + centre_[1][j] + centre_[2][k]; }
+
+    inline const std::vector<ObstacleRow>& getObstacleRows() const { return obstacleRows_; }
+
+    /** Returns the explicit row of cell (i, j, k), or nullptr if the cell is fluid */
+    const ObstacleRow* findObstacleRow(int i, int j, int k = 0) const;
+  };
+
+} // namespace Solvers
@@ -3,195 +3,439 @@
 #include "SORSolver.hpp"
 
 Solvers::SORSolver::SORSolver(FlowField& flowField, const Parameters& parameters):
-  LinearSolver(flowField, parameters) {}
+  LinearSolver(flowField, parameters),
+  lineLength_((flowField.getNx() + 4) / 2),
+  lines_((flowField.getNy() + 3) * (parameters.geometry.dim == 3 ? flowField.getNz() + 3 : 1)),
+  maxIterations_(parameters.solver.maxIterations),
+  fixedOmega_(parameters.solver.omega),
+  chebyshev_(parameters.solver.chebyshev != 0),
+  residualInterval_(parameters.solver.residualInterval),
+  jacobiRadius_(-1.0) {
 
-void Solvers::SORSolver::solve() {
-  RealType resnorm = DBL_MAX, tol = 1e-4;
+  for (int colour = 0; colour < 2; colour++) {
+    pressure_[colour].assign(lines_ * lineLength_, 0.0);
+    rhs_[colour].assign(lines_ * lineLength_, 0.0);
+    fluid_[colour].assign(lines_ * lineLength_, 0.0);
+  }
+
+  setUpCoefficients();
+  updateFluidCells();
+}
 
-  double omg        = 1.7;
-  int    iterations = -1;
-  int    it         = 0;
+void Solvers::SORSolver::setUpCoefficients() {
+  const int dim      = parameters_.geometry.dim;
+  const int sizes[3] = {flowField_.getNx(), flowField_.getNy(), flowField_.getNz()};
 
-  int          nx = flowField_.getNx(), ny = flowField_.getNy(), nz = flowField_.getNz();
-  ScalarField& P = flowField_.getPressure();
-  if (parameters_.geometry.dim == 3) {
-    do {
-      for (int k = 2; k < nz + 2; k++) {
-        for (int j = 2; j < ny + 2; j++) {
-          for (int i = 2; i < nx + 2; i++) {
-            const RealType dx_0  = parameters_.meshsize->getDx(i, j, k);
-            const RealType dx_M1 = parameters_.meshsize->getDx(i - 1, j, k);
-            const RealType dx_P1 = parameters_.meshsize->getDx(i + 1, j, k);
-            const RealType dy_0  = parameters_.meshsize->getDy(i, j, k);
-            const RealType dy_M1 = parameters_.meshsize->getDy(i, j - 1, k);
-            const RealType dy_P1 = parameters_.meshsize->getDy(i, j + 1, k);
-            const RealType dz_0  = parameters_.meshsize->getDz(i, j, k);
-            const RealType dz_M1 = parameters_.meshsize->getDz(i, j, k - 1);
-            const RealType dz_P1 = parameters_.meshsize->getDz(i, j, k + 1);
-
-            const RealType dx_W = 0.5 * (dx_0 + dx_M1);
-            const RealType dx_E = 0.5 * (dx_0 + dx_P1);
-            const RealType dx_S = 0.5 * (dy_0 + dy_M1);
-            const RealType dx_N = 0.5 * (dy_0 + dy_P1);
-            const RealType dx_B = 0.5 * (dz_0 + dz_M1);
-            const RealType dx_T = 0.5 * (dz_0 + dz_P1);
-
-            const RealType a_W = 2.0 / (dx_W * (dx_W + dx_E));
-            const RealType a_E = 2.0 / (dx_E * (dx_W + dx_E));
-            const RealType a_N = 2.0 / (dx_N * (dx_N + dx_S));
-            const RealType a_S = 2.0 / (dx_S * (dx_N + dx_S));
-            const RealType a_T = 2.0 / (dx_T * (dx_T + dx_B));
-            const RealType a_B = 2.0 / (dx_B * (dx_T + dx_B));
-            const RealType a_C = -2.0 / (dx_E * dx_W) - 2.0 / (dx_N * dx_S) - 2.0 / (dx_B * dx_T);
-
-            P.getScalar(
-              i, j, k
-            ) = omg / a_C
-                  * (flowField_.getRHS().getScalar(i, j, k) - a_W * P.getScalar(i - 1, j, k) - a_E * P.getScalar(i + 1, j, k) - a_S * P.getScalar(i, j - 1, k) - a_N * P.getScalar(i, j + 1, k) - a_B * P.getScalar(i, j, k - 1) - a_T * P.getScalar(i, j, k + 1))
-                + (1.0 - omg) * P.getScalar(i, j, k);
+  for (int axis = 0; axis < dim; axis++) {
+    const RealType* const lower  = pressureOperator_.getLower(axis);
+    const RealType* const upper  = pressureOperator_.getUpper(axis);
+    const RealType* const centre = pressureOperator_.getCentre(axis);
+    lower_[axis].assign(lower, lower + sizes[axis] + 3);
+    upper_[axis].assign(upper, upper + sizes[axis] + 3);
+    centre_[axis].assign(centre, centre + sizes[axis] + 3);
+
+    // A ghost cell mirrors the inner cell, with the opposite sign for Dirichlet faces. The pressure on a Dirichlet face
+    // moves to the right hand side, see copyIn(). Lagging the ghost cells instead breaks the over-relaxation.
+    const int last = sizes[axis] + 1;
+    if (lowerFaces_[axis] != PeriodicFace) {
+      centre_[axis][2] += (lowerFaces_[axis] == DirichletFace ? -1.0 : 1.0) * lower_[axis][2];
+      lower_[axis][2] = 0.0;
+    }
+    if (upperFaces_[axis] != PeriodicFace) {
+      centre_[axis][last] += (upperFaces_[axis] == DirichletFace ? -1.0 : 1.0) * upper_[axis][last];
+      upper_[axis][last] = 0.0;
+    }
+  }
+
+  for (int parity = 0; parity < 2; parity++) {
+    lowerX_[parity].assign(lineLength_, 0.0);
+    upperX_[parity].assign(lineLength_, 0.0);
+    centreX_[parity].assign(lineLength_, 0.0);
+    for (int m = 0; 2 * m + parity < sizes[0] + 3; m++) {
+      lowerX_[parity][m]  = lower_[0][2 * m + parity];
+      upperX_[parity][m]  = upper_[0][2 * m + parity];
+      centreX_[parity][m] = centre_[0][2 * m + parity];
+    }
+  }
+}
+
+void Solvers::SORSolver::updateFluidCells() {
+  const int nx = flowField_.getNx(), ny = flowField_.getNy();
+  const int kBegin = parameters_.geometry.dim == 3 ? 2 : 0;
+  const int kEnd   = parameters_.geometry.dim == 3 ? flowField_.getNz() + 2 : 1;
+
+  for (int colour = 0; colour < 2; colour++) {
+    std::fill(fluid_[colour].begin(), fluid_[colour].end(), 0.0);
+  }
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      for (int i = 2; i < nx + 2; i++) {
+        fluid_[(i + j + k) & 1][getLine(j, k) * lineLength_ + (i >> 1)] = 1.0;
+      }
+    }
+  }
+  for (const PressureOperator::ObstacleRow& row : pressureOperator_.getObstacleRows()) {
+    fluid_[(row.i + row.j + row.k) & 1][getLine(row.j, row.k) * lineLength_ + (row.i >> 1)] = 0.0;
+  }
+}
+
+void Solvers::SORSolver::reInitMatrix() {
+  LinearSolver::reInitMatrix();
+  updateFluidCells();
+  jacobiRadius_ = -1.0;
+}
+
+void Solvers::SORSolver::copyIn() {
+  ScalarField& P   = flowField_.getPressure();
+  ScalarField& RHS = flowField_.getRHS();
+
+  const int nx = flowField_.getNx(), ny = flowField_.getNy();
+  const int nz = parameters_.geometry.dim == 3 ? flowField_.getNz() + 3 : 1;
+
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny + 3; j++) {
+      for (int i = 0; i < nx + 3; i++) {
+        const int position = getLine(j, k) * lineLength_ + (i >> 1);
+
+        pressure_[(i + j + k) & 1][position] = P.getScalar(i, j, k);
+        rhs_[(i + j + k) & 1][position]      = RHS.getScalar(i, j, k);
+      }
+    }
+  }
+
+  // The pressure on Dirichlet faces, whose ghost cells are eliminated from the operator
+  const int dim      = parameters_.geometry.dim;
+  const int sizes[3] = {nx, ny, flowField_.getNz()};
+  for (int axis = 0; axis < dim; axis++) {
+    for (int side = 0; side < 2; side++) {
+      if ((side == 0 ? lowerFaces_[axis] : upperFaces_[axis]) != DirichletFace) {
+        continue;
+      }
+      const int      n     = side == 0 ? 2 : sizes[axis] + 1;
+      const RealType value = 2.0 * (side == 0 ? lowerValues_[axis] * pressureOperator_.getLower(axis)[n]
+                                              : upperValues_[axis] * pressureOperator_.getUpper(axis)[n]);
+
+      int begin[3] = {2, 2, dim == 3 ? 2 : 0};
+      int end[3]   = {nx + 2, ny + 2, dim == 3 ? sizes[2] + 2 : 1};
+      begin[axis]  = n;
+      end[axis]    = n + 1;
+      for (int k = begin[2]; k < end[2]; k++) {
+        for (int j = begin[1]; j < end[1]; j++) {
+          for (int i = begin[0]; i < end[0]; i++) {
+            getRhs(i, j, k) -= value;
           }
         }
       }
+    }
+  }
+}
 
-      for (int j = 2; j < ny + 2; j++) {
-        for (int k = 2; k < nz + 2; k++) {
-          P.getScalar(1, j, k)      = P.getScalar(2, j, k);
-          P.getScalar(nx + 2, j, k) = P.getScalar(nx + 1, j, k);
-        }
+void Solvers::SORSolver::copyOut() {
+  ScalarField& P = flowField_.getPressure();
+
+  const int nx = flowField_.getNx(), ny = flowField_.getNy();
+  const int nz = parameters_.geometry.dim == 3 ? flowField_.getNz() + 3 : 1;
+
+  for (int k = 0; k < nz; k++) {
+    for (int j = 0; j < ny + 3; j++) {
+      for (int i = 0; i < nx + 3; i++) {
+        P.getScalar(i, j, k) = getPressure(i, j, k);
       }
+    }
+  }
+}
+
+template <int Dim>
+void Solvers::SORSolver::updateGhosts() {
+  const int nx = flowField_.getNx(), ny = flowField_.getNy(), nz = flowField_.getNz();
+  const int kBegin = Dim == 3 ? 2 : 0;
+  const int kEnd   = Dim == 3 ? nz + 2 : 1;
 
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      getPressure(1, j, k)      = getGhostValue(lowerFaces_[0], getPressure(2, j, k), getPressure(nx + 1, j, k), lowerValues_[0]);
+      getPressure(nx + 2, j, k) = getGhostValue(upperFaces_[0], getPressure(nx + 1, j, k), getPressure(2, j, k), upperValues_[0]);
+    }
+    for (int i = 2; i < nx + 2; i++) {
+      getPressure(i, 1, k)      = getGhostValue(lowerFaces_[1], getPressure(i, 2, k), getPressure(i, ny + 1, k), lowerValues_[1]);
+      getPressure(i, ny + 2, k) = getGhostValue(upperFaces_[1], getPressure(i, ny + 1, k), getPressure(i, 2, k), upperValues_[1]);
+    }
+  }
+
+  if constexpr (Dim == 3) {
+    for (int j = 2; j < ny + 2; j++) {
       for (int i = 2; i < nx + 2; i++) {
-        for (int k = 2; k < nz + 2; k++) {
-          P.getScalar(i, 1, k)      = P.getScalar(i, 2, k);
-          P.getScalar(i, ny + 2, k) = P.getScalar(i, ny + 1, k);
-        }
+        getPressure(i, j, 1)      = getGhostValue(lowerFaces_[2], getPressure(i, j, 2), getPressure(i, j, nz + 1), lowerValues_[2]);
+        getPressure(i, j, nz + 2) = getGhostValue(upperFaces_[2], getPressure(i, j, nz + 1), getPressure(i, j, 2), upperValues_[2]);
       }
+    }
+  }
+}
 
-      for (int i = 2; i < nx + 2; i++) {
-        for (int j = 2; j < ny + 2; j++) {
-          P.getScalar(i, j, 1)      = P.getScalar(i, j, 2);
-          P.getScalar(i, j, nz + 2) = P.getScalar(i, j, nz + 1);
+// Applies the explicit row of an obstacle cell to the pressure without its centre entry. The right hand side of these
+// rows is zero, as in the PETSc assembly.
+template <class Accessor>
+static inline RealType obstacleNeighbours(const Solvers::PressureOperator::ObstacleRow& row, Accessor&& P) {
+  const int i = row.i, j = row.j, k = row.k;
+  return row.values[Solvers::PressureOperator::West] * P(i - 1, j, k)
+         + row.values[Solvers::PressureOperator::East] * P(i + 1, j, k)
+         + row.values[Solvers::PressureOperator::South] * P(i, j - 1, k)
+         + row.values[Solvers::PressureOperator::North] * P(i, j + 1, k)
+         + (row.values[Solvers::PressureOperator::Bottom] != 0.0 ? row.values[Solvers::PressureOperator::Bottom] * P(i, j, k - 1) : 0.0)
+         + (row.values[Solvers::PressureOperator::Top] != 0.0 ? row.values[Solvers::PressureOperator::Top] * P(i, j, k + 1) : 0.0);
+}
+
+template <int Dim, bool ComputeNorm>
+RealType Solvers::SORSolver::sweep(int colour, RealType omega) {
+  const int nx = flowField_.getNx(), ny = flowField_.getNy();
+  const int kBegin = Dim == 3 ? 2 : 0;
+  const int kEnd   = Dim == 3 ? flowField_.getNz() + 2 : 1;
+  const int planeStride = (ny + 3) * lineLength_;
+
+  const RealType* const a_S = lower_[1].data();
+  const RealType* const a_N = upper_[1].data();
+  const RealType* const c_Y = centre_[1].data();
+  const RealType* const a_B = lower_[2].data();
+  const RealType* const a_T = upper_[2].data();
+  const RealType* const c_Z = centre_[2].data();
+
+  RealType resnorm = 0.0;
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static) reduction(+ : resnorm)
+#endif
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      const int parity = (colour + j + k) & 1;
+      const int line   = getLine(j, k) * lineLength_;
+      const int last   = (nx + 1 - parity) / 2;
+
+      RealType* const       P     = pressure_[colour].data() + line;
+      const RealType* const R     = rhs_[colour].data() + line;
+      const RealType* const F     = fluid_[colour].data() + line;
+      const RealType* const other = pressure_[1 - colour].data() + line;
+      const RealType* const W     = other + parity - 1;
+      const RealType* const E     = other + parity;
+      const RealType* const S     = other - lineLength_;
+      const RealType* const N     = other + lineLength_;
+
+      const RealType* const a_W = lowerX_[parity].data();
+      const RealType* const a_E = upperX_[parity].data();
+      const RealType* const c_X = centreX_[parity].data();
+
+      RealType lineNorm = 0.0;
+      if constexpr (Dim == 2) {
+        const RealType centreY = c_Y[j];
+#ifdef ENABLE_OPENMP
+#pragma omp simd reduction(+ : lineNorm)
+#endif
+        for (int m = 1; m <= last; m++) {
+          const RealType a_C      = c_X[m] + centreY;
+          const RealType residual = F[m] * (R[m] - a_W[m] * W[m] - a_E[m] * E[m] - a_S[j] * S[m] - a_N[j] * N[m] - a_C * P[m]);
+          P[m] += omega * residual / a_C;
+          if constexpr (ComputeNorm) {
+            lineNorm += residual * residual;
+          }
         }
-      }
+      } else {
+        const RealType* const B = other - planeStride;
+        const RealType* const T = other + planeStride;
 
-      resnorm = 0;
-      for (int k = 2; k < nz + 2; k++) {
-        for (int j = 2; j < ny + 2; j++) {
-          for (int i = 2; i < nx + 2; i++) {
-            const RealType dx_0  = parameters_.meshsize->getDx(i, j, k);
-            const RealType dx_M1 = parameters_.meshsize->getDx(i - 1, j, k);
-            const RealType dx_P1 = parameters_.meshsize->getDx(i + 1, j, k);
-            const RealType dy_0  = parameters_.meshsize->getDy(i, j, k);
-            const RealType dy_M1 = parameters_.meshsize->getDy(i, j - 1, k);
-            const RealType dy_P1 = parameters_.meshsize->getDy(i, j + 1, k);
-            const RealType dz_0  = parameters_.meshsize->getDz(i, j, k);
-            const RealType dz_M1 = parameters_.meshsize->getDz(i, j, k - 1);
-            const RealType dz_P1 = parameters_.meshsize->getDz(i, j, k + 1);
-
-            const RealType dx_W = 0.5 * (dx_0 + dx_M1);
-            const RealType dx_E = 0.5 * (dx_0 + dx_P1);
-            const RealType dx_S = 0.5 * (dy_0 + dy_M1);
-            const RealType dx_N = 0.5 * (dy_0 + dy_P1);
-            const RealType dx_B = 0.5 * (dz_0 + dz_M1);
-            const RealType dx_T = 0.5 * (dz_0 + dz_P1);
-
-            const RealType a_W = 2.0 / (dx_W * (dx_W + dx_E));
-            const RealType a_E = 2.0 / (dx_E * (dx_W + dx_E));
-            const RealType a_N = 2.0 / (dx_N * (dx_N + dx_S));
-            const RealType a_S = 2.0 / (dx_S * (dx_N + dx_S));
-            const RealType a_T = 2.0 / (dx_T * (dx_T + dx_B));
-            const RealType a_B = 2.0 / (dx_B * (dx_T + dx_B));
-            const RealType a_C = -2.0 / (dx_E * dx_W) - 2.0 / (dx_N * dx_S) - 2.0 / (dx_B * dx_T);
-
-            resnorm += pow(
-              (flowField_.getRHS().getScalar(i, j, k) - a_W * P.getScalar(i - 1, j, k) - a_E * P.getScalar(i + 1, j, k)
-               - a_S * P.getScalar(i, j - 1, k) - a_N * P.getScalar(i, j + 1, k) - a_B * P.getScalar(i, j, k - 1)
-               - a_T * P.getScalar(i, j, k + 1) - a_C * P.getScalar(i, j, k)),
-              2
-            );
+        const RealType centreYZ = c_Y[j] + c_Z[k];
+#ifdef ENABLE_OPENMP
+#pragma omp simd reduction(+ : lineNorm)
+#endif
+        for (int m = 1; m <= last; m++) {
+          const RealType a_C      = c_X[m] + centreYZ;
+          const RealType residual = F[m]
+                                    * (R[m] - a_W[m] * W[m] - a_E[m] * E[m] - a_S[j] * S[m] - a_N[j] * N[m]
+                                       - a_B[k] * B[m] - a_T[k] * T[m] - a_C * P[m]);
+          P[m] += omega * residual / a_C;
+          if constexpr (ComputeNorm) {
+            lineNorm += residual * residual;
           }
         }
       }
-      resnorm = sqrt(resnorm / (nx * ny * nz));
-      spdlog::debug("Residual norm : {}", resnorm);
-
-      it++;
-      iterations--;
-    } while (resnorm > tol && iterations);
+      resnorm += lineNorm;
+    }
   }
-  if (parameters_.geometry.dim == 2) {
-    do {
-      for (int j = 2; j < ny + 2; j++) {
-        for (int i = 2; i < nx + 2; i++) {
-          const RealType dx_0  = parameters_.meshsize->getDx(i, j);
-          const RealType dx_M1 = parameters_.meshsize->getDx(i - 1, j);
-          const RealType dx_P1 = parameters_.meshsize->getDx(i + 1, j);
-          const RealType dy_0  = parameters_.meshsize->getDy(i, j);
-          const RealType dy_M1 = parameters_.meshsize->getDy(i, j - 1);
-          const RealType dy_P1 = parameters_.meshsize->getDy(i, j + 1);
-
-          const RealType dx_W = 0.5 * (dx_0 + dx_M1);
-          const RealType dx_E = 0.5 * (dx_0 + dx_P1);
-          const RealType dx_S = 0.5 * (dy_0 + dy_M1);
-          const RealType dx_N = 0.5 * (dy_0 + dy_P1);
-
-          const RealType a_W = 2.0 / (dx_W * (dx_W + dx_E));
-          const RealType a_E = 2.0 / (dx_E * (dx_W + dx_E));
-          const RealType a_N = 2.0 / (dx_N * (dx_N + dx_S));
-          const RealType a_S = 2.0 / (dx_S * (dx_N + dx_S));
-          const RealType a_C = -2.0 / (dx_E * dx_W) - 2.0 / (dx_N * dx_S);
-
-          const RealType gaussSeidel
-            = 1.0 / a_C
-              * (flowField_.getRHS().getScalar(i, j) - a_W * P.getScalar(i - 1, j) - a_E * P.getScalar(i + 1, j) - a_S * P.getScalar(i, j - 1) - a_N * P.getScalar(i, j + 1));
-          P.getScalar(i, j) = omg * gaussSeidel + (1.0 - omg) * P.getScalar(i, j);
-        }
+
+  // The obstacle rows only couple to cells of the other colour as well
+  auto pressure = [this](int i, int j, int k) { return getPressure(i, j, k); };
+  for (const PressureOperator::ObstacleRow& row : pressureOperator_.getObstacleRows()) {
+    if (((row.i + row.j + row.k) & 1) == colour) {
+      RealType&      p        = getPressure(row.i, row.j, row.k);
+      const RealType residual = -obstacleNeighbours(row, pressure) - row.values[PressureOperator::Centre] * p;
+      p += omega * residual / row.values[PressureOperator::Centre];
+      if constexpr (ComputeNorm) {
+        resnorm += residual * residual;
       }
+    }
+  }
+
+  updateGhosts<Dim>();
+  return resnorm;
+}
+
+template <int Dim>
+RealType Solvers::SORSolver::computeResidualNorm() {
+  const int nx = flowField_.getNx(), ny = flowField_.getNy(), nz = flowField_.getNz();
+  const int kBegin = Dim == 3 ? 2 : 0;
+  const int kEnd   = Dim == 3 ? nz + 2 : 1;
+  const int planeStride = (ny + 3) * lineLength_;
+
+  const RealType* const a_S = lower_[1].data();
+  const RealType* const a_N = upper_[1].data();
+  const RealType* const c_Y = centre_[1].data();
+  const RealType* const a_B = lower_[2].data();
+  const RealType* const a_T = upper_[2].data();
+  const RealType* const c_Z = centre_[2].data();
 
-      resnorm = 0.0;
+  RealType resnorm = 0.0;
+  for (int colour = 0; colour < 2; colour++) {
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for collapse(2) schedule(static) reduction(+ : resnorm)
+#endif
+    for (int k = kBegin; k < kEnd; k++) {
       for (int j = 2; j < ny + 2; j++) {
-        for (int i = 2; i < nx + 2; i++) {
-          const RealType dx_0  = parameters_.meshsize->getDx(i, j);
-          const RealType dx_M1 = parameters_.meshsize->getDx(i - 1, j);
-          const RealType dx_P1 = parameters_.meshsize->getDx(i + 1, j);
-          const RealType dy_0  = parameters_.meshsize->getDy(i, j);
-          const RealType dy_M1 = parameters_.meshsize->getDy(i, j - 1);
-          const RealType dy_P1 = parameters_.meshsize->getDy(i, j + 1);
-
-          const RealType dx_W = 0.5 * (dx_0 + dx_M1);
-          const RealType dx_E = 0.5 * (dx_0 + dx_P1);
-          const RealType dx_S = 0.5 * (dy_0 + dy_M1);
-          const RealType dx_N = 0.5 * (dy_0 + dy_P1);
-
-          const RealType a_W = 2.0 / (dx_W * (dx_W + dx_E));
-          const RealType a_E = 2.0 / (dx_E * (dx_W + dx_E));
-          const RealType a_N = 2.0 / (dx_N * (dx_N + dx_S));
-          const RealType a_S = 2.0 / (dx_S * (dx_N + dx_S));
-          const RealType a_C = -2.0 / (dx_E * dx_W) - 2.0 / (dx_N * dx_S);
-
-          const RealType residual = flowField_.getRHS().getScalar(i, j) - a_W * P.getScalar(i - 1, j)
-                                    - a_E * P.getScalar(i + 1, j) - a_S * P.getScalar(i, j - 1)
-                                    - a_N * P.getScalar(i, j + 1) - a_C * P.getScalar(i, j);
-          resnorm += residual * residual;
+        const int parity = (colour + j + k) & 1;
+        const int line   = getLine(j, k) * lineLength_;
+        const int last   = (nx + 1 - parity) / 2;
+
+        const RealType* const P     = pressure_[colour].data() + line;
+        const RealType* const R     = rhs_[colour].data() + line;
+        const RealType* const F     = fluid_[colour].data() + line;
+        const RealType* const other = pressure_[1 - colour].data() + line;
+        const RealType* const W     = other + parity - 1;
+        const RealType* const E     = other + parity;
+        const RealType* const S     = other - lineLength_;
+        const RealType* const N     = other + lineLength_;
+        const RealType* const B     = Dim == 3 ? other - planeStride : other;
+        const RealType* const T     = Dim == 3 ? other + planeStride : other;
+
+        const RealType* const a_W = lowerX_[parity].data();
+        const RealType* const a_E = upperX_[parity].data();
+        const RealType* const c_X = centreX_[parity].data();
+
+        const RealType centreYZ = Dim == 3 ? c_Y[j] + c_Z[k] : c_Y[j];
+        const RealType lowerZ   = Dim == 3 ? a_B[k] : 0.0;
+        const RealType upperZ   = Dim == 3 ? a_T[k] : 0.0;
+
+        RealType lineNorm = 0.0;
+#ifdef ENABLE_OPENMP
+#pragma omp simd reduction(+ : lineNorm)
+#endif
+        for (int m = 1; m <= last; m++) {
+          const RealType residual = F[m]
+                                    * (R[m] - a_W[m] * W[m] - a_E[m] * E[m] - a_S[j] * S[m] - a_N[j] * N[m]
+                                       - lowerZ * B[m] - upperZ * T[m] - (c_X[m] + centreYZ) * P[m]);
+          lineNorm += residual * residual;
         }
+        resnorm += lineNorm;
       }
-      resnorm = sqrt(resnorm / (nx * ny));
+    }
+  }
 
-      for (int j = 2; j < ny + 2; j++) {
-        P.getScalar(1, j)      = P.getScalar(2, j);
-        P.getScalar(nx + 2, j) = P.getScalar(nx + 1, j);
-      }
+  auto pressure = [this](int i, int j, int k) { return getPressure(i, j, k); };
+  for (const PressureOperator::ObstacleRow& row : pressureOperator_.getObstacleRows()) {
+    const RealType residual = -obstacleNeighbours(row, pressure)
+                              - row.values[PressureOperator::Centre] * getPressure(row.i, row.j, row.k);
+    resnorm += residual * residual;
+  }
 
-      for (int i = 2; i < nx + 2; i++) {
-        P.getScalar(i, 1)      = P.getScalar(i, 2);
-        P.getScalar(i, ny + 2) = P.getScalar(i, ny + 1);
-      }
+  return sqrt(resnorm / (Dim == 3 ? nx * ny * nz : nx * ny));
+}
+
+template <int Dim>
+void Solvers::SORSolver::iterate() {
+  const int cells = flowField_.getNx() * flowField_.getNy() * (Dim == 3 ? flowField_.getNz() : 1);
+
+  // Without an estimate of the spectral radius of Jacobi, start with Gauss-Seidel to measure it
+  RealType omega = fixedOmega_ > 0 ? fixedOmega_ : getOptimalOmega(jacobiRadius_);
+
+  RealType resnorm   = DBL_MAX;
+  RealType lastNorm  = -1.0;
+  RealType lastRate  = -1.0;
+  RealType halfOmega = 1.0; // Relaxation factor of the last half-sweep with Chebyshev acceleration
+  int      lastCheck = 0;
+  int      it        = 0;
+  bool     converged = false;
+
+  while (!converged && (maxIterations_ <= 0 || it < maxIterations_)) {
+    const bool estimating = fixedOmega_ == 0 && jacobiRadius_ < 0;
+    const bool check      = estimating || (it + 1) % residualInterval_ == 0;
+
+    RealType redOmega   = omega;
+    RealType blackOmega = omega;
+    if (chebyshev_ && !estimating) {
+      // Chebyshev sequence of the relaxation factors per half-sweep, starting from Gauss-Seidel
+      const RealType radius2 = jacobiRadius_ * jacobiRadius_;
+      redOmega               = it == 0 ? 1.0 : 1.0 / (1.0 - 0.25 * radius2 * halfOmega);
+      blackOmega             = it == 0 ? 1.0 / (1.0 - 0.5 * radius2) : 1.0 / (1.0 - 0.25 * radius2 * redOmega);
+      halfOmega              = blackOmega;
+    }
 
-      spdlog::debug("Residual norm : {}", resnorm);
-      iterations--;
-      it++;
-    } while (resnorm > tol && iterations);
+    if (check) {
+      resnorm = sqrt((sweep<Dim, true>(0, redOmega) + sweep<Dim, true>(1, blackOmega)) / cells);
+    } else {
+      sweep<Dim, false>(0, redOmega);
+      sweep<Dim, false>(1, blackOmega);
+    }
+    it++;
+
+    if (!check) {
+      continue;
+    }
+    spdlog::debug("Residual norm : {}", resnorm);
+
+    if (resnorm <= tolerance_) {
+      // The norm of the sweep mixes the residuals before and after the first half-sweep, confirm it
+      resnorm   = computeResidualNorm<Dim>();
+      converged = resnorm <= tolerance_;
+      continue;
+    }
+
+    if (fixedOmega_ > 0 || lastNorm <= 0) {
+      lastNorm  = resnorm;
+      lastCheck = it;
+      continue;
+    }
+
+    // Convergence rate per iteration. Once it settles, it determines the spectral radius of Jacobi by the relation
+    // (rate + omega - 1)^2 = rate * omega^2 * radius^2 for consistently ordered matrices. As long as omega is below the
+    // optimum, the dominant eigenvalue is real and exceeds omega - 1 markedly, and the estimate approaches the radius
+    // from below. Above the optimum, the rate oscillates around omega - 1 and is not used. Close to the optimum, small
+    // errors of the rate shift the relaxation factor considerably, hence the tight criterion for a settled rate.
+    const RealType rate = pow(resnorm / lastNorm, 1.0 / (it - lastCheck));
+    lastNorm            = resnorm;
+    lastCheck           = it;
+    if (lastRate > 0 && rate < 1.0 && fabs(rate - lastRate) < 0.002 * (1.0 - rate) && rate > pow(blackOmega - 1.0, 0.75)) {
+      const RealType radius = std::min((rate + blackOmega - 1.0) / (blackOmega * sqrt(rate)), maxJacobiRadius_);
+      if (radius > jacobiRadius_) {
+        jacobiRadius_ = radius;
+        omega         = getOptimalOmega(jacobiRadius_);
+        halfOmega     = omega;
+        lastNorm      = -1.0;
+        spdlog::debug("SORSolver estimated the spectral radius of Jacobi as {}, omega {}", jacobiRadius_, omega);
+      }
+      lastRate = -1.0;
+    } else {
+      lastRate = rate;
+    }
   }
 
+  if (!converged) {
+    spdlog::warn("SORSolver did not converge within {} iterations, residual norm {}", it, resnorm);
+  }
   spdlog::debug("SORSolver needed {} iterations", it);
+  iterations_ = it;
+}
+
+void Solvers::SORSolver::solve() {
+  copyIn();
+  if (parameters_.geometry.dim == 3) {
+    iterate<3>();
+  } else {
+    iterate<2>();
+  }
+  copyOut();
 }
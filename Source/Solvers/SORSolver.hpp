@@ -4,12 +4,92 @@
 
 namespace Solvers {
 
+  /** Red-black SOR solver for the pressure equation
+   *
+   * The cells are split like a chessboard into two colours, a cell only couples to cells of the other colour. All
+   * cells of one colour are therefore updated independently, and the sweep over a colour is threaded over the lines
+   * in x-direction. To get unit-stride loops, the pressure and right hand side are stored per colour: line (j, k) of a
+   * colour holds the cells i = 2m + p, m = 0, 1, ..., with the parity p = (colour + j + k) % 2 of the line. The west
+   * and east neighbours of cell m are then the cells m - 1 + p and m + p of the other colour in the same line, the
+   * other neighbours are the cells m of the other colour in the neighbouring lines, which have the same parity.
+   *
+   * Unless set in the configuration, the relaxation factor is derived from the spectral radius of the Jacobi iteration,
+   * which is estimated from the observed convergence rate, starting with Gauss-Seidel. With Chebyshev acceleration,
+   * the relaxation factor changes per half-sweep and approaches the optimum from below. The residual is accumulated
+   * during the sweeps every residualInterval iterations, and computed separately only to confirm convergence. The
+   * pressure boundaries follow the PETSc assembly, as in the multigrid solver.
+   */
   class SORSolver: public LinearSolver {
+  private:
+    int lineLength_; //! Number of cells per line and colour, ghost layers included
+    int lines_;      //! Number of lines in x-direction, ghost layers included
+
+    const int      maxIterations_; //! No limit if not positive
+    const RealType fixedOmega_;    //! Relaxation factor from the configuration, 0 if it is estimated
+    const bool     chebyshev_;
+    const int      residualInterval_;
+
+    // Estimate of the spectral radius of the Jacobi iteration, which determines the optimal relaxation factor. It only
+    // depends on the operator and is kept across the solves. Negative as long as it is unknown.
+    RealType jacobiRadius_;
+
+    static constexpr RealType maxJacobiRadius_ = 1.0 - 1e-6;
+
+    std::vector<RealType> pressure_[2];
+    std::vector<RealType> rhs_[2];
+    std::vector<RealType> fluid_[2]; //! One for fluid cells, zero for obstacle and ghost cells
+
+    // Coefficients per axis, indexed by the local cell index. The ghost cells of Neumann and Dirichlet faces are
+    // eliminated, so that only periodic faces couple to the ghost layers.
+    std::vector<RealType> lower_[3];
+    std::vector<RealType> upper_[3];
+    std::vector<RealType> centre_[3];
+
+    // Coefficients in x-direction of the cells of a line, per parity
+    std::vector<RealType> lowerX_[2];
+    std::vector<RealType> upperX_[2];
+    std::vector<RealType> centreX_[2];
+
+    inline int getLine(int j, int k) const { return j + (flowField_.getNy() + 3) * k; }
+
+    inline RealType& getPressure(int i, int j, int k) {
+      return pressure_[(i + j + k) & 1][getLine(j, k) * lineLength_ + (i >> 1)];
+    }
+    inline RealType& getRhs(int i, int j, int k) { return rhs_[(i + j + k) & 1][getLine(j, k) * lineLength_ + (i >> 1)]; }
+
+    void setUpCoefficients();
+
+    void updateFluidCells();
+
+    void copyIn();
+    void copyOut();
+
+    // Sets the ghost layers from the inner cells according to the boundary conditions
+    template <int Dim>
+    void updateGhosts();
+
+    // Updates all cells of one colour. Returns the sum of the squared residuals of these cells before the update if
+    // ComputeNorm is set, zero otherwise.
+    template <int Dim, bool ComputeNorm>
+    RealType sweep(int colour, RealType omega);
+
+    static inline RealType getOptimalOmega(RealType jacobiRadius) {
+      return jacobiRadius < 0 ? 1.0 : 2.0 / (1.0 + sqrt(1.0 - jacobiRadius * jacobiRadius));
+    }
+
+    template <int Dim>
+    RealType computeResidualNorm();
+
+    template <int Dim>
+    void iterate();
+
   public:
     SORSolver(FlowField& flowField, const Parameters& parameters);
     ~SORSolver() override = default;
 
     void solve() override;
+
+    void reInitMatrix() override;
   };
 
 } // namespace Solvers
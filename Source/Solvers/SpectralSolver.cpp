@@ -0,0 +1,397 @@
+#include "StdAfx.hpp"
+
+#include "SpectralSolver.hpp"
+
+bool Solvers::SpectralSolver::isApplicable(const Parameters& parameters) {
+  const bool slabs = parameters.parallel.numProcessors[0] == 1
+                     && (parameters.geometry.dim == 2 || parameters.parallel.numProcessors[1] == 1);
+
+  // The channel scenarios place the backward-facing step as obstacle, see BFStepInitStencil
+  const bool channel  = parameters.simulation.scenario == "channel"
+                       || parameters.simulation.scenario == "pressure-channel";
+  const bool obstacle = channel && parameters.bfStep.xRatio > 0 && parameters.bfStep.yRatio > 0;
+
+  return parameters.geometry.meshsizeType == Uniform && slabs && !obstacle;
+}
+
+Solvers::SpectralSolver::SpectralSolver(FlowField& flowField, const Parameters& parameters):
+  LinearSolver(flowField, parameters),
+  outer_(parameters.geometry.dim - 1),
+  processes_(parameters.parallel.numProcessors[outer_]),
+  slab_(processes_ > 1 ? parameters.parallel.indices[outer_] : 0) {
+
+  if (!isApplicable(parameters)) {
+    throw std::runtime_error("Spectral solver requires a uniform mesh without obstacles, split along the outermost axis only");
+  }
+
+  setAxis(0, parameters.walls.typeLeft, parameters.walls.typeRight);
+  setAxis(1, parameters.walls.typeBottom, parameters.walls.typeTop);
+  if (parameters.geometry.dim == 3) {
+    setAxis(2, parameters.walls.typeFront, parameters.walls.typeBack);
+  }
+
+  int longest = 0;
+  for (int axis = 0; axis <= outer_; axis++) {
+    longest = std::max(longest, axes_[axis].size);
+  }
+  line_.resize(2 * longest);
+
+  setUpTranspose();
+}
+
+void Solvers::SpectralSolver::setUpTranspose() {
+  // Lines along the outermost axis, i.e. cells of a slab at a fixed position along this axis
+  const int lines = outer_ == 2 ? axes_[0].size * axes_[1].size : axes_[0].size;
+
+  lineCounts_.resize(processes_);
+  lineOffsets_.resize(processes_);
+  for (int p = 0, offset = 0; p < processes_; p++) {
+    lineCounts_[p]  = lines / processes_ + (p < lines % processes_ ? 1 : 0);
+    lineOffsets_[p] = offset;
+    offset += lineCounts_[p];
+  }
+
+  slabSizes_.assign(1, parameters_.parallel.localSize[outer_]);
+  slabOffsets_.assign(1, parameters_.parallel.firstCorner[outer_]);
+  if (processes_ > 1) {
+    slabSizes_.resize(processes_);
+    slabOffsets_.resize(processes_);
+    MPI_Allgather(&parameters_.parallel.localSize[outer_], 1, MPI_INT, slabSizes_.data(), 1, MPI_INT, PETSC_COMM_WORLD);
+    MPI_Allgather(&parameters_.parallel.firstCorner[outer_], 1, MPI_INT, slabOffsets_.data(), 1, MPI_INT, PETSC_COMM_WORLD);
+  }
+
+  // Before the transpose, a process holds all lines for its cells along the outermost axis. It sends the lines of
+  // each process cell by cell, and receives all cells for its own lines, which are the complete lines.
+  const int lineCount = lineCounts_[slab_];
+  sendCounts_.resize(processes_);
+  sendOffsets_.resize(processes_);
+  receiveCounts_.resize(processes_);
+  receiveOffsets_.resize(processes_);
+  for (int p = 0; p < processes_; p++) {
+    sendCounts_[p]     = lineCounts_[p] * slabSizes_[slab_];
+    sendOffsets_[p]    = lineOffsets_[p] * slabSizes_[slab_];
+    receiveCounts_[p]  = lineCount * slabSizes_[p];
+    receiveOffsets_[p] = lineCount * slabOffsets_[p];
+  }
+
+  axes_[0].stride = 1;
+  if (outer_ == 2) {
+    axes_[1].stride = axes_[0].size;
+  }
+  axes_[outer_].stride = lineCount;
+
+  values_.resize(lines * slabSizes_[slab_]);
+  if (processes_ > 1) {
+    transposed_.resize(lineCount * axes_[outer_].size);
+    buffer_.resize(values_.size());
+  }
+
+  innerEigenvalues_.resize(lineCount);
+  for (int line = 0; line < lineCount; line++) {
+    const int index         = lineOffsets_[slab_] + line;
+    innerEigenvalues_[line] = axes_[0].eigenvalues[index % axes_[0].size];
+    if (outer_ == 2) {
+      innerEigenvalues_[line] += axes_[1].eigenvalues[index / axes_[0].size];
+    }
+  }
+}
+
+void Solvers::SpectralSolver::transpose(bool inverse) {
+  const int slabSize = slabSizes_[slab_];
+  const int lines    = lineOffsets_.back() + lineCounts_.back();
+
+  if (!inverse) {
+    for (int p = 0; p < processes_; p++) {
+      RealType* target = buffer_.data() + sendOffsets_[p];
+      for (int k = 0; k < slabSize; k++) {
+        std::copy_n(values_.data() + lines * k + lineOffsets_[p], lineCounts_[p], target + lineCounts_[p] * k);
+      }
+    }
+    MPI_Alltoallv(
+      buffer_.data(), sendCounts_.data(), sendOffsets_.data(), MY_MPI_FLOAT, transposed_.data(), receiveCounts_.data(), receiveOffsets_.data(), MY_MPI_FLOAT, PETSC_COMM_WORLD
+    );
+    return;
+  }
+
+  MPI_Alltoallv(
+    transposed_.data(), receiveCounts_.data(), receiveOffsets_.data(), MY_MPI_FLOAT, buffer_.data(), sendCounts_.data(), sendOffsets_.data(), MY_MPI_FLOAT, PETSC_COMM_WORLD
+  );
+  for (int p = 0; p < processes_; p++) {
+    const RealType* source = buffer_.data() + sendOffsets_[p];
+    for (int k = 0; k < slabSize; k++) {
+      std::copy_n(source + lineCounts_[p] * k, lineCounts_[p], values_.data() + lines * k + lineOffsets_[p]);
+    }
+  }
+}
+
+void Solvers::SpectralSolver::setAxis(int axis, BoundaryType lower, BoundaryType upper) {
+  Axis& a = axes_[axis];
+
+  a.size        = axis == 0 ? parameters_.geometry.sizeX : (axis == 1 ? parameters_.geometry.sizeY : parameters_.geometry.sizeZ);
+  a.coefficient = pressureOperator_.getLower(axis)[2];
+  a.lowerValue  = lowerValues_[axis];
+  a.upperValue  = upperValues_[axis];
+
+  const int size = a.size;
+
+  // The transforms span the whole domain, so the faces between the slabs do not count
+  const FaceType lowerFace = getDomainFace(lower);
+  const FaceType upperFace = getDomainFace(upper);
+  if (lowerFace == PeriodicFace) {
+    a.type  = PeriodicAxis;
+    a.shift = 0.0;
+    a.sine  = false;
+    a.eigenvalues.resize(size);
+    for (int k = 0; k < size; k++) {
+      const RealType s = sin(M_PI * k / size);
+      a.eigenvalues[k] = -4.0 * a.coefficient * s * s;
+    }
+    a.transform = std::make_unique<FourierTransform>(size);
+    return;
+  }
+
+  const bool lowerDirichlet = lowerFace == DirichletFace;
+  const bool upperDirichlet = upperFace == DirichletFace;
+  if (!lowerDirichlet && !upperDirichlet) {
+    a.type  = NeumannNeumann;
+    a.shift = 0.0;
+    a.sine  = false;
+  } else if (lowerDirichlet && upperDirichlet) {
+    a.type  = DirichletDirichlet;
+    a.shift = 1.0;
+    a.sine  = true;
+  } else if (upperDirichlet) {
+    a.type  = NeumannDirichlet;
+    a.shift = 0.5;
+    a.sine  = false;
+  } else {
+    a.type  = DirichletNeumann;
+    a.shift = 0.5;
+    a.sine  = true;
+  }
+
+  a.eigenvalues.resize(size);
+  a.weights.resize(size);
+  a.preTwiddles.resize(size);
+  a.postTwiddles.resize(size);
+  for (int k = 0; k < size; k++) {
+    const RealType s = sin(M_PI * (k + a.shift) / (2 * size));
+    a.eigenvalues[k] = -4.0 * a.coefficient * s * s;
+
+    // The basis functions are orthogonal with squared norm size / 2, except for the constant and the alternating one
+    const bool full = (a.type == NeumannNeumann && k == 0) || (a.type == DirichletDirichlet && k == size - 1);
+    a.weights[k]    = (full ? 1.0 : 2.0) / size;
+
+    a.preTwiddles[k]  = std::exp(FourierTransform::Complex(0.0, -M_PI * a.shift * k / size));
+    a.postTwiddles[k] = std::exp(FourierTransform::Complex(0.0, -M_PI * (k + a.shift) / (2 * size)));
+  }
+  a.transform = std::make_unique<FourierTransform>(2 * size);
+}
+
+void Solvers::SpectralSolver::transformLine(Axis& axis, RealType* data, bool inverse) {
+  const int size   = axis.size;
+  const int stride = axis.stride;
+
+  if (axis.type == PeriodicAxis) {
+    // The Hartley transform sum_n x_n (cos + sin)(2 pi k n / size) is its own inverse up to the factor 1 / size
+    for (int n = 0; n < size; n++) {
+      line_[n] = data[n * stride];
+    }
+    axis.transform->forward(line_.data());
+    const RealType scaling = inverse ? 1.0 / size : 1.0;
+    for (int k = 0; k < size; k++) {
+      data[k * stride] = scaling * (line_[k].real() - line_[k].imag());
+    }
+    return;
+  }
+
+  // sum_n x_n exp(-i pi (k + shift) (2n + 1) / (2 size)) is a transform of length 2 size of the zero-padded x_n
+  // exp(-i pi shift n / size), multiplied by exp(-i pi (k + shift) / (2 size)). Its real part is the cosine
+  // transform, the negative imaginary part the sine transform. The inverse follows from the conjugate relation.
+  std::fill(line_.begin() + size, line_.begin() + 2 * size, FourierTransform::Complex(0.0, 0.0));
+  if (!inverse) {
+    for (int n = 0; n < size; n++) {
+      line_[n] = data[n * stride] * axis.preTwiddles[n];
+    }
+    axis.transform->forward(line_.data());
+    for (int k = 0; k < size; k++) {
+      const FourierTransform::Complex value = line_[k] * axis.postTwiddles[k];
+      data[k * stride]                      = axis.sine ? -value.imag() : value.real();
+    }
+  } else {
+    for (int k = 0; k < size; k++) {
+      line_[k] = axis.weights[k] * data[k * stride] * std::conj(axis.postTwiddles[k]);
+    }
+    axis.transform->backward(line_.data());
+    for (int n = 0; n < size; n++) {
+      const FourierTransform::Complex value = line_[n] * std::conj(axis.preTwiddles[n]);
+      data[n * stride]                      = axis.sine ? value.imag() : value.real();
+    }
+  }
+}
+
+void Solvers::SpectralSolver::transformLines(int axis, std::vector<RealType>& data, bool inverse) {
+  Axis&     a      = axes_[axis];
+  const int length = a.size * a.stride;
+  const int cells  = static_cast<int>(data.size());
+
+  // A process may have no lines along the outermost axis if there are fewer lines than processes
+  if (cells == 0) {
+    return;
+  }
+  for (int outer = 0; outer < cells; outer += length) {
+    for (int inner = 0; inner < a.stride; inner++) {
+      transformLine(a, data.data() + outer + inner, inverse);
+    }
+  }
+}
+
+void Solvers::SpectralSolver::solve() {
+  ScalarField& P   = flowField_.getPressure();
+  ScalarField& RHS = flowField_.getRHS();
+
+  const bool is3D = parameters_.geometry.dim == 3;
+  const int  nx = flowField_.getNx(), ny = flowField_.getNy(), nz = is3D ? flowField_.getNz() : 1;
+
+  // Cell (i, j, k) is stored at i - 2 + nx (j - 2 + ny (k - 2)); in 2D, k stays 0
+  auto position = [&](int i, int j, int k) { return (i - 2) + nx * ((j - 2) + ny * (is3D ? k - 2 : 0)); };
+  const int kBegin = is3D ? 2 : 0;
+  const int kEnd   = is3D ? nz + 2 : 1;
+
+  // Only the slabs at the ends of the outermost axis touch its boundaries
+  auto isLower = [&](int axis) { return axis != outer_ || slab_ == 0; };
+  auto isUpper = [&](int axis) { return axis != outer_ || slab_ == processes_ - 1; };
+  auto isLowerDirichlet = [&](int axis) {
+    return isLower(axis) && (axes_[axis].type == DirichletDirichlet || axes_[axis].type == DirichletNeumann);
+  };
+  auto isUpperDirichlet = [&](int axis) {
+    return isUpper(axis) && (axes_[axis].type == DirichletDirichlet || axes_[axis].type == NeumannDirichlet);
+  };
+
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      for (int i = 2; i < nx + 2; i++) {
+        values_[position(i, j, k)] = RHS.getScalar(i, j, k);
+      }
+    }
+  }
+
+  // The ghost cell behind a Dirichlet face is 2 value - inner, which moves 2 value times the coupling to the right hand
+  // side
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      if (isLowerDirichlet(0)) {
+        values_[position(2, j, k)] -= 2.0 * axes_[0].coefficient * axes_[0].lowerValue;
+      }
+      if (isUpperDirichlet(0)) {
+        values_[position(nx + 1, j, k)] -= 2.0 * axes_[0].coefficient * axes_[0].upperValue;
+      }
+    }
+    for (int i = 2; i < nx + 2; i++) {
+      if (isLowerDirichlet(1)) {
+        values_[position(i, 2, k)] -= 2.0 * axes_[1].coefficient * axes_[1].lowerValue;
+      }
+      if (isUpperDirichlet(1)) {
+        values_[position(i, ny + 1, k)] -= 2.0 * axes_[1].coefficient * axes_[1].upperValue;
+      }
+    }
+  }
+  if (is3D) {
+    for (int j = 2; j < ny + 2; j++) {
+      for (int i = 2; i < nx + 2; i++) {
+        if (isLowerDirichlet(2)) {
+          values_[position(i, j, 2)] -= 2.0 * axes_[2].coefficient * axes_[2].lowerValue;
+        }
+        if (isUpperDirichlet(2)) {
+          values_[position(i, j, nz + 1)] -= 2.0 * axes_[2].coefficient * axes_[2].upperValue;
+        }
+      }
+    }
+  }
+
+  // The inner axes are complete on every process. On a single process, values_ is already laid out as transposed_.
+  for (int axis = 0; axis < outer_; axis++) {
+    transformLines(axis, values_, false);
+  }
+  std::vector<RealType>& lines = processes_ > 1 ? transposed_ : values_;
+  if (processes_ > 1) {
+    transpose(false);
+  }
+  transformLines(outer_, lines, false);
+
+  // Without Dirichlet faces, the constant mode has the eigenvalue zero. Dropping it removes the incompatible part of
+  // the right hand side and fixes the mean pressure to zero.
+  const Axis& outer     = axes_[outer_];
+  const int   lineCount = outer.stride;
+  for (int k = 0; k < outer.size; k++) {
+    RealType* values = lines.data() + lineCount * k;
+    for (int line = 0; line < lineCount; line++) {
+      const RealType eigenvalue = innerEigenvalues_[line] + outer.eigenvalues[k];
+      values[line]              = eigenvalue != 0.0 ? values[line] / eigenvalue : 0.0;
+    }
+  }
+
+  transformLines(outer_, lines, true);
+  if (processes_ > 1) {
+    transpose(true);
+  }
+  for (int axis = 0; axis < outer_; axis++) {
+    transformLines(axis, values_, true);
+  }
+
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      for (int i = 2; i < nx + 2; i++) {
+        P.getScalar(i, j, k) = values_[position(i, j, k)];
+      }
+    }
+  }
+
+  // Ghost layers, consistent with the boundary conditions of the transforms. The ghost layers towards other slabs, and
+  // those of a periodic outermost axis split between processes, are left to the exchange after the solve.
+  auto ghost = [](const Axis& axis, bool upper, RealType inner, RealType opposite) -> RealType {
+    const bool dirichlet = axis.type == DirichletDirichlet
+                           || (upper ? axis.type == NeumannDirichlet : axis.type == DirichletNeumann);
+    if (dirichlet) {
+      return 2.0 * (upper ? axis.upperValue : axis.lowerValue) - inner;
+    }
+    return axis.type == PeriodicAxis ? opposite : inner;
+  };
+  const bool split    = processes_ > 1 && outer.type == PeriodicAxis;
+  auto       hasLower = [&](int axis) { return isLower(axis) && !(axis == outer_ && split); };
+  auto       hasUpper = [&](int axis) { return isUpper(axis) && !(axis == outer_ && split); };
+
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < ny + 2; j++) {
+      P.getScalar(1, j, k)      = ghost(axes_[0], false, P.getScalar(2, j, k), P.getScalar(nx + 1, j, k));
+      P.getScalar(nx + 2, j, k) = ghost(axes_[0], true, P.getScalar(nx + 1, j, k), P.getScalar(2, j, k));
+    }
+    for (int i = 2; i < nx + 2; i++) {
+      if (hasLower(1)) {
+        P.getScalar(i, 1, k) = ghost(axes_[1], false, P.getScalar(i, 2, k), P.getScalar(i, ny + 1, k));
+      }
+      if (hasUpper(1)) {
+        P.getScalar(i, ny + 2, k) = ghost(axes_[1], true, P.getScalar(i, ny + 1, k), P.getScalar(i, 2, k));
+      }
+    }
+  }
+  if (is3D) {
+    for (int j = 2; j < ny + 2; j++) {
+      for (int i = 2; i < nx + 2; i++) {
+        if (hasLower(2)) {
+          P.getScalar(i, j, 1) = ghost(axes_[2], false, P.getScalar(i, j, 2), P.getScalar(i, j, nz + 1));
+        }
+        if (hasUpper(2)) {
+          P.getScalar(i, j, nz + 2) = ghost(axes_[2], true, P.getScalar(i, j, nz + 1), P.getScalar(i, j, 2));
+        }
+      }
+    }
+  }
+}
+
+void Solvers::SpectralSolver::reInitMatrix() {
+  LinearSolver::reInitMatrix();
+  if (!pressureOperator_.getObstacleRows().empty()) {
+    throw std::runtime_error("Spectral solver does not support obstacles");
+  }
+}
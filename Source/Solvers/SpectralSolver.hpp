@@ -0,0 +1,94 @@
+#pragma once
+
+#include "FourierTransform.hpp"
+#include "LinearSolver.hpp"
+
+namespace Solvers {
+
+  /** Direct solver for the pressure equation on uniform meshes without obstacles
+   *
+   * On a uniform mesh, the discrete Laplacian is a sum of constant-coefficient 1D operators, one per axis. Each of them
+   * is diagonalised by a trigonometric transform that depends on the pressure boundaries of the axis: a discrete
+   * Hartley transform for periodic axes, and the cosine and sine transforms of type II (Neumann or Dirichlet at both
+   * ends) or type IV (Neumann at one end, Dirichlet at the other) on cell-centred data. The solver transforms the right
+   * hand side along all axes, divides by the eigenvalues and transforms back, which solves the system exactly in
+   * O(N log N). All transforms are evaluated with complex FFTs, see FourierTransform.
+   *
+   * The pressure boundaries follow the PETSc assembly, as in the multigrid solver. The transforms are global along
+   * each axis, so in parallel runs the domain may only be split along the outermost axis, z in 3D and y in 2D (slab
+   * decomposition). The inner axes are transformed on each process. The data is then transposed with MPI_Alltoallv,
+   * so that every process holds the complete lines along the outermost axis for a part of the inner cells, which are
+   * transformed, solved and transposed back.
+   */
+  class SpectralSolver: public LinearSolver {
+  private:
+    enum AxisType { PeriodicAxis, NeumannNeumann, DirichletDirichlet, NeumannDirichlet, DirichletNeumann };
+
+    struct Axis {
+      int      size;        //! Number of inner cells of the whole domain
+      int      stride;      //! Distance of neighbouring cells along this axis in values_, or transposed_ for the outermost axis
+      AxisType type;
+      RealType coefficient; //! Coupling to the neighbours, i.e., the inverse squared meshsize
+      RealType lowerValue;  //! Pressure on Dirichlet faces
+      RealType upperValue;
+
+      // The basis functions of non-periodic axes are cos or sin(pi (k + shift) (n + 1/2) / size)
+      RealType shift;
+      bool     sine;
+
+      std::vector<RealType>                  eigenvalues;
+      std::vector<RealType>                  weights;      //! Normalisation of the inverse transform
+      std::vector<FourierTransform::Complex> preTwiddles;  //! exp(-i pi shift n / size)
+      std::vector<FourierTransform::Complex> postTwiddles; //! exp(-i pi (k + shift) / (2 size))
+      std::unique_ptr<FourierTransform>      transform;
+    };
+
+    Axis axes_[3];
+    int  outer_;     //! Outermost axis, along which the domain may be split
+    int  processes_; //! Number of processes along the outermost axis
+    int  slab_;      //! Index of this process along the outermost axis
+
+    std::vector<RealType>                  values_;     //! Inner cells of the subdomain, x fastest
+    std::vector<RealType>                  transposed_; //! The lines along the outermost axis of this process, line index fastest
+    std::vector<RealType>                  innerEigenvalues_; //! Sum of the eigenvalues of the inner axes per line of transposed_
+    std::vector<FourierTransform::Complex> line_;
+
+    // Partition of the lines along the outermost axis and of the cells along this axis among the processes, and the
+    // buffers of the transpose
+    std::vector<int>      lineCounts_;
+    std::vector<int>      lineOffsets_;
+    std::vector<int>      slabSizes_;
+    std::vector<int>      slabOffsets_;
+    std::vector<int>      sendCounts_;
+    std::vector<int>      sendOffsets_;
+    std::vector<int>      receiveCounts_;
+    std::vector<int>      receiveOffsets_;
+    std::vector<RealType> buffer_;
+
+    void setAxis(int axis, BoundaryType lower, BoundaryType upper);
+
+    void setUpTranspose();
+
+    // Redistributes values_ into transposed_, or back if inverse is set
+    void transpose(bool inverse);
+
+    // Transforms all lines along an axis in data into the eigenbasis of the axis, or back if inverse is set
+    void transformLines(int axis, std::vector<RealType>& data, bool inverse);
+
+    void transformLine(Axis& axis, RealType* data, bool inverse);
+
+  public:
+    SpectralSolver(FlowField& flowField, const Parameters& parameters);
+    ~SpectralSolver() override = default;
+
+    /** Returns if the solver can be used for the given configuration: a uniform mesh without obstacles, split along
+     * the outermost axis only
+     */
+    static bool isApplicable(const Parameters& parameters);
+
+    void solve() override;
+
+    void reInitMatrix() override;
+  };
+
+} // namespace Solvers
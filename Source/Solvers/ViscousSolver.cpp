@@ -0,0 +1,292 @@
+#include "StdAfx.hpp"
+
+#include "ViscousSolver.hpp"
+
+Solvers::ViscousSolver::ViscousSolver(
+  FlowField& flowField, const Parameters& parameters, ParallelManagers::PetscParallelManager& parallelManager
+):
+  flowField_(flowField),
+  parameters_(parameters),
+  parallelManager_(parallelManager),
+  weights_(parameters),
+  delta_(createField(flowField, parameters)),
+  direction_(createField(flowField, parameters)),
+  residual_(createField(flowField, parameters)),
+  product_(createField(flowField, parameters)),
+  theta_(0.5),
+  tolerance_(parameters.timestep.imexTolerance),
+  maxIterations_(parameters.timestep.imexIterations) {
+
+  for (int component = 0; component < 3; component++) {
+    setRange(component, 0, flowField.getNx(), parameters.walls.typeLeft, parameters.walls.typeRight, parameters.parallel.leftNb, parameters.parallel.rightNb);
+    setRange(component, 1, flowField.getNy(), parameters.walls.typeBottom, parameters.walls.typeTop, parameters.parallel.bottomNb, parameters.parallel.topNb);
+    if (parameters.geometry.dim == 3) {
+      setRange(component, 2, flowField.getNz(), parameters.walls.typeFront, parameters.walls.typeBack, parameters.parallel.frontNb, parameters.parallel.backNb);
+    } else {
+      // A single layer k = 0 in 2D
+      wrap_[2]                 = false;
+      first_[component][2]     = 0;
+      last_[component][2]      = 0;
+      lowerSign_[component][2] = 0.0;
+      upperSign_[component][2] = 0.0;
+    }
+  }
+}
+
+VectorField Solvers::ViscousSolver::createField(const FlowField& flowField, const Parameters& parameters) {
+  return parameters.geometry.dim == 2 ? VectorField(flowField.getNx() + 3, flowField.getNy() + 3)
+                                      : VectorField(flowField.getNx() + 3, flowField.getNy() + 3, flowField.getNz() + 3);
+}
+
+void Solvers::ViscousSolver::setRange(
+  int component, int axis, int size, BoundaryType lower, BoundaryType upper, int lowerNb, int upperNb
+) {
+  // Periodic axes with a single process, split axes exchange their ghost layers like any other subdomain face
+  wrap_[axis] = lower == PERIODIC && lowerNb < 0;
+  if (wrap_[axis]) {
+    first_[component][axis]     = 2;
+    last_[component][axis]      = size + 1;
+    lowerSign_[component][axis] = 0.0;
+    upperSign_[component][axis] = 0.0;
+    return;
+  }
+
+  // Faces between subdomains are interior faces, without a wall
+  if (lowerNb >= 0) {
+    lower = NEUMANN;
+  }
+  if (upperNb >= 0) {
+    upper = NEUMANN;
+  }
+
+  if (component == axis) {
+    // The normal component is located on the wall. It is prescribed for Dirichlet walls and computed by
+    // the FGH stencil otherwise. On a lower face between subdomains, it belongs to the lower neighbour.
+    first_[component][axis]     = lower == DIRICHLET || lowerNb >= 0 ? 2 : 1;
+    last_[component][axis]      = upper == DIRICHLET ? size : size + 1;
+    lowerSign_[component][axis] = lower == DIRICHLET ? 0.0 : 1.0;
+    upperSign_[component][axis] = upper == DIRICHLET ? 0.0 : 1.0;
+  } else {
+    // Tangential components are mirrored into the ghost cells, see the moving wall stencils
+    first_[component][axis]     = 2;
+    last_[component][axis]      = size + 1;
+    lowerSign_[component][axis] = lower == DIRICHLET ? -1.0 : 1.0;
+    upperSign_[component][axis] = upper == DIRICHLET ? -1.0 : 1.0;
+  }
+}
+
+void Solvers::ViscousSolver::solve() {
+  const RealType coefficient = theta_ * parameters_.timestep.dt / parameters_.flow.Re;
+
+  if (parameters_.geometry.dim == 2) {
+    solveComponent<2>(0, coefficient);
+    solveComponent<2>(1, coefficient);
+  } else {
+    solveComponent<3>(0, coefficient);
+    solveComponent<3>(1, coefficient);
+    solveComponent<3>(2, coefficient);
+  }
+}
+
+template <typename Function>
+void Solvers::ViscousSolver::forEachUnknown(int component, Function function) {
+  const int       mask  = OBSTACLE_SELF | (component == 0 ? OBSTACLE_RIGHT : (component == 1 ? OBSTACLE_TOP : OBSTACLE_BACK));
+  IntScalarField& flags = flowField_.getFlags();
+
+  for (int k = first_[component][2]; k <= last_[component][2]; k++) {
+    for (int j = first_[component][1]; j <= last_[component][1]; j++) {
+      for (int i = first_[component][0]; i <= last_[component][0]; i++) {
+        if ((flags.getValue(i, j, k) & mask) == 0) {
+          function(i, j, k);
+        }
+      }
+    }
+  }
+}
+
+template <int Dim>
+void Solvers::ViscousSolver::solveComponent(int component, RealType coefficient) {
+  VectorField& fgh      = flowField_.getFGH();
+  VectorField& velocity = flowField_.getVelocity();
+
+  const RealType dt = parameters_.timestep.dt;
+  // The predictor of the incremental projection already includes the gradient, see FGHStencil
+  const RealType shift = parameters_.solver.incremental ? 0.0 : dt;
+
+  // Move the pressure gradient of the last projection into the explicit part, F - dt grad(p)
+  forEachUnknown(component, [&](int i, int j, int k) {
+    fgh.getVector(i, j, k)[component] -= shift * pressureGradient(component, i, j, k);
+  });
+
+  // Residual of the weighted system for the previous increment, r = W (F - u) - A delta
+  applyOperator<Dim>(component, coefficient, delta_, product_);
+  RealType rhsNorm = 0.0;
+  forEachUnknown(component, [&](int i, int j, int k) {
+    const RealType rhs                      = getWeight<Dim>(i, j, k) * (fgh.getVector(i, j, k)[component] - velocity.getVector(i, j, k)[component]);
+    residual_.getVector(i, j, k)[component] = rhs - product_.getVector(i, j, k)[component];
+    rhsNorm += rhs * rhs;
+  });
+  MPI_Allreduce(MPI_IN_PLACE, &rhsNorm, 1, MY_MPI_FLOAT, MPI_SUM, PETSC_COMM_WORLD);
+
+  int      it       = 0;
+  RealType residual = 0.0;
+  if (rhsNorm > 0.0) {
+    // Jacobi-preconditioned conjugate gradients, z = D^-1 r is stored in the direction for the first iteration
+    RealType projection = 0.0;
+    forEachUnknown(component, [&](int i, int j, int k) {
+      const RealType value                     = residual_.getVector(i, j, k)[component];
+      const RealType preconditioned            = value / getDiagonal<Dim>(i, j, k, coefficient);
+      direction_.getVector(i, j, k)[component] = preconditioned;
+      projection += value * preconditioned;
+      residual += value * value;
+    });
+    RealType sums[2] = {projection, residual};
+    MPI_Allreduce(MPI_IN_PLACE, sums, 2, MY_MPI_FLOAT, MPI_SUM, PETSC_COMM_WORLD);
+    projection = sums[0];
+    residual   = sums[1];
+
+    while (residual > tolerance_ * tolerance_ * rhsNorm && it < maxIterations_) {
+      applyOperator<Dim>(component, coefficient, direction_, product_);
+      RealType curvature = 0.0;
+      forEachUnknown(component, [&](int i, int j, int k) {
+        curvature += direction_.getVector(i, j, k)[component] * product_.getVector(i, j, k)[component];
+      });
+      MPI_Allreduce(MPI_IN_PLACE, &curvature, 1, MY_MPI_FLOAT, MPI_SUM, PETSC_COMM_WORLD);
+
+      const RealType alpha = projection / curvature;
+      sums[0]              = 0.0;
+      sums[1]              = 0.0;
+      forEachUnknown(component, [&](int i, int j, int k) {
+        delta_.getVector(i, j, k)[component] += alpha * direction_.getVector(i, j, k)[component];
+        RealType& value = residual_.getVector(i, j, k)[component];
+        value -= alpha * product_.getVector(i, j, k)[component];
+        sums[0] += value * value / getDiagonal<Dim>(i, j, k, coefficient);
+        sums[1] += value * value;
+      });
+      MPI_Allreduce(MPI_IN_PLACE, sums, 2, MY_MPI_FLOAT, MPI_SUM, PETSC_COMM_WORLD);
+
+      const RealType beta = sums[0] / projection;
+      projection          = sums[0];
+      residual            = sums[1];
+      forEachUnknown(component, [&](int i, int j, int k) {
+        RealType& value = direction_.getVector(i, j, k)[component];
+        value           = residual_.getVector(i, j, k)[component] / getDiagonal<Dim>(i, j, k, coefficient) + beta * value;
+      });
+      it++;
+    }
+
+    if (residual > tolerance_ * tolerance_ * rhsNorm) {
+      spdlog::warn(
+        "ViscousSolver did not converge for component {} in {} iterations, relative residual {}", component, it, std::sqrt(residual / rhsNorm)
+      );
+    }
+  }
+  spdlog::debug("ViscousSolver needed {} iterations for component {}", it, component);
+
+  forEachUnknown(component, [&](int i, int j, int k) {
+    RealType* const delta = delta_.getVector(i, j, k);
+    if (rhsNorm == 0.0) {
+      delta[component] = 0.0;
+    }
+    fgh.getVector(i, j, k)[component] = velocity.getVector(i, j, k)[component] + delta[component]
+                                        + shift * pressureGradient(component, i, j, k);
+  });
+
+  // The normal face on a periodic lower boundary is the one on the upper boundary
+  if (component < Dim && wrap_[component]) {
+    const int b = (component + 1) % 3;
+    const int c = (component + 2) % 3;
+    int       index[3];
+    for (int m = first_[component][b]; m <= last_[component][b]; m++) {
+      for (int n = first_[component][c]; n <= last_[component][c]; n++) {
+        index[b]             = m;
+        index[c]             = n;
+        index[component]     = last_[component][component];
+        const RealType value = fgh.getVector(index[0], index[1], index[2])[component];
+        index[component]     = first_[component][component] - 1;
+        fgh.getVector(index[0], index[1], index[2])[component] = value;
+      }
+    }
+  }
+}
+
+RealType Solvers::ViscousSolver::pressureGradient(int component, int i, int j, int k) {
+  ScalarField& pressure = flowField_.getPressure();
+  // Same difference as in the VelocityStencil
+  if (component == 0) {
+    return weights_.getX(i).inverseCentreDistance * (pressure.getScalar(i + 1, j, k) - pressure.getScalar(i, j, k));
+  } else if (component == 1) {
+    return weights_.getY(j).inverseCentreDistance * (pressure.getScalar(i, j + 1, k) - pressure.getScalar(i, j, k));
+  }
+  return weights_.getZ(k).inverseCentreDistance * (pressure.getScalar(i, j, k + 1) - pressure.getScalar(i, j, k));
+}
+
+template <int Dim>
+RealType Solvers::ViscousSolver::getWeight(int i, int j, int k) const {
+  RealType weight = 1.0 / (weights_.getX(i).inverseCentreDistance * weights_.getY(j).inverseCentreDistance);
+  if constexpr (Dim == 3) {
+    weight /= weights_.getZ(k).inverseCentreDistance;
+  }
+  return weight;
+}
+
+template <int Dim>
+RealType Solvers::ViscousSolver::getDiagonal(int i, int j, int k, RealType coefficient) const {
+  RealType laplace = weights_.getX(i).laplace[1] + weights_.getY(j).laplace[1];
+  if constexpr (Dim == 3) {
+    laplace += weights_.getZ(k).laplace[1];
+  }
+  return getWeight<Dim>(i, j, k) * (1.0 - coefficient * laplace);
+}
+
+template <int Dim>
+void Solvers::ViscousSolver::applyOperator(int component, RealType coefficient, VectorField& input, VectorField& output) {
+  updateGhosts<Dim>(component, input);
+  parallelManager_.communicateVector(input);
+
+  forEachUnknown(component, [&](int i, int j, int k) {
+    const Stencils::AxisWeights& wx = weights_.getX(i);
+    const Stencils::AxisWeights& wy = weights_.getY(j);
+
+    RealType laplace = wx.laplace[0] * input.getVector(i - 1, j, k)[component]
+                     + wx.laplace[1] * input.getVector(i, j, k)[component]
+                     + wx.laplace[2] * input.getVector(i + 1, j, k)[component]
+                     + wy.laplace[0] * input.getVector(i, j - 1, k)[component]
+                     + wy.laplace[1] * input.getVector(i, j, k)[component]
+                     + wy.laplace[2] * input.getVector(i, j + 1, k)[component];
+    if constexpr (Dim == 3) {
+      const Stencils::AxisWeights& wz = weights_.getZ(k);
+
+      laplace += wz.laplace[0] * input.getVector(i, j, k - 1)[component]
+               + wz.laplace[1] * input.getVector(i, j, k)[component]
+               + wz.laplace[2] * input.getVector(i, j, k + 1)[component];
+    }
+
+    output.getVector(i, j, k)[component] = getWeight<Dim>(i, j, k) * (input.getVector(i, j, k)[component] - coefficient * laplace);
+  });
+}
+
+template <int Dim>
+void Solvers::ViscousSolver::updateGhosts(int component, VectorField& field) {
+  int index[3];
+  for (int axis = 0; axis < Dim; axis++) {
+    const int b = (axis + 1) % 3;
+    const int c = (axis + 2) % 3;
+    for (int m = first_[component][b]; m <= last_[component][b]; m++) {
+      for (int n = first_[component][c]; n <= last_[component][c]; n++) {
+        index[b] = m;
+        index[c] = n;
+
+        index[axis]          = first_[component][axis];
+        const RealType lower = field.getVector(index[0], index[1], index[2])[component];
+        index[axis]          = last_[component][axis];
+        const RealType upper = field.getVector(index[0], index[1], index[2])[component];
+
+        index[axis] = first_[component][axis] - 1;
+        field.getVector(index[0], index[1], index[2])[component] = wrap_[axis] ? upper : lowerSign_[component][axis] * lower;
+        index[axis] = last_[component][axis] + 1;
+        field.getVector(index[0], index[1], index[2])[component] = wrap_[axis] ? lower : upperSign_[component][axis] * upper;
+      }
+    }
+  }
+}
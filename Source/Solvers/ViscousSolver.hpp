@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "FlowField.hpp"
+#include "Parameters.hpp"
+
+#include "ParallelManagers/PetscParallelManager.hpp"
+#include "Stencils/MeshWeights.hpp"
+
+namespace Solvers {
+
+  /** Implicit part of the semi-implicit (IMEX) viscous treatment
+   *
+   * The FGH stencils compute the predictor F with explicit viscous terms at the timestep of the current stage. This
+   * solver turns it into a Crank-Nicolson predictor for the viscous terms by solving, per velocity component,
+   *
+   *   (I - theta * dt / Re * L) delta = F - u,   F = u + delta,
+   *
+   * with theta = 1/2. Convection and body forces stay explicit. The pressure gradient of the last projection
+   * is moved from the projection into F - u while solving (incremental form), otherwise theta dt / Re L grad(p)
+   * would remain in steady states and make them depend on the timestep. The predictor of the incremental
+   * projection includes this gradient already and is solved as it is.
+   *
+   * The increment delta vanishes on Dirichlet walls, is mirrored with opposite sign into tangential ghost cells,
+   * copied at Neumann boundaries and wrapped around periodic axes that are not split between processes. Velocity
+   * components on obstacle faces are kept at delta = 0. The diagonal dominance of the system fades with
+   * theta dt / (Re h^2), so Gauss-Seidel would need more sweeps than cells along an axis once the timestep exceeds
+   * the explicit viscous limit. Instead, each row is scaled by the dual cell volume of the velocity component, which
+   * makes the operator symmetric positive definite on stretched meshes as well, and the system is solved with
+   * Jacobi-preconditioned conjugate gradients, warm-started from the previous increment.
+   * Faces between subdomains are interior faces, the ghost layers of the search direction are exchanged before every
+   * operator application. The tolerance of the relative residual and the iteration limit are the timestep options
+   * imexTolerance and imexIterations.
+   */
+  class ViscousSolver {
+  private:
+    FlowField&                              flowField_;
+    const Parameters&                       parameters_;
+    ParallelManagers::PetscParallelManager& parallelManager_;
+
+    // Laplace coefficients, the same that are used by the explicit viscous terms
+    const Stencils::MeshWeights weights_;
+
+    VectorField delta_;     //! Increment of the predictor, per velocity component
+    VectorField direction_; //! Search direction of the conjugate gradients, with ghost layers
+    VectorField residual_;
+    VectorField product_;   //! Operator applied to the search direction
+
+    // Range of unknowns [first, last] per velocity component and axis, and the factor used to fill the ghost
+    // value before first and after last: 0 for a fixed wall, -1 for a tangential wall, 1 for Neumann. The ghost
+    // values at faces between subdomains are overwritten by the exchange.
+    int      first_[3][3];
+    int      last_[3][3];
+    RealType lowerSign_[3][3];
+    RealType upperSign_[3][3];
+
+    // Periodic axes within this process. The ghost values are taken from the opposite end of the range, which
+    // excludes the face on the lower boundary, as it is stored a second time on the upper one.
+    bool wrap_[3];
+
+    const RealType theta_;
+    const RealType tolerance_;
+    const int      maxIterations_;
+
+    static VectorField createField(const FlowField& flowField, const Parameters& parameters);
+
+    void setRange(int component, int axis, int size, BoundaryType lower, BoundaryType upper, int lowerNb, int upperNb);
+
+    // Calls function(i, j, k) for the unknowns of the velocity component, i.e., not on obstacle faces
+    template <typename Function>
+    void forEachUnknown(int component, Function function);
+
+    // Gradient of the current pressure at the location of the velocity component
+    RealType pressureGradient(int component, int i, int j, int k);
+
+    template <int Dim>
+    void solveComponent(int component, RealType coefficient);
+
+    // Dual cell volume that symmetrises the rows of the velocity at (i, j, k)
+    template <int Dim>
+    RealType getWeight(int i, int j, int k) const;
+
+    template <int Dim>
+    RealType getDiagonal(int i, int j, int k, RealType coefficient) const;
+
+    // output = W (I - coefficient L) input, updates the ghost layers of input
+    template <int Dim>
+    void applyOperator(int component, RealType coefficient, VectorField& input, VectorField& output);
+
+    template <int Dim>
+    void updateGhosts(int component, VectorField& field);
+
+  public:
+    ViscousSolver(FlowField& flowField, const Parameters& parameters, ParallelManagers::PetscParallelManager& parallelManager);
+    ~ViscousSolver() = default;
+
+    /** Replaces the explicit predictor in the FGH field by the Crank-Nicolson one for the current timestep */
+    void solve();
+  };
+
+} // namespace Solvers
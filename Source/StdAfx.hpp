@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <array>
 #include <assert.h>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cmath>
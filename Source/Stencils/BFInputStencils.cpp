@@ -45,38 +45,26 @@ Stencils::BFInputVelocityStencil::BFInputVelocityStencil(const Parameters& param
   ,
   stepSize_(parameters.bfStep.yRatio > 0.0 ? parameters.bfStep.yRatio * parameters.geometry.lengthY : 0.0) {
 
-  if (parameters_.geometry.dim == 2) {
-    RealType posY   = parameters_.meshsize->getPosY(0, 0);
-    RealType dy     = parameters_.meshsize->getDy(0, 0);
-    RealType nextDy = parameters_.meshsize->getDy(0, 1);
-
-    for (int j = 0; j < parameters_.geometry.sizeY - 1; ++j) {
-      posY   = parameters_.meshsize->getPosY(0, j);
-      dy     = parameters_.meshsize->getDy(0, j);
-      nextDy = parameters_.meshsize->getDy(0, j + 1);
-
-      // Check if stepSize is in this cell
-      if (posY + 0.5 * dy < stepSize_ && stepSize_ <= posY + dy + 0.5 * nextDy) {
-        stepSize_ = posY + dy;
-        break;
-      }
-    }
-  } else if (parameters_.geometry.dim == 3) {
-    RealType posY   = parameters_.meshsize->getPosY(0, 0, 0);
-    RealType dy     = parameters_.meshsize->getDy(0, 0, 0);
-    RealType nextDy = parameters_.meshsize->getDy(0, 1, 0);
-
-    for (int j = 0; j < parameters_.geometry.sizeY - 1; ++j) {
-      posY   = parameters_.meshsize->getPosY(0, j, 0);
-      dy     = parameters_.meshsize->getDy(0, j, 0);
-      nextDy = parameters_.meshsize->getDy(0, j + 1, 0);
-
-      if (posY + 0.5 * dy < stepSize_ && stepSize_ <= posY + dy + 0.5 * nextDy) {
-        stepSize_ = posY + dy;
-        break;
-      }
+  // The step is moved to the nearest cell face. The meshsize only covers the cells of this process, so every process
+  // searches its own cells and the face is taken from the one that contains it.
+  RealType face = MY_FLOAT_MAX;
+  for (int j = 0; j < parameters_.parallel.localSize[1] + 2; ++j) {
+    const RealType posY   = parameters_.meshsize->getPosY(0, j);
+    const RealType dy     = parameters_.meshsize->getDy(0, j);
+    const RealType nextDy = parameters_.meshsize->getDy(0, j + 1);
+
+    // Check if stepSize is in this cell
+    if (posY + 0.5 * dy < stepSize_ && stepSize_ <= posY + dy + 0.5 * nextDy) {
+      face = posY + dy;
+      break;
     }
   }
+
+  RealType globalFace = MY_FLOAT_MAX;
+  MPI_Allreduce(&face, &globalFace, 1, MY_MPI_FLOAT, MPI_MIN, PETSC_COMM_WORLD);
+  if (globalFace < MY_FLOAT_MAX) {
+    stepSize_ = globalFace;
+  }
 }
 
 void Stencils::BFInputVelocityStencil::applyLeftWall(FlowField& flowField, int i, int j) {
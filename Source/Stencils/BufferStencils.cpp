@@ -0,0 +1,197 @@
+#include "StdAfx.hpp"
+
+#include "BufferStencils.hpp"
+
+static VectorField& getVectorField(FlowField& flowField, Stencils::HaloQuantity quantity, VectorField* vector) {
+  if (quantity == Stencils::HaloVelocity) {
+    return flowField.getVelocity();
+  } else if (quantity == Stencils::HaloFGH) {
+    return flowField.getFGH();
+  }
+  return *vector;
+}
+
+Stencils::BufferFillStencil::BufferFillStencil(const Parameters& parameters):
+  BoundaryStencil<FlowField>(parameters),
+  quantity_(HaloPressure),
+  axis_(0),
+  vector_(nullptr) {}
+
+void Stencils::BufferFillStencil::setUp(HaloQuantity quantity, int axis, VectorField* vector) {
+  quantity_ = quantity;
+  axis_     = axis;
+  vector_   = vector;
+  buffers_[2 * axis].clear();
+  buffers_[2 * axis + 1].clear();
+}
+
+const std::vector<RealType>& Stencils::BufferFillStencil::getBuffer(int face) const { return buffers_[face]; }
+
+void Stencils::BufferFillStencil::fill(FlowField& flowField, int face, int i, int j, int k) {
+  std::vector<RealType>& buffer = buffers_[face];
+  if (quantity_ == HaloPressure) {
+    buffer.push_back(flowField.getPressure().getScalar(i, j, k));
+  } else {
+    const RealType* values = getVectorField(flowField, quantity_, vector_).getVector(i, j, k);
+    buffer.insert(buffer.end(), values, values + parameters_.geometry.dim);
+  }
+}
+
+void Stencils::BufferFillStencil::applyLeftWall(FlowField& flowField, [[maybe_unused]] int i, int j) {
+  if (axis_ == 0) {
+    fill(flowField, 0, 2, j);
+  }
+}
+
+void Stencils::BufferFillStencil::applyRightWall(FlowField& flowField, [[maybe_unused]] int i, int j) {
+  if (axis_ == 0) {
+    fill(flowField, 1, flowField.getNx(), j);
+    fill(flowField, 1, flowField.getNx() + 1, j);
+  }
+}
+
+void Stencils::BufferFillStencil::applyBottomWall(FlowField& flowField, int i, [[maybe_unused]] int j) {
+  if (axis_ == 1) {
+    fill(flowField, 2, i, 2);
+  }
+}
+
+void Stencils::BufferFillStencil::applyTopWall(FlowField& flowField, int i, [[maybe_unused]] int j) {
+  if (axis_ == 1) {
+    fill(flowField, 3, i, flowField.getNy());
+    fill(flowField, 3, i, flowField.getNy() + 1);
+  }
+}
+
+void Stencils::BufferFillStencil::applyLeftWall(FlowField& flowField, [[maybe_unused]] int i, int j, int k) {
+  if (axis_ == 0) {
+    fill(flowField, 0, 2, j, k);
+  }
+}
+
+void Stencils::BufferFillStencil::applyRightWall(FlowField& flowField, [[maybe_unused]] int i, int j, int k) {
+  if (axis_ == 0) {
+    fill(flowField, 1, flowField.getNx(), j, k);
+    fill(flowField, 1, flowField.getNx() + 1, j, k);
+  }
+}
+
+void Stencils::BufferFillStencil::applyBottomWall(FlowField& flowField, int i, [[maybe_unused]] int j, int k) {
+  if (axis_ == 1) {
+    fill(flowField, 2, i, 2, k);
+  }
+}
+
+void Stencils::BufferFillStencil::applyTopWall(FlowField& flowField, int i, [[maybe_unused]] int j, int k) {
+  if (axis_ == 1) {
+    fill(flowField, 3, i, flowField.getNy(), k);
+    fill(flowField, 3, i, flowField.getNy() + 1, k);
+  }
+}
+
+void Stencils::BufferFillStencil::applyFrontWall(FlowField& flowField, int i, int j, [[maybe_unused]] int k) {
+  if (axis_ == 2) {
+    fill(flowField, 4, i, j, 2);
+  }
+}
+
+void Stencils::BufferFillStencil::applyBackWall(FlowField& flowField, int i, int j, [[maybe_unused]] int k) {
+  if (axis_ == 2) {
+    fill(flowField, 5, i, j, flowField.getNz());
+    fill(flowField, 5, i, j, flowField.getNz() + 1);
+  }
+}
+
+Stencils::BufferReadStencil::BufferReadStencil(const Parameters& parameters):
+  BoundaryStencil<FlowField>(parameters),
+  quantity_(HaloPressure),
+  axis_(0),
+  vector_(nullptr),
+  positions_{} {}
+
+void Stencils::BufferReadStencil::setUp(HaloQuantity quantity, int axis, VectorField* vector) {
+  quantity_                = quantity;
+  axis_                    = axis;
+  vector_                  = vector;
+  positions_[2 * axis]     = 0;
+  positions_[2 * axis + 1] = 0;
+}
+
+std::vector<RealType>& Stencils::BufferReadStencil::getBuffer(int face) { return buffers_[face]; }
+
+void Stencils::BufferReadStencil::read(FlowField& flowField, int face, int i, int j, int k) {
+  const RealType* values = buffers_[face].data() + positions_[face];
+  if (quantity_ == HaloPressure) {
+    flowField.getPressure().getScalar(i, j, k) = values[0];
+    positions_[face]++;
+  } else {
+    RealType* target = getVectorField(flowField, quantity_, vector_).getVector(i, j, k);
+    std::copy(values, values + parameters_.geometry.dim, target);
+    positions_[face] += parameters_.geometry.dim;
+  }
+}
+
+void Stencils::BufferReadStencil::applyLeftWall(FlowField& flowField, [[maybe_unused]] int i, int j) {
+  if (axis_ == 0) {
+    read(flowField, 0, 0, j);
+    read(flowField, 0, 1, j);
+  }
+}
+
+void Stencils::BufferReadStencil::applyRightWall(FlowField& flowField, [[maybe_unused]] int i, int j) {
+  if (axis_ == 0) {
+    read(flowField, 1, flowField.getNx() + 2, j);
+  }
+}
+
+void Stencils::BufferReadStencil::applyBottomWall(FlowField& flowField, int i, [[maybe_unused]] int j) {
+  if (axis_ == 1) {
+    read(flowField, 2, i, 0);
+    read(flowField, 2, i, 1);
+  }
+}
+
+void Stencils::BufferReadStencil::applyTopWall(FlowField& flowField, int i, [[maybe_unused]] int j) {
+  if (axis_ == 1) {
+    read(flowField, 3, i, flowField.getNy() + 2);
+  }
+}
+
+void Stencils::BufferReadStencil::applyLeftWall(FlowField& flowField, [[maybe_unused]] int i, int j, int k) {
+  if (axis_ == 0) {
+    read(flowField, 0, 0, j, k);
+    read(flowField, 0, 1, j, k);
+  }
+}
+
+void Stencils::BufferReadStencil::applyRightWall(FlowField& flowField, [[maybe_unused]] int i, int j, int k) {
+  if (axis_ == 0) {
+    read(flowField, 1, flowField.getNx() + 2, j, k);
+  }
+}
+
+void Stencils::BufferReadStencil::applyBottomWall(FlowField& flowField, int i, [[maybe_unused]] int j, int k) {
+  if (axis_ == 1) {
+    read(flowField, 2, i, 0, k);
+    read(flowField, 2, i, 1, k);
+  }
+}
+
+void Stencils::BufferReadStencil::applyTopWall(FlowField& flowField, int i, [[maybe_unused]] int j, int k) {
+  if (axis_ == 1) {
+    read(flowField, 3, i, flowField.getNy() + 2, k);
+  }
+}
+
+void Stencils::BufferReadStencil::applyFrontWall(FlowField& flowField, int i, int j, [[maybe_unused]] int k) {
+  if (axis_ == 2) {
+    read(flowField, 4, i, j, 0);
+    read(flowField, 4, i, j, 1);
+  }
+}
+
+void Stencils::BufferReadStencil::applyBackWall(FlowField& flowField, int i, int j, [[maybe_unused]] int k) {
+  if (axis_ == 2) {
+    read(flowField, 5, i, j, flowField.getNz() + 2);
+  }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "BoundaryStencil.hpp"
+#include "FlowField.hpp"
+#include "Parameters.hpp"
+
+namespace Stencils {
+
+  /** Quantities that are exchanged between neighbouring subdomains, HaloVector is a vector field outside the flow field */
+  enum HaloQuantity { HaloPressure, HaloVelocity, HaloFGH, HaloVector };
+
+  /** Copies the layers next to the subdomain boundaries into one contiguous buffer per face
+   *
+   * The lower neighbour receives the first inner layer, the upper neighbour the last two, which become its ghost
+   * layers. The buffers cover the whole face including the ghost cells, so that exchanging one axis after the other
+   * also fills the edges and corners. Only the faces of the selected axis are packed, see setUp().
+   * Faces are numbered left, right, bottom, top, front, back.
+   */
+  class BufferFillStencil: public BoundaryStencil<FlowField> {
+  private:
+    HaloQuantity quantity_;
+    int          axis_;
+    VectorField* vector_;
+
+    std::vector<RealType> buffers_[6];
+
+    void fill(FlowField& flowField, int face, int i, int j, int k = 0);
+
+  public:
+    BufferFillStencil(const Parameters& parameters);
+    ~BufferFillStencil() override = default;
+
+    /** Selects the quantity and axis and empties the buffers of that axis, vector is packed for HaloVector */
+    void setUp(HaloQuantity quantity, int axis, VectorField* vector = nullptr);
+
+    const std::vector<RealType>& getBuffer(int face) const;
+
+    void applyLeftWall(FlowField& flowField, int i, int j) override;
+    void applyRightWall(FlowField& flowField, int i, int j) override;
+    void applyBottomWall(FlowField& flowField, int i, int j) override;
+    void applyTopWall(FlowField& flowField, int i, int j) override;
+
+    void applyLeftWall(FlowField& flowField, int i, int j, int k) override;
+    void applyRightWall(FlowField& flowField, int i, int j, int k) override;
+    void applyBottomWall(FlowField& flowField, int i, int j, int k) override;
+    void applyTopWall(FlowField& flowField, int i, int j, int k) override;
+    void applyFrontWall(FlowField& flowField, int i, int j, int k) override;
+    void applyBackWall(FlowField& flowField, int i, int j, int k) override;
+  };
+
+  /** Writes the buffers received from the neighbours into the ghost layers, the counterpart of BufferFillStencil
+   *
+   * Two layers are read from the lower neighbour and one from the upper neighbour, in the order they were packed.
+   */
+  class BufferReadStencil: public BoundaryStencil<FlowField> {
+  private:
+    HaloQuantity quantity_;
+    int          axis_;
+    VectorField* vector_;
+
+    std::vector<RealType> buffers_[6];
+    std::size_t           positions_[6];
+
+    void read(FlowField& flowField, int face, int i, int j, int k = 0);
+
+  public:
+    BufferReadStencil(const Parameters& parameters);
+    ~BufferReadStencil() override = default;
+
+    /** Selects the quantity and axis and rewinds the buffers of that axis, vector is written for HaloVector */
+    void setUp(HaloQuantity quantity, int axis, VectorField* vector = nullptr);
+
+    /** Buffer to receive into, resized by the caller */
+    std::vector<RealType>& getBuffer(int face);
+
+    void applyLeftWall(FlowField& flowField, int i, int j) override;
+    void applyRightWall(FlowField& flowField, int i, int j) override;
+    void applyBottomWall(FlowField& flowField, int i, int j) override;
+    void applyTopWall(FlowField& flowField, int i, int j) override;
+
+    void applyLeftWall(FlowField& flowField, int i, int j, int k) override;
+    void applyRightWall(FlowField& flowField, int i, int j, int k) override;
+    void applyBottomWall(FlowField& flowField, int i, int j, int k) override;
+    void applyTopWall(FlowField& flowField, int i, int j, int k) override;
+    void applyFrontWall(FlowField& flowField, int i, int j, int k) override;
+    void applyBackWall(FlowField& flowField, int i, int j, int k) override;
+  };
+
+} // namespace Stencils
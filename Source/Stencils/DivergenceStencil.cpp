@@ -0,0 +1,37 @@
+#include "StdAfx.hpp"
+
+#include "DivergenceStencil.hpp"
+
+Stencils::DivergenceStencil::DivergenceStencil(const Parameters& parameters):
+  FieldStencil<FlowField>(parameters) {
+
+  reset();
+}
+
+void Stencils::DivergenceStencil::apply(FlowField& flowField, int i, int j) {
+  if ((flowField.getFlags().getValue(i, j) & OBSTACLE_SELF) != 0) {
+    return;
+  }
+  VectorField&   velocity   = flowField.getVelocity();
+  const RealType divergence = (velocity.getVector(i, j)[0] - velocity.getVector(i - 1, j)[0]) / parameters_.meshsize->getDx(i, j)
+                              + (velocity.getVector(i, j)[1] - velocity.getVector(i, j - 1)[1]) / parameters_.meshsize->getDy(i, j);
+  sum_ += divergence * divergence;
+  cells_ += 1.0;
+}
+
+void Stencils::DivergenceStencil::apply(FlowField& flowField, int i, int j, int k) {
+  if ((flowField.getFlags().getValue(i, j, k) & OBSTACLE_SELF) != 0) {
+    return;
+  }
+  VectorField&   velocity   = flowField.getVelocity();
+  const RealType divergence = (velocity.getVector(i, j, k)[0] - velocity.getVector(i - 1, j, k)[0]) / parameters_.meshsize->getDx(i, j, k)
+                              + (velocity.getVector(i, j, k)[1] - velocity.getVector(i, j - 1, k)[1]) / parameters_.meshsize->getDy(i, j, k)
+                              + (velocity.getVector(i, j, k)[2] - velocity.getVector(i, j, k - 1)[2]) / parameters_.meshsize->getDz(i, j, k);
+  sum_ += divergence * divergence;
+  cells_ += 1.0;
+}
+
+void Stencils::DivergenceStencil::reset() {
+  sum_   = 0.0;
+  cells_ = 0.0;
+}
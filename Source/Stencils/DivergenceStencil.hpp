@@ -0,0 +1,33 @@
+#pragma once
+
+#include "FieldStencil.hpp"
+#include "FlowField.hpp"
+#include "Parameters.hpp"
+
+namespace Stencils {
+
+  /** Accumulates the squared divergence of the velocity over the fluid cells.
+   *
+   * Applied after the projection, this measures the divergence error that the pressure solve left. The sum is
+   * local, the caller reduces it over all processes.
+   */
+  class DivergenceStencil: public FieldStencil<FlowField> {
+  private:
+    RealType sum_;   //! Sum of the squared divergence
+    RealType cells_; //! Number of fluid cells in the sum
+
+  public:
+    DivergenceStencil(const Parameters& parameters);
+    ~DivergenceStencil() override = default;
+
+    void apply(FlowField& flowField, int i, int j) override;
+    void apply(FlowField& flowField, int i, int j, int k) override;
+
+    /** Resets the sum before the next sweep */
+    void reset();
+
+    RealType getSum() const { return sum_; }
+    RealType getCells() const { return cells_; }
+  };
+
+} // namespace Stencils
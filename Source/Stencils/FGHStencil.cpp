@@ -3,24 +3,133 @@
 #include "FGHStencil.hpp"
 
 #include "Definitions.hpp"
-#include "StencilFunctions.hpp"
 
 Stencils::FGHStencil::FGHStencil(const Parameters& parameters):
-  FieldStencil<FlowField>(parameters) {}
+  FieldStencil<FlowField>(parameters),
+  weights_(parameters) {
+  const bool bodyForce = parameters.environment.gx != 0.0 || parameters.environment.gy != 0.0
+                         || (parameters.geometry.dim == 3 && parameters.environment.gz != 0.0);
+  const bool history     = parameters.timestep.scheme != ForwardEuler;
+  const bool imex        = parameters.timestep.imex;
+  const bool incremental = parameters.solver.incremental != 0;
 
-void Stencils::FGHStencil::apply(FlowField& flowField, int i, int j) {
+  switch (getConvectionScheme(parameters)) {
+  case ConvectionScheme::Central:
+    selectKernels<ConvectionScheme::Central>(bodyForce, history, imex, incremental);
+    break;
+  case ConvectionScheme::DonorCell:
+    selectKernels<ConvectionScheme::DonorCell>(bodyForce, history, imex, incremental);
+    break;
+  default:
+    selectKernels<ConvectionScheme::Blended>(bodyForce, history, imex, incremental);
+    break;
+  }
+}
+
+template <Stencils::ConvectionScheme Scheme>
+void Stencils::FGHStencil::selectKernels(bool bodyForce, bool history, bool imex, bool incremental) {
+  if (bodyForce) {
+    selectTimeIntegration<Scheme, true>(history, imex, incremental);
+  } else {
+    selectTimeIntegration<Scheme, false>(history, imex, incremental);
+  }
+}
+
+template <Stencils::ConvectionScheme Scheme, bool BodyForce>
+void Stencils::FGHStencil::selectTimeIntegration(bool history, bool imex, bool incremental) {
+  if (history && imex) {
+    selectProjection<Scheme, BodyForce, true, true>(incremental);
+  } else if (history) {
+    selectProjection<Scheme, BodyForce, true, false>(incremental);
+  } else {
+    selectProjection<Scheme, BodyForce, false, false>(incremental);
+  }
+}
+
+template <Stencils::ConvectionScheme Scheme, bool BodyForce, bool History, bool Imex>
+void Stencils::FGHStencil::selectProjection(bool incremental) {
+  if (incremental) {
+    kernel2D_ = &FGHStencil::applyKernel<Scheme, BodyForce, History, Imex, true>;
+    kernel3D_ = &FGHStencil::applyKernel<Scheme, BodyForce, History, Imex, true>;
+  } else {
+    kernel2D_ = &FGHStencil::applyKernel<Scheme, BodyForce, History, Imex, false>;
+    kernel3D_ = &FGHStencil::applyKernel<Scheme, BodyForce, History, Imex, false>;
+  }
+}
+
+void Stencils::FGHStencil::setStageCoefficients(const StageCoefficients& stage) { stage_ = stage; }
+
+void Stencils::FGHStencil::apply(FlowField& flowField, int i, int j) { (this->*kernel2D_)(flowField, i, j); }
+
+void Stencils::FGHStencil::apply(FlowField& flowField, int i, int j, int k) {
+  (this->*kernel3D_)(flowField, i, j, k);
+}
+
+template <Stencils::ConvectionScheme Scheme, bool BodyForce, bool History, bool Imex, bool Incremental>
+void Stencils::FGHStencil::applyKernel(FlowField& flowField, int i, int j) {
   // Load local velocities into the center layer of the local array
   loadLocalVelocity2D(flowField, localVelocity_, i, j);
-  loadLocalMeshsize2D(parameters_, localMeshsize_, i, j);
+
+  const AxisWeights& wx = weights_.getX(i);
+  const AxisWeights& wy = weights_.getY(j);
 
   RealType* const values = flowField.getFGH().getVector(i, j);
 
   // Now the localVelocity array should contain lexicographically ordered elements around the given index
-  values[0] = computeF2D(localVelocity_, localMeshsize_, parameters_, parameters_.timestep.dt);
-  values[1] = computeG2D(localVelocity_, localMeshsize_, parameters_, parameters_.timestep.dt);
+  if constexpr (History) {
+    RealType* const history = flowField.getHistory().getVector(i, j);
+
+    if constexpr (Imex) {
+      values[0] = advanceStage(
+                    localVelocity_[mapd(0, 0, 0, 0)],
+                    computeConvectionF2D<Scheme, BodyForce>(localVelocity_, wx, wy, parameters_),
+                    history[0],
+                    values[0]
+                  )
+                  + stage_.viscousWeight * computeViscousF2D(localVelocity_, wx, wy, parameters_);
+      values[1] = advanceStage(
+                    localVelocity_[mapd(0, 0, 0, 1)],
+                    computeConvectionG2D<Scheme, BodyForce>(localVelocity_, wx, wy, parameters_),
+                    history[1],
+                    values[1]
+                  )
+                  + stage_.viscousWeight * computeViscousG2D(localVelocity_, wx, wy, parameters_);
+    } else {
+      values[0] = advanceStage(
+        localVelocity_[mapd(0, 0, 0, 0)],
+        computeTendencyF2D<Scheme, BodyForce>(localVelocity_, wx, wy, parameters_),
+        history[0],
+        values[0]
+      );
+      values[1] = advanceStage(
+        localVelocity_[mapd(0, 0, 0, 1)],
+        computeTendencyG2D<Scheme, BodyForce>(localVelocity_, wx, wy, parameters_),
+        history[1],
+        values[1]
+      );
+    }
+  } else {
+    values[0] = computeF2D<Scheme, BodyForce>(localVelocity_, wx, wy, parameters_, parameters_.timestep.dt);
+    values[1] = computeG2D<Scheme, BodyForce>(localVelocity_, wx, wy, parameters_, parameters_.timestep.dt);
+  }
+
+  if constexpr (Incremental) {
+    const int obstacle = flowField.getFlags().getValue(i, j);
+    if ((obstacle & OBSTACLE_SELF) == 0) {
+      ScalarField&   pressure = flowField.getPressure();
+      const RealType dt       = parameters_.timestep.dt;
+      if ((obstacle & OBSTACLE_RIGHT) == 0) {
+        values[0] -= dt * wx.inverseCentreDistance * (pressure.getScalar(i + 1, j) - pressure.getScalar(i, j));
+      }
+      if ((obstacle & OBSTACLE_TOP) == 0) {
+        values[1] -= dt * wy.inverseCentreDistance * (pressure.getScalar(i, j + 1) - pressure.getScalar(i, j));
+      }
+    }
+  }
 }
 
-void Stencils::FGHStencil::apply(FlowField& flowField, int i, int j, int k) {
+template <Stencils::ConvectionScheme Scheme, bool BodyForce, bool History, bool Imex, bool Incremental>
+void Stencils::FGHStencil::applyKernel(FlowField& flowField, int i, int j, int k) {
   // The same as in 2D, with slight modifications.
 
   const int       obstacle = flowField.getFlags().getValue(i, j, k);
@@ -28,16 +137,99 @@ void Stencils::FGHStencil::apply(FlowField& flowField, int i, int j, int k) {
 
   if ((obstacle & OBSTACLE_SELF) == 0) { // If the cell is fluid
     loadLocalVelocity3D(flowField, localVelocity_, i, j, k);
-    loadLocalMeshsize3D(parameters_, localMeshsize_, i, j, k);
 
-    if ((obstacle & OBSTACLE_RIGHT) == 0) { // If the right cell is fluid
-      values[0] = computeF3D(localVelocity_, localMeshsize_, parameters_, parameters_.timestep.dt);
-    }
-    if ((obstacle & OBSTACLE_TOP) == 0) {
-      values[1] = computeG3D(localVelocity_, localMeshsize_, parameters_, parameters_.timestep.dt);
+    const AxisWeights& wx = weights_.getX(i);
+    const AxisWeights& wy = weights_.getY(j);
+    const AxisWeights& wz = weights_.getZ(k);
+
+    if constexpr (History) {
+      RealType* const history = flowField.getHistory().getVector(i, j, k);
+
+      if constexpr (Imex) {
+        if ((obstacle & OBSTACLE_RIGHT) == 0) { // If the right cell is fluid
+          values[0] = advanceStage(
+                        localVelocity_[mapd(0, 0, 0, 0)],
+                        computeConvectionF3D<Scheme, BodyForce>(localVelocity_, wx, wy, wz, parameters_),
+                        history[0],
+                        values[0]
+                      )
+                      + stage_.viscousWeight * computeViscousF3D(localVelocity_, wx, wy, wz, parameters_);
+        }
+        if ((obstacle & OBSTACLE_TOP) == 0) {
+          values[1] = advanceStage(
+                        localVelocity_[mapd(0, 0, 0, 1)],
+                        computeConvectionG3D<Scheme, BodyForce>(localVelocity_, wx, wy, wz, parameters_),
+                        history[1],
+                        values[1]
+                      )
+                      + stage_.viscousWeight * computeViscousG3D(localVelocity_, wx, wy, wz, parameters_);
+        }
+        if ((obstacle & OBSTACLE_BACK) == 0) {
+          values[2] = advanceStage(
+                        localVelocity_[mapd(0, 0, 0, 2)],
+                        computeConvectionH3D<Scheme, BodyForce>(localVelocity_, wx, wy, wz, parameters_),
+                        history[2],
+                        values[2]
+                      )
+                      + stage_.viscousWeight * computeViscousH3D(localVelocity_, wx, wy, wz, parameters_);
+        }
+      } else {
+        if ((obstacle & OBSTACLE_RIGHT) == 0) { // If the right cell is fluid
+          values[0] = advanceStage(
+            localVelocity_[mapd(0, 0, 0, 0)],
+            computeTendencyF3D<Scheme, BodyForce>(localVelocity_, wx, wy, wz, parameters_),
+            history[0],
+            values[0]
+          );
+        }
+        if ((obstacle & OBSTACLE_TOP) == 0) {
+          values[1] = advanceStage(
+            localVelocity_[mapd(0, 0, 0, 1)],
+            computeTendencyG3D<Scheme, BodyForce>(localVelocity_, wx, wy, wz, parameters_),
+            history[1],
+            values[1]
+          );
+        }
+        if ((obstacle & OBSTACLE_BACK) == 0) {
+          values[2] = advanceStage(
+            localVelocity_[mapd(0, 0, 0, 2)],
+            computeTendencyH3D<Scheme, BodyForce>(localVelocity_, wx, wy, wz, parameters_),
+            history[2],
+            values[2]
+          );
+        }
+      }
+    } else {
+      if ((obstacle & OBSTACLE_RIGHT) == 0) { // If the right cell is fluid
+        values[0] = computeF3D<Scheme, BodyForce>(
+          localVelocity_, wx, wy, wz, parameters_, parameters_.timestep.dt
+        );
+      }
+      if ((obstacle & OBSTACLE_TOP) == 0) {
+        values[1] = computeG3D<Scheme, BodyForce>(
+          localVelocity_, wx, wy, wz, parameters_, parameters_.timestep.dt
+        );
+      }
+      if ((obstacle & OBSTACLE_BACK) == 0) {
+        values[2] = computeH3D<Scheme, BodyForce>(
+          localVelocity_, wx, wy, wz, parameters_, parameters_.timestep.dt
+        );
+      }
     }
-    if ((obstacle & OBSTACLE_BACK) == 0) {
-      values[2] = computeH3D(localVelocity_, localMeshsize_, parameters_, parameters_.timestep.dt);
+
+    if constexpr (Incremental) {
+      ScalarField&   pressure = flowField.getPressure();
+      const RealType dt       = parameters_.timestep.dt;
+      const RealType centre   = pressure.getScalar(i, j, k);
+      if ((obstacle & OBSTACLE_RIGHT) == 0) {
+        values[0] -= dt * wx.inverseCentreDistance * (pressure.getScalar(i + 1, j, k) - centre);
+      }
+      if ((obstacle & OBSTACLE_TOP) == 0) {
+        values[1] -= dt * wy.inverseCentreDistance * (pressure.getScalar(i, j + 1, k) - centre);
+      }
+      if ((obstacle & OBSTACLE_BACK) == 0) {
+        values[2] -= dt * wz.inverseCentreDistance * (pressure.getScalar(i, j, k + 1) - centre);
+      }
     }
   }
 }
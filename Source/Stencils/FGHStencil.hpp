@@ -2,21 +2,81 @@
 
 #include "FieldStencil.hpp"
 #include "FlowField.hpp"
+#include "MeshWeights.hpp"
 #include "Parameters.hpp"
+#include "StencilFunctions.hpp"
 
 namespace Stencils {
 
+  /** Coefficients of one stage of the explicit time integration
+   *
+   * With the momentum tendency R and the history register Q of the flow field, a stage first adds the
+   * pressure correction of the previous stage, Q* = Q + projectionWeight * (u - F), then computes
+   * F = u + rhsWeight * R + historyWeight * Q* and updates Q = historyDecay * Q* + historyGain * R.
+   * In IMEX mode, R is the convective tendency N only and the viscous tendency V at u is added explicitly,
+   * F = u + rhsWeight * N + historyWeight * Q* + viscousWeight * V, which the ViscousSolver then completes to
+   * Crank-Nicolson with viscousWeight as the timestep of the stage.
+   */
+  struct StageCoefficients {
+    RealType rhsWeight        = 0;
+    RealType historyWeight    = 0;
+    RealType historyDecay     = 0;
+    RealType historyGain      = 0;
+    RealType projectionWeight = 0;
+    RealType viscousWeight    = 0;
+  };
+
   class FGHStencil: public FieldStencil<FlowField> {
   private:
     // A local velocity variable that will be used to approximate derivatives. Size matches 3D
     // case, but can be used for 2D as well.
     RealType localVelocity_[27 * 3];
-    RealType localMeshsize_[27 * 3];
+
+    // Interpolation weights and inverse spacings per axis, looked up instead of gathering local meshsizes
+    const MeshWeights weights_;
+
+    // Coefficients of the current stage, only used by the multi-step/multi-stage kernels
+    StageCoefficients stage_;
+
+    // Kernels specialised for the convection scheme, body force, time integration and projection of this run. They
+    // are selected once in the constructor, so that the per-cell work does not evaluate unused difference forms,
+    // add zero gravity, touch the history register for forward Euler or read the pressure for the full projection.
+    // Imex is only used with History, forward Euler already computes the predictor that the ViscousSolver expects.
+    void (FGHStencil::*kernel2D_)(FlowField& flowField, int i, int j);
+    void (FGHStencil::*kernel3D_)(FlowField& flowField, int i, int j, int k);
+
+    // With Incremental, the predictor includes the gradient of the current pressure, so that the projection only
+    // solves for its change. The faces are the ones that the VelocityStencil corrects.
+    template <ConvectionScheme Scheme, bool BodyForce, bool History, bool Imex, bool Incremental>
+    void applyKernel(FlowField& flowField, int i, int j);
+    template <ConvectionScheme Scheme, bool BodyForce, bool History, bool Imex, bool Incremental>
+    void applyKernel(FlowField& flowField, int i, int j, int k);
+
+    template <ConvectionScheme Scheme>
+    void selectKernels(bool bodyForce, bool history, bool imex, bool incremental);
+    template <ConvectionScheme Scheme, bool BodyForce>
+    void selectTimeIntegration(bool history, bool imex, bool incremental);
+    template <ConvectionScheme Scheme, bool BodyForce, bool History, bool Imex>
+    void selectProjection(bool incremental);
+
+    // Combines velocity, tendency and history into the new predictor and advances the history register.
+    // predictor is the value of F from the previous stage, which is still stored in the flow field.
+    inline RealType advanceStage(RealType velocity, RealType tendency, RealType& history, RealType predictor) const {
+      const RealType accumulated = history + stage_.projectionWeight * (velocity - predictor);
+      history                    = stage_.historyDecay * accumulated + stage_.historyGain * tendency;
+      return velocity + stage_.rhsWeight * tendency + stage_.historyWeight * accumulated;
+    }
 
   public:
     FGHStencil(const Parameters& parameters);
     ~FGHStencil() override = default;
 
+    /** Sets the coefficients used by the next sweep
+     *
+     * Ignored for forward Euler, where F = u + dt * R with the current timestep.
+     */
+    void setStageCoefficients(const StageCoefficients& stage);
+
     void apply(FlowField& flowField, int i, int j) override;
     void apply(FlowField& flowField, int i, int j, int k) override;
   };
@@ -0,0 +1,25 @@
+#include "StdAfx.hpp"
+
+#include "MeshWeights.hpp"
+
+Stencils::MeshWeights::MeshWeights(const Parameters& parameters) {
+  const Meshsize& meshsize = *parameters.meshsize;
+
+  // Cells 0 to localSize + 2 are stored, which covers the ghost layers of the flow field
+  x_.resize(parameters.parallel.localSize[0] + 3);
+  for (int i = 0; i < static_cast<int>(x_.size()); i++) {
+    x_[i] = computeAxisWeights(meshsize.getDx(i - 1, 2, 2), meshsize.getDx(i, 2, 2), meshsize.getDx(i + 1, 2, 2));
+  }
+
+  y_.resize(parameters.parallel.localSize[1] + 3);
+  for (int j = 0; j < static_cast<int>(y_.size()); j++) {
+    y_[j] = computeAxisWeights(meshsize.getDy(2, j - 1, 2), meshsize.getDy(2, j, 2), meshsize.getDy(2, j + 1, 2));
+  }
+
+  if (parameters.geometry.dim == 3) {
+    z_.resize(parameters.parallel.localSize[2] + 3);
+    for (int k = 0; k < static_cast<int>(z_.size()); k++) {
+      z_[k] = computeAxisWeights(meshsize.getDz(2, 2, k - 1), meshsize.getDz(2, 2, k), meshsize.getDz(2, 2, k + 1));
+    }
+  }
+}
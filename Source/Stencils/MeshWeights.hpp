@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Definitions.hpp"
+#include "Parameters.hpp"
+
+namespace Stencils {
+
+  /** Mesh-dependent coefficients along one axis around the cell n. A quantity f is interpolated to the face n-1/2 as
+   * lower[0] * f(n-1) + upper[0] * f(n) and to the face n+1/2 as lower[1] * f(n) + upper[1] * f(n+1). The second
+   * derivative of a quantity stored along the axis is laplace[0] * f(n-1) + laplace[1] * f(n) + laplace[2] * f(n+1).
+   */
+  struct AxisWeights {
+    RealType lower[2];
+    RealType upper[2];
+    RealType inverseSpacing;        //! 1 / h(n)
+    RealType inverseCentreDistance; //! 1 / distance between the centres of the cells n and n+1
+    RealType laplace[3];
+  };
+
+  // Computes the weights of cell n from the meshsizes of the cells n-1, n and n+1.
+  inline AxisWeights computeAxisWeights(RealType hM1, RealType h0, RealType hP1) {
+    AxisWeights weights;
+    weights.lower[0]              = h0 / (hM1 + h0);
+    weights.upper[0]              = hM1 / (hM1 + h0);
+    weights.lower[1]              = hP1 / (h0 + hP1);
+    weights.upper[1]              = h0 / (h0 + hP1);
+    weights.inverseSpacing        = 1.0 / h0;
+    weights.inverseCentreDistance = 2.0 / (h0 + hP1);
+    weights.laplace[0]            = 2.0 / (h0 * (h0 + hP1));
+    weights.laplace[1]            = -2.0 / (h0 * hP1);
+    weights.laplace[2]            = 2.0 / (hP1 * (h0 + hP1));
+    return weights;
+  }
+
+  /** Tables of AxisWeights for every local cell index (ghost layers included) of each axis. The weights only depend
+   * on the 1D index, so they are computed once from the meshsize and looked up by the FGH kernels afterwards.
+   */
+  class MeshWeights {
+  private:
+    std::vector<AxisWeights> x_;
+    std::vector<AxisWeights> y_;
+    std::vector<AxisWeights> z_;
+
+  public:
+    MeshWeights(const Parameters& parameters);
+    ~MeshWeights() = default;
+
+    inline const AxisWeights& getX(int i) const { return x_[i]; }
+    inline const AxisWeights& getY(int j) const { return y_[j]; }
+    inline const AxisWeights& getZ(int k) const { return z_[k]; }
+  };
+
+} // namespace Stencils
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Definitions.hpp"
+#include "MeshWeights.hpp"
 #include "Parameters.hpp"
 
 namespace Stencils {
@@ -62,6 +63,34 @@ namespace Stencils {
   // Maps an index and a component to the corresponding value in the cube.
   inline int mapd(int i, int j, int k, int component) { return 39 + 27 * k + 9 * j + 3 * i + component; }
 
+  // Discretisation of the convective terms. Blended mixes central and donor-cell differences with
+  // parameters.solver.gamma; Central (gamma = 0) and DonorCell (gamma = 1) are its limits and only evaluate the
+  // difference they need.
+  enum class ConvectionScheme { Central, DonorCell, Blended };
+
+  // Selects the convection scheme matching the configured gamma.
+  inline ConvectionScheme getConvectionScheme(const Parameters& parameters) {
+    if (parameters.solver.gamma == 0.0) {
+      return ConvectionScheme::Central;
+    }
+    if (parameters.solver.gamma == 1.0) {
+      return ConvectionScheme::DonorCell;
+    }
+    return ConvectionScheme::Blended;
+  }
+
+  // Returns the linear combination of central and donor-cell difference.
+  template <ConvectionScheme Scheme>
+  inline RealType blendConvection(const Parameters& parameters, RealType secondOrder, RealType firstOrder) {
+    if constexpr (Scheme == ConvectionScheme::Central) {
+      return secondOrder;
+    } else if constexpr (Scheme == ConvectionScheme::DonorCell) {
+      return firstOrder;
+    } else {
+      return (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    }
+  }
+
   // Derivative functions. They are applied to a cube of 3x3x3 cells. lv stands for the local velocity, lm represents
   // the local mesh sizes dudx <-> first derivative of u-component of velocity field w.r.t. x-direction.
   inline RealType dudx(const RealType* const lv, const RealType* const lm) {
@@ -83,128 +112,70 @@ namespace Stencils {
     return (lv[index0] - lv[index1]) / lm[index0];
   }
 
-    // TODO WS1: Second derivatives
-
-  // Second derivatives of u, v, and w components
-  inline RealType d2udx2(const RealType* const lv, const RealType* const lm) {
-    // Evaluate d2udx2 in the cell center by a central difference
-    const int index_u0 = mapd(0, 0, 0, 0); // u at center
-    const int index_u1 = mapd(-1, 0, 0, 0); // u at left
-    const int index_u2 = mapd(1, 0, 0, 0);  // u at right
-
-    const int index_x0 = mapd(0, 0, 0, 0); // x at center
-    const int index_x1 = mapd(-1, 0, 0, 0); // x at left
-    const int index_x2 = mapd(1, 0, 0, 0);  // x at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))
-    -(lv[index_u0])/(lm[index_x0] * lm[index_x2])
-    +(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index00] * lm[index00]);
-  }
-
-  inline RealType d2vdx2(const RealType* const lv, const RealType* const lm) {
-    // Evaluate d2vdx2 in the cell center by a central difference
-    const int index_u0 = mapd(0, 0, 0, 1); // v at center
-    const int index_u1 = mapd(-1, 0, 0, 1); // v at left
-    const int index_u2 = mapd(1, 0, 0, 1);  // v at right
-
-    const int index_x0 = mapd(0, 0, 0, 0); // x at center
-    const int index_x1 = mapd(-1, 0, 0, 0); // x at left
-    const int index_x2 = mapd(1, 0, 0, 0);  // x at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index00] * lm[index00]);
+  // Extracts the weights of one axis (0: x, 1: y, 2: z) from a local meshsize cube. The derivatives below read
+  // precomputed weights from MeshWeights, this allows evaluating them on a local meshsize cube as well.
+  inline AxisWeights loadAxisWeights(const RealType* const lm, int axis) {
+    const int offset[3] = {axis == 0, axis == 1, axis == 2};
+    return computeAxisWeights(
+      lm[mapd(-offset[0], -offset[1], -offset[2], axis)],
+      lm[mapd(0, 0, 0, axis)],
+      lm[mapd(offset[0], offset[1], offset[2], axis)]
+    );
   }
 
-  inline RealType d2wdx2(const RealType* const lv, const RealType* const lm) {
-    // Evaluate d2wdx2 in the cell center by a central difference
-    const int index_u0 = mapd(0, 0, 0, 2); // w at center
-    const int index_u1 = mapd(-1, 0, 0, 2); // w at left
-    const int index_u2 = mapd(1, 0, 0, 2);  // w at right
-
-    const int index_x0 = mapd(0, 0, 0, 0); // x at center
-    const int index_x1 = mapd(-1, 0, 0, 0); // x at left
-    const int index_x2 = mapd(1, 0, 0, 0);  // x at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index00] * lm[index00]);
+  // Second derivatives of u, v, and w components. The weights w belong to the axis of the derivative; for the
+  // component along that axis this is the difference between neighbouring faces, otherwise between cell centres.
+  inline RealType d2udx2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(-1, 0, 0, 0)] + w.laplace[1] * lv[mapd(0, 0, 0, 0)]
+           + w.laplace[2] * lv[mapd(1, 0, 0, 0)];
   }
 
-  // Similarly for y directions
-  inline RealType d2udy2(const RealType* const lv, const RealType* const lm) {
-    const int index_u0 = mapd(0, 0, 0, 0); // u at center
-    const int index_u1 = mapd(0, -1, 0, 0); // u at left
-    const int index_u2 = mapd(0, 1, 0, 0);  // u at right
-
-    const int index_x0 = mapd(0, 0, 0, 1); // y at center
-    const int index_x1 = mapd(0, -1, 0, 1); // y at left
-    const int index_x2 = mapd(0, 1, 0, 1);  // y at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index0] * lm[index0]);
+  inline RealType d2vdx2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(-1, 0, 0, 1)] + w.laplace[1] * lv[mapd(0, 0, 0, 1)]
+           + w.laplace[2] * lv[mapd(1, 0, 0, 1)];
   }
 
-  inline RealType d2vdy2(const RealType* const lv, const RealType* const lm) {
-    const int index_u0 = mapd(0, 0, 0, 1); // v at center
-    const int index_u1 = mapd(0, -1, 0, 1); // v at left
-    const int index_u2 = mapd(0, 1, 0, 1);  // v at right
-
-    const int index_x0 = mapd(0, 0, 0, 1); // y at center
-    const int index_x1 = mapd(0, -1, 0, 1); // y at left
-    const int index_x2 = mapd(0, 1, 0, 1);  // y at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index0] * lm[index0]);
+  inline RealType d2wdx2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(-1, 0, 0, 2)] + w.laplace[1] * lv[mapd(0, 0, 0, 2)]
+           + w.laplace[2] * lv[mapd(1, 0, 0, 2)];
   }
 
-  inline RealType d2wdy2(const RealType* const lv, const RealType* const lm) {
-    const int index_u0 = mapd(0, 0, 0, 2); // w at center
-    const int index_u1 = mapd(0, -1, 0, 2); // w at left
-    const int index_u2 = mapd(0, 1, 0, 2);  // w at right
-
-    const int index_x0 = mapd(0, 0, 0, 1); // y at center
-    const int index_x1 = mapd(0, -1, 0, 1); // y at left
-    const int index_x2 = mapd(0, 1, 0, 1);  // y at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index0] * lm[index0]);
+  inline RealType d2udy2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(0, -1, 0, 0)] + w.laplace[1] * lv[mapd(0, 0, 0, 0)]
+           + w.laplace[2] * lv[mapd(0, 1, 0, 0)];
   }
 
-  // And for z direction
-  inline RealType d2udz2(const RealType* const lv, const RealType* const lm) {
-    const int index_u0 = mapd(0, 0, 0, 0); // u at center
-    const int index_u1 = mapd(0, 0, -1, 0); // u at left
-    const int index_u2 = mapd(0, 0, 1, 0);  // u at right
-
-    const int index_x0 = mapd(0, 0, 0, 0); // z at center
-    const int index_x1 = mapd(0, 0, -1, 0); // z at left
-    const int index_x2 = mapd(0, 0, 1, 0);  // z at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index0] * lm[index0]);
+  inline RealType d2vdy2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(0, -1, 0, 1)] + w.laplace[1] * lv[mapd(0, 0, 0, 1)]
+           + w.laplace[2] * lv[mapd(0, 1, 0, 1)];
   }
 
-  inline RealType d2vdz2(const RealType* const lv, const RealType* const lm) {
-    const int index_u0 = mapd(0, 0, 0, 1); // v at center
-    const int index_u1 = mapd(0, 0, -1, 1); // v at left
-    const int index_u2 = mapd(0, 0, 1, 1);  // v at right
+  inline RealType d2wdy2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(0, -1, 0, 2)] + w.laplace[1] * lv[mapd(0, 0, 0, 2)]
+           + w.laplace[2] * lv[mapd(0, 1, 0, 2)];
+  }
 
-    const int index_x0 = mapd(0, 0, 0, 0); // z at center
-    const int index_x1 = mapd(0, 0, -1, 0); // z at left
-    const int index_x2 = mapd(0, 0, 1, 0);  // z at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index0] * lm[index0]);
-  }
-
-  // Similarly for w, you would do:
-  inline RealType d2wdz2(const RealType* const lv, const RealType* const lm) {
-    const int index_u0 = mapd(0, 0, 0, 2); // w at center
-    const int index_u1 = mapd(0, 0, -1, 2); // w at left
-    const int index_u2 = mapd(0, 0, 1, 2);  // w at right
+  inline RealType d2udz2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(0, 0, -1, 0)] + w.laplace[1] * lv[mapd(0, 0, 0, 0)]
+           + w.laplace[2] * lv[mapd(0, 0, 1, 0)];
+  }
 
-    const int index_x0 = mapd(0, 0, 0, 0); // z at center
-    const int index_x1 = mapd(0, 0, -1, 0); // z at left
-    const int index_x2 = mapd(0, 0, 1, 0);  // z at right
-    return 2*((lv[index_u2])/(lm[index_x2] * (lm[index_x2] + lm[index_x0]))-(lv[index_u0])/(lm[index_x0] * lm[index_x2])+(lv[index_u1])/(lm[index_x0]*(lm[index_x0]+lm[index_x2])));
-    //return (lv[index2] - 2 * lv[index0] + lv[index1]) / (lm[index0] * lm[index0]);
+  inline RealType d2vdz2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(0, 0, -1, 1)] + w.laplace[1] * lv[mapd(0, 0, 0, 1)]
+           + w.laplace[2] * lv[mapd(0, 0, 1, 1)];
   }
 
+  inline RealType d2wdz2(const RealType* const lv, const AxisWeights& w) {
+    return w.laplace[0] * lv[mapd(0, 0, -1, 2)] + w.laplace[1] * lv[mapd(0, 0, 0, 2)]
+           + w.laplace[2] * lv[mapd(0, 0, 1, 2)];
+  }
 
-  // First derivative of product (u*v), evaluated at the location of the v-component.
-  inline RealType duvdx(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  // First derivative of product (u*v), evaluated at the location of the v-component. wx and wy are the weights of the
+  // current cell along x and y.
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType duvdx(
+    const RealType* const lv, const Parameters& parameters, const AxisWeights& wx, const AxisWeights& wy
+  ) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 0)] + lv[mapd(0, 1, 0, 0)]) *
         (lv[mapd(0, 0, 0, 1)] + lv[mapd(1, 0, 0, 1)])) -
@@ -214,17 +185,9 @@ namespace Stencils {
             (lv[mapd(0, 0, 0, 1)] - lv[mapd(1, 0, 0, 1)])) -
             (fabs(lv[mapd(-1, 0, 0, 0)] + lv[mapd(-1, 1, 0, 0)]) *
                 (lv[mapd(-1, 0, 0, 1)] - lv[mapd(0, 0, 0, 1)])))
-        ) / lm[mapd(0, 0, 0, 0)];
+        ) * wx.inverseSpacing;
 #endif
 
-    const RealType hxShort = 0.5 * lm[mapd(0, 0, 0, 0)]; // Distance of corner points in x-direction from center v-value
-    const RealType hxLong0 = 0.5 * (lm[mapd(0, 0, 0, 0)] + lm[mapd(-1, 0, 0, 0)]); // Distance between center and west
-                                                                                   // v-value
-    const RealType hxLong1 = 0.5 * (lm[mapd(0, 0, 0, 0)] + lm[mapd(1, 0, 0, 0)]);  // Distance between center and east
-                                                                                   // v-value
-    const RealType hyShort = 0.5 * lm[mapd(0, 0, 0, 1)]; // Distance of center u-value from upper edge of cell
-    const RealType hyLong = 0.5 * (lm[mapd(0, 0, 0, 1)] + lm[mapd(0, 1, 0, 1)]); // Distance of north and center u-value
-
     const RealType u00 = lv[mapd(0, 0, 0, 0)];
     const RealType u01 = lv[mapd(0, 1, 0, 0)];
     const RealType v00 = lv[mapd(0, 0, 0, 1)];
@@ -234,26 +197,29 @@ namespace Stencils {
     const RealType uM11 = lv[mapd(-1, 1, 0, 0)];
     const RealType vM10 = lv[mapd(-1, 0, 0, 1)];
 
+    // Interpolation of u onto the upper right and upper left corner of the cell (upper edge in y-direction).
+    const RealType kr = wy.lower[1] * u00 + wy.upper[1] * u01;
+    const RealType kl = wy.lower[1] * uM10 + wy.upper[1] * uM11;
+
     // This a central difference expression for the first-derivative. We therefore linearly interpolate u*v onto the
     // surface of the current cell (in 2D: upper left and upper right corner) and then take the central difference.
-    const RealType secondOrder = (((hyLong - hyShort) / hyLong * u00 + hyShort / hyLong * u01
-                                  ) * ((hxLong1 - hxShort) / hxLong1 * v00 + hxShort / hxLong1 * v10)
-                                  - ((hyLong - hyShort) / hyLong * uM10 + hyShort / hyLong * uM11
-                                    ) * ((hxLong0 - hxShort) / hxLong0 * v00 + hxShort / hxLong0 * vM10))
-                                 / (2.0 * hxShort);
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = (kr * (wx.lower[1] * v00 + wx.upper[1] * v10) - kl * (wx.lower[0] * vM10 + wx.upper[0] * v00))
+                    * wx.inverseSpacing;
+    }
 
     // This is a forward-difference in donor-cell style. We apply donor cell and again interpolate the velocity values
     // (u-comp.) onto the surface of the cell. We then apply the standard donor cell scheme. This will, however, result
     // in non-equal mesh spacing evaluations (in case of stretched meshes).
-    const RealType kr = (hyLong - hyShort) / hyLong * u00 + hyShort / hyLong * u01;
-    const RealType kl = (hyLong - hyShort) / hyLong * uM10 + hyShort / hyLong * uM11;
-
-    const RealType firstOrder
-      = 1.0 / (4.0 * hxShort)
-        * (kr * (v00 + v10) - kl * (vM10 + v00) + fabs(kr) * (v00 - v10) - fabs(kl) * (vM10 - v00));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wx.inverseSpacing
+                   * (kr * (v00 + v10) - kl * (vM10 + v00) + fabs(kr) * (v00 - v10) - fabs(kl) * (vM10 - v00));
+    }
 
     // Return linear combination of central and donor-cell difference
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -265,7 +231,10 @@ namespace Stencils {
   }
 
   // Evaluates first derivative w.r.t. y for u*v at location of u-component. For details on implementation, see duvdx.
-  inline RealType duvdy(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType duvdy(
+    const RealType* const lv, const Parameters& parameters, const AxisWeights& wx, const AxisWeights& wy
+  ) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 1)] + lv[mapd(1, 0, 0, 1)]) *
         (lv[mapd(0, 0, 0, 0)] + lv[mapd(0, 1, 0, 0)])) -
@@ -274,18 +243,10 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 1)] + lv[mapd(1, 0, 0, 1)]) *
             (lv[mapd(0, 0, 0, 0)] - lv[mapd(0, 1, 0, 0)])) -
             (fabs(lv[mapd(0, -1, 0, 1)] + lv[mapd(1, -1, 0, 1)]) *
-                (lv[mapd(0, -1, 0, 0)] - lv[mapd(0, 0, 0, 0)])))) /
-        lm[mapd(0, 0, 0, 1)];
+                (lv[mapd(0, -1, 0, 0)] - lv[mapd(0, 0, 0, 0)])))) *
+        wy.inverseSpacing;
 #endif
 
-    const RealType hyShort = 0.5 * lm[mapd(0, 0, 0, 1)]; // Distance of corner points in x-direction from center v-value
-    const RealType hyLong0 = 0.5 * (lm[mapd(0, 0, 0, 1)] + lm[mapd(0, -1, 0, 1)]); // Distance between center and west
-                                                                                   // v-value
-    const RealType hyLong1 = 0.5 * (lm[mapd(0, 0, 0, 1)] + lm[mapd(0, 1, 0, 1)]);  // Distance between center and east
-                                                                                   // v-value
-    const RealType hxShort = 0.5 * lm[mapd(0, 0, 0, 0)]; // Distance of center u-value from upper edge of cell
-    const RealType hxLong = 0.5 * (lm[mapd(0, 0, 0, 0)] + lm[mapd(1, 0, 0, 0)]); // Distance of north and center u-value
-
     const RealType v00 = lv[mapd(0, 0, 0, 1)];
     const RealType v10 = lv[mapd(1, 0, 0, 1)];
     const RealType u00 = lv[mapd(0, 0, 0, 0)];
@@ -295,20 +256,22 @@ namespace Stencils {
     const RealType v1M1 = lv[mapd(1, -1, 0, 1)];
     const RealType u0M1 = lv[mapd(0, -1, 0, 0)];
 
-    const RealType secondOrder = (((hxLong - hxShort) / hxLong * v00 + hxShort / hxLong * v10
-                                  ) * ((hyLong1 - hyShort) / hyLong1 * u00 + hyShort / hyLong1 * u01)
-                                  - ((hxLong - hxShort) / hxLong * v0M1 + hxShort / hxLong * v1M1
-                                    ) * ((hyLong0 - hyShort) / hyLong0 * u00 + hyShort / hyLong0 * u0M1))
-                                 / (2.0 * hyShort);
+    const RealType kr = wx.lower[1] * v00 + wx.upper[1] * v10;
+    const RealType kl = wx.lower[1] * v0M1 + wx.upper[1] * v1M1;
 
-    const RealType kr = (hxLong - hxShort) / hxLong * v00 + hxShort / hxLong * v10;
-    const RealType kl = (hxLong - hxShort) / hxLong * v0M1 + hxShort / hxLong * v1M1;
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = (kr * (wy.lower[1] * u00 + wy.upper[1] * u01) - kl * (wy.lower[0] * u0M1 + wy.upper[0] * u00))
+                    * wy.inverseSpacing;
+    }
 
-    const RealType firstOrder
-      = 1.0 / (4.0 * hyShort)
-        * (kr * (u00 + u01) - kl * (u0M1 + u00) + fabs(kr) * (u00 - u01) - fabs(kl) * (u0M1 - u00));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wy.inverseSpacing
+                   * (kr * (u00 + u01) - kl * (u0M1 + u00) + fabs(kr) * (u00 - u01) - fabs(kl) * (u0M1 - u00));
+    }
 
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -320,7 +283,10 @@ namespace Stencils {
   }
 
   // Evaluates first derivative w.r.t. x for u*w at location of w-component. For details on implementation, see duvdx.
-  inline RealType duwdx(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType duwdx(
+    const RealType* const lv, const Parameters& parameters, const AxisWeights& wx, const AxisWeights& wz
+  ) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 0)] + lv[mapd(0, 0, 1, 0)]) *
         (lv[mapd(0, 0, 0, 2)] + lv[mapd(1, 0, 0, 2)])) -
@@ -329,18 +295,10 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 0)] + lv[mapd(0, 0, 1, 0)]) *
             (lv[mapd(0, 0, 0, 2)] - lv[mapd(1, 0, 0, 2)])) -
             (fabs(lv[mapd(-1, 0, 0, 0)] + lv[mapd(-1, 0, 1, 0)]) *
-                (lv[mapd(-1, 0, 0, 2)] - lv[mapd(0, 0, 0, 2)])))) /
-        lm[mapd(0, 0, 0, 0)];
+                (lv[mapd(-1, 0, 0, 2)] - lv[mapd(0, 0, 0, 2)])))) *
+        wx.inverseSpacing;
 #endif
 
-    const RealType hxShort = 0.5 * lm[mapd(0, 0, 0, 0)]; // Distance of corner points in x-direction from center v-value
-    const RealType hxLong0 = 0.5 * (lm[mapd(0, 0, 0, 0)] + lm[mapd(-1, 0, 0, 0)]); // Distance between center and west
-                                                                                   // v-value
-    const RealType hxLong1 = 0.5 * (lm[mapd(0, 0, 0, 0)] + lm[mapd(1, 0, 0, 0)]);  // Distance between center and east
-                                                                                   // v-value
-    const RealType hzShort = 0.5 * lm[mapd(0, 0, 0, 2)]; // Distance of center u-value from upper edge of cell
-    const RealType hzLong = 0.5 * (lm[mapd(0, 0, 0, 2)] + lm[mapd(0, 0, 1, 2)]); // Distance of north and center u-value
-
     const RealType u00 = lv[mapd(0, 0, 0, 0)];
     const RealType u01 = lv[mapd(0, 0, 1, 0)];
     const RealType w00 = lv[mapd(0, 0, 0, 2)];
@@ -350,20 +308,22 @@ namespace Stencils {
     const RealType uM11 = lv[mapd(-1, 0, 1, 0)];
     const RealType wM10 = lv[mapd(-1, 0, 0, 2)];
 
-    const RealType secondOrder = (((hzLong - hzShort) / hzLong * u00 + hzShort / hzLong * u01
-                                  ) * ((hxLong1 - hxShort) / hxLong1 * w00 + hxShort / hxLong1 * w10)
-                                  - ((hzLong - hzShort) / hzLong * uM10 + hzShort / hzLong * uM11
-                                    ) * ((hxLong0 - hxShort) / hxLong0 * w00 + hxShort / hxLong0 * wM10))
-                                 / (2.0 * hxShort);
+    const RealType kr = wz.lower[1] * u00 + wz.upper[1] * u01;
+    const RealType kl = wz.lower[1] * uM10 + wz.upper[1] * uM11;
 
-    const RealType kr = (hzLong - hzShort) / hzLong * u00 + hzShort / hzLong * u01;
-    const RealType kl = (hzLong - hzShort) / hzLong * uM10 + hzShort / hzLong * uM11;
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = (kr * (wx.lower[1] * w00 + wx.upper[1] * w10) - kl * (wx.lower[0] * wM10 + wx.upper[0] * w00))
+                    * wx.inverseSpacing;
+    }
 
-    const RealType firstOrder
-      = 1.0 / (4.0 * hxShort)
-        * (kr * (w00 + w10) - kl * (wM10 + w00) + fabs(kr) * (w00 - w10) - fabs(kl) * (wM10 - w00));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wx.inverseSpacing
+                   * (kr * (w00 + w10) - kl * (wM10 + w00) + fabs(kr) * (w00 - w10) - fabs(kl) * (wM10 - w00));
+    }
 
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -375,7 +335,10 @@ namespace Stencils {
   }
 
   // Evaluates first derivative w.r.t. z for u*w at location of u-component. For details on implementation, see duvdx.
-  inline RealType duwdz(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType duwdz(
+    const RealType* const lv, const Parameters& parameters, const AxisWeights& wx, const AxisWeights& wz
+  ) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 2)] + lv[mapd(1, 0, 0, 2)]) *
         (lv[mapd(0, 0, 0, 0)] + lv[mapd(0, 0, 1, 0)])) -
@@ -384,18 +347,10 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 2)] + lv[mapd(1, 0, 0, 2)]) *
             (lv[mapd(0, 0, 0, 0)] - lv[mapd(0, 0, 1, 0)])) -
             (fabs(lv[mapd(0, 0, -1, 2)] + lv[mapd(1, 0, -1, 2)]) *
-                (lv[mapd(0, 0, -1, 0)] - lv[mapd(0, 0, 0, 0)])))) /
-        lm[mapd(0, 0, 0, 2)];
+                (lv[mapd(0, 0, -1, 0)] - lv[mapd(0, 0, 0, 0)])))) *
+        wz.inverseSpacing;
 #endif
 
-    const RealType hzShort = 0.5 * lm[mapd(0, 0, 0, 2)]; // Distance of corner points in x-direction from center v-value
-    const RealType hzLong0 = 0.5 * (lm[mapd(0, 0, 0, 2)] + lm[mapd(0, 0, -1, 2)]); // Distance between center and west
-                                                                                   // v-value
-    const RealType hzLong1 = 0.5 * (lm[mapd(0, 0, 0, 2)] + lm[mapd(0, 0, 1, 2)]);  // Distance between center and east
-                                                                                   // v-value
-    const RealType hxShort = 0.5 * lm[mapd(0, 0, 0, 0)]; // Distance of center u-value from upper edge of cell
-    const RealType hxLong = 0.5 * (lm[mapd(0, 0, 0, 0)] + lm[mapd(1, 0, 0, 0)]); // Distance of north and center u-value
-
     const RealType w00 = lv[mapd(0, 0, 0, 2)];
     const RealType w10 = lv[mapd(1, 0, 0, 2)];
     const RealType u00 = lv[mapd(0, 0, 0, 0)];
@@ -405,20 +360,22 @@ namespace Stencils {
     const RealType w1M1 = lv[mapd(1, 0, -1, 2)];
     const RealType u0M1 = lv[mapd(0, 0, -1, 0)];
 
-    const RealType secondOrder = (((hxLong - hxShort) / hxLong * w00 + hxShort / hxLong * w10
-                                  ) * ((hzLong1 - hzShort) / hzLong1 * u00 + hzShort / hzLong1 * u01)
-                                  - ((hxLong - hxShort) / hxLong * w0M1 + hxShort / hxLong * w1M1
-                                    ) * ((hzLong0 - hzShort) / hzLong0 * u00 + hzShort / hzLong0 * u0M1))
-                                 / (2.0 * hzShort);
+    const RealType kr = wx.lower[1] * w00 + wx.upper[1] * w10;
+    const RealType kl = wx.lower[1] * w0M1 + wx.upper[1] * w1M1;
 
-    const RealType kr = (hxLong - hxShort) / hxLong * w00 + hxShort / hxLong * w10;
-    const RealType kl = (hxLong - hxShort) / hxLong * w0M1 + hxShort / hxLong * w1M1;
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = (kr * (wz.lower[1] * u00 + wz.upper[1] * u01) - kl * (wz.lower[0] * u0M1 + wz.upper[0] * u00))
+                    * wz.inverseSpacing;
+    }
 
-    const RealType firstOrder
-      = 1.0 / (4.0 * hzShort)
-        * (kr * (u00 + u01) - kl * (u0M1 + u00) + fabs(kr) * (u00 - u01) - fabs(kl) * (u0M1 - u00));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wz.inverseSpacing
+                   * (kr * (u00 + u01) - kl * (u0M1 + u00) + fabs(kr) * (u00 - u01) - fabs(kl) * (u0M1 - u00));
+    }
 
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -430,7 +387,10 @@ namespace Stencils {
   }
 
   // Evaluates first derivative w.r.t. y for v*w at location of w-component. For details on implementation, see duvdx.
-  inline RealType dvwdy(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType dvwdy(
+    const RealType* const lv, const Parameters& parameters, const AxisWeights& wy, const AxisWeights& wz
+  ) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 1)] + lv[mapd(0, 0, 1, 1)]) *
         (lv[mapd(0, 0, 0, 2)] + lv[mapd(0, 1, 0, 2)])) -
@@ -439,18 +399,10 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 1)] + lv[mapd(0, 0, 1, 1)]) *
             (lv[mapd(0, 0, 0, 2)] - lv[mapd(0, 1, 0, 2)])) -
             (fabs(lv[mapd(0, -1, 0, 1)] + lv[mapd(0, -1, 1, 1)]) *
-                (lv[mapd(0, -1, 0, 2)] - lv[mapd(0, 0, 0, 2)])))) /
-        lm[mapd(0, 0, 0, 1)];
+                (lv[mapd(0, -1, 0, 2)] - lv[mapd(0, 0, 0, 2)])))) *
+        wy.inverseSpacing;
 #endif
 
-    const RealType hyShort = 0.5 * lm[mapd(0, 0, 0, 1)]; // Distance of corner points in x-direction from center v-value
-    const RealType hyLong0 = 0.5 * (lm[mapd(0, 0, 0, 1)] + lm[mapd(0, -1, 0, 1)]); // Distance between center and west
-                                                                                   // v-value
-    const RealType hyLong1 = 0.5 * (lm[mapd(0, 0, 0, 1)] + lm[mapd(0, 1, 0, 1)]);  // Distance between center and east
-                                                                                   // v-value
-    const RealType hzShort = 0.5 * lm[mapd(0, 0, 0, 2)]; // Distance of center u-value from upper edge of cell
-    const RealType hzLong = 0.5 * (lm[mapd(0, 0, 0, 2)] + lm[mapd(0, 0, 1, 2)]); // Distance of north and center u-value
-
     const RealType v00 = lv[mapd(0, 0, 0, 1)];
     const RealType v01 = lv[mapd(0, 0, 1, 1)];
     const RealType w00 = lv[mapd(0, 0, 0, 2)];
@@ -460,20 +412,22 @@ namespace Stencils {
     const RealType vM11 = lv[mapd(0, -1, 1, 1)];
     const RealType wM10 = lv[mapd(0, -1, 0, 2)];
 
-    const RealType secondOrder = (((hzLong - hzShort) / hzLong * v00 + hzShort / hzLong * v01
-                                  ) * ((hyLong1 - hyShort) / hyLong1 * w00 + hyShort / hyLong1 * w10)
-                                  - ((hzLong - hzShort) / hzLong * vM10 + hzShort / hzLong * vM11
-                                    ) * ((hyLong0 - hyShort) / hyLong0 * w00 + hyShort / hyLong0 * wM10))
-                                 / (2.0 * hyShort);
+    const RealType kr = wz.lower[1] * v00 + wz.upper[1] * v01;
+    const RealType kl = wz.lower[1] * vM10 + wz.upper[1] * vM11;
 
-    const RealType kr = (hzLong - hzShort) / hzLong * v00 + hzShort / hzLong * v01;
-    const RealType kl = (hzLong - hzShort) / hzLong * vM10 + hzShort / hzLong * vM11;
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = (kr * (wy.lower[1] * w00 + wy.upper[1] * w10) - kl * (wy.lower[0] * wM10 + wy.upper[0] * w00))
+                    * wy.inverseSpacing;
+    }
 
-    const RealType firstOrder
-      = 1.0 / (4.0 * hyShort)
-        * (kr * (w00 + w10) - kl * (wM10 + w00) + fabs(kr) * (w00 - w10) - fabs(kl) * (wM10 - w00));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wy.inverseSpacing
+                   * (kr * (w00 + w10) - kl * (wM10 + w00) + fabs(kr) * (w00 - w10) - fabs(kl) * (wM10 - w00));
+    }
 
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -485,7 +439,10 @@ namespace Stencils {
   }
 
   // Evaluates first derivative w.r.t. z for v*w at location of v-component. For details on implementation, see duvdx.
-  inline RealType dvwdz(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType dvwdz(
+    const RealType* const lv, const Parameters& parameters, const AxisWeights& wy, const AxisWeights& wz
+  ) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 2)] + lv[mapd(0, 1, 0, 2)]) *
         (lv[mapd(0, 0, 0, 1)] + lv[mapd(0, 0, 1, 1)])) -
@@ -494,18 +451,10 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 2)] + lv[mapd(0, 1, 0, 2)]) *
             (lv[mapd(0, 0, 0, 1)] - lv[mapd(0, 0, 1, 1)])) -
             (fabs(lv[mapd(0, 0, -1, 2)] + lv[mapd(0, 1, -1, 2)]) *
-                (lv[mapd(0, 0, -1, 1)] - lv[mapd(0, 0, 0, 1)])))) /
-        lm[mapd(0, 0, 0, 2)];
+                (lv[mapd(0, 0, -1, 1)] - lv[mapd(0, 0, 0, 1)])))) *
+        wz.inverseSpacing;
 #endif
 
-    const RealType hzShort = 0.5 * lm[mapd(0, 0, 0, 2)]; // Distance of corner points in x-direction from center v-value
-    const RealType hzLong0 = 0.5 * (lm[mapd(0, 0, 0, 2)] + lm[mapd(0, 0, -1, 2)]); // Distance between center and west
-                                                                                   // v-value
-    const RealType hzLong1 = 0.5 * (lm[mapd(0, 0, 0, 2)] + lm[mapd(0, 0, 1, 2)]);  // Distance between center and east
-                                                                                   // v-value
-    const RealType hyShort = 0.5 * lm[mapd(0, 0, 0, 1)]; // Distance of center u-value from upper edge of cell
-    const RealType hyLong = 0.5 * (lm[mapd(0, 0, 0, 1)] + lm[mapd(0, 1, 0, 1)]); // Distance of north and center u-value
-
     const RealType w00 = lv[mapd(0, 0, 0, 2)];
     const RealType w10 = lv[mapd(0, 1, 0, 2)];
     const RealType v00 = lv[mapd(0, 0, 0, 1)];
@@ -515,20 +464,22 @@ namespace Stencils {
     const RealType w1M1 = lv[mapd(0, 1, -1, 2)];
     const RealType v0M1 = lv[mapd(0, 0, -1, 1)];
 
-    const RealType secondOrder = (((hyLong - hyShort) / hyLong * w00 + hyShort / hyLong * w10
-                                  ) * ((hzLong1 - hzShort) / hzLong1 * v00 + hzShort / hzLong1 * v01)
-                                  - ((hyLong - hyShort) / hyLong * w0M1 + hyShort / hyLong * w1M1
-                                    ) * ((hzLong0 - hzShort) / hzLong0 * v00 + hzShort / hzLong0 * v0M1))
-                                 / (2.0 * hzShort);
+    const RealType kr = wy.lower[1] * w00 + wy.upper[1] * w10;
+    const RealType kl = wy.lower[1] * w0M1 + wy.upper[1] * w1M1;
 
-    const RealType kr = (hyLong - hyShort) / hyLong * w00 + hyShort / hyLong * w10;
-    const RealType kl = (hyLong - hyShort) / hyLong * w0M1 + hyShort / hyLong * w1M1;
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = (kr * (wz.lower[1] * v00 + wz.upper[1] * v01) - kl * (wz.lower[0] * v0M1 + wz.upper[0] * v00))
+                    * wz.inverseSpacing;
+    }
 
-    const RealType firstOrder
-      = 1.0 / (4.0 * hzShort)
-        * (kr * (v00 + v01) - kl * (v0M1 + v00) + fabs(kr) * (v00 - v01) - fabs(kl) * (v0M1 - v00));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wz.inverseSpacing
+                   * (kr * (v00 + v01) - kl * (v0M1 + v00) + fabs(kr) * (v00 - v01) - fabs(kl) * (v0M1 - v00));
+    }
 
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -541,7 +492,8 @@ namespace Stencils {
   }
 
   // First derivative of u*u w.r.t. x, evaluated at location of u-component.
-  inline RealType du2dx(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType du2dx(const RealType* const lv, const Parameters& parameters, const AxisWeights& wx) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 0)] + lv[mapd(1, 0, 0, 0)]) *
         (lv[mapd(0, 0, 0, 0)] + lv[mapd(1, 0, 0, 0)])) -
@@ -550,40 +502,34 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 0)] + lv[mapd(1, 0, 0, 0)]) *
             (lv[mapd(0, 0, 0, 0)] - lv[mapd(1, 0, 0, 0)])) -
             (fabs(lv[mapd(-1, 0, 0, 0)] + lv[mapd(0, 0, 0, 0)]) *
-                (lv[mapd(-1, 0, 0, 0)] - lv[mapd(0, 0, 0, 0)])))) /
-        lm[mapd(0, 0, 0, 0)];
+                (lv[mapd(-1, 0, 0, 0)] - lv[mapd(0, 0, 0, 0)])))) *
+        wx.inverseSpacing;
 #endif
 
-    const RealType dxShort = 0.5 * lm[mapd(0, 0, 0, 0)];
-    // const RealType dxLong0 = 0.5*(lm[mapd(-1,0,0,0)] + lm[mapd(0,0,0,0)]);
-    const RealType dxLong1 = 0.5 * (lm[mapd(0, 0, 0, 0)] + lm[mapd(1, 0, 0, 0)]);
-
     const RealType u0  = lv[mapd(0, 0, 0, 0)];
     const RealType uM1 = lv[mapd(-1, 0, 0, 0)];
     const RealType u1  = lv[mapd(1, 0, 0, 0)];
 
-    // const RealType kr = (dxLong1 - dxShort) / dxLong1 * u0 + dxShort / dxLong1 * u1;
-    // const RealType kl = (dxLong0 - dxShort) / dxLong0 * u0 + dxShort / dxLong0 * uM1;
     const RealType kr = (u0 + u1) / 2;
     const RealType kl = (u0 + uM1) / 2;
 
     // Central difference expression which is second-order accurate for uniform meshes. We interpolate u half-way
     // between neighboured u-component values and afterwards build the central difference for u*u.
-
-    /*const RealType secondOrder = (((dxLong1 - dxShort) / dxLong1 * u0 + dxShort / dxLong1 * u1) * ((dxLong1 - dxShort)
-       / dxLong1 * u0 + dxShort / dxLong1 * u1)
-        - ((dxLong0 - dxShort) / dxLong0 * u0 + dxShort / dxLong0 * uM1) * ((dxLong0 - dxShort) / dxLong0 * u0 + dxShort
-       / dxLong0 * uM1) ) / (2.0 * dxShort);*/
-
-    const RealType secondOrder = ((u0 + u1) * (u0 + u1) - (u0 + uM1) * (u0 + uM1)) / (4 * dxLong1);
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = 0.25 * wx.inverseCentreDistance * ((u0 + u1) * (u0 + u1) - (u0 + uM1) * (u0 + uM1));
+    }
 
     // Donor-cell like derivative expression. We evaluate u half-way between neighboured u-components and use this as a
     // prediction of the transport direction.
-    const RealType firstOrder = 1.0 / (4.0 * dxShort)
-                                * (kr * (u0 + u1) - kl * (uM1 + u0) + fabs(kr) * (u0 - u1) - fabs(kl) * (uM1 - u0));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wx.inverseSpacing
+                   * (kr * (u0 + u1) - kl * (uM1 + u0) + fabs(kr) * (u0 - u1) - fabs(kl) * (uM1 - u0));
+    }
 
     // Return linear combination of central- and upwind difference
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -596,7 +542,8 @@ namespace Stencils {
   }
 
   // First derivative of v*v w.r.t. y, evaluated at location of v-component. For details, see du2dx.
-  inline RealType dv2dy(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType dv2dy(const RealType* const lv, const Parameters& parameters, const AxisWeights& wy) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 1)] + lv[mapd(0, 1, 0, 1)]) *
         (lv[mapd(0, 0, 0, 1)] + lv[mapd(0, 1, 0, 1)])) -
@@ -605,34 +552,29 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 1)] + lv[mapd(0, 1, 0, 1)]) *
             (lv[mapd(0, 0, 0, 1)] - lv[mapd(0, 1, 0, 1)])) -
             (fabs(lv[mapd(0, -1, 0, 1)] + lv[mapd(0, 0, 0, 1)]) *
-                (lv[mapd(0, -1, 0, 1)] - lv[mapd(0, 0, 0, 1)])))) /
-        lm[mapd(0, 0, 0, 1)];
+                (lv[mapd(0, -1, 0, 1)] - lv[mapd(0, 0, 0, 1)])))) *
+        wy.inverseSpacing;
 #endif
 
-    const RealType dyShort = 0.5 * lm[mapd(0, 0, 0, 1)];
-    // const RealType dyLong0 = 0.5*(lm[mapd(0,-1,0,1)] + lm[mapd(0,0,0,1)]);
-    const RealType dyLong1 = 0.5 * (lm[mapd(0, 0, 0, 1)] + lm[mapd(0, 1, 0, 1)]);
-
     const RealType v0  = lv[mapd(0, 0, 0, 1)];
     const RealType vM1 = lv[mapd(0, -1, 0, 1)];
     const RealType v1  = lv[mapd(0, 1, 0, 1)];
 
-    // const RealType kr = (dyLong1 - dyShort) / dyLong1 * v0 + dyShort / dyLong1 * v1;
-    // const RealType kl = (dyLong0 - dyShort) / dyLong0 * v0 + dyShort / dyLong0 * vM1;
     const RealType kr = (v0 + v1) / 2;
     const RealType kl = (v0 + vM1) / 2;
 
-    /*const RealType secondOrder = (((dyLong1 - dyShort) / dyLong1 * v0 + dyShort / dyLong1 * v1) * ((dyLong1 - dyShort)
-       / dyLong1 * v0 + dyShort / dyLong1 * v1)
-        - ((dyLong0 - dyShort) / dyLong0 * v0 + dyShort / dyLong0 * vM1) * ((dyLong0 - dyShort) / dyLong0 * v0 + dyShort
-       / dyLong0 * vM1) ) / (2.0 * dyShort);*/
-
-    const RealType secondOrder = ((v0 + v1) * (v0 + v1) - (v0 + vM1) * (v0 + vM1)) / (4 * dyLong1);
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = 0.25 * wy.inverseCentreDistance * ((v0 + v1) * (v0 + v1) - (v0 + vM1) * (v0 + vM1));
+    }
 
-    const RealType firstOrder = 1.0 / (4.0 * dyShort)
-                                * (kr * (v0 + v1) - kl * (vM1 + v0) + fabs(kr) * (v0 - v1) - fabs(kl) * (vM1 - v0));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wy.inverseSpacing
+                   * (kr * (v0 + v1) - kl * (vM1 + v0) + fabs(kr) * (v0 - v1) - fabs(kl) * (vM1 - v0));
+    }
 
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -645,7 +587,8 @@ namespace Stencils {
   }
 
   // First derivative of w*w w.r.t. z, evaluated at location of w-component. For details, see du2dx.
-  inline RealType dw2dz(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended>
+  inline RealType dw2dz(const RealType* const lv, const Parameters& parameters, const AxisWeights& wz) {
 #ifndef NDEBUG
     const RealType tmp1 = 1.0 / 4.0 * ((((lv[mapd(0, 0, 0, 2)] + lv[mapd(0, 0, 1, 2)]) *
         (lv[mapd(0, 0, 0, 2)] + lv[mapd(0, 0, 1, 2)])) -
@@ -654,34 +597,29 @@ namespace Stencils {
         parameters.solver.gamma * ((fabs(lv[mapd(0, 0, 0, 2)] + lv[mapd(0, 0, 1, 2)]) *
             (lv[mapd(0, 0, 0, 2)] - lv[mapd(0, 0, 1, 2)])) -
             (fabs(lv[mapd(0, 0, -1, 2)] + lv[mapd(0, 0, 0, 2)]) *
-                (lv[mapd(0, 0, -1, 2)] - lv[mapd(0, 0, 0, 2)])))) /
-        lm[mapd(0, 0, 0, 2)];
+                (lv[mapd(0, 0, -1, 2)] - lv[mapd(0, 0, 0, 2)])))) *
+        wz.inverseSpacing;
 #endif
 
-    const RealType dzShort = 0.5 * lm[mapd(0, 0, 0, 2)];
-    // const RealType dzLong0 = 0.5 * (lm[mapd(0, 0, -1, 2)] + lm[mapd(0, 0, 0, 2)]);
-    const RealType dzLong1 = 0.5 * (lm[mapd(0, 0, 0, 2)] + lm[mapd(0, 0, 1, 2)]);
-
     const RealType w0  = lv[mapd(0, 0, 0, 2)];
     const RealType wM1 = lv[mapd(0, 0, -1, 2)];
     const RealType w1  = lv[mapd(0, 0, 1, 2)];
 
-    // const RealType kr = (dzLong1 - dzShort) / dzLong1 * w0 + dzShort / dzLong1 * w1;
-    // const RealType kl = (dzLong0 - dzShort) / dzLong0 * w0 + dzShort / dzLong0 * wM1;
     const RealType kr = (w0 + w1) / 2;
     const RealType kl = (w0 + wM1) / 2;
 
-    /*const RealType secondOrder = (((dzLong1 - dzShort) / dzLong1 * w0 + dzShort / dzLong1 * w1) * ((dzLong1 - dzShort)
-       / dzLong1 * w0 + dzShort / dzLong1 * w1)
-        - ((dzLong0 - dzShort) / dzLong0 * w0 + dzShort / dzLong0 * wM1) * ((dzLong0 - dzShort) / dzLong0 * w0 + dzShort
-       / dzLong0 * wM1) ) / (2.0 * dzShort);*/
-
-    const RealType secondOrder = ((w0 + w1) * (w0 + w1) - (w0 + wM1) * (w0 + wM1)) / (4 * dzLong1);
+    RealType secondOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::DonorCell) {
+      secondOrder = 0.25 * wz.inverseCentreDistance * ((w0 + w1) * (w0 + w1) - (w0 + wM1) * (w0 + wM1));
+    }
 
-    const RealType firstOrder = 1.0 / (4.0 * dzShort)
-                                * (kr * (w0 + w1) - kl * (wM1 + w0) + fabs(kr) * (w0 - w1) - fabs(kl) * (wM1 - w0));
+    RealType firstOrder = 0.0;
+    if constexpr (Scheme != ConvectionScheme::Central) {
+      firstOrder = 0.5 * wz.inverseSpacing
+                   * (kr * (w0 + w1) - kl * (wM1 + w0) + fabs(kr) * (w0 - w1) - fabs(kl) * (wM1 - w0));
+    }
 
-    const RealType tmp2 = (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+    const RealType tmp2 = blendConvection<Scheme>(parameters, secondOrder, firstOrder);
 
 #ifndef NDEBUG
     if (fabs(tmp1 - tmp2) > 1.0e-12) {
@@ -693,75 +631,332 @@ namespace Stencils {
     return tmp2;
   }
 
+  // Variants of the convective derivatives on a local meshsize cube lm, e.g. for tests.
+  inline RealType duvdx(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return duvdx(lv, parameters, loadAxisWeights(lm, 0), loadAxisWeights(lm, 1));
+  }
+
+  inline RealType duvdy(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return duvdy(lv, parameters, loadAxisWeights(lm, 0), loadAxisWeights(lm, 1));
+  }
+
+  inline RealType duwdx(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return duwdx(lv, parameters, loadAxisWeights(lm, 0), loadAxisWeights(lm, 2));
+  }
+
+  inline RealType duwdz(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return duwdz(lv, parameters, loadAxisWeights(lm, 0), loadAxisWeights(lm, 2));
+  }
+
+  inline RealType dvwdy(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return dvwdy(lv, parameters, loadAxisWeights(lm, 1), loadAxisWeights(lm, 2));
+  }
+
+  inline RealType dvwdz(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return dvwdz(lv, parameters, loadAxisWeights(lm, 1), loadAxisWeights(lm, 2));
+  }
+
+  inline RealType du2dx(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return du2dx(lv, parameters, loadAxisWeights(lm, 0));
+  }
+
+  inline RealType dv2dy(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return dv2dy(lv, parameters, loadAxisWeights(lm, 1));
+  }
+
+  inline RealType dw2dz(const RealType* const lv, const Parameters& parameters, const RealType* const lm) {
+    return dw2dz(lv, parameters, loadAxisWeights(lm, 2));
+  }
+
+  // The tendency functions return the explicit right-hand side of the momentum equation (convection, diffusion
+  // and body force) for one velocity component. They are instantiated per convection scheme and for zero
+  // (BodyForce = false) or non-zero gravity, see FGHStencil for the selection. wx, wy and wz are the mesh
+  // weights of the current cell.
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeTendencyF2D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const Parameters&     parameters
+  ) {
+    RealType viscousTermU = d2udx2(localVelocity, wx); // d2u/dx2
+    RealType viscousTermV = d2udy2(localVelocity, wy); // d2u/dy2
+    RealType rhs          = -du2dx<Scheme>(localVelocity, parameters, wx)
+                            - duvdy<Scheme>(localVelocity, parameters, wx, wy)
+                            + 1 / parameters.flow.Re * (viscousTermU + viscousTermV);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gx;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeTendencyG2D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const Parameters&     parameters
+  ) {
+    RealType viscousTermU = d2vdx2(localVelocity, wx); // d2v/dx2
+    RealType viscousTermV = d2vdy2(localVelocity, wy); // d2v/dy2
+    RealType rhs          = -duvdx<Scheme>(localVelocity, parameters, wx, wy)
+                            - dv2dy<Scheme>(localVelocity, parameters, wy)
+                            + 1 / parameters.flow.Re * (viscousTermU + viscousTermV);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gy;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeTendencyF3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    RealType viscousTermU = d2udx2(localVelocity, wx); // d²u/dx²
+    RealType viscousTermV = d2udy2(localVelocity, wy); // d²u/dy²
+    RealType viscousTermW = d2udz2(localVelocity, wz); // d²u/dz²
+    RealType rhs          = -du2dx<Scheme>(localVelocity, parameters, wx)
+                            - duvdy<Scheme>(localVelocity, parameters, wx, wy)
+                            - duwdz<Scheme>(localVelocity, parameters, wx, wz)
+                            + 1 / parameters.flow.Re * (viscousTermU + viscousTermV + viscousTermW);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gx;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeTendencyG3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    RealType viscousTermU = d2vdx2(localVelocity, wx); // d²v/dx²
+    RealType viscousTermV = d2vdy2(localVelocity, wy); // d²v/dy²
+    RealType viscousTermW = d2vdz2(localVelocity, wz); // d²v/dz²
+    RealType rhs          = -dv2dy<Scheme>(localVelocity, parameters, wy)
+                            - duvdx<Scheme>(localVelocity, parameters, wx, wy)
+                            - dvwdz<Scheme>(localVelocity, parameters, wy, wz)
+                            + 1 / parameters.flow.Re * (viscousTermU + viscousTermV + viscousTermW);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gy;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeTendencyH3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    RealType viscousTermU = d2wdx2(localVelocity, wx); // d²w/dx²
+    RealType viscousTermV = d2wdy2(localVelocity, wy); // d²w/dy²
+    RealType viscousTermW = d2wdz2(localVelocity, wz); // d²w/dz²
+    RealType rhs          = -dw2dz<Scheme>(localVelocity, parameters, wz)
+                            - duwdx<Scheme>(localVelocity, parameters, wx, wz)
+                            - dvwdy<Scheme>(localVelocity, parameters, wy, wz)
+                            + 1 / parameters.flow.Re * (viscousTermU + viscousTermV + viscousTermW);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gz;
+    }
+    return rhs;
+  }
+
+  // In IMEX mode, the tendency is split into the convective part, which includes the body force, and the viscous
+  // part. Only the convective part enters the history register of the multi-step/multi-stage kernels, the viscous
+  // part is weighted with the stage timestep and completed to Crank-Nicolson by the ViscousSolver.
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeConvectionF2D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const Parameters&     parameters
+  ) {
+    RealType rhs = -du2dx<Scheme>(localVelocity, parameters, wx) - duvdy<Scheme>(localVelocity, parameters, wx, wy);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gx;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeConvectionG2D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const Parameters&     parameters
+  ) {
+    RealType rhs = -duvdx<Scheme>(localVelocity, parameters, wx, wy) - dv2dy<Scheme>(localVelocity, parameters, wy);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gy;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeConvectionF3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    RealType rhs = -du2dx<Scheme>(localVelocity, parameters, wx)
+                   - duvdy<Scheme>(localVelocity, parameters, wx, wy)
+                   - duwdz<Scheme>(localVelocity, parameters, wx, wz);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gx;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeConvectionG3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    RealType rhs = -dv2dy<Scheme>(localVelocity, parameters, wy)
+                   - duvdx<Scheme>(localVelocity, parameters, wx, wy)
+                   - dvwdz<Scheme>(localVelocity, parameters, wy, wz);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gy;
+    }
+    return rhs;
+  }
+
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
+  inline RealType computeConvectionH3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    RealType rhs = -dw2dz<Scheme>(localVelocity, parameters, wz)
+                   - duwdx<Scheme>(localVelocity, parameters, wx, wz)
+                   - dvwdy<Scheme>(localVelocity, parameters, wy, wz);
+    if constexpr (BodyForce) {
+      rhs += parameters.environment.gz;
+    }
+    return rhs;
+  }
+
+  inline RealType computeViscousF2D(
+    const RealType* const localVelocity, const AxisWeights& wx, const AxisWeights& wy, const Parameters& parameters
+  ) {
+    return 1 / parameters.flow.Re * (d2udx2(localVelocity, wx) + d2udy2(localVelocity, wy));
+  }
+
+  inline RealType computeViscousG2D(
+    const RealType* const localVelocity, const AxisWeights& wx, const AxisWeights& wy, const Parameters& parameters
+  ) {
+    return 1 / parameters.flow.Re * (d2vdx2(localVelocity, wx) + d2vdy2(localVelocity, wy));
+  }
+
+  inline RealType computeViscousF3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    return 1 / parameters.flow.Re * (d2udx2(localVelocity, wx) + d2udy2(localVelocity, wy) + d2udz2(localVelocity, wz));
+  }
+
+  inline RealType computeViscousG3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    return 1 / parameters.flow.Re * (d2vdx2(localVelocity, wx) + d2vdy2(localVelocity, wy) + d2vdz2(localVelocity, wz));
+  }
+
+  inline RealType computeViscousH3D(
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters
+  ) {
+    return 1 / parameters.flow.Re * (d2wdx2(localVelocity, wx) + d2wdy2(localVelocity, wy) + d2wdz2(localVelocity, wz));
+  }
+
+  // Forward Euler predictors F, G and H
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
   inline RealType computeF2D(
-    const RealType* const localVelocity, const RealType* const localMeshsize, const Parameters& parameters, RealType dt
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const Parameters&     parameters,
+    RealType              dt
   ) {
-    // TODO WS1
-    RealType viscousTermU = d2udx2(localVelocity, localMeshsize); // d2u/dx2
-    RealType viscousTermV = d2udy2(localVelocity, localMeshsize); // d2u/dy2
     return localVelocity[mapd(0, 0, 0, 0)]
-        + dt * (-du2dx(localVelocity, parameters, localMeshsize) 
-                - duvdy(localVelocity, parameters, localMeshsize)
-                + 1/parameters.flow.Re*(viscousTermU + viscousTermV) 
-                + parameters.environment.gx);
+           + dt * computeTendencyF2D<Scheme, BodyForce>(localVelocity, wx, wy, parameters);
   }
 
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
   inline RealType computeG2D(
-    const RealType* const localVelocity, const RealType* const localMeshsize, const Parameters& parameters, RealType dt
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const Parameters&     parameters,
+    RealType              dt
   ) {
-    // TODO WS1
-    RealType viscousTermU = d2vdx2(localVelocity, localMeshsize); // d2v/dx2
-    RealType viscousTermV = d2vdy2(localVelocity, localMeshsize); // d2v/dy2
     return localVelocity[mapd(0, 0, 0, 1)]
-        + dt * (- duvdx(localVelocity, parameters, localMeshsize) 
-                - dv2dy(localVelocity, parameters, localMeshsize)
-                +  1/parameters.flow.Re*(viscousTermU + viscousTermV) 
-                + parameters.environment.gy);
+           + dt * computeTendencyG2D<Scheme, BodyForce>(localVelocity, wx, wy, parameters);
   }
 
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
   inline RealType computeF3D(
-    const RealType* const localVelocity, const RealType* const localMeshsize, const Parameters& parameters, RealType dt
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters,
+    RealType              dt
   ) {
-    // TODO WS1
-    RealType viscousTermU = d2udx2(localVelocity, localMeshsize); // d²u/dx²
-    RealType viscousTermV = d2udy2(localVelocity, localMeshsize); // d²u/dy²
-    RealType viscousTermW = d2udz2(localVelocity, localMeshsize); // d²u/dz²
     return localVelocity[mapd(0, 0, 0, 0)]
-        + dt * (-du2dx(localVelocity, parameters, localMeshsize) 
-                - duvdy(localVelocity, parameters, localMeshsize)
-                - duwdz(localVelocity, parameters, localMeshsize) 
-                + 1/parameters.flow.Re*(viscousTermU + viscousTermV + viscousTermW)
-                + parameters.environment.gx);
+           + dt * computeTendencyF3D<Scheme, BodyForce>(localVelocity, wx, wy, wz, parameters);
   }
 
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
   inline RealType computeG3D(
-    const RealType* const localVelocity, const RealType* const localMeshsize, const Parameters& parameters, RealType dt
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters,
+    RealType              dt
   ) {
-    // TODO WS1
-    RealType viscousTermU = d2vdx2(localVelocity, localMeshsize); // d²v/dx²
-    RealType viscousTermV = d2vdy2(localVelocity, localMeshsize); // d²v/dy²
-    RealType viscousTermW = d2vdz2(localVelocity, localMeshsize); // d²v/dz²
     return localVelocity[mapd(0, 0, 0, 1)]
-        + dt * (-dSv2dy(localVelocity, parameters, localMeshsize) 
-                - duvdx(localVelocity, parameters, localMeshsize)
-                - dvwdz(localVelocity, parameters, localMeshsize) 
-                + 1/parameters.flow.Re*(viscousTermU + viscousTermV + viscousTermW)
-                + parameters.environment.gy);
+           + dt * computeTendencyG3D<Scheme, BodyForce>(localVelocity, wx, wy, wz, parameters);
   }
 
+  template <ConvectionScheme Scheme = ConvectionScheme::Blended, bool BodyForce = true>
   inline RealType computeH3D(
-    const RealType* const localVelocity, const RealType* const localMeshsize, const Parameters& parameters, RealType dt
+    const RealType* const localVelocity,
+    const AxisWeights&    wx,
+    const AxisWeights&    wy,
+    const AxisWeights&    wz,
+    const Parameters&     parameters,
+    RealType              dt
   ) {
-    // TODO WS1
-    RealType viscousTermU = d2wdx2(localVelocity, localMeshsize); // d²w/dx²
-    RealType viscousTermV = d2wdy2(localVelocity, localMeshsize); // d²w/dy²
-    RealType viscousTermW = d2wdz2(localVelocity, localMeshsize); // d²w/dz²
     return localVelocity[mapd(0, 0, 0, 2)]
-        + dt * (-dw2dz(localVelocity, parameters, localMeshsize) 
-                - duwdx(localVelocity, parameters, localMeshsize)
-                - dvwdy(localVelocity, parameters, localMeshsize) 
-                + 1/parameters.flow.Re*(viscousTermU + viscousTermV + viscousTermW)
-                + parameters.environment.gz);
+           + dt * computeTendencyH3D<Scheme, BodyForce>(localVelocity, wx, wy, wz, parameters);
   }
 
 } // namespace Stencils
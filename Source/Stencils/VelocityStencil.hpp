@@ -7,6 +7,9 @@
 namespace Stencils {
 
   /** Stencil to compute the velocity once the pressure has been found.
+   *
+   * In incremental mode, the predictor already includes the gradient of the previous pressure and the pressure
+   * field holds the change of the pressure at this point, so that only the correction is applied.
    */
   class VelocityStencil: public FieldStencil<FlowField> {
   public:
@@ -0,0 +1,187 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "Configuration.hpp"
+#include "FlowField.hpp"
+#include "Iterators.hpp"
+#include "Meshsize.hpp"
+#include "MeshsizeFactory.hpp"
+#include "Parameters.hpp"
+#include "Simulation.hpp"
+
+#include "ParallelManagers/PetscParallelConfiguration.hpp"
+#include "Stencils/DivergenceStencil.hpp"
+
+// Exposes the schedule of the pressure tolerance
+class ScheduleSimulation: public Simulation {
+public:
+  using Simulation::Simulation;
+  using Simulation::updateToleranceScaling;
+
+  RealType getToleranceScaling() const { return toleranceScaling_; }
+};
+
+/** Applies the DivergenceStencil to a linear velocity field with a constant divergence on a stretched mesh, with a
+ * few obstacle cells that have to be left out
+ */
+static void checkDivergenceStencil(int dim) {
+  Parameters parameters;
+  parameters.geometry.dim          = dim;
+  parameters.geometry.sizeX        = 12;
+  parameters.geometry.sizeY        = 9;
+  parameters.geometry.sizeZ        = dim == 3 ? 7 : 1;
+  parameters.geometry.lengthX      = 1.0;
+  parameters.geometry.lengthY      = 0.6;
+  parameters.geometry.lengthZ      = 0.4;
+  parameters.geometry.meshsizeType = TanhStretching;
+  parameters.simulation.scenario   = "cavity";
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.numProcessors[d] = 1;
+  }
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  parameters.meshsize = new TanhMeshStretching(parameters, true, true, dim == 3);
+
+  // u = a x, v = b y and w = c z at the faces, whose divergence is a + b + c in every cell
+  const RealType a = 0.7, b = -1.9, c = dim == 3 ? 0.4 : 0.0;
+  FlowField      flowField(parameters);
+  const int      kBegin = dim == 3 ? 1 : 0;
+  const int      kEnd   = dim == 3 ? flowField.getNz() + 2 : 1;
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 1; j < flowField.getNy() + 2; j++) {
+      for (int i = 1; i < flowField.getNx() + 2; i++) {
+        RealType* const velocity = flowField.getVelocity().getVector(i, j, k);
+        velocity[0]              = a * (parameters.meshsize->getPosX(i, j, k) + parameters.meshsize->getDx(i, j, k));
+        velocity[1]              = b * (parameters.meshsize->getPosY(i, j, k) + parameters.meshsize->getDy(i, j, k));
+        if (dim == 3) {
+          velocity[2] = c * (parameters.meshsize->getPosZ(i, j, k) + parameters.meshsize->getDz(i, j, k));
+        }
+      }
+    }
+  }
+
+  // Obstacle cells keep the linear field, as their faces are shared with fluid cells, and only change the count
+  int fluidCells = flowField.getNx() * flowField.getNy() * (dim == 3 ? flowField.getNz() : 1);
+  for (const int i : {3, 4, 9}) {
+    flowField.getFlags().getValue(i, 5, dim == 3 ? 3 : 0) = OBSTACLE_SELF;
+    fluidCells--;
+  }
+
+  Stencils::DivergenceStencil stencil(parameters);
+  FieldIterator<FlowField>    iterator(flowField, parameters, stencil, 1, 0);
+  iterator.iterate();
+
+  const RealType divergence = a + b + c;
+  CHECK(stencil.getCells() == fluidCells);
+  CHECK(std::abs(stencil.getSum() / stencil.getCells() - divergence * divergence) < 1e-10);
+
+  // The sum starts over after a reset
+  stencil.reset();
+  CHECK(stencil.getSum() == 0.0);
+  CHECK(stencil.getCells() == 0.0);
+  iterator.iterate();
+  CHECK(stencil.getCells() == fluidCells);
+}
+
+/** Feeds the schedule with the divergence floor + slope * scaling * target, i.e., a divergence that follows the
+ * pressure tolerance down to the floor, both relative to the target
+ * @return Scaling of the pressure tolerance after the given number of stages
+ */
+static RealType runSchedule(const std::string& path, RealType floor, RealType slope, int stages, RealType* divergence) {
+  Configuration configuration(path);
+  Parameters    parameters;
+  configuration.loadParameters(parameters);
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  MeshsizeFactory::getInstance().initMeshsize(parameters);
+
+  FlowField          flowField(parameters);
+  ScheduleSimulation simulation(parameters, flowField);
+
+  const RealType target = parameters.solver.divergence;
+  for (int stage = 0; stage < stages; stage++) {
+    *divergence = (floor + slope * simulation.getToleranceScaling()) * target;
+    simulation.updateToleranceScaling(*divergence);
+  }
+  return simulation.getToleranceScaling();
+}
+
+static void checkSchedule() {
+  const std::string path = (std::filesystem::temp_directory_path() / "DivergenceSchedule.xml").string();
+  {
+    std::ofstream file(path);
+    file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+         << "<configuration>\n"
+         << "  <flow Re=\"100\" />\n"
+         << "  <simulation finalTime=\"1\"><type>dns</type><scenario>cavity</scenario></simulation>\n"
+         << "  <timestep dt=\"1\" tau=\"0.5\" />\n"
+         << "  <solver gamma=\"0.5\" type=\"cg\" divergence=\"1e-6\" />\n"
+         << "  <geometry dim=\"2\" lengthX=\"1.0\" lengthY=\"1.0\" lengthZ=\"1.0\" sizeX=\"8\" sizeY=\"8\" sizeZ=\"1\">\n"
+         << "    <mesh>uniform</mesh>\n"
+         << "  </geometry>\n"
+         << "  <environment gx=\"0\" gy=\"0\" gz=\"0\" />\n"
+         << "  <walls>\n"
+         << "    <left><vector x=\"0\" y=\"0\" z=\"0\" /></left>\n"
+         << "    <right><vector x=\"0\" y=\"0\" z=\"0\" /></right>\n"
+         << "    <top><vector x=\"1\" y=\"0\" z=\"0\" /></top>\n"
+         << "    <bottom><vector x=\"0\" y=\"0\" z=\"0\" /></bottom>\n"
+         << "    <front><vector x=\"0\" y=\"0\" z=\"0\" /></front>\n"
+         << "    <back><vector x=\"0\" y=\"0\" z=\"0\" /></back>\n"
+         << "  </walls>\n"
+         << "  <vtk interval=\"1\">DivergenceSchedule</vtk>\n"
+         << "  <stdOut interval=\"1\" />\n"
+         << "  <parallel numProcessorsX=\"1\" numProcessorsY=\"1\" numProcessorsZ=\"1\" />\n"
+         << "</configuration>\n";
+  }
+  RealType divergence = 0.0;
+
+  // Without a floor, the tolerance is tightened until the divergence meets the target
+  RealType scaling = runSchedule(path, 0.0, 10.0, 30, &divergence);
+  CHECK(scaling < 0.2);
+  CHECK(std::abs(divergence / 1e-6 - 1.0) < 0.5);
+
+  // Below the target, the tolerance is relaxed up to the one that would meet the target without correction
+  scaling = runSchedule(path, 0.0, 0.1, 30, &divergence);
+  CHECK(scaling == 1.0);
+
+  // Above the floor of 3 times the target, the divergence stops following the tolerance. The schedule stops close to
+  // where this happens instead of going down to the fixed lower bound, and stays there.
+  scaling = runSchedule(path, 3.0, 10.0, 5, &divergence);
+  CHECK(scaling == 0.25);
+  scaling = runSchedule(path, 3.0, 10.0, 30, &divergence);
+  CHECK(scaling == 0.25);
+  CHECK(std::abs(divergence / 1e-6 - 5.5) < 1e-9);
+
+  // A floor just below the target still lets the divergence come close to it
+  scaling = runSchedule(path, 0.8, 10.0, 30, &divergence);
+  CHECK(divergence < 1.5e-6);
+}
+
+TEST_CASE("Test the divergence stencil and the schedule of the pressure tolerance", "[single-file]") {
+  spdlog::info("Testing the divergence stencil and the schedule of the pressure tolerance");
+
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscInitializeNoArguments();
+#else
+    MPI_Init(nullptr, nullptr);
+#endif
+  }
+
+  for (const int dim : {2, 3}) {
+    INFO(dim << "D");
+    checkDivergenceStencil(dim);
+  }
+  checkSchedule();
+
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscFinalize();
+#else
+    MPI_Finalize();
+#endif
+  }
+
+  spdlog::info("Test for the divergence stencil and the schedule of the pressure tolerance completed successfully");
+}
@@ -0,0 +1,296 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "FlowField.hpp"
+#include "Iterators.hpp"
+#include "Meshsize.hpp"
+#include "Parameters.hpp"
+
+#include "ParallelManagers/PetscParallelConfiguration.hpp"
+#include "Stencils/FGHStencil.hpp"
+#include "Stencils/MeshWeights.hpp"
+#include "Stencils/StencilFunctions.hpp"
+
+/** The generic formulas of the FGH stencil before the kernels were specialised and the mesh weights tabulated. They
+ * gather the local meshsizes of every cell and blend central and donor-cell differences with gamma at runtime. The
+ * debug comparisons with the uniform-mesh formulas are left out, and computeG3D calls dv2dy instead of the misspelled
+ * dSv2dy.
+ */
+namespace Reference {
+
+  using Stencils::mapd;
+
+  // Second derivative of the component c along the axis, with the local meshsizes of that axis (d2udz2, d2vdz2 and
+  // d2wdz2 read dx before the tables)
+  inline RealType d2dx2(const RealType* const lv, const RealType* const lm, int c, int axis) {
+    const int offset[3] = {axis == 0, axis == 1, axis == 2};
+    const int index_u0  = mapd(0, 0, 0, c);
+    const int index_u1  = mapd(-offset[0], -offset[1], -offset[2], c);
+    const int index_u2  = mapd(offset[0], offset[1], offset[2], c);
+    const int index_x0  = mapd(0, 0, 0, axis);
+    const int index_x2  = mapd(offset[0], offset[1], offset[2], axis);
+    return 2
+           * ((lv[index_u2]) / (lm[index_x2] * (lm[index_x2] + lm[index_x0])) - (lv[index_u0]) / (lm[index_x0] * lm[index_x2])
+              + (lv[index_u1]) / (lm[index_x0] * (lm[index_x0] + lm[index_x2])));
+  }
+
+  /** First derivative along the axis of the product of the component c along the axis and the component t, evaluated
+   * at the location of t. This is the common form of duvdx, duvdy, duwdx, duwdz, dvwdy and dvwdz.
+   */
+  inline RealType dmixed(const RealType* const lv, const Parameters& parameters, const RealType* const lm, int axis, int t) {
+    const int a[3] = {axis == 0, axis == 1, axis == 2};
+    const int b[3] = {t == 0, t == 1, t == 2};
+
+    const RealType hxShort = 0.5 * lm[mapd(0, 0, 0, axis)];
+    const RealType hxLong0 = 0.5 * (lm[mapd(0, 0, 0, axis)] + lm[mapd(-a[0], -a[1], -a[2], axis)]);
+    const RealType hxLong1 = 0.5 * (lm[mapd(0, 0, 0, axis)] + lm[mapd(a[0], a[1], a[2], axis)]);
+    const RealType hyShort = 0.5 * lm[mapd(0, 0, 0, t)];
+    const RealType hyLong  = 0.5 * (lm[mapd(0, 0, 0, t)] + lm[mapd(b[0], b[1], b[2], t)]);
+
+    const RealType u00 = lv[mapd(0, 0, 0, axis)];
+    const RealType u01 = lv[mapd(b[0], b[1], b[2], axis)];
+    const RealType v00 = lv[mapd(0, 0, 0, t)];
+    const RealType v10 = lv[mapd(a[0], a[1], a[2], t)];
+
+    const RealType uM10 = lv[mapd(-a[0], -a[1], -a[2], axis)];
+    const RealType uM11 = lv[mapd(b[0] - a[0], b[1] - a[1], b[2] - a[2], axis)];
+    const RealType vM10 = lv[mapd(-a[0], -a[1], -a[2], t)];
+
+    const RealType secondOrder = (((hyLong - hyShort) / hyLong * u00 + hyShort / hyLong * u01)
+                                    * ((hxLong1 - hxShort) / hxLong1 * v00 + hxShort / hxLong1 * v10)
+                                  - ((hyLong - hyShort) / hyLong * uM10 + hyShort / hyLong * uM11)
+                                      * ((hxLong0 - hxShort) / hxLong0 * v00 + hxShort / hxLong0 * vM10))
+                                 / (2.0 * hxShort);
+
+    const RealType kr = (hyLong - hyShort) / hyLong * u00 + hyShort / hyLong * u01;
+    const RealType kl = (hyLong - hyShort) / hyLong * uM10 + hyShort / hyLong * uM11;
+
+    const RealType firstOrder = 1.0 / (4.0 * hxShort)
+                                * (kr * (v00 + v10) - kl * (vM10 + v00) + fabs(kr) * (v00 - v10) - fabs(kl) * (vM10 - v00));
+
+    return (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+  }
+
+  // First derivative of the square of the component c along its own axis, the common form of du2dx, dv2dy and dw2dz
+  inline RealType dsquare(const RealType* const lv, const Parameters& parameters, const RealType* const lm, int c) {
+    const int a[3] = {c == 0, c == 1, c == 2};
+
+    const RealType dxShort = 0.5 * lm[mapd(0, 0, 0, c)];
+    const RealType dxLong1 = 0.5 * (lm[mapd(0, 0, 0, c)] + lm[mapd(a[0], a[1], a[2], c)]);
+
+    const RealType u0  = lv[mapd(0, 0, 0, c)];
+    const RealType uM1 = lv[mapd(-a[0], -a[1], -a[2], c)];
+    const RealType u1  = lv[mapd(a[0], a[1], a[2], c)];
+
+    const RealType kr = (u0 + u1) / 2;
+    const RealType kl = (u0 + uM1) / 2;
+
+    const RealType secondOrder = ((u0 + u1) * (u0 + u1) - (u0 + uM1) * (u0 + uM1)) / (4 * dxLong1);
+
+    const RealType firstOrder = 1.0 / (4.0 * dxShort)
+                                * (kr * (u0 + u1) - kl * (uM1 + u0) + fabs(kr) * (u0 - u1) - fabs(kl) * (uM1 - u0));
+
+    return (1.0 - parameters.solver.gamma) * secondOrder + parameters.solver.gamma * firstOrder;
+  }
+
+  // Predictor of the component c, i.e., computeF2D/3D for c = 0, computeG2D/3D for c = 1 and computeH3D for c = 2
+  inline RealType computeFGH(const RealType* const lv, const RealType* const lm, const Parameters& parameters, RealType dt, int c) {
+    const int      dim        = parameters.geometry.dim;
+    const RealType gravity[3] = {parameters.environment.gx, parameters.environment.gy, parameters.environment.gz};
+
+    RealType convection = -dsquare(lv, parameters, lm, c);
+    RealType viscosity  = 0.0;
+    for (int axis = 0; axis < dim; axis++) {
+      viscosity += d2dx2(lv, lm, c, axis);
+    }
+    if (c == 1) {
+      convection -= dmixed(lv, parameters, lm, 0, 1);
+      if (dim == 3) {
+        convection -= dmixed(lv, parameters, lm, 2, 1);
+      }
+    } else if (c == 0) {
+      convection -= dmixed(lv, parameters, lm, 1, 0);
+      if (dim == 3) {
+        convection -= dmixed(lv, parameters, lm, 2, 0);
+      }
+    } else {
+      convection -= dmixed(lv, parameters, lm, 0, 2);
+      convection -= dmixed(lv, parameters, lm, 1, 2);
+    }
+    return lv[mapd(0, 0, 0, c)] + dt * (convection + 1 / parameters.flow.Re * viscosity + gravity[c]);
+  }
+
+} // namespace Reference
+
+static bool isClose(RealType value, RealType expected, RealType tolerance) {
+  return std::abs(value - expected) <= tolerance * std::max<RealType>(1.0, std::abs(expected));
+}
+
+static void setUpParameters(Parameters& parameters, int dim, RealType gamma, bool gravity) {
+  parameters.geometry.dim          = dim;
+  parameters.geometry.sizeX        = 10;
+  parameters.geometry.sizeY        = 8;
+  parameters.geometry.sizeZ        = dim == 3 ? 6 : 1;
+  parameters.geometry.lengthX      = 1.0;
+  parameters.geometry.lengthY      = 0.7;
+  parameters.geometry.lengthZ      = 0.5;
+  parameters.simulation.scenario   = "cavity";
+  parameters.flow.Re               = 37.0;
+  parameters.solver.gamma          = gamma;
+  parameters.timestep.dt           = 1.3e-3;
+  parameters.environment.gx        = gravity ? -0.3 : 0.0;
+  parameters.environment.gy        = gravity ? -9.81 : 0.0;
+  parameters.environment.gz        = gravity ? 0.2 : 0.0;
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.numProcessors[d] = 1;
+  }
+}
+
+/** Compares the tables of MeshWeights with the distances and ratios that the generic formulas compute from the local
+ * meshsizes, for every cell whose neighbours exist, ghost layers included
+ * @return Number of weights that differ by more than rounding
+ */
+static int getMeshWeightMismatches(const Parameters& parameters, const FlowField& flowField) {
+  const Stencils::MeshWeights weights(parameters);
+  const int                   dim     = parameters.geometry.dim;
+  const int                   size[3] = {flowField.getNx(), flowField.getNy(), dim == 3 ? flowField.getNz() : 0};
+  RealType                    lm[27 * 3];
+
+  int mismatches = 0;
+  for (int axis = 0; axis < dim; axis++) {
+    for (int n = 1; n < size[axis] + 2; n++) {
+      // The cell n along the axis and an inner cell along the others
+      const int index[3] = {axis == 0 ? n : 2, axis == 1 ? n : 2, axis == 2 ? n : 2};
+      if (dim == 2) {
+        Stencils::loadLocalMeshsize2D(parameters, lm, index[0], index[1]);
+      } else {
+        Stencils::loadLocalMeshsize3D(parameters, lm, index[0], index[1], index[2]);
+      }
+      const int      a[3]   = {axis == 0, axis == 1, axis == 2};
+      const RealType hM1    = lm[Stencils::mapd(-a[0], -a[1], -a[2], axis)];
+      const RealType h0     = lm[Stencils::mapd(0, 0, 0, axis)];
+      const RealType hP1    = lm[Stencils::mapd(a[0], a[1], a[2], axis)];
+      const RealType hShort = 0.5 * h0;
+      const RealType hLong0 = 0.5 * (h0 + hM1);
+      const RealType hLong1 = 0.5 * (h0 + hP1);
+
+      const Stencils::AxisWeights& w = axis == 0 ? weights.getX(n) : (axis == 1 ? weights.getY(n) : weights.getZ(n));
+      const RealType expected[] = {
+        hShort / hLong0,
+        (hLong0 - hShort) / hLong0,
+        (hLong1 - hShort) / hLong1,
+        hShort / hLong1,
+        1.0 / (2.0 * hShort),
+        1.0 / hLong1,
+        2.0 / (h0 * (h0 + hP1)),
+        -2.0 / (h0 * hP1),
+        2.0 / (hP1 * (hP1 + h0))};
+      const RealType values[] = {
+        w.lower[0], w.upper[0], w.lower[1], w.upper[1], w.inverseSpacing, w.inverseCentreDistance, w.laplace[0], w.laplace[1], w.laplace[2]};
+      for (std::size_t m = 0; m < std::size(values); m++) {
+        mismatches += !isClose(values[m], expected[m], 1e-13);
+      }
+    }
+  }
+  return mismatches;
+}
+
+/** Compares the specialised FGH kernels and the tables of mesh weights with the generic formulas, on random
+ * velocities, for the limits and a blend of the convection schemes, with and without gravity and on uniform and
+ * stretched meshes. Only rounding may differ, as the weights are evaluated in a different order.
+ */
+static void checkGenericFormulas() {
+  for (const int dim : {2, 3}) {
+    for (const MeshsizeType meshsizeType : {Uniform, TanhStretching}) {
+      for (const RealType gamma : {0.0, 0.5, 1.0}) {
+        for (const bool gravity : {false, true}) {
+          INFO(dim << "D " << (meshsizeType == Uniform ? "uniform" : "stretched") << " mesh gamma " << gamma << (gravity ? " with" : " without") << " gravity");
+          Parameters parameters;
+          setUpParameters(parameters, dim, gamma, gravity);
+          parameters.geometry.meshsizeType = meshsizeType;
+          const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+          if (meshsizeType == Uniform) {
+            parameters.meshsize = new UniformMeshsize(parameters);
+          } else {
+            parameters.meshsize = new TanhMeshStretching(parameters, true, true, dim == 3);
+          }
+
+          FlowField    flowField(parameters);
+          VectorField& velocity = flowField.getVelocity();
+          std::mt19937 generator(dim * 1000 + meshsizeType * 100 + static_cast<int>(10 * gamma) + gravity);
+          std::uniform_real_distribution<RealType> distribution(-1.0, 1.0);
+          for (int k = 0; k < (dim == 3 ? flowField.getNz() + 3 : 1); k++) {
+            for (int j = 0; j < flowField.getNy() + 3; j++) {
+              for (int i = 0; i < flowField.getNx() + 3; i++) {
+                for (int d = 0; d < dim; d++) {
+                  velocity.getVector(i, j, k)[d] = distribution(generator);
+                }
+              }
+            }
+          }
+
+          CHECK(getMeshWeightMismatches(parameters, flowField) == 0);
+
+          Stencils::FGHStencil     stencil(parameters);
+          FieldIterator<FlowField> iterator(flowField, parameters, stencil);
+          iterator.iterate();
+
+          RealType  lv[27 * 3];
+          RealType  lm[27 * 3];
+          int       mismatches = 0;
+          RealType  maxError   = 0.0;
+          const int kBegin     = dim == 3 ? 2 : 0;
+          const int kEnd       = dim == 3 ? flowField.getNz() + 2 : 1;
+          for (int k = kBegin; k < kEnd; k++) {
+            for (int j = 2; j < flowField.getNy() + 2; j++) {
+              for (int i = 2; i < flowField.getNx() + 2; i++) {
+                if (dim == 2) {
+                  Stencils::loadLocalVelocity2D(flowField, lv, i, j);
+                  Stencils::loadLocalMeshsize2D(parameters, lm, i, j);
+                } else {
+                  Stencils::loadLocalVelocity3D(flowField, lv, i, j, k);
+                  Stencils::loadLocalMeshsize3D(parameters, lm, i, j, k);
+                }
+                const RealType* const values = flowField.getFGH().getVector(i, j, k);
+                for (int d = 0; d < dim; d++) {
+                  const RealType expected = Reference::computeFGH(lv, lm, parameters, parameters.timestep.dt, d);
+                  maxError                = std::max(maxError, std::abs(values[d] - expected));
+                  mismatches += !isClose(values[d], expected, 1e-12);
+                }
+              }
+            }
+          }
+          INFO("largest difference " << maxError);
+          CHECK(mismatches == 0);
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Test the FGH kernels against the generic formulas", "[single-file]") {
+  spdlog::info("Testing the FGH kernels against the generic formulas");
+
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscInitializeNoArguments();
+#else
+    MPI_Init(nullptr, nullptr);
+#endif
+  }
+
+  checkGenericFormulas();
+
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscFinalize();
+#else
+    MPI_Finalize();
+#endif
+  }
+
+  spdlog::info("Test for the FGH kernels against the generic formulas completed successfully");
+}
@@ -0,0 +1,42 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "Solvers/FourierTransform.hpp"
+
+using Solvers::FourierTransform;
+
+TEST_CASE("Test Fourier transform against the definition", "[single-file]") {
+  spdlog::info("Testing Fourier transform");
+
+  // Powers of two use the radix-2 transform, the other lengths Bluestein's algorithm
+  for (const int size : {1, 8, 12, 15, 64}) {
+    std::vector<FourierTransform::Complex> input(size);
+    for (int n = 0; n < size; n++) {
+      input[n] = FourierTransform::Complex(sin(0.3 * n + 0.1), cos(1.7 * n * n));
+    }
+
+    std::vector<FourierTransform::Complex> expected(size, FourierTransform::Complex(0.0, 0.0));
+    for (int k = 0; k < size; k++) {
+      for (int n = 0; n < size; n++) {
+        const double angle = -2.0 * M_PI * static_cast<double>((k * n) % size) / size;
+        expected[k] += input[n] * FourierTransform::Complex(cos(angle), sin(angle));
+      }
+    }
+
+    FourierTransform                       transform(size);
+    std::vector<FourierTransform::Complex> data = input;
+    transform.forward(data.data());
+    for (int k = 0; k < size; k++) {
+      REQUIRE_THAT(data[k].real(), Catch::Matchers::WithinAbs(expected[k].real(), 1e-10));
+      REQUIRE_THAT(data[k].imag(), Catch::Matchers::WithinAbs(expected[k].imag(), 1e-10));
+    }
+
+    transform.backward(data.data());
+    for (int n = 0; n < size; n++) {
+      REQUIRE_THAT(data[n].real() / size, Catch::Matchers::WithinAbs(input[n].real(), 1e-12));
+      REQUIRE_THAT(data[n].imag() / size, Catch::Matchers::WithinAbs(input[n].imag(), 1e-12));
+    }
+  }
+}
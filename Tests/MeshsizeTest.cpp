@@ -0,0 +1,99 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "Meshsize.hpp"
+#include "Parameters.hpp"
+
+constexpr auto SIZE_X = 12;
+constexpr auto SIZE_Y = 8;
+
+TEST_CASE("Test mesh read from file", "[single-file]") {
+  spdlog::info("Testing mesh read from file");
+
+  Parameters parameters;
+  parameters.geometry.dim     = 2;
+  parameters.geometry.sizeX   = SIZE_X;
+  parameters.geometry.sizeY   = SIZE_Y;
+  parameters.geometry.sizeZ   = 1;
+  parameters.geometry.lengthX = 1.0;
+  parameters.geometry.lengthY = 2.0;
+  parameters.geometry.lengthZ = 1.0;
+
+  parameters.parallel.localSize[0] = SIZE_X;
+  parameters.parallel.localSize[1] = SIZE_Y;
+  parameters.parallel.localSize[2] = 1;
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.firstCorner[d] = 0;
+  }
+
+  // Write the nodes of the tanh-stretched mesh in x, y stays uniform
+  TanhMeshStretching tanhMesh(parameters, true, false, false);
+
+  parameters.geometry.meshFile = (std::filesystem::temp_directory_path() / "NS-EOF-MeshsizeTest.mesh").string();
+  {
+    std::ofstream file(parameters.geometry.meshFile);
+    file << "# Stretched in x" << std::endl << "x" << std::endl;
+    file << std::setprecision(17);
+    for (int i = 2; i < SIZE_X + 2; i++) {
+      file << tanhMesh.getPosX(i, 2) << std::endl;
+    }
+    file << parameters.geometry.lengthX << std::endl;
+  }
+
+  FileMeshsize fileMesh(parameters);
+  std::filesystem::remove(parameters.geometry.meshFile);
+
+  for (int i = 0; i < SIZE_X + 4; i++) {
+    REQUIRE_THAT(fileMesh.getDx(i, 2), Catch::Matchers::WithinRel(tanhMesh.getDx(i, 2), 1e-12));
+    REQUIRE_THAT(fileMesh.getPosX(i, 2), Catch::Matchers::WithinAbs(tanhMesh.getPosX(i, 2), 1e-12));
+  }
+  for (int j = 0; j < SIZE_Y + 4; j++) {
+    REQUIRE_THAT(fileMesh.getDy(2, j), Catch::Matchers::WithinRel(0.25, 1e-12));
+  }
+  REQUIRE_THAT(fileMesh.getDxMin(), Catch::Matchers::WithinRel(tanhMesh.getDxMin(), 1e-12));
+  REQUIRE_THAT(fileMesh.getDyMin(), Catch::Matchers::WithinRel(0.25, 1e-12));
+
+  spdlog::info("Test for mesh read from file completed successfully");
+}
+
+TEST_CASE("Test mesh of a subdomain", "[single-file]") {
+  spdlog::info("Testing mesh of a subdomain");
+
+  Parameters parameters;
+  parameters.geometry.dim     = 2;
+  parameters.geometry.sizeX   = SIZE_X;
+  parameters.geometry.sizeY   = SIZE_Y;
+  parameters.geometry.sizeZ   = 1;
+  parameters.geometry.lengthX = 1.0;
+  parameters.geometry.lengthY = 2.0;
+  parameters.geometry.lengthZ = 1.0;
+
+  parameters.parallel.localSize[0] = SIZE_X;
+  parameters.parallel.localSize[1] = SIZE_Y;
+  parameters.parallel.localSize[2] = 1;
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.firstCorner[d] = 0;
+  }
+  TanhMeshStretching globalMesh(parameters, true, true, false);
+
+  // Upper right quarter of the domain, the ghost layers reach into the neighbouring subdomains
+  parameters.parallel.localSize[0]   = SIZE_X / 2;
+  parameters.parallel.localSize[1]   = SIZE_Y / 2;
+  parameters.parallel.firstCorner[0] = SIZE_X / 2;
+  parameters.parallel.firstCorner[1] = SIZE_Y / 2;
+  TanhMeshStretching localMesh(parameters, true, true, false);
+
+  for (int i = -2; i < SIZE_X / 2 + 4; i++) {
+    REQUIRE_THAT(localMesh.getDx(i, 2), Catch::Matchers::WithinRel(globalMesh.getDx(i + SIZE_X / 2, 2), 1e-12));
+    REQUIRE_THAT(localMesh.getPosX(i, 2), Catch::Matchers::WithinAbs(globalMesh.getPosX(i + SIZE_X / 2, 2), 1e-12));
+  }
+  for (int j = -2; j < SIZE_Y / 2 + 4; j++) {
+    REQUIRE_THAT(localMesh.getDy(2, j), Catch::Matchers::WithinRel(globalMesh.getDy(2, j + SIZE_Y / 2), 1e-12));
+    REQUIRE_THAT(localMesh.getPosY(2, j), Catch::Matchers::WithinAbs(globalMesh.getPosY(2, j + SIZE_Y / 2), 1e-12));
+  }
+  REQUIRE_THAT(localMesh.getDxMin(), Catch::Matchers::WithinRel(globalMesh.getDxMin(), 1e-12));
+
+  spdlog::info("Test for mesh of a subdomain completed successfully");
+}
@@ -0,0 +1,141 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "FlowField.hpp"
+#include "Parameters.hpp"
+
+#include "ParallelManagers/PetscParallelConfiguration.hpp"
+#include "ParallelManagers/PetscParallelManager.hpp"
+
+// Uneven sizes, so that the subdomains differ in size
+constexpr int SIZES[3] = {7, 6, 5};
+
+// Value of a component of a quantity in the cell with the given global indices
+static RealType getExpected(const int global[3], int component) {
+  return 1.0 + global[0] + 100.0 * global[1] + 10000.0 * global[2] + 0.25 * component;
+}
+
+/** Fills the inner cells with a function of the global indices, exchanges the ghost layers and compares them
+ *
+ * Ghost cells outside the domain are only checked on periodic axes that are split between processes, the others are
+ * left to the boundary iterators.
+ * @return Number of wrong values
+ */
+static int checkExchange(int dim, const std::string& scenario) {
+  int processes;
+  MPI_Comm_size(PETSC_COMM_WORLD, &processes);
+
+  Parameters parameters;
+  parameters.geometry.dim        = dim;
+  parameters.geometry.sizeX      = SIZES[0];
+  parameters.geometry.sizeY      = SIZES[1];
+  parameters.geometry.sizeZ      = SIZES[2];
+  parameters.simulation.scenario = scenario;
+
+  int numProcessors[3] = {0, 0, dim == 3 ? 0 : 1};
+  MPI_Dims_create(processes, dim, numProcessors);
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.numProcessors[d] = numProcessors[d];
+  }
+
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  FlowField                                          flowField(parameters);
+  ParallelManagers::PetscParallelManager             parallelManager(parameters, flowField);
+
+  const bool periodic = scenario == "periodic-box";
+  const int  cells[3] = {flowField.getCellsX(), flowField.getCellsY(), dim == 3 ? flowField.getCellsZ() : 1};
+
+  // Global indices of a cell, false if the cell is not filled by the exchange
+  auto getGlobal = [&](int i, int j, int k, int global[3], bool& inner) {
+    const int local[3] = {i, j, k};
+    inner              = true;
+    for (int d = 0; d < dim; d++) {
+      global[d] = parameters.parallel.firstCorner[d] + local[d] - 2;
+      inner     = inner && local[d] >= 2 && local[d] < parameters.parallel.localSize[d] + 2;
+      if (global[d] < 0 || global[d] >= SIZES[d]) {
+        if (!periodic || numProcessors[d] == 1) {
+          return false;
+        }
+        global[d] = (global[d] + SIZES[d]) % SIZES[d];
+      }
+    }
+    if (dim == 2) {
+      global[2] = 0;
+    }
+    return true;
+  };
+
+  for (int k = 0; k < cells[2]; k++) {
+    for (int j = 0; j < cells[1]; j++) {
+      for (int i = 0; i < cells[0]; i++) {
+        int        global[3];
+        bool       inner;
+        const bool exchanged = getGlobal(i, j, k, global, inner);
+        for (int component = 0; component < dim; component++) {
+          const RealType value = exchanged && inner ? getExpected(global, component) : -1.0;
+          if (component == 0) {
+            flowField.getPressure().getScalar(i, j, k) = value;
+          }
+          flowField.getVelocity().getVector(i, j, k)[component] = value;
+          flowField.getFGH().getVector(i, j, k)[component]      = -value;
+        }
+      }
+    }
+  }
+
+  parallelManager.communicatePressure();
+  parallelManager.communicateVelocity();
+  parallelManager.communicateFGH();
+
+  int errors = 0;
+  for (int k = 0; k < cells[2]; k++) {
+    for (int j = 0; j < cells[1]; j++) {
+      for (int i = 0; i < cells[0]; i++) {
+        int  global[3];
+        bool inner;
+        if (!getGlobal(i, j, k, global, inner)) {
+          continue;
+        }
+        errors += flowField.getPressure().getScalar(i, j, k) != getExpected(global, 0);
+        for (int component = 0; component < dim; component++) {
+          errors += flowField.getVelocity().getVector(i, j, k)[component] != getExpected(global, component);
+          errors += flowField.getFGH().getVector(i, j, k)[component] != -getExpected(global, component);
+        }
+      }
+    }
+  }
+  return errors;
+}
+
+// Meaningful with several processes, e.g. mpirun -np 4, see Tests/CMakeLists.txt
+TEST_CASE("Test the exchange of ghost layers", "[single-file]") {
+  spdlog::info("Testing the parallel manager");
+
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscInitializeNoArguments();
+#else
+    MPI_Init(nullptr, nullptr);
+#endif
+  }
+
+  for (const int dim : {2, 3}) {
+    for (const std::string scenario : {"cavity", "periodic-box"}) {
+      INFO(dim << "D " << scenario);
+      CHECK(checkExchange(dim, scenario) == 0);
+    }
+  }
+
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscFinalize();
+#else
+    MPI_Finalize();
+#endif
+  }
+
+  spdlog::info("Test for the parallel manager completed successfully");
+}
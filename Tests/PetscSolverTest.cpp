@@ -0,0 +1,663 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "Configuration.hpp"
+#include "FlowField.hpp"
+#include "Meshsize.hpp"
+#include "MeshsizeFactory.hpp"
+#include "Parameters.hpp"
+#include "Simulation.hpp"
+
+#include "ParallelManagers/PetscParallelConfiguration.hpp"
+#include "Solvers/PetscSolver.hpp"
+
+#ifdef ENABLE_PETSC
+
+// Exposes the autotuner and its cache
+class TunedSolver: public Solvers::PetscSolver {
+public:
+  using Solvers::PetscSolver::PetscSolver;
+  using Solvers::PetscSolver::getCacheKey;
+  using Solvers::PetscSolver::readCache;
+  using Solvers::PetscSolver::tune;
+};
+
+// Global inner cells of the obstacle, a block away from the walls and from the periodic ends
+static bool isObstacle(int dim, int i, int j, int k) { return i >= 4 && i <= 6 && j >= 3 && j <= 5 && (dim == 2 || (k >= 2 && k <= 4)); }
+
+/** A small stretched grid, split along x between the processes. typeX selects the walls along x: DIRICHLET for a
+ * cavity, in which the pressure is only defined up to a constant, NEUMANN for an outflow on the right and PERIODIC
+ * for periodic ends along x, and along z in 3D. The caller sets up the parallel configuration and the meshsize.
+ */
+static void setUpParameters(Parameters& parameters, int dim, BoundaryType typeX) {
+  int commSize;
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+
+  parameters.geometry.dim          = dim;
+  parameters.geometry.sizeX        = 12;
+  parameters.geometry.sizeY        = 10;
+  parameters.geometry.sizeZ        = dim == 3 ? 8 : 1;
+  parameters.geometry.lengthX      = 1.0;
+  parameters.geometry.lengthY      = 0.8;
+  parameters.geometry.lengthZ      = 0.6;
+  parameters.geometry.meshsizeType = TanhStretching;
+  parameters.simulation.scenario   = "cavity";
+
+  parameters.parallel.numProcessors[0] = commSize;
+  parameters.parallel.numProcessors[1] = 1;
+  parameters.parallel.numProcessors[2] = 1;
+
+  const bool periodic         = typeX == PERIODIC;
+  parameters.walls.typeLeft   = periodic ? PERIODIC : DIRICHLET;
+  parameters.walls.typeRight  = typeX;
+  parameters.walls.typeBottom = DIRICHLET;
+  parameters.walls.typeTop    = DIRICHLET;
+  parameters.walls.typeFront  = periodic && dim == 3 ? PERIODIC : DIRICHLET;
+  parameters.walls.typeBack   = periodic && dim == 3 ? PERIODIC : DIRICHLET;
+}
+
+static Meshsize* createMeshsize(Parameters& parameters) {
+  const bool periodic = parameters.walls.typeLeft == PERIODIC;
+  return new TanhMeshStretching(parameters, !periodic, true, parameters.geometry.dim == 3 && !periodic);
+}
+
+// Flags the obstacle, also in the ghost layers of the subdomain, together with the obstacle bits of the neighbours
+static void setObstacle(const Parameters& parameters, FlowField& flowField) {
+  const int  dim    = parameters.geometry.dim;
+  const int* first  = parameters.parallel.firstCorner;
+  const auto global = [&](int i, int j, int k) { return isObstacle(dim, i - 2 + first[0], j - 2 + first[1], k - 2 + first[2]); };
+
+  IntScalarField& flags = flowField.getFlags();
+  for (int k = 0; k < (dim == 3 ? flowField.getNz() + 3 : 1); k++) {
+    for (int j = 0; j < flowField.getNy() + 3; j++) {
+      for (int i = 0; i < flowField.getNx() + 3; i++) {
+        int flag = 0;
+        if (global(i, j, k)) {
+          flag = OBSTACLE_SELF;
+          flag += global(i - 1, j, k) ? OBSTACLE_LEFT : 0;
+          flag += global(i + 1, j, k) ? OBSTACLE_RIGHT : 0;
+          flag += global(i, j - 1, k) ? OBSTACLE_BOTTOM : 0;
+          flag += global(i, j + 1, k) ? OBSTACLE_TOP : 0;
+          if (dim == 3) {
+            flag += global(i, j, k - 1) ? OBSTACLE_FRONT : 0;
+            flag += global(i, j, k + 1) ? OBSTACLE_BACK : 0;
+          }
+        }
+        flags.getValue(i, j, k) = flag;
+      }
+    }
+  }
+}
+
+// Owned part of a DMDA vector or, with ghosts, of a local vector, indexed by the global node indices
+struct NodeRange {
+  PetscInt first[3], length[3];
+
+  NodeRange(DM grid, bool ghosts) {
+    if (ghosts) {
+      DMDAGetGhostCorners(grid, &first[0], &first[1], &first[2], &length[0], &length[1], &length[2]);
+    } else {
+      DMDAGetCorners(grid, &first[0], &first[1], &first[2], &length[0], &length[1], &length[2]);
+    }
+  }
+
+  PetscInt operator()(PetscInt i, PetscInt j, PetscInt k) const {
+    return i - first[0] + length[0] * (j - first[1] + length[1] * (k - first[2]));
+  }
+};
+
+/** Applies the rows of the inner nodes as given by the PressureOperator to x and compares them with y
+ * @return Largest difference, relative to the largest product of a coefficient and an entry of x
+ */
+static RealType getOperatorError(const Parameters& parameters, FlowField& flowField, DM grid, Vec x, Vec y) {
+  const int dim = parameters.geometry.dim;
+
+  Solvers::PressureOperator pressureOperator(parameters);
+  pressureOperator.update(flowField.getFlags());
+
+  const PetscInt sizes[3] = {parameters.geometry.sizeX + 2, parameters.geometry.sizeY + 2, dim == 3 ? parameters.geometry.sizeZ + 2 : 1};
+  const auto     inner    = [&](int axis, PetscInt n) { return (axis == 2 && dim == 2) || (n > 0 && n < sizes[axis] - 1); };
+
+  Vec local;
+  DMGetLocalVector(grid, &local);
+  DMGlobalToLocalBegin(grid, x, INSERT_VALUES, local);
+  DMGlobalToLocalEnd(grid, x, INSERT_VALUES, local);
+
+  const PetscScalar* in;
+  const PetscScalar* out;
+  VecGetArrayRead(local, &in);
+  VecGetArrayRead(y, &out);
+  const NodeRange owned(grid, false), ghosted(grid, true);
+
+  RealType error = 0.0, scale = 0.0;
+  for (PetscInt k = owned.first[2]; k < owned.first[2] + owned.length[2]; k++) {
+    for (PetscInt j = owned.first[1]; j < owned.first[1] + owned.length[1]; j++) {
+      for (PetscInt i = owned.first[0]; i < owned.first[0] + owned.length[0]; i++) {
+        if (!inner(0, i) || !inner(1, j) || !inner(2, k)) {
+          continue;
+        }
+        // Node n of the DMDA is the local cell n + 1 of the flow field on the first process of the axis
+        const int cellX = static_cast<int>(i) + 1 - parameters.parallel.firstCorner[0];
+        const int cellY = static_cast<int>(j) + 1 - parameters.parallel.firstCorner[1];
+        const int cellZ = dim == 3 ? static_cast<int>(k) + 1 - parameters.parallel.firstCorner[2] : 0;
+
+        RealType                                      coefficients[7] = {};
+        const Solvers::PressureOperator::ObstacleRow* obstacle        = pressureOperator.findObstacleRow(cellX, cellY, cellZ);
+        if (obstacle != nullptr) {
+          std::copy(obstacle->values, obstacle->values + 7, coefficients);
+        } else {
+          const int cells[3] = {cellX, cellY, cellZ};
+          for (int axis = 0; axis < dim; axis++) {
+            coefficients[2 * axis]     = pressureOperator.getLower(axis)[cells[axis]];
+            coefficients[2 * axis + 1] = pressureOperator.getUpper(axis)[cells[axis]];
+          }
+          coefficients[Solvers::PressureOperator::Centre] = dim == 3 ? pressureOperator.getCentre(cellX, cellY, cellZ) : pressureOperator.getCentre(cellX, cellY);
+        }
+
+        const PetscInt neighbours[7] = {
+          ghosted(i - 1, j, k),
+          ghosted(i + 1, j, k),
+          ghosted(i, j - 1, k),
+          ghosted(i, j + 1, k),
+          dim == 3 ? ghosted(i, j, k - 1) : 0,
+          dim == 3 ? ghosted(i, j, k + 1) : 0,
+          ghosted(i, j, k)};
+        RealType expected = 0.0;
+        for (int n = 0; n < 7; n++) {
+          expected += coefficients[n] * in[neighbours[n]];
+          scale = std::max(scale, std::abs(coefficients[n] * in[neighbours[n]]));
+        }
+        error = std::max(error, std::abs(out[owned(i, j, k)] - expected));
+      }
+    }
+  }
+
+  VecRestoreArrayRead(y, &out);
+  VecRestoreArrayRead(local, &in);
+  DMRestoreLocalVector(grid, &local);
+
+  MPI_Allreduce(MPI_IN_PLACE, &error, 1, MY_MPI_FLOAT, MPI_MAX, PETSC_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, &scale, 1, MY_MPI_FLOAT, MPI_MAX, PETSC_COMM_WORLD);
+  return error / scale;
+}
+
+// The assembled matrix has the rows of the PressureOperator on a stretched mesh with an obstacle
+static void checkAssembledOperator(int dim) {
+  Parameters parameters;
+  setUpParameters(parameters, dim, NEUMANN);
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  parameters.meshsize = createMeshsize(parameters);
+
+  FlowField flowField(parameters);
+  setObstacle(parameters, flowField);
+  Solvers::PetscSolver solver(flowField, parameters);
+  // As after the initialisation of the flags in the simulation, the next solve assembles the operator
+  solver.reInitMatrix();
+  solver.solve();
+
+  Mat A;
+  Vec x, y;
+  KSPGetOperators(solver.getKrylovSolver(), &A, PETSC_NULLPTR);
+  DMCreateGlobalVector(solver.getGrid(), &x);
+  VecDuplicate(x, &y);
+  VecSetRandom(x, PETSC_NULLPTR);
+  MatMult(A, x, y);
+
+  CHECK(getOperatorError(parameters, flowField, solver.getGrid(), x, y) < 1e-13);
+
+  VecDestroy(&x);
+  VecDestroy(&y);
+}
+
+/** The shell of the matrix-free mode applies the same operator as the assembled matrix, on all rows including the
+ * boundaries, the edges and the ghost nodes of periodic axes, and has the same diagonal
+ */
+static void checkMatrixFree(int dim, BoundaryType typeX) {
+  // The solvers keep a reference to their parameters, which own the meshsize
+  Parameters parameters, shellParameters;
+  setUpParameters(parameters, dim, typeX);
+  setUpParameters(shellParameters, dim, typeX);
+  shellParameters.solver.matrixFree = 1;
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  const ParallelManagers::PetscParallelConfiguration shellParallelConfiguration(shellParameters);
+  parameters.meshsize      = createMeshsize(parameters);
+  shellParameters.meshsize = createMeshsize(shellParameters);
+
+  FlowField flowField(parameters);
+  setObstacle(parameters, flowField);
+  Solvers::PetscSolver solver(flowField, parameters);
+  Solvers::PetscSolver shellSolver(flowField, shellParameters);
+  solver.reInitMatrix();
+  shellSolver.reInitMatrix();
+  solver.solve();
+
+  Mat A, shell;
+  KSPGetOperators(solver.getKrylovSolver(), &A, PETSC_NULLPTR);
+  KSPGetOperators(shellSolver.getKrylovSolver(), &shell, PETSC_NULLPTR);
+
+  // Both grids have the same layout, but each operator works on the vectors of its own grid
+  Vec x, y, shellX, shellY;
+  DMCreateGlobalVector(solver.getGrid(), &x);
+  DMCreateGlobalVector(shellSolver.getGrid(), &shellX);
+  VecDuplicate(x, &y);
+  VecDuplicate(shellX, &shellY);
+  VecSetRandom(x, PETSC_NULLPTR);
+  VecCopy(x, shellX);
+
+  PetscReal size, difference;
+  MatMult(A, x, y);
+  MatMult(shell, shellX, shellY);
+  VecAXPY(shellY, -1.0, y);
+  VecNorm(y, NORM_INFINITY, &size);
+  VecNorm(shellY, NORM_INFINITY, &difference);
+  CHECK(difference <= 1e-13 * size);
+
+  MatGetDiagonal(A, y);
+  MatGetDiagonal(shell, shellY);
+  VecAXPY(shellY, -1.0, y);
+  VecNorm(y, NORM_INFINITY, &size);
+  VecNorm(shellY, NORM_INFINITY, &difference);
+  CHECK(difference <= 1e-13 * size);
+
+  // Every row has an entry on the diagonal, the Jacobi preconditioner of the shell needs them
+  PetscReal minimum;
+  VecAbs(y);
+  VecMin(y, PETSC_NULLPTR, &minimum);
+  CHECK(minimum > 0.0);
+
+  VecDestroy(&x);
+  VecDestroy(&y);
+  VecDestroy(&shellX);
+  VecDestroy(&shellY);
+}
+
+// Sets the right hand side of the inner cells to random values between 0 and 1, whose mean is not zero
+static void setRandomRhs(const Parameters& parameters, FlowField& flowField) {
+  int rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+  std::mt19937                             generator(rank);
+  std::uniform_real_distribution<RealType> distribution(0.0, 1.0);
+
+  const int kBegin = parameters.geometry.dim == 3 ? 2 : 0;
+  const int kEnd   = parameters.geometry.dim == 3 ? flowField.getNz() + 2 : 1;
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 2; j < flowField.getNy() + 2; j++) {
+      for (int i = 2; i < flowField.getNx() + 2; i++) {
+        flowField.getRHS().getScalar(i, j, k) = distribution(generator);
+      }
+    }
+  }
+}
+
+/** A cavity with an obstacle, whose pressure is only defined up to a constant, converges for a right hand side with a
+ * non-zero mean, which the solver removes
+ * @param preconditioner PETSc preconditioner, or nullptr for the default ILU or ASM
+ */
+static void checkSingularSystem(int dim, const char* preconditioner) {
+  if (preconditioner != nullptr) {
+    PetscOptionsSetValue(PETSC_NULLPTR, "-pc_type", preconditioner);
+  }
+
+  Parameters parameters;
+  setUpParameters(parameters, dim, DIRICHLET);
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  parameters.meshsize = createMeshsize(parameters);
+
+  FlowField flowField(parameters);
+  setObstacle(parameters, flowField);
+  Solvers::PetscSolver solver(flowField, parameters);
+  solver.reInitMatrix();
+
+  setRandomRhs(parameters, flowField);
+  solver.solve();
+
+  KSPConvergedReason reason;
+  KSPGetConvergedReason(solver.getKrylovSolver(), &reason);
+  CHECK(reason > 0);
+  CHECK(solver.getIterations() > 0);
+
+  PetscOptionsClearValue(PETSC_NULLPTR, "-pc_type");
+}
+
+/** Writes the configuration of a scenario: the cavity, the channel, the channel with a backward facing step or the
+ * channel driven by a pressure difference, on a stretched mesh
+ * @param solver Attributes of the solver, e.g., the PETSc options
+ * @return Path of the file
+ */
+static std::string writeConfiguration(const std::string& name, int sizeX, int sizeY, const std::string& solver) {
+  int rank, commSize;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+
+  const bool        cavity     = name == "cavity";
+  const int         processesY = commSize % 2 == 0 ? 2 : 1;
+  const std::string still      = "<vector x=\"0\" y=\"0\" z=\"0\" />";
+  const std::string moving     = "<vector x=\"1\" y=\"0\" z=\"0\" />";
+  const std::string left       = name == "pressure-channel" ? "<scalar value=\"1\" />" : (cavity ? still : moving);
+
+  const std::string path = (std::filesystem::temp_directory_path() / ("PetscSolver_" + name + ".xml")).string();
+  if (rank == 0) {
+    std::ofstream file(path);
+    file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+         << "<configuration>\n"
+         << "  <flow Re=\"100\" />\n"
+         << "  <simulation finalTime=\"1\"><type>dns</type><scenario>" << (name == "step" ? "channel" : name) << "</scenario></simulation>\n"
+         << (name == "step" ? "  <backwardFacingStep xRatio=\"0.2\" yRatio=\"0.5\" />\n" : "")
+         << "  <timestep dt=\"1\" tau=\"0.5\" />\n"
+         << "  <solver gamma=\"0.5\" type=\"petsc\" tolerance=\"1e-10\" " << solver << " />\n"
+         << "  <geometry dim=\"2\" lengthX=\"" << (cavity ? 1.0 : 5.0) << "\" lengthY=\"1.0\" lengthZ=\"1.0\" sizeX=\"" << sizeX << "\" sizeY=\"" << sizeY
+         << "\" sizeZ=\"1\" stretchX=\"" << (cavity ? "true" : "false") << "\" stretchY=\"true\" stretchZ=\"false\">\n"
+         << "    <mesh>stretched</mesh>\n"
+         << "  </geometry>\n"
+         << "  <environment gx=\"0\" gy=\"0\" gz=\"0\" />\n"
+         << "  <walls>\n"
+         << "    <left>" << left << "</left>\n"
+         << "    <right>" << still << "</right>\n"
+         << "    <top>" << (cavity ? moving : still) << "</top>\n"
+         << "    <bottom>" << still << "</bottom>\n"
+         << "    <front>" << still << "</front>\n"
+         << "    <back>" << still << "</back>\n"
+         << "  </walls>\n"
+         << "  <vtk interval=\"1\">PetscSolver</vtk>\n"
+         << "  <stdOut interval=\"1\" />\n"
+         << "  <parallel numProcessorsX=\"" << commSize / processesY << "\" numProcessorsY=\"" << processesY << "\" numProcessorsZ=\"1\" />\n"
+         << "</configuration>\n";
+  }
+  MPI_Barrier(PETSC_COMM_WORLD);
+  return path;
+}
+
+// Average number of iterations of the pressure solver in the first timesteps of the scenario
+static RealType getIterationsPerSolve(const std::string& path, int steps) {
+  Configuration configuration(path);
+  Parameters    parameters;
+  configuration.loadParameters(parameters);
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  MeshsizeFactory::getInstance().initMeshsize(parameters);
+
+  FlowField  flowField(parameters);
+  Simulation simulation(parameters, flowField);
+  simulation.initializeFlowField();
+  for (int step = 0; step < steps; step++) {
+    simulation.solveTimestep();
+  }
+  return static_cast<RealType>(simulation.getPressureIterations()) / steps;
+}
+
+// Algebraic multigrid needs at most as many iterations as ILU, or ASM in parallel runs, in all scenarios
+static void checkAlgebraicMultigrid() {
+  for (const std::string name : {"cavity", "channel", "step", "pressure-channel"}) {
+    INFO(name);
+    const std::string path = writeConfiguration(name, name == "cavity" ? 48 : 96, name == "cavity" ? 48 : 24, "");
+
+    const RealType standard = getIterationsPerSolve(path, 5);
+    PetscOptionsSetValue(PETSC_NULLPTR, "-pc_type", "gamg");
+    const RealType algebraic = getIterationsPerSolve(path, 5);
+    PetscOptionsClearValue(PETSC_NULLPTR, "-pc_type");
+
+    spdlog::info("{}: {} iterations per solve with ILU or ASM, {} with GAMG", name, standard, algebraic);
+    CHECK(algebraic > 0.0);
+    CHECK(algebraic <= standard);
+  }
+}
+
+/** Mixed precision converges in all scenarios with the single-precision multigrid cycle as preconditioner, and needs
+ * at most as many iterations as ILU, or ASM in parallel runs, where the cycle only covers the subdomain of a process
+ */
+static void checkMixedPrecision() {
+  for (const std::string name : {"cavity", "channel", "step", "pressure-channel"}) {
+    INFO(name);
+    const int sizeX = name == "cavity" ? 48 : 96, sizeY = name == "cavity" ? 48 : 24;
+
+    const RealType standard = getIterationsPerSolve(writeConfiguration(name, sizeX, sizeY, ""), 5);
+    const RealType mixed    = getIterationsPerSolve(writeConfiguration(name, sizeX, sizeY, "mixedPrecision=\"true\""), 5);
+
+    spdlog::info("{}: {} iterations per solve with ILU or ASM, {} with the single-precision cycle", name, standard, mixed);
+    CHECK(mixed > 0.0);
+    CHECK(mixed <= standard);
+  }
+}
+
+/** The iterations of geometric multigrid hardly grow when the cavity is refined, those of ILU, or ASM in parallel runs,
+ * grow with the number of cells along an axis
+ */
+static void checkGeometricMultigrid() {
+  const int sizes[3] = {32, 64, 128};
+  RealType  multigrid[3], standard[3];
+  for (int n = 0; n < 3; n++) {
+    multigrid[n] = getIterationsPerSolve(writeConfiguration("cavity", sizes[n], sizes[n], "multigrid=\"true\""), 5);
+    standard[n]  = getIterationsPerSolve(writeConfiguration("cavity", sizes[n], sizes[n], ""), 5);
+    spdlog::info("{} x {} cells: {} iterations per solve with multigrid, {} with ILU or ASM", sizes[n], sizes[n], multigrid[n], standard[n]);
+  }
+  CHECK(multigrid[0] > 0.0);
+  CHECK(multigrid[2] <= 1.5 * multigrid[0] + 2.0);
+  CHECK(multigrid[2] < standard[2]);
+}
+
+// Preconditioner of the PETSc solver of a scenario and its levels of multigrid, 0 for other preconditioners
+static std::pair<std::string, PetscInt> getPreconditioner(const std::string& path) {
+  Configuration configuration(path);
+  Parameters    parameters;
+  configuration.loadParameters(parameters);
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  MeshsizeFactory::getInstance().initMeshsize(parameters);
+
+  FlowField  flowField(parameters);
+  Simulation simulation(parameters, flowField);
+  simulation.initializeFlowField();
+  Solvers::PetscSolver solver(flowField, parameters);
+
+  PC       pc;
+  PCType   preconditioner;
+  PetscInt levels = 0;
+  KSPGetPC(solver.getKrylovSolver(), &pc);
+  PCGetType(pc, &preconditioner);
+  if (std::string(preconditioner) == PCMG) {
+    PCMGGetLevels(pc, &levels);
+  }
+  return {preconditioner, levels};
+}
+
+/** Geometric multigrid is active at the sizes of the shipped channel and backward facing step examples, 50 x 10 and
+ * 200 x 40 cells, and when they are refined twice, and its iterations hardly grow under the refinement. An axis is
+ * only halved if the cells of every process along it are even, so with 2 x 2 processes the 25 x 5 cells per process
+ * of the channel fall back to ASM, and the refined sizes are compared instead.
+ */
+static void checkShippedMultigrid() {
+  int commSize;
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+  const int  processesY = commSize % 2 == 0 ? 2 : 1;
+  const auto halves     = [](int cells, int processes) { return cells % processes == 0 && cells / processes % 2 == 0 && cells / processes >= 4; };
+
+  for (const std::string name : {"channel", "step"}) {
+    INFO(name);
+    const int baseX = name == "channel" ? 50 : 200, baseY = name == "channel" ? 10 : 40;
+    int       first = -1;
+    RealType  iterations[3];
+    for (int n = 0; n < 3; n++) {
+      const int         sizeX = baseX << n, sizeY = baseY << n;
+      const std::string path  = writeConfiguration(name, sizeX, sizeY, "multigrid=\"true\"");
+      INFO(sizeX << " x " << sizeY << " cells");
+
+      const auto [preconditioner, levels] = getPreconditioner(path);
+      iterations[n]                       = getIterationsPerSolve(path, 5);
+      spdlog::info("{}, {} x {} cells: {} with {} levels, {} iterations per solve", name, sizeX, sizeY, preconditioner, levels, iterations[n]);
+      CHECK(iterations[n] > 0.0);
+      if (halves(sizeX, commSize / processesY) || halves(sizeY, processesY)) {
+        CHECK(preconditioner == PCMG);
+        CHECK(levels >= 2);
+        first = first < 0 ? n : first;
+      } else {
+        CHECK(preconditioner == (commSize == 1 ? PCILU : PCASM));
+      }
+    }
+    REQUIRE(first >= 0);
+    CHECK(iterations[2] <= 1.5 * iterations[first] + 2.0);
+  }
+}
+
+/** Geometric multigrid halves the axes along which every process has an even number of at least four cells, the
+ * others keep their cells. Without any such axis, the solver falls back to ILU, or ASM in parallel runs, and still
+ * converges.
+ * @param multigrid Whether the grid can be coarsened
+ */
+static void checkMultigridLevels(int sizeX, int sizeY, BoundaryType typeX, bool multigrid) {
+  int commSize;
+  MPI_Comm_size(PETSC_COMM_WORLD, &commSize);
+
+  Parameters parameters;
+  setUpParameters(parameters, 2, typeX);
+  parameters.geometry.sizeX   = sizeX;
+  parameters.geometry.sizeY   = sizeY;
+  parameters.solver.multigrid = 1;
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  parameters.meshsize = createMeshsize(parameters);
+
+  FlowField flowField(parameters);
+  setRandomRhs(parameters, flowField);
+  Solvers::PetscSolver solver(flowField, parameters);
+  solver.solve();
+
+  KSPConvergedReason reason;
+  KSPGetConvergedReason(solver.getKrylovSolver(), &reason);
+  CHECK(reason > 0);
+
+  PC     pc;
+  PCType preconditioner;
+  KSPGetPC(solver.getKrylovSolver(), &pc);
+  PCGetType(pc, &preconditioner);
+  if (multigrid) {
+    CHECK(std::string(preconditioner) == PCMG);
+    PetscInt levels;
+    PCMGGetLevels(pc, &levels);
+    CHECK(levels >= 2);
+  } else {
+    CHECK(std::string(preconditioner) == (commSize == 1 ? PCILU : PCASM));
+  }
+}
+
+// Krylov method and preconditioner of a solver as "method preconditioner"
+static std::string getMethods(const Solvers::PetscSolver& solver) {
+  KSPType method;
+  PCType  preconditioner;
+  PC      pc;
+  KSPGetType(solver.getKrylovSolver(), &method);
+  KSPGetPC(solver.getKrylovSolver(), &pc);
+  PCGetType(pc, &preconditioner);
+  return std::string(method) + " " + preconditioner;
+}
+
+/** The autotuner skips the candidates that do not converge within the iteration limit, here those without a
+ * preconditioner or with Jacobi, and fails if none converges. Its choice is written to the cache, where lines of other
+ * configurations or with unknown methods are skipped, and read back by the next solver of the same configuration.
+ */
+static void checkAutotuner() {
+  int rank;
+  MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
+  const std::string cache = (std::filesystem::temp_directory_path() / "PetscSolver.cache").string();
+  if (rank == 0) {
+    std::filesystem::remove(cache);
+  }
+  MPI_Barrier(PETSC_COMM_WORLD);
+
+  Parameters parameters;
+  setUpParameters(parameters, 2, NEUMANN);
+  parameters.geometry.sizeX       = 64;
+  parameters.geometry.sizeY       = 64;
+  parameters.solver.autotune      = 1;
+  parameters.solver.autotuneCache = cache;
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  parameters.meshsize = createMeshsize(parameters);
+
+  FlowField flowField(parameters);
+  setRandomRhs(parameters, flowField);
+  PetscOptionsSetValue(PETSC_NULLPTR, "-ksp_max_it", "40");
+
+  std::string chosen;
+  {
+    TunedSolver solver(flowField, parameters);
+    CHECK(solver.readCache() == -1);
+    solver.solve();
+
+    KSPConvergedReason reason;
+    KSPGetConvergedReason(solver.getKrylovSolver(), &reason);
+    CHECK(reason > 0);
+    chosen = getMethods(solver);
+    CHECK_FALSE(chosen.ends_with(" none"));
+    CHECK_FALSE(chosen.ends_with(" jacobi"));
+
+    const int candidate = solver.readCache();
+    CHECK(candidate >= 0);
+
+    if (rank == 0) {
+      std::ifstream     input(cache);
+      const std::string written((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+      input.close();
+      std::ofstream output(cache);
+      output << "cavity 1x1 1 cg ilu 0\n" << solver.getCacheKey() << " unknown ilu 0\n" << written;
+    }
+    MPI_Barrier(PETSC_COMM_WORLD);
+    CHECK(solver.readCache() == candidate);
+  }
+
+  {
+    // The same configuration takes the cached choice without tuning
+    TunedSolver solver(flowField, parameters);
+    CHECK(getMethods(solver) == chosen);
+    solver.solve();
+    KSPConvergedReason reason;
+    KSPGetConvergedReason(solver.getKrylovSolver(), &reason);
+    CHECK(reason > 0);
+  }
+
+  // Without a cache and with a single iteration, no candidate converges
+  parameters.solver.autotuneCache = "";
+  PetscOptionsSetValue(PETSC_NULLPTR, "-ksp_max_it", "1");
+  {
+    TunedSolver solver(flowField, parameters);
+    CHECK_THROWS_AS(solver.tune(), std::runtime_error);
+  }
+  PetscOptionsClearValue(PETSC_NULLPTR, "-ksp_max_it");
+}
+
+#endif
+
+TEST_CASE("Test the PETSc pressure solver", "[single-file]") {
+  spdlog::info("Testing the PETSc pressure solver");
+
+#ifdef ENABLE_PETSC
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+    PetscInitializeNoArguments();
+  }
+
+  for (const int dim : {2, 3}) {
+    INFO(dim << "D");
+    checkAssembledOperator(dim);
+    for (const BoundaryType typeX : {NEUMANN, DIRICHLET, PERIODIC}) {
+      INFO("Walls along x of type " << typeX);
+      checkMatrixFree(dim, typeX);
+    }
+    checkSingularSystem(dim, nullptr);
+    checkSingularSystem(dim, PCGAMG);
+  }
+  checkAlgebraicMultigrid();
+  checkMixedPrecision();
+  checkGeometricMultigrid();
+  checkShippedMultigrid();
+  checkMultigridLevels(64, 64, NEUMANN, true);
+  checkMultigridLevels(31, 40, NEUMANN, true);
+  checkMultigridLevels(31, 31, NEUMANN, false);
+  checkMultigridLevels(96, 24, PERIODIC, true);
+  checkMultigridLevels(31, 31, PERIODIC, false);
+  checkAutotuner();
+
+  if (!initialized) {
+    PetscFinalize();
+  }
+#endif
+
+  spdlog::info("Test for the PETSc pressure solver completed successfully");
+}
@@ -0,0 +1,283 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "FlowField.hpp"
+#include "Meshsize.hpp"
+#include "Parameters.hpp"
+
+#include "Solvers/CGSolver.hpp"
+#include "Solvers/MultigridSolver.hpp"
+#include "Solvers/SORSolver.hpp"
+#include "Solvers/SpectralSolver.hpp"
+
+constexpr auto SIZE = 16;
+
+// Cells 7 to 9 in both directions, the centre cell is not connected to any fluid cell
+static bool isObstacle(int i, int j) { return i >= 7 && i <= 9 && j >= 7 && j <= 9; }
+
+static void setUpParameters(Parameters& parameters, bool stretched, bool dirichlet) {
+  parameters.geometry.dim          = 2;
+  parameters.geometry.sizeX        = SIZE;
+  parameters.geometry.sizeY        = SIZE;
+  parameters.geometry.sizeZ        = 1;
+  parameters.geometry.lengthX      = 1.0;
+  parameters.geometry.lengthY      = 2.0;
+  parameters.geometry.lengthZ      = 1.0;
+  parameters.geometry.meshsizeType = stretched ? TanhStretching : Uniform;
+
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.numProcessors[d] = 1;
+    parameters.parallel.localSize[d]     = d < 2 ? SIZE : 1;
+    parameters.parallel.firstCorner[d]   = 0;
+  }
+
+  // Walls everywhere, except for an outflow on the right, which makes that face Dirichlet for the pressure
+  parameters.walls.typeLeft    = DIRICHLET;
+  parameters.walls.typeRight   = dirichlet ? NEUMANN : DIRICHLET;
+  parameters.walls.typeBottom  = DIRICHLET;
+  parameters.walls.typeTop     = DIRICHLET;
+  parameters.walls.typeFront   = DIRICHLET;
+  parameters.walls.typeBack    = DIRICHLET;
+  parameters.walls.scalarRight = 0.3;
+
+  parameters.solver.tolerance = 1e-10;
+
+  if (stretched) {
+    parameters.meshsize = new TanhMeshStretching(parameters, true, true, false);
+  } else {
+    parameters.meshsize = new UniformMeshsize(parameters);
+  }
+}
+
+/** Sets a smooth pressure, and the right hand side for which it is the exact solution of the discrete problem
+ *
+ * The obstacle cells take the average of their fluid neighbours, or zero if they have none, so that their rows are
+ * satisfied with a zero right hand side as in the solvers. The pressure is symmetric about the diagonals through the
+ * centre of the obstacle, so the fluid neighbours of an obstacle cell have the same pressure. The Neumann faces
+ * towards obstacles of the CG solver are then exact as well.
+ */
+static void setUpProblem(const Parameters& parameters, FlowField& flowField, bool obstacle, bool dirichlet) {
+  IntScalarField& flags    = flowField.getFlags();
+  ScalarField&    pressure = flowField.getPressure();
+  ScalarField&    rhs      = flowField.getRHS();
+
+  for (int j = 0; j < SIZE + 3; j++) {
+    for (int i = 0; i < SIZE + 3; i++) {
+      int flag = 0;
+      if (obstacle && isObstacle(i, j)) {
+        flag = OBSTACLE_SELF;
+        flag += isObstacle(i - 1, j) ? OBSTACLE_LEFT : 0;
+        flag += isObstacle(i + 1, j) ? OBSTACLE_RIGHT : 0;
+        flag += isObstacle(i, j - 1) ? OBSTACLE_BOTTOM : 0;
+        flag += isObstacle(i, j + 1) ? OBSTACLE_TOP : 0;
+      }
+      flags.getValue(i, j) = flag;
+
+      const RealType x         = i - 8.0;
+      const RealType y         = j - 8.0;
+      pressure.getScalar(i, j) = cos(0.3 * sqrt(x * x + y * y)) + 0.02 * x * y;
+      rhs.getScalar(i, j)      = 0.0;
+    }
+  }
+
+  if (obstacle) {
+    for (int j = 7; j <= 9; j++) {
+      for (int i = 7; i <= 9; i++) {
+        const int neighbours[4][2] = {{i - 1, j}, {i + 1, j}, {i, j - 1}, {i, j + 1}};
+        RealType  sum              = 0.0;
+        int       fluid            = 0;
+        for (const auto& neighbour : neighbours) {
+          if (!isObstacle(neighbour[0], neighbour[1])) {
+            sum += pressure.getScalar(neighbour[0], neighbour[1]);
+            fluid++;
+          }
+        }
+        pressure.getScalar(i, j) = fluid > 0 ? sum / fluid : 0.0;
+      }
+    }
+  }
+
+  // Ghost cells as imposed by the boundary conditions
+  for (int j = 2; j < SIZE + 2; j++) {
+    pressure.getScalar(1, j)        = pressure.getScalar(2, j);
+    pressure.getScalar(SIZE + 2, j) = dirichlet ? 2.0 * parameters.walls.scalarRight - pressure.getScalar(SIZE + 1, j)
+                                                : pressure.getScalar(SIZE + 1, j);
+  }
+  for (int i = 2; i < SIZE + 2; i++) {
+    pressure.getScalar(i, 1)        = pressure.getScalar(i, 2);
+    pressure.getScalar(i, SIZE + 2) = pressure.getScalar(i, SIZE + 1);
+  }
+
+  const Solvers::PressureOperator pressureOperator(parameters);
+  for (int j = 2; j < SIZE + 2; j++) {
+    for (int i = 2; i < SIZE + 2; i++) {
+      if (flags.getValue(i, j) & OBSTACLE_SELF) {
+        continue;
+      }
+      rhs.getScalar(i, j) = pressureOperator.getLower(0)[i] * pressure.getScalar(i - 1, j)
+                            + pressureOperator.getUpper(0)[i] * pressure.getScalar(i + 1, j)
+                            + pressureOperator.getLower(1)[j] * pressure.getScalar(i, j - 1)
+                            + pressureOperator.getUpper(1)[j] * pressure.getScalar(i, j + 1)
+                            + pressureOperator.getCentre(i, j) * pressure.getScalar(i, j);
+    }
+  }
+}
+
+// Compares the fluid cells with the expected pressure, stored line by line, up to a constant if no face is Dirichlet
+static void checkPressure(FlowField& flowField, const std::vector<RealType>& expected, bool dirichlet) {
+  ScalarField&    pressure = flowField.getPressure();
+  IntScalarField& flags    = flowField.getFlags();
+
+  RealType shift = 0.0;
+  if (!dirichlet) {
+    int fluid = 0;
+    for (int j = 2; j < SIZE + 2; j++) {
+      for (int i = 2; i < SIZE + 2; i++) {
+        if ((flags.getValue(i, j) & OBSTACLE_SELF) == 0) {
+          shift += expected[i + (SIZE + 3) * j] - pressure.getScalar(i, j);
+          fluid++;
+        }
+      }
+    }
+    shift /= fluid;
+  }
+
+  for (int j = 2; j < SIZE + 2; j++) {
+    for (int i = 2; i < SIZE + 2; i++) {
+      if ((flags.getValue(i, j) & OBSTACLE_SELF) == 0) {
+        REQUIRE_THAT(pressure.getScalar(i, j) + shift, Catch::Matchers::WithinAbs(expected[i + (SIZE + 3) * j], 1e-7));
+      }
+    }
+  }
+}
+
+TEST_CASE("Test pressure solvers on a manufactured solution", "[single-file]") {
+  spdlog::info("Testing pressure solvers");
+
+  struct Setting {
+    const char* name;
+    int         type;
+    int         chebyshev;
+    int         mixedPrecision;
+    RealType    omega; //! Estimated by SOR if 0, the line solver takes the default of the configuration
+  };
+  const Setting settings[] = {
+    {"red-black SOR", SORPressureSolver, 0, 0, 0.0},
+    {"Chebyshev SOR", SORPressureSolver, 1, 0, 0.0},
+    {"multigrid", MultigridPressureSolver, 0, 0, 0.0},
+    {"mixed-precision multigrid", MultigridPressureSolver, 0, 1, 0.0},
+    {"line", LinePressureSolver, 0, 0, 1.0},
+    {"mixed-precision line", LinePressureSolver, 0, 1, 1.0},
+    {"CG", CGPressureSolver, 0, 0, 0.0},
+    {"mixed-precision CG", CGPressureSolver, 0, 1, 0.0},
+    {"spectral", SpectralPressureSolver, 0, 0, 0.0}};
+
+  for (const bool stretched : {false, true}) {
+    for (const bool dirichlet : {false, true}) {
+      for (const bool obstacle : {false, true}) {
+        for (const Setting& setting : settings) {
+          if (setting.type == SpectralPressureSolver && (stretched || obstacle)) {
+            continue;
+          }
+          INFO(setting.name << (stretched ? ", stretched" : ", uniform") << (dirichlet ? ", Dirichlet" : ", Neumann")
+                            << (obstacle ? ", obstacle" : ""));
+
+          Parameters parameters;
+          setUpParameters(parameters, stretched, dirichlet);
+          parameters.solver.type           = setting.type;
+          parameters.solver.chebyshev      = setting.chebyshev;
+          parameters.solver.mixedPrecision = setting.mixedPrecision;
+          parameters.solver.omega          = setting.omega;
+
+          FlowField flowField(parameters);
+          setUpProblem(parameters, flowField, obstacle, dirichlet);
+          // The solvers start from zero
+          std::vector<RealType> expected((SIZE + 3) * (SIZE + 3));
+          for (int j = 0; j < SIZE + 3; j++) {
+            for (int i = 0; i < SIZE + 3; i++) {
+              expected[i + (SIZE + 3) * j]            = flowField.getPressure().getScalar(i, j);
+              flowField.getPressure().getScalar(i, j) = 0.0;
+            }
+          }
+
+          std::unique_ptr<Solvers::LinearSolver> solver;
+          if (setting.type == SORPressureSolver) {
+            solver = std::make_unique<Solvers::SORSolver>(flowField, parameters);
+          } else if (setting.type == CGPressureSolver) {
+            solver = std::make_unique<Solvers::CGSolver>(flowField, parameters);
+          } else if (setting.type == SpectralPressureSolver) {
+            solver = std::make_unique<Solvers::SpectralSolver>(flowField, parameters);
+          } else {
+            solver = std::make_unique<Solvers::MultigridSolver>(flowField, parameters);
+          }
+          solver->solve();
+          if (setting.mixedPrecision) {
+            CHECK(solver->getSingleIterations() > 0);
+          }
+
+          checkPressure(flowField, expected, dirichlet);
+        }
+      }
+    }
+  }
+
+  spdlog::info("Test for pressure solvers completed successfully");
+}
+
+TEST_CASE("Test the single-precision multigrid cycle as a correction", "[single-file]") {
+  spdlog::info("Testing the single-precision multigrid cycle");
+
+  // The PETSc solver applies the cycle to its residuals with mixed precision. As a plain iterative refinement, the
+  // corrections have to converge to the double-precision solution.
+  for (const bool stretched : {false, true}) {
+    INFO((stretched ? "stretched" : "uniform"));
+
+    Parameters parameters;
+    setUpParameters(parameters, stretched, true);
+    parameters.solver.type           = MultigridPressureSolver;
+    parameters.solver.mixedPrecision = 1;
+    // Point smoothers converge slowly on the anisotropic cells of the stretched mesh
+    parameters.solver.smoother = stretched ? LineGaussSeidel : RedBlackGaussSeidel;
+
+    FlowField flowField(parameters);
+    setUpProblem(parameters, flowField, false, true);
+    ScalarField& pressure = flowField.getPressure();
+    ScalarField& rhs      = flowField.getRHS();
+
+    // Zero in the inner cells, the ghost cells satisfy the boundary conditions
+    std::vector<RealType> expected((SIZE + 3) * (SIZE + 3));
+    for (int j = 0; j < SIZE + 3; j++) {
+      for (int i = 0; i < SIZE + 3; i++) {
+        expected[i + (SIZE + 3) * j] = pressure.getScalar(i, j);
+        pressure.getScalar(i, j)     = i == SIZE + 2 ? 2.0 * parameters.walls.scalarRight : 0.0;
+      }
+    }
+
+    Solvers::MultigridSolver        solver(flowField, parameters);
+    const Solvers::PressureOperator pressureOperator(parameters);
+    std::vector<RealType>           residual(expected.size(), 0.0), correction(expected.size());
+    for (int step = 0; step < 30; step++) {
+      for (int j = 2; j < SIZE + 2; j++) {
+        for (int i = 2; i < SIZE + 2; i++) {
+          residual[i + (SIZE + 3) * j] = rhs.getScalar(i, j) - pressureOperator.getLower(0)[i] * pressure.getScalar(i - 1, j)
+                                         - pressureOperator.getUpper(0)[i] * pressure.getScalar(i + 1, j)
+                                         - pressureOperator.getLower(1)[j] * pressure.getScalar(i, j - 1)
+                                         - pressureOperator.getUpper(1)[j] * pressure.getScalar(i, j + 1)
+                                         - pressureOperator.getCentre(i, j) * pressure.getScalar(i, j);
+        }
+      }
+      solver.applyCycle(residual.data(), correction.data());
+      for (int j = 1; j < SIZE + 3; j++) {
+        for (int i = 1; i < SIZE + 3; i++) {
+          pressure.getScalar(i, j) += correction[i + (SIZE + 3) * j];
+        }
+      }
+    }
+
+    checkPressure(flowField, expected, true);
+  }
+
+  spdlog::info("Test for the single-precision multigrid cycle completed successfully");
+}
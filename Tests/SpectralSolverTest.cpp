@@ -0,0 +1,220 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "FlowField.hpp"
+#include "Meshsize.hpp"
+#include "Parameters.hpp"
+
+#include "ParallelManagers/PetscParallelConfiguration.hpp"
+#include "ParallelManagers/PetscParallelManager.hpp"
+#include "Solvers/SpectralSolver.hpp"
+
+// Uneven sizes, so that the slabs differ in size and the lines do not divide evenly among the processes
+constexpr int SIZES[3] = {9, 7, 6};
+
+enum Face { NeumannFace, DirichletFace, PeriodicFace };
+
+// Smooth pressure in the inner cell with the given global indices
+static RealType getInner(const int global[3]) {
+  return cos(0.7 * global[0] + 0.3) + 0.5 * sin(0.4 * global[1]) * cos(0.2 * global[0]) + 0.25 * cos(0.9 * global[2] + 0.1 * global[1]);
+}
+
+/** Pressure in a cell of the domain or of the ghost layers, at most one index may be outside the domain
+ *
+ * The ghost cells follow the boundary conditions: a copy of the inner cell for Neumann faces, the mirror about the
+ * face value for Dirichlet faces, and the opposite inner cell for periodic axes.
+ */
+static RealType getPressure(const int cell[3], const Face faces[3][2], const RealType values[3][2]) {
+  int global[3] = {cell[0], cell[1], cell[2]};
+  for (int d = 0; d < 3; d++) {
+    if (global[d] >= 0 && global[d] < SIZES[d]) {
+      continue;
+    }
+    const int upper = global[d] < 0 ? 0 : 1;
+    if (faces[d][upper] == PeriodicFace) {
+      global[d] = (global[d] + SIZES[d]) % SIZES[d];
+      return getInner(global);
+    }
+    global[d]            = upper ? SIZES[d] - 1 : 0;
+    const RealType inner = getInner(global);
+    return faces[d][upper] == DirichletFace ? 2.0 * values[d][upper] - inner : inner;
+  }
+  return getInner(global);
+}
+
+/** Solves a manufactured problem on slabs along the outermost axis, exchanges the ghost layers and compares them and
+ * the inner cells with the expected pressure, up to a constant if no face is Dirichlet
+ * @return Largest error
+ */
+static RealType checkSolve(int dim, const std::string& scenario) {
+  int processes;
+  MPI_Comm_size(PETSC_COMM_WORLD, &processes);
+
+  Parameters parameters;
+  parameters.geometry.dim          = dim;
+  parameters.geometry.sizeX        = SIZES[0];
+  parameters.geometry.sizeY        = SIZES[1];
+  parameters.geometry.sizeZ        = dim == 3 ? SIZES[2] : 1;
+  parameters.geometry.lengthX      = 1.0;
+  parameters.geometry.lengthY      = 0.8;
+  parameters.geometry.lengthZ      = 1.2;
+  parameters.geometry.meshsizeType = Uniform;
+  parameters.simulation.scenario   = scenario;
+
+  const int outer = dim - 1;
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.numProcessors[d] = d == outer ? processes : 1;
+  }
+
+  // Walls everywhere for the cavity. The outflow has Dirichlet pressure faces at both ends of the outermost axis and
+  // on the right.
+  const bool periodic = scenario == "periodic-box";
+  const bool outflow  = scenario == "outflow";
+
+  BoundaryType* types[3][2] = {
+    {&parameters.walls.typeLeft, &parameters.walls.typeRight},
+    {&parameters.walls.typeBottom, &parameters.walls.typeTop},
+    {&parameters.walls.typeFront, &parameters.walls.typeBack}};
+  RealType* scalars[3][2] = {
+    {&parameters.walls.scalarLeft, &parameters.walls.scalarRight},
+    {&parameters.walls.scalarBottom, &parameters.walls.scalarTop},
+    {&parameters.walls.scalarFront, &parameters.walls.scalarBack}};
+
+  Face     faces[3][2];
+  RealType values[3][2];
+  for (int d = 0; d < 3; d++) {
+    for (int upper = 0; upper < 2; upper++) {
+      const bool dirichlet = outflow && (d == outer || (d == 0 && upper == 1));
+      faces[d][upper]      = periodic ? PeriodicFace : (dirichlet ? DirichletFace : NeumannFace);
+      values[d][upper]     = dirichlet ? 0.3 - 0.2 * d - 0.1 * upper : 0.0;
+      *types[d][upper]     = periodic ? PERIODIC : (dirichlet ? NEUMANN : DIRICHLET);
+      *scalars[d][upper]   = values[d][upper];
+    }
+  }
+
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  parameters.meshsize = new UniformMeshsize(parameters);
+
+  FlowField                              flowField(parameters);
+  ParallelManagers::PetscParallelManager parallelManager(parameters, flowField);
+  const Solvers::PressureOperator        pressureOperator(parameters);
+
+  const int localSize[3] = {flowField.getNx(), flowField.getNy(), dim == 3 ? flowField.getNz() : 1};
+  const int kBegin       = dim == 3 ? 1 : 0;
+  const int kEnd         = dim == 3 ? localSize[2] + 3 : 1;
+
+  // Cells with at most one index in the ghost layers 1 and size + 2, false for the others
+  auto getGlobal = [&](int i, int j, int k, int global[3], bool& inner) {
+    const int local[3] = {i, j, k};
+    int       outside  = 0;
+    for (int d = 0; d < 3; d++) {
+      global[d] = d < dim ? parameters.parallel.firstCorner[d] + local[d] - 2 : 0;
+      outside += d < dim && (local[d] < 2 || local[d] >= localSize[d] + 2);
+    }
+    inner = outside == 0;
+    return outside <= 1;
+  };
+
+  // Right hand side of the inner cells for the expected pressure, which starts from zero
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 1; j < localSize[1] + 3; j++) {
+      for (int i = 1; i < localSize[0] + 3; i++) {
+        int  global[3];
+        bool inner;
+        if (!getGlobal(i, j, k, global, inner) || !inner) {
+          continue;
+        }
+        const int      local[3] = {i, j, k};
+        const RealType centre   = getPressure(global, faces, values);
+        RealType       rhs      = 0.0;
+        for (int d = 0; d < dim; d++) {
+          int lower[3] = {global[0], global[1], global[2]};
+          int upper[3] = {global[0], global[1], global[2]};
+          lower[d]--;
+          upper[d]++;
+          rhs += pressureOperator.getLower(d)[local[d]] * (getPressure(lower, faces, values) - centre)
+                 + pressureOperator.getUpper(d)[local[d]] * (getPressure(upper, faces, values) - centre);
+        }
+        flowField.getRHS().getScalar(i, j, k) = rhs;
+      }
+    }
+  }
+
+  Solvers::SpectralSolver solver(flowField, parameters);
+  solver.solve();
+  parallelManager.communicatePressure();
+
+  RealType shift = 0.0;
+  if (!outflow) {
+    RealType local[2] = {0.0, 0.0};
+    for (int k = kBegin; k < kEnd; k++) {
+      for (int j = 1; j < localSize[1] + 3; j++) {
+        for (int i = 1; i < localSize[0] + 3; i++) {
+          int  global[3];
+          bool inner;
+          if (getGlobal(i, j, k, global, inner) && inner) {
+            local[0] += getPressure(global, faces, values) - flowField.getPressure().getScalar(i, j, k);
+            local[1] += 1.0;
+          }
+        }
+      }
+    }
+    RealType sums[2];
+    MPI_Allreduce(local, sums, 2, MY_MPI_FLOAT, MPI_SUM, PETSC_COMM_WORLD);
+    shift = sums[0] / sums[1];
+  }
+
+  RealType error = 0.0;
+  for (int k = kBegin; k < kEnd; k++) {
+    for (int j = 1; j < localSize[1] + 3; j++) {
+      for (int i = 1; i < localSize[0] + 3; i++) {
+        int  global[3];
+        bool inner;
+        if (!getGlobal(i, j, k, global, inner)) {
+          continue;
+        }
+        // The ghost cells behind Dirichlet faces are fixed, the others move with the constant
+        const RealType expected = getPressure(global, faces, values);
+        const RealType computed = flowField.getPressure().getScalar(i, j, k);
+        error                   = std::max(error, std::abs(computed + shift - expected));
+      }
+    }
+  }
+
+  RealType globalError;
+  MPI_Allreduce(&error, &globalError, 1, MY_MPI_FLOAT, MPI_MAX, PETSC_COMM_WORLD);
+  return globalError;
+}
+
+// Meaningful with several processes, e.g. mpirun -np 4, see Tests/CMakeLists.txt
+TEST_CASE("Test the spectral solver on slabs", "[single-file]") {
+  spdlog::info("Testing the spectral solver on slabs");
+
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscInitializeNoArguments();
+#else
+    MPI_Init(nullptr, nullptr);
+#endif
+  }
+
+  for (const int dim : {2, 3}) {
+    for (const std::string scenario : {"cavity", "outflow", "periodic-box"}) {
+      INFO(dim << "D " << scenario);
+      CHECK(checkSolve(dim, scenario) < 1e-9);
+    }
+  }
+
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscFinalize();
+#else
+    MPI_Finalize();
+#endif
+  }
+
+  spdlog::info("Test for the spectral solver on slabs completed successfully");
+}
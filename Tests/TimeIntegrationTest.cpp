@@ -0,0 +1,410 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "Configuration.hpp"
+#include "FlowField.hpp"
+#include "Iterators.hpp"
+#include "Meshsize.hpp"
+#include "MeshsizeFactory.hpp"
+#include "Parameters.hpp"
+#include "Simulation.hpp"
+
+#include "ParallelManagers/PetscParallelConfiguration.hpp"
+#include "Stencils/FGHStencil.hpp"
+#include "Stencils/MeshWeights.hpp"
+#include "Stencils/StencilFunctions.hpp"
+
+// Runs with a prescribed timestep instead of the stability limit, so that the steps of different runs are nested
+class FixedStepSimulation: public Simulation {
+private:
+  const RealType dt_;
+
+protected:
+  void setTimeStep() override { parameters_.timestep.dt = dt_; }
+
+public:
+  FixedStepSimulation(Parameters& parameters, FlowField& flowField, RealType dt):
+    Simulation(parameters, flowField),
+    dt_(dt) {}
+};
+
+/** Writes a configuration with the given flow, timestep and additional solver attributes and returns its path. The
+ * walls of the cavity are ignored by the periodic Taylor-Green vortex, the pressure channel has a pressure of 1 on the
+ * left wall instead.
+ */
+static std::string writeConfiguration(
+  const std::string& scenario, const std::string& flow, const std::string& timestep, RealType finalTime, int size, const std::string& solver = ""
+) {
+  const std::string path = (std::filesystem::temp_directory_path() / ("TimeIntegration-" + scenario + ".xml")).string();
+  std::ofstream     file(path);
+  file << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+       << "<configuration>\n"
+       << "  <flow " << flow << " />\n"
+       << "  <simulation finalTime=\"" << finalTime << "\"><type>dns</type><scenario>" << scenario << "</scenario></simulation>\n"
+       << "  <timestep " << timestep << " />\n"
+       << "  <solver gamma=\"0\" type=\"" << (scenario == "taylor-green" ? "spectral" : "cg") << "\" tolerance=\"1e-12\" " << solver << " />\n"
+       << "  <geometry dim=\"2\" lengthX=\"1.0\" lengthY=\"1.0\" lengthZ=\"1.0\" sizeX=\"" << size << "\" sizeY=\"" << size << "\" sizeZ=\"1\">\n"
+       << "    <mesh>uniform</mesh>\n"
+       << "  </geometry>\n"
+       << "  <environment gx=\"0\" gy=\"0\" gz=\"0\" />\n"
+       << "  <walls>\n"
+       << "    <left>" << (scenario == "pressure-channel" ? "<scalar value=\"1\" />" : "<vector x=\"0\" y=\"0\" z=\"0\" />") << "</left>\n"
+       << "    <right><vector x=\"0\" y=\"0\" z=\"0\" /></right>\n"
+       << "    <top><vector x=\"1\" y=\"0\" z=\"0\" /></top>\n"
+       << "    <bottom><vector x=\"0\" y=\"0\" z=\"0\" /></bottom>\n"
+       << "    <front><vector x=\"0\" y=\"0\" z=\"0\" /></front>\n"
+       << "    <back><vector x=\"0\" y=\"0\" z=\"0\" /></back>\n"
+       << "  </walls>\n"
+       << "  <vtk interval=\"1\">TimeIntegration</vtk>\n"
+       << "  <stdOut interval=\"1\" />\n"
+       << "  <parallel numProcessorsX=\"1\" numProcessorsY=\"1\" numProcessorsZ=\"1\" />\n"
+       << "</configuration>\n";
+  return path;
+}
+
+// Velocity of the inner cells, both components per cell
+static std::vector<RealType> getVelocity(FlowField& flowField) {
+  std::vector<RealType> velocity;
+  for (int j = 2; j < flowField.getNy() + 2; j++) {
+    for (int i = 2; i < flowField.getNx() + 2; i++) {
+      velocity.push_back(flowField.getVelocity().getVector(i, j)[0]);
+      velocity.push_back(flowField.getVelocity().getVector(i, j)[1]);
+    }
+  }
+  return velocity;
+}
+
+static RealType getDifference(const std::vector<RealType>& a, const std::vector<RealType>& b) {
+  RealType difference = 0.0;
+  for (std::size_t n = 0; n < a.size(); n++) {
+    difference = std::max(difference, std::abs(a[n] - b[n]));
+  }
+  return difference;
+}
+
+/** Integrates up to the final time, with a fixed timestep or, for dt = 0, with the stability limit. The translation
+ * is added to the initial velocity, in x and with half the magnitude in y.
+ * @return Velocity of the inner cells and the number of pressure solves
+ */
+static std::pair<std::vector<RealType>, int> integrate(const std::string& path, RealType dt, RealType translation = 0.0) {
+  Configuration configuration(path);
+  Parameters    parameters;
+  configuration.loadParameters(parameters);
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  MeshsizeFactory::getInstance().initMeshsize(parameters);
+
+  FlowField                   flowField(parameters);
+  std::unique_ptr<Simulation> simulation = dt > 0.0 ? std::make_unique<FixedStepSimulation>(parameters, flowField, dt)
+                                                    : std::make_unique<Simulation>(parameters, flowField);
+  simulation->initializeFlowField();
+  for (int j = 0; j < flowField.getNy() + 3; j++) {
+    for (int i = 0; i < flowField.getNx() + 3; i++) {
+      flowField.getVelocity().getVector(i, j)[0] += translation;
+      flowField.getVelocity().getVector(i, j)[1] += 0.5 * translation;
+    }
+  }
+
+  const int stages = parameters.timestep.scheme == RungeKutta3 && !parameters.timestep.singleProjection ? 3 : 1;
+  int       solves = 0;
+  RealType  time   = 0.0;
+  if (dt > 0.0) {
+    const int steps = static_cast<int>(std::lround(parameters.simulation.finalTime / dt));
+    for (int step = 0; step < steps; step++) {
+      simulation->solveTimestep();
+    }
+    solves = steps * stages;
+  } else {
+    while (time < parameters.simulation.finalTime) {
+      simulation->solveTimestep();
+      time += parameters.timestep.dt;
+      solves += stages;
+    }
+  }
+  return {getVelocity(flowField), solves};
+}
+
+/** Observed order of convergence towards a solution with a much smaller timestep, the lowest one between successive
+ * timesteps of the given ones, which halve
+ */
+static RealType getOrder(const std::string& path, const std::vector<RealType>& timesteps, RealType translation) {
+  const std::vector<RealType> reference = integrate(path, timesteps.back() / 16, translation).first;
+  std::vector<RealType>       errors;
+  for (const RealType dt : timesteps) {
+    errors.push_back(getDifference(integrate(path, dt, translation).first, reference));
+    spdlog::info("dt {} error {:.3e}", dt, errors.back());
+  }
+  RealType order = MY_FLOAT_MAX;
+  for (std::size_t n = 1; n < errors.size(); n++) {
+    order = std::min(order, std::log2(errors[n - 1] / errors[n]));
+  }
+  return order;
+}
+
+// The forward Euler predictor as it was computed before the multi-step and multi-stage schemes were added
+template <Stencils::ConvectionScheme Scheme>
+static void checkForwardEuler(const Parameters& parameters, FlowField& flowField) {
+  const Stencils::MeshWeights weights(parameters);
+  RealType                    localVelocity[27 * 3];
+  const RealType              dt = parameters.timestep.dt;
+  const RealType              Re = parameters.flow.Re;
+
+  int mismatches = 0;
+  for (int k = parameters.geometry.dim == 3 ? 2 : 0; k < (parameters.geometry.dim == 3 ? flowField.getNz() + 2 : 1); k++) {
+    for (int j = 2; j < flowField.getNy() + 2; j++) {
+      for (int i = 2; i < flowField.getNx() + 2; i++) {
+        const Stencils::AxisWeights& wx = weights.getX(i);
+        const Stencils::AxisWeights& wy = weights.getY(j);
+        RealType                     expected[3];
+        if (parameters.geometry.dim == 2) {
+          Stencils::loadLocalVelocity2D(flowField, localVelocity, i, j);
+          expected[0] = localVelocity[Stencils::mapd(0, 0, 0, 0)]
+                        + dt
+                            * (-Stencils::du2dx<Scheme>(localVelocity, parameters, wx)
+                               - Stencils::duvdy<Scheme>(localVelocity, parameters, wx, wy)
+                               + 1 / Re * (Stencils::d2udx2(localVelocity, wx) + Stencils::d2udy2(localVelocity, wy))
+                               + parameters.environment.gx);
+          expected[1] = localVelocity[Stencils::mapd(0, 0, 0, 1)]
+                        + dt
+                            * (-Stencils::duvdx<Scheme>(localVelocity, parameters, wx, wy)
+                               - Stencils::dv2dy<Scheme>(localVelocity, parameters, wy)
+                               + 1 / Re * (Stencils::d2vdx2(localVelocity, wx) + Stencils::d2vdy2(localVelocity, wy))
+                               + parameters.environment.gy);
+        } else {
+          const Stencils::AxisWeights& wz = weights.getZ(k);
+          Stencils::loadLocalVelocity3D(flowField, localVelocity, i, j, k);
+          expected[0] = localVelocity[Stencils::mapd(0, 0, 0, 0)]
+                        + dt
+                            * (-Stencils::du2dx<Scheme>(localVelocity, parameters, wx)
+                               - Stencils::duvdy<Scheme>(localVelocity, parameters, wx, wy)
+                               - Stencils::duwdz<Scheme>(localVelocity, parameters, wx, wz)
+                               + 1 / Re
+                                   * (Stencils::d2udx2(localVelocity, wx) + Stencils::d2udy2(localVelocity, wy)
+                                      + Stencils::d2udz2(localVelocity, wz))
+                               + parameters.environment.gx);
+          expected[1] = localVelocity[Stencils::mapd(0, 0, 0, 1)]
+                        + dt
+                            * (-Stencils::dv2dy<Scheme>(localVelocity, parameters, wy)
+                               - Stencils::duvdx<Scheme>(localVelocity, parameters, wx, wy)
+                               - Stencils::dvwdz<Scheme>(localVelocity, parameters, wy, wz)
+                               + 1 / Re
+                                   * (Stencils::d2vdx2(localVelocity, wx) + Stencils::d2vdy2(localVelocity, wy)
+                                      + Stencils::d2vdz2(localVelocity, wz))
+                               + parameters.environment.gy);
+          expected[2] = localVelocity[Stencils::mapd(0, 0, 0, 2)]
+                        + dt
+                            * (-Stencils::dw2dz<Scheme>(localVelocity, parameters, wz)
+                               - Stencils::duwdx<Scheme>(localVelocity, parameters, wx, wz)
+                               - Stencils::dvwdy<Scheme>(localVelocity, parameters, wy, wz)
+                               + 1 / Re
+                                   * (Stencils::d2wdx2(localVelocity, wx) + Stencils::d2wdy2(localVelocity, wy)
+                                      + Stencils::d2wdz2(localVelocity, wz))
+                               + parameters.environment.gz);
+        }
+        const RealType* const values = flowField.getFGH().getVector(i, j, k);
+        for (int d = 0; d < parameters.geometry.dim; d++) {
+          mismatches += values[d] != expected[d];
+        }
+      }
+    }
+  }
+  CHECK(mismatches == 0);
+}
+
+// Compares the forward Euler kernels on random velocities with the formula, for every convection scheme
+static void checkForwardEulerKernels() {
+
+  for (const int dim : {2, 3}) {
+    for (const RealType gamma : {0.0, 0.5, 1.0}) {
+      for (const bool gravity : {false, true}) {
+        INFO(dim << "D gamma " << gamma << (gravity ? " with" : " without") << " gravity");
+        Parameters parameters;
+        parameters.geometry.dim          = dim;
+        parameters.geometry.sizeX        = 10;
+        parameters.geometry.sizeY        = 8;
+        parameters.geometry.sizeZ        = dim == 3 ? 6 : 1;
+        parameters.geometry.lengthX      = 1.0;
+        parameters.geometry.lengthY      = 0.7;
+        parameters.geometry.lengthZ      = 0.5;
+        parameters.geometry.meshsizeType = TanhStretching;
+        parameters.simulation.scenario   = "cavity";
+        parameters.flow.Re               = 37.0;
+        parameters.solver.gamma          = gamma;
+        parameters.timestep.dt           = 1.3e-3;
+        parameters.environment.gx        = gravity ? -0.3 : 0.0;
+        parameters.environment.gy        = gravity ? -9.81 : 0.0;
+        parameters.environment.gz        = gravity ? 0.2 : 0.0;
+        for (int d = 0; d < 3; d++) {
+          parameters.parallel.numProcessors[d] = 1;
+        }
+        const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+        parameters.meshsize = new TanhMeshStretching(parameters, true, true, dim == 3);
+
+        FlowField    flowField(parameters);
+        VectorField& velocity = flowField.getVelocity();
+        std::mt19937 generator(dim * 100 + static_cast<int>(10 * gamma) + gravity);
+        std::uniform_real_distribution<RealType> distribution(-1.0, 1.0);
+        for (int k = 0; k < (dim == 3 ? flowField.getNz() + 3 : 1); k++) {
+          for (int j = 0; j < flowField.getNy() + 3; j++) {
+            for (int i = 0; i < flowField.getNx() + 3; i++) {
+              for (int d = 0; d < dim; d++) {
+                velocity.getVector(i, j, k)[d] = distribution(generator);
+              }
+            }
+          }
+        }
+
+        Stencils::FGHStencil     stencil(parameters);
+        FieldIterator<FlowField> iterator(flowField, parameters, stencil);
+        iterator.iterate();
+
+        switch (Stencils::getConvectionScheme(parameters)) {
+        case Stencils::ConvectionScheme::Central:
+          checkForwardEuler<Stencils::ConvectionScheme::Central>(parameters, flowField);
+          break;
+        case Stencils::ConvectionScheme::DonorCell:
+          checkForwardEuler<Stencils::ConvectionScheme::DonorCell>(parameters, flowField);
+          break;
+        default:
+          checkForwardEuler<Stencils::ConvectionScheme::Blended>(parameters, flowField);
+          break;
+        }
+      }
+    }
+  }
+}
+
+static void checkOrders() {
+  // The Taylor-Green vortex, whose velocity decays by a factor of about 2 until the final time. Its convective term
+  // is a gradient, which the projection removes. The translation advects the vortex, so that the convective term
+  // contributes to the temporal error.
+  const std::vector<RealType> timesteps = {0.02, 0.01, 0.005};
+  const std::tuple<std::string, bool, RealType> schemes[4] = {
+    {"euler", false, 1.0}, {"ab2", false, 2.0}, {"rk3", false, 3.0}, {"rk3", true, 2.0}};
+  for (const auto& [scheme, singleProjection, expected] : schemes) {
+    for (const bool imex : {false, true}) {
+      if (singleProjection && imex) {
+        continue;
+      }
+      INFO(scheme << (singleProjection ? " with a single projection" : "") << (imex ? " with" : " without") << " IMEX");
+      const std::string path = writeConfiguration(
+        "taylor-green",
+        "Re=\"100\"",
+        "scheme=\"" + scheme + "\" imex=\"" + (imex ? "true" : "false") + "\" singleProjection=\""
+          + (singleProjection ? "true" : "false") + "\" imexTolerance=\"1e-13\" imexIterations=\"1000\"",
+        0.2,
+        16
+      );
+      // Crank-Nicolson limits RK3 to second order
+      const RealType order = getOrder(path, timesteps, 0.5);
+      spdlog::info("{}{} {} IMEX: order {:.2f}", scheme, singleProjection ? " with a single projection," : "", imex ? "with" : "without", order);
+      CHECK(order > (imex ? std::min<RealType>(expected, 2.0) : expected) - 0.15);
+    }
+  }
+}
+
+static void checkPressureSolves() {
+  // A cavity at a low Reynolds number, where the viscous limit of the explicit schemes is far below the convective
+  // one. Both runs use the stability limit of the scheme and end close to the same flow.
+  const RealType finalTime = 0.5;
+  const auto [euler, eulerSolves] = integrate(
+    writeConfiguration("cavity", "Re=\"10\"", "scheme=\"euler\" tau=\"0.5\"", finalTime, 32), 0.0
+  );
+  const auto [rk3, rk3Solves] = integrate(
+    writeConfiguration("cavity", "Re=\"10\"", "scheme=\"rk3\" imex=\"true\" imexTolerance=\"1e-10\" tau=\"0.5\"", finalTime, 32), 0.0
+  );
+  const RealType difference = getDifference(euler, rk3);
+  spdlog::info(
+    "Pressure solves per simulated second: euler {}, rk3 with IMEX {}, difference of the velocities {:.3e}",
+    eulerSolves / finalTime,
+    rk3Solves / finalTime,
+    difference
+  );
+  CHECK(3 * rk3Solves < eulerSolves);
+  CHECK(difference < 1e-2);
+
+  // Explicit RK3 with a single projection per step takes the larger steps of RK3 at the cost of one pressure solve.
+  // The viscous limit dominates at Re 10, where its steps are 1.25 times as large as forward Euler, the convective
+  // one at Re 1000. The velocities are compared to RK3 with a projection in every stage.
+  for (const auto& [Re, ratio] : {std::pair<std::string, RealType>{"10", 0.85}, {"1000", 0.6}}) {
+    const std::string flow         = "Re=\"" + Re + "\"";
+    const int         forwardEuler = integrate(writeConfiguration("cavity", flow, "scheme=\"euler\" tau=\"0.5\"", finalTime, 32), 0.0).second;
+    const auto [single, singleSolves] = integrate(
+      writeConfiguration("cavity", flow, "scheme=\"rk3\" singleProjection=\"true\" tau=\"0.5\"", finalTime, 32), 0.0
+    );
+    const auto [stages, stageSolves] = integrate(writeConfiguration("cavity", flow, "scheme=\"rk3\" tau=\"0.5\"", finalTime, 32), 0.0);
+    const RealType difference = getDifference(single, stages);
+    spdlog::info(
+      "Pressure solves per simulated second at Re {}: euler {}, rk3 {}, rk3 with a single projection {}, difference of the "
+      "velocities {:.3e}",
+      Re,
+      forwardEuler / finalTime,
+      stageSolves / finalTime,
+      singleSolves / finalTime,
+      difference
+    );
+    CHECK(singleSolves < ratio * forwardEuler);
+    CHECK(difference < 2e-2);
+  }
+
+  // The lagged pressure of RK3/Crank-Nicolson would not be damped
+  Configuration configuration(writeConfiguration("cavity", "Re=\"10\"", "scheme=\"rk3\" imex=\"true\" singleProjection=\"true\"", finalTime, 32));
+  Parameters    parameters;
+  CHECK_THROWS_AS(configuration.loadParameters(parameters), std::runtime_error);
+}
+
+/** Runs the same flows with the standard and the incremental projection. Both project onto the same velocity, the
+ * incremental one only moves the gradient of the current pressure from the projection into the predictor. The
+ * pressure channel covers the Dirichlet wall, on which the increments vanish, also with the implicit viscous terms.
+ */
+static void checkIncrementalProjection() {
+  for (const std::string scenario : {"cavity", "pressure-channel"}) {
+    for (const std::string scheme : {"euler", "ab2"}) {
+      for (const bool imex : {false, true}) {
+        INFO(scenario << " " << scheme << (imex ? " with IMEX" : ""));
+        const std::string timestep = "scheme=\"" + scheme + "\" imex=\"" + (imex ? "true" : "false")
+                                     + "\" imexTolerance=\"1e-13\" imexIterations=\"1000\"";
+        const std::vector<RealType> standard = integrate(writeConfiguration(scenario, "Re=\"100\"", timestep, 0.1, 16), 0.01).first;
+        const std::vector<RealType> incremental
+          = integrate(writeConfiguration(scenario, "Re=\"100\"", timestep, 0.1, 16, "incremental=\"true\""), 0.01).first;
+        const RealType difference = getDifference(standard, incremental);
+        spdlog::info("{} {}{}: difference of the velocities {:.3e}", scenario, scheme, imex ? " with IMEX" : "", difference);
+        CHECK(difference < 1e-9);
+      }
+    }
+  }
+
+  // The low-storage Runge-Kutta scheme needs the predictor without the pressure gradient
+  Configuration configuration(writeConfiguration("cavity", "Re=\"100\"", "scheme=\"rk3\"", 0.1, 16, "incremental=\"true\""));
+  Parameters    parameters;
+  CHECK_THROWS_AS(configuration.loadParameters(parameters), std::runtime_error);
+}
+
+TEST_CASE("Test the time integration schemes", "[single-file]") {
+  spdlog::info("Testing the time integration schemes");
+
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscInitializeNoArguments();
+#else
+    MPI_Init(nullptr, nullptr);
+#endif
+  }
+
+  checkForwardEulerKernels();
+  checkOrders();
+  checkPressureSolves();
+  checkIncrementalProjection();
+
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscFinalize();
+#else
+    MPI_Finalize();
+#endif
+  }
+
+  spdlog::info("Test for the time integration schemes completed successfully");
+}
@@ -0,0 +1,178 @@
+#include "StdAfx.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "FlowField.hpp"
+#include "Meshsize.hpp"
+#include "Parameters.hpp"
+
+#include "ParallelManagers/PetscParallelConfiguration.hpp"
+#include "ParallelManagers/PetscParallelManager.hpp"
+#include "Solvers/ViscousSolver.hpp"
+#include "Stencils/MeshWeights.hpp"
+
+// Uneven sizes, so that the subdomains differ in size
+constexpr int SIZES[3] = {24, 20, 12};
+
+/** Expected increment of a velocity component in a cavity, position[component] is the index of the face between the
+ * cells position - 1 and position, the others are cell indices. The increment vanishes on the walls and is mirrored
+ * into the tangential ghost cells.
+ */
+static RealType getDelta(int component, const int position[3], int dim) {
+  int      cell[3] = {position[0], position[1], position[2]};
+  RealType sign    = 1.0;
+  for (int d = 0; d < dim; d++) {
+    if (d == component) {
+      if (cell[d] <= 0 || cell[d] >= SIZES[d]) {
+        return 0.0;
+      }
+    } else if (cell[d] < 0 || cell[d] >= SIZES[d]) {
+      cell[d] = cell[d] < 0 ? 0 : SIZES[d] - 1;
+      sign    = -sign;
+    }
+  }
+  return sign * (sin(0.3 * cell[0] + 0.2 * component) * cos(0.25 * cell[1]) + 0.5 * cos(0.4 * cell[2] + 0.1 * cell[0]));
+}
+
+/** Solves the implicit viscous system of a manufactured increment with a timestep far beyond the explicit viscous
+ * limit and compares the predictor with the expected one
+ * @return Largest error relative to the largest increment
+ */
+static RealType checkSolve(int dim, bool stretched) {
+  int processes;
+  MPI_Comm_size(PETSC_COMM_WORLD, &processes);
+
+  Parameters parameters;
+  parameters.geometry.dim            = dim;
+  parameters.geometry.sizeX          = SIZES[0];
+  parameters.geometry.sizeY          = SIZES[1];
+  parameters.geometry.sizeZ          = dim == 3 ? SIZES[2] : 1;
+  parameters.geometry.lengthX        = 1.0;
+  parameters.geometry.lengthY        = 0.8;
+  parameters.geometry.lengthZ        = 0.5;
+  parameters.geometry.meshsizeType   = stretched ? TanhStretching : Uniform;
+  parameters.simulation.scenario     = "cavity";
+  parameters.flow.Re                 = 1.0;
+  parameters.timestep.dt             = 10.0;
+  parameters.timestep.imexTolerance  = 1e-11;
+  parameters.timestep.imexIterations = 2000;
+  parameters.walls.typeLeft          = DIRICHLET;
+  parameters.walls.typeRight         = DIRICHLET;
+  parameters.walls.typeBottom        = DIRICHLET;
+  parameters.walls.typeTop           = DIRICHLET;
+  parameters.walls.typeFront         = DIRICHLET;
+  parameters.walls.typeBack          = DIRICHLET;
+
+  int numProcessors[3] = {0, 0, dim == 3 ? 0 : 1};
+  MPI_Dims_create(processes, dim, numProcessors);
+  for (int d = 0; d < 3; d++) {
+    parameters.parallel.numProcessors[d] = numProcessors[d];
+  }
+
+  const ParallelManagers::PetscParallelConfiguration parallelConfiguration(parameters);
+  if (stretched) {
+    parameters.meshsize = new TanhMeshStretching(parameters, true, true, dim == 3);
+  } else {
+    parameters.meshsize = new UniformMeshsize(parameters);
+  }
+
+  FlowField                              flowField(parameters);
+  ParallelManagers::PetscParallelManager parallelManager(parameters, flowField);
+  const Stencils::MeshWeights            weights(parameters);
+
+  const RealType coefficient  = 0.5 * parameters.timestep.dt / parameters.flow.Re;
+  const int      localSize[3] = {flowField.getNx(), flowField.getNy(), dim == 3 ? flowField.getNz() : 1};
+  const int      kBegin       = dim == 3 ? 2 : 0;
+  const int      kEnd         = dim == 3 ? localSize[2] + 2 : 1;
+
+  // Position of the velocity component at the local indices, see getDelta()
+  auto getPosition = [&](int component, const int local[3], int position[3]) {
+    for (int d = 0; d < 3; d++) {
+      position[d] = d < dim ? parameters.parallel.firstCorner[d] + local[d] - 2 + (d == component) : 0;
+    }
+  };
+
+  // Predictor F = u + (I - coefficient L) delta, with the velocity and pressure at zero
+  for (int component = 0; component < dim; component++) {
+    for (int k = kBegin; k < kEnd; k++) {
+      for (int j = 2; j < localSize[1] + 2; j++) {
+        for (int i = 2; i < localSize[0] + 2; i++) {
+          const int local[3] = {i, j, k};
+          int       position[3];
+          getPosition(component, local, position);
+          if (position[component] >= SIZES[component]) {
+            continue; // On the upper wall
+          }
+
+          const Stencils::AxisWeights* axes[3] = {&weights.getX(i), &weights.getY(j), dim == 3 ? &weights.getZ(k) : nullptr};
+          RealType                     laplace = 0.0;
+          for (int d = 0; d < dim; d++) {
+            for (int offset = -1; offset <= 1; offset++) {
+              int neighbour[3] = {position[0], position[1], position[2]};
+              neighbour[d] += offset;
+              laplace += axes[d]->laplace[offset + 1] * getDelta(component, neighbour, dim);
+            }
+          }
+          flowField.getFGH().getVector(i, j, k)[component] = getDelta(component, position, dim) - coefficient * laplace;
+        }
+      }
+    }
+  }
+
+  Solvers::ViscousSolver solver(flowField, parameters, parallelManager);
+  solver.solve();
+
+  RealType errors[2] = {0.0, 0.0};
+  for (int component = 0; component < dim; component++) {
+    for (int k = kBegin; k < kEnd; k++) {
+      for (int j = 2; j < localSize[1] + 2; j++) {
+        for (int i = 2; i < localSize[0] + 2; i++) {
+          const int local[3] = {i, j, k};
+          int       position[3];
+          getPosition(component, local, position);
+          if (position[component] >= SIZES[component]) {
+            continue; // On the upper wall
+          }
+          const RealType expected = getDelta(component, position, dim);
+          errors[0]               = std::max(errors[0], std::abs(flowField.getFGH().getVector(i, j, k)[component] - expected));
+          errors[1]               = std::max(errors[1], std::abs(expected));
+        }
+      }
+    }
+  }
+
+  RealType globalErrors[2];
+  MPI_Allreduce(errors, globalErrors, 2, MY_MPI_FLOAT, MPI_MAX, PETSC_COMM_WORLD);
+  return globalErrors[0] / globalErrors[1];
+}
+
+TEST_CASE("Test the implicit viscous solver at large timesteps", "[single-file]") {
+  spdlog::info("Testing the implicit viscous solver at large timesteps");
+
+  int initialized;
+  MPI_Initialized(&initialized);
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscInitializeNoArguments();
+#else
+    MPI_Init(nullptr, nullptr);
+#endif
+  }
+
+  for (const int dim : {2, 3}) {
+    for (const bool stretched : {false, true}) {
+      INFO(dim << "D " << (stretched ? "stretched" : "uniform"));
+      CHECK(checkSolve(dim, stretched) < 1e-8);
+    }
+  }
+
+  if (!initialized) {
+#ifdef ENABLE_PETSC
+    PetscFinalize();
+#else
+    MPI_Finalize();
+#endif
+  }
+
+  spdlog::info("Test for the implicit viscous solver at large timesteps completed successfully");
+}